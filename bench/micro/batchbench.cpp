@@ -0,0 +1,321 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+
+/**
+ * @file	batchbench.cpp
+ * @brief	Micro benchmark of a batched device compute. It measures the
+ * number of service time computations per second on a mix of HDDs and SSDs,
+ * with one virtual compute() call by request as the execution module does,
+ * and with batches of received requests grouped by device type and by device,
+ * each group being computed by its model without virtual call. It checks that
+ * both give the same times.
+ *
+ * Usage: ogssim-batchbench [-n requests] [-d devices] [-b batch] [-r rounds]
+ *                          [-s ssd ratio]
+ */
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "ComputationModels/cmdiskhdd.hpp"
+#include "ComputationModels/cmdiskssd.hpp"
+#include "Structures/architecture.hpp"
+#include "Structures/requestarray0.hpp"
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+static const unsigned		SEED			= 42;
+
+/**************************************/
+/* FUNCTIONS **************************/
+/**************************************/
+/**
+ * Fill a HDD with the parameters of example/hdd_hitachi_A7K1000.xml.
+ * @param	hdd					HDD device.
+ */
+void
+initHDD (
+	HDDDevice				& hdd) {
+	hdd.m_sectorSize = 512;
+	hdd.m_sectorsByTrack = 1380;
+	hdd.m_tracksByPlatter = 117967;
+	hdd.m_numPlatters = 3;
+	hdd.m_numDataHeads = 6;
+	hdd.m_numCylinders = hdd.m_tracksByPlatter;
+	hdd.m_numSectors = (OGSS_Ulong) hdd.m_sectorsByTrack
+		* hdd.m_tracksByPlatter * hdd.m_numPlatters;
+	hdd.m_minRSeekTime = hdd.m_minWSeekTime = 1.1;
+	hdd.m_avgRSeekTime = hdd.m_avgWSeekTime = 8.7;
+	hdd.m_maxRSeekTime = hdd.m_maxWSeekTime = 15.2;
+	hdd.m_mediaTransferRate = 120;
+	hdd.m_maxRotationTime = 60000. / 7200;
+	hdd.m_ataNCQ = false;
+	hdd.m_trackPosition = 0;
+	hdd.m_headPosition = 0;
+	hdd.m_seekCurve = NULL;
+	hdd.m_zoneTable = NULL;
+}
+
+/**
+ * Fill a SSD with the parameters of example/ssd_transcend_370.xml.
+ * @param	ssd					SSD device.
+ */
+void
+initSSD (
+	SSDDevice				& ssd) {
+	ssd.m_pageSize = 4096;
+	ssd.m_pagesByBlock = 512;
+	ssd.m_blocksByDie = 2048;
+	ssd.m_numDies = 16;
+	ssd.m_numChannels = 0;
+	ssd.m_numPages = (OGSS_Ulong) ssd.m_pagesByBlock * ssd.m_blocksByDie
+		* ssd.m_numDies;
+	ssd.m_randomReadTime = 1. / 70;
+	ssd.m_randomWriteTime = 1. / 70;
+	ssd.m_sequentialReadTime = 4096. / (560 * MILLISEC * MEGABYTE);
+	ssd.m_sequentialWriteTime = 4096. / (320 * MILLISEC * MEGABYTE);
+	ssd.m_lastPageSeen = new OGSS_Ulong [ssd.m_numDies] ();
+	ssd.m_dieClock = NULL;
+	ssd.m_channelClock = NULL;
+	ssd.m_ftl = NULL;
+}
+
+/**
+ * Reset the head positions and the last pages seen of all the devices.
+ * @param	arch				Architecture.
+ */
+void
+resetDevices (
+	Architecture			& arch) {
+	for (OGSS_Ushort i = 0; i < arch.m_geometry->m_numDevices; ++i) {
+		if (arch.m_devices [i] .m_type == DVT_HDD) {
+			arch.m_devices [i] .m_hardware.m_hdd.m_trackPosition = 0;
+			arch.m_devices [i] .m_hardware.m_hdd.m_headPosition = 0;
+		} else {
+			SSDDevice & ssd = arch.m_devices [i] .m_hardware.m_ssd;
+			for (unsigned j = 0; j < ssd.m_numDies; ++j)
+				ssd.m_lastPageSeen [j] = 0;
+		}
+	}
+}
+
+/**
+ * Compute a batch grouped by device type and by device. The requests of a
+ * device keep their order, so that the models see the same sequence as with
+ * one call by request.
+ * @param	requests			Request array.
+ * @param	arch				Architecture.
+ * @param	hddModel			HDD model.
+ * @param	ssdModel			SSD model.
+ * @param	first				First request of the batch.
+ * @param	numRequests			Batch size.
+ * @param	times				Service times (output).
+ */
+void
+computeBatch (
+	RequestArray			* requests,
+	Architecture			& arch,
+	CMDiskHDD				& hddModel,
+	CMDiskSSD				& ssdModel,
+	const OGSS_Ulong		first,
+	const OGSS_Ulong		numRequests,
+	vector < OGSS_Real >	& times) {
+	static vector < OGSS_Ulong >	offsets;
+	static vector < OGSS_Ulong >	indexes;
+	OGSS_Ushort				numDevices = arch.m_geometry->m_numDevices;
+
+	// Counting sort of the batch by device, stable in each device
+	offsets.assign (numDevices + 1, 0);
+	indexes.resize (numRequests);
+
+	for (OGSS_Ulong i = 0; i < numRequests; ++i)
+		offsets [requests->getIdxDevice (first + i) + 1] ++;
+	for (OGSS_Ushort d = 0; d < numDevices; ++d)
+		offsets [d + 1] += offsets [d];
+	for (OGSS_Ulong i = 0; i < numRequests; ++i)
+		indexes [offsets [requests->getIdxDevice (first + i)] ++] = first + i;
+	for (OGSS_Ushort d = numDevices; d > 0; --d)
+		offsets [d] = offsets [d - 1];
+	offsets [0] = 0;
+
+	// One pass by device type, the model is known for the whole pass
+	for (OGSS_Ushort d = 0; d < numDevices; ++d) {
+		if (arch.m_devices [d] .m_type != DVT_HDD) continue;
+		for (OGSS_Ulong j = offsets [d]; j < offsets [d + 1]; ++j)
+			times [indexes [j] ] = hddModel.CMDiskHDD::compute (indexes [j]);
+	}
+
+	for (OGSS_Ushort d = 0; d < numDevices; ++d) {
+		if (arch.m_devices [d] .m_type != DVT_SSD) continue;
+		for (OGSS_Ulong j = offsets [d]; j < offsets [d + 1]; ++j)
+			times [indexes [j] ] = ssdModel.CMDiskSSD::compute (indexes [j]);
+	}
+}
+
+/**
+ * Print a measure.
+ * @param	name				Measure name.
+ * @param	numComputations		Number of computations.
+ * @param	start				Start time.
+ */
+void
+report (
+	const char				* name,
+	const OGSS_Ulong		numComputations,
+	const chrono::steady_clock::time_point	& start) {
+	double seconds = chrono::duration < double > (
+		chrono::steady_clock::now () - start) .count ();
+
+	cout << "  \"" << name << "\": " << (OGSS_Ulong) (numComputations / seconds);
+}
+
+int
+main (
+	int						argc,
+	char					** argv) {
+	OGSS_Ulong				numRequests = 1000000;
+	OGSS_Ushort				numDevices = 8;
+	OGSS_Ulong				batchSize = 64;
+	unsigned				numRounds = 5;
+	OGSS_Real				ssdRatio = .5;
+	int						opt;
+
+	while ( (opt = getopt (argc, argv, "n:d:b:r:s:") ) != -1) {
+		switch (opt) {
+		case 'n': numRequests = strtoull (optarg, NULL, 10); break;
+		case 'd': numDevices = atoi (optarg); break;
+		case 'b': batchSize = strtoull (optarg, NULL, 10); break;
+		case 'r': numRounds = atoi (optarg); break;
+		case 's': ssdRatio = atof (optarg); break;
+		default:
+			cerr << "Usage: " << argv [0] << " [-n requests] [-d devices] "
+				<< "[-b batch] [-r rounds] [-s ssd ratio]" << endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (numDevices == 0 || batchSize == 0) {
+		cerr << "The number of devices and the batch size must be positive"
+			<< endl;
+		return EXIT_FAILURE;
+	}
+
+	Architecture arch;
+	arch.m_geometry = new Geometry ();
+	arch.m_geometry->m_numDevices = numDevices;
+	arch.m_devices = new Device [numDevices] ();
+
+	OGSS_Ushort numSSDs = round (numDevices * ssdRatio);
+
+	for (OGSS_Ushort i = 0; i < numDevices; ++i) {
+		arch.m_devices [i] .m_parallel = false;
+		arch.m_devices [i] .m_cacheSegmentSize = 0;
+
+		if (i < numSSDs) {
+			arch.m_devices [i] .m_type = DVT_SSD;
+			initSSD (arch.m_devices [i] .m_hardware.m_ssd);
+		} else {
+			arch.m_devices [i] .m_type = DVT_HDD;
+			initHDD (arch.m_devices [i] .m_hardware.m_hdd);
+			arch.m_devices [i] .m_hardware.m_hdd.m_seekCurve =
+				arch.getSeekCurve (arch.m_devices [i] .m_hardware.m_hdd);
+		}
+	}
+
+	RequestArray_Type0 requests (numRequests, 0, 0);
+	mt19937_64 generator (SEED);
+
+	vector < OGSS_Ulong > lastAddresses (numDevices, 0);
+
+	for (OGSS_Ulong i = 0; i < numRequests; ++i) {
+		OGSS_Ushort dev = generator () % numDevices;
+		OGSS_Ulong size = 4096 << (generator () % 5);
+		OGSS_Ulong maxAddress = (arch.m_devices [dev] .m_type == DVT_SSD) ?
+			arch.m_devices [dev] .m_hardware.m_ssd.m_numPages * 4096
+			: arch.m_devices [dev] .m_hardware.m_hdd.m_numSectors * 512;
+
+		// Half of the requests follow the previous one of their device
+		if (generator () % 2 || lastAddresses [dev] + size > maxAddress)
+			lastAddresses [dev] = (generator () % (maxAddress / 2) )
+				& ~ (OGSS_Ulong) 4095;
+
+		requests.initRequest (i, i, 0, size,
+			(generator () % 3 == 0) ? RQT_WRITE : RQT_READ);
+		requests.setIdxDevice (i, dev);
+		requests.setDeviceAddress (i, lastAddresses [dev]);
+		lastAddresses [dev] += size;
+	}
+
+	CMDiskHDD hddModel (&requests, &arch);
+	CMDiskSSD ssdModel (&requests, &arch);
+	ComputationModel * models [DVT_TOTAL] = { NULL };
+	vector < OGSS_Real > times (numRequests);
+	vector < OGSS_Real > batchTimes (numRequests);
+	OGSS_Real maxMismatch = 0;
+
+	models [DVT_HDD] = &hddModel;
+	models [DVT_SSD] = &ssdModel;
+
+	cout << "{" << endl << "  \"requests\": " << numRequests << ","
+		<< endl << "  \"devices\": " << numDevices << ","
+		<< endl << "  \"ssds\": " << numSSDs << ","
+		<< endl << "  \"batch\": " << batchSize << "," << endl;
+
+	auto start = chrono::steady_clock::now ();
+	for (unsigned r = 0; r < numRounds; ++r) {
+		resetDevices (arch);
+		for (OGSS_Ulong i = 0; i < numRequests; ++i)
+			times [i] = models [arch.m_devices [requests.getIdxDevice (i)]
+				.m_type] ->compute (i);
+	}
+	report ("single_per_s", numRequests * numRounds, start);
+	cout << "," << endl;
+
+	start = chrono::steady_clock::now ();
+	for (unsigned r = 0; r < numRounds; ++r) {
+		resetDevices (arch);
+		for (OGSS_Ulong i = 0; i < numRequests; i += batchSize)
+			computeBatch (&requests, arch, hddModel, ssdModel, i,
+				min (batchSize, numRequests - i), batchTimes);
+	}
+	report ("batch_per_s", numRequests * numRounds, start);
+	cout << "," << endl;
+
+	for (OGSS_Ulong i = 0; i < numRequests; ++i)
+		maxMismatch = max (maxMismatch, fabs (batchTimes [i] - times [i]) );
+
+	cout << "  \"batch_max_mismatch_ms\": " << maxMismatch << endl
+		<< "}" << endl;
+
+	return EXIT_SUCCESS;
+}
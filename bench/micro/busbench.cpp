@@ -0,0 +1,260 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+
+/**
+ * @file	busbench.cpp
+ * @brief	Micro benchmark of the advanced bus model. It measures the number
+ * of requests computed per second on a large architecture (256 buses by
+ * default: the host bus, the tier buses and the volume buses), with a part of
+ * the writes mirrored as RAID-1 does: the ghost request waits for its two
+ * writes before going back. The second write of a mirror can be delivered
+ * some requests later, as a slow decomposition does: the bus model then waits
+ * for it before moving the transfers after its date. The sum of the response
+ * times is given to check that two versions of the model give the same
+ * results, with the number of entries kept by the bus profiles.
+ *
+ * Usage: ogssim-busbench [-n requests] [-b buses] [-t tiers] [-d devices by
+ *                        volume] [-m mirrored ratio] [-i interarrival (ms)]
+ *                        [-l late delivery (requests)]
+ */
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+#include "ComputationModels/cmbusadvanced.hpp"
+#include "Structures/architecture.hpp"
+#include "Structures/requestarray0.hpp"
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+static const unsigned		SEED			= 42;
+static const OGSS_Ulong		BUFFER_SIZE		= 1024 * MEGABYTE;
+
+/**************************************/
+/* FUNCTIONS **************************/
+/**************************************/
+/**
+ * Build the architecture: one host bus, one bus by tier and one bus by
+ * volume. All the components have a buffer.
+ * @param	arch				Architecture.
+ * @param	numBuses			Number of buses.
+ * @param	numTiers			Number of tiers.
+ * @param	devicesByVolume		Number of devices by volume.
+ */
+void
+initArchitecture (
+	Architecture			& arch,
+	const OGSS_Ushort		numBuses,
+	const OGSS_Ushort		numTiers,
+	const OGSS_Ushort		devicesByVolume) {
+	OGSS_Ushort				numVolumes = numBuses - 1 - numTiers;
+
+	arch.m_geometry = new Geometry ();
+	arch.m_geometry->m_numBuses = numBuses;
+	arch.m_geometry->m_numHosts = 1;
+	arch.m_geometry->m_numTiers = numTiers;
+	arch.m_geometry->m_numVolumes = numVolumes;
+	arch.m_geometry->m_numDevices = numVolumes * devicesByVolume;
+	arch.m_geometry->m_idxBus = 0;
+
+	arch.m_buses = new Bus [numBuses] ();
+	for (OGSS_Ushort i = 0; i < numBuses; ++i) {
+		arch.m_buses [i] .m_type = BST_SAS;
+		arch.m_buses [i] .m_bandwidth = (i == 0) ? 64000 : 1200;
+		arch.m_buses [i] .m_clock = .0;
+	}
+
+	// Only the default host, without adapter nor limit
+	arch.m_hosts = new Host [1] ();
+	arch.m_hosts [0] .m_idxBus = OGSS_USHORT_MAX;
+	arch.m_hosts [0] .m_idxFabricNode = OGSS_USHORT_MAX;
+
+	arch.m_tiers = new Tier [numTiers] ();
+	for (OGSS_Ushort i = 0; i < numTiers; ++i) {
+		arch.m_tiers [i] .m_idxBus = 1 + i;
+		arch.m_tiers [i] .m_bufferSize = BUFFER_SIZE;
+	}
+
+	arch.m_volumes = new Volume [numVolumes] ();
+	for (OGSS_Ushort i = 0; i < numVolumes; ++i) {
+		arch.m_volumes [i] .m_idxTier = i % numTiers;
+		arch.m_volumes [i] .m_idxBus = 1 + numTiers + i;
+		arch.m_volumes [i] .m_bufferSize = BUFFER_SIZE;
+	}
+
+	arch.m_devices = new Device [arch.m_geometry->m_numDevices] ();
+	for (OGSS_Ushort i = 0; i < arch.m_geometry->m_numDevices; ++i) {
+		arch.m_devices [i] .m_type = DVT_HDD;
+		arch.m_devices [i] .m_idxVolume = i / devicesByVolume;
+		arch.m_devices [i] .m_clock = .0;
+		arch.m_devices [i] .m_parallel = false;
+		arch.m_devices [i] .m_bufferSize = BUFFER_SIZE;
+	}
+}
+
+int
+main (
+	int						argc,
+	char					** argv) {
+	OGSS_Ulong				numRequests = 200000;
+	OGSS_Ushort				numBuses = 256;
+	OGSS_Ushort				numTiers = 15;
+	OGSS_Ushort				devicesByVolume = 4;
+	OGSS_Real				mirroredRatio = .25;
+	OGSS_Real				interarrival = .01;
+	OGSS_Ulong				lateDelivery = 0;
+	int						opt;
+
+	while ( (opt = getopt (argc, argv, "n:b:t:d:m:i:l:") ) != -1) {
+		switch (opt) {
+		case 'n': numRequests = strtoull (optarg, NULL, 10); break;
+		case 'b': numBuses = atoi (optarg); break;
+		case 't': numTiers = atoi (optarg); break;
+		case 'd': devicesByVolume = atoi (optarg); break;
+		case 'm': mirroredRatio = atof (optarg); break;
+		case 'i': interarrival = atof (optarg); break;
+		case 'l': lateDelivery = strtoull (optarg, NULL, 10); break;
+		default:
+			cerr << "Usage: " << argv [0] << " [-n requests] [-b buses] "
+				<< "[-t tiers] [-d devices by volume] [-m mirrored ratio] "
+				<< "[-i interarrival (ms)] [-l late delivery (requests)]"
+				<< endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (numTiers == 0 || numBuses < numTiers + 2 || devicesByVolume < 2) {
+		cerr << "There must be at least one tier, one volume and two "
+			<< "devices by volume" << endl;
+		return EXIT_FAILURE;
+	}
+
+	Architecture arch;
+	initArchitecture (arch, numBuses, numTiers, devicesByVolume);
+
+	RequestArray_Type0 requests (numRequests, 2 * numRequests, 0);
+	ofstream results ("/dev/null");
+	CMBusAdvanced model (&requests, &arch, &results, &results);
+	mt19937_64 generator (SEED);
+	exponential_distribution < OGSS_Real > arrival (1. / interarrival);
+	uniform_real_distribution < OGSS_Real > ratio (.0, 1.);
+	OGSS_Real date = .0, responseTimes = .0;
+	OGSS_Ulong profileEntries = 0;
+	OGSS_Ulong idxSubrequest = numRequests, numComputations = 0;
+	deque < pair < OGSS_Ulong, OGSS_Ulong > > lateWrites;
+
+	// The trace is read before the simulation: the requests which are not
+	// decomposed yet stop the bus model
+	for (OGSS_Ulong i = 0; i < numRequests; ++i) {
+		date += arrival (generator);
+		requests.initRequest (i, date, 0, 4096 << (generator () % 5),
+			(ratio (generator) < .4) ? RQT_WRITE : RQT_READ);
+		requests.setIdxDevice (i,
+			generator () % arch.m_geometry->m_numDevices);
+		requests.setServiceTime (i, .1 + 5 * ratio (generator) );
+	}
+
+	auto start = chrono::steady_clock::now ();
+
+	for (OGSS_Ulong i = 0; i < numRequests; ++i) {
+		while (! lateWrites.empty () && lateWrites.front () .first <= i) {
+			model.compute (lateWrites.front () .second);
+			lateWrites.pop_front ();
+		}
+
+		requests.setNumEffBusChild (i, 0);
+
+		if (requests.getType (i) != RQT_WRITE
+			|| ratio (generator) >= mirroredRatio) {
+			requests.setNumBusChild (i, 1);
+			model.compute (i);
+			numComputations ++;
+			continue;
+		}
+
+		// The ghost goes to the first device of the pair, then the two
+		// writes are sent, and the ghost goes back when they are done
+		OGSS_Ushort dev = requests.getIdxDevice (i);
+		OGSS_Real serviceTime = requests.getServiceTime (i);
+
+		dev -= dev % 2;
+		requests.setIdxDevice (i, dev);
+		requests.setType (i, RQT_GHSTW);
+		requests.setNumChild (i, 2);
+		requests.setNumBusChild (i, 3);
+		requests.setServiceTime (i, .0);
+
+		model.compute (i);
+
+		for (OGSS_Ushort j = 0; j < 2; ++j, ++idxSubrequest) {
+			requests.initRequest (idxSubrequest, requests.getDate (i), 0,
+				requests.getSize (i), RQT_WRTPR);
+			requests.setIdxParent (idxSubrequest, i);
+			requests.setIdxDevice (idxSubrequest, dev + j);
+			requests.setServiceTime (idxSubrequest, serviceTime);
+
+			if (j == 1 && lateDelivery != 0)
+				lateWrites.push_back (make_pair (i + lateDelivery,
+					idxSubrequest) );
+			else
+				model.compute (idxSubrequest);
+		}
+
+		numComputations += 3;
+	}
+
+	for (auto & write: lateWrites)
+		model.compute (write.second);
+
+	double seconds = chrono::duration < double > (
+		chrono::steady_clock::now () - start) .count ();
+
+	for (OGSS_Ulong i = 0; i < numRequests; ++i)
+		responseTimes += requests.getResponseTime (i);
+
+	for (OGSS_Ushort i = 0; i < numBuses; ++i)
+		profileEntries += arch.m_buses [i] .m_profile.size ();
+
+	cout << "{" << endl << "  \"requests\": " << numRequests << ","
+		<< endl << "  \"buses\": " << numBuses << ","
+		<< endl << "  \"devices\": " << arch.m_geometry->m_numDevices << ","
+		<< endl << "  \"mirrored_ratio\": " << mirroredRatio << ","
+		<< endl << "  \"late_delivery\": " << lateDelivery << ","
+		<< endl << "  \"computations_per_s\": "
+		<< (OGSS_Ulong) (numComputations / seconds) << ","
+		<< endl << "  \"profile_entries\": " << profileEntries << ","
+		<< endl << "  \"response_time_sum_ms\": " << fixed << responseTimes
+		<< endl << "}" << endl;
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,355 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+
+/**
+ * @file	busmodelbench.cpp
+ * @brief	Micro benchmark which compares the bus models on the same trace:
+ * the default model, which ignores the contention, the fluid model, which
+ * queues the transfers on each bus, and the advanced model, which simulates
+ * each transfer and is the reference. The architectures reproduce the
+ * examples (jbod: three 640MB/s buses and 5 devices, raid1: 7 buses and 5
+ * volumes of 2 devices) or the large one of busbench. The fabric one is the
+ * large one with its 15 enclosures behind a leaf and spine fabric, which only
+ * the fluid model crosses. For each model, it gives the number of requests
+ * computed per second, the mean response, bus and buffer waiting times, and
+ * the mean error on the response time against the advanced model. The buffers
+ * are large enough to never stop a transfer, unless a smaller size is given. With a trace file,
+ * all the events of the advanced model are traced, which gives the cost of
+ * the tracing.
+ *
+ * Usage: ogssim-busmodelbench [-a jbod|raid1|large|fabric] [-n requests]
+ *                             [-i interarrival (ms)] [-b buffer (MB)]
+ *                             [-t trace]
+ */
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+#include "ComputationModels/cmbusadvanced.hpp"
+#include "ComputationModels/cmbusdefault.hpp"
+#include "ComputationModels/cmbusfluid.hpp"
+#include "Structures/architecture.hpp"
+#include "Structures/fabric.hpp"
+#include "Structures/requestarray0.hpp"
+#include "Utils/eventtrace.hpp"
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+static const unsigned		SEED			= 42;
+static const OGSS_Ulong		BUFFER_SIZE		= 1024 * MEGABYTE;
+
+/**************************************/
+/* FUNCTIONS **************************/
+/**************************************/
+/**
+ * Build the architecture: one host bus, one bus by tier and one bus by
+ * volume. All the components have a buffer.
+ * @param	arch				Architecture.
+ * @param	numTiers			Number of tiers.
+ * @param	numVolumes			Number of volumes.
+ * @param	devicesByVolume		Number of devices by volume.
+ * @param	hostBandwidth		Host bus bandwidth.
+ * @param	bandwidth			Tier and volume bus bandwidth.
+ * @param	bufferSize			Buffer size of the components.
+ */
+void
+initArchitecture (
+	Architecture			& arch,
+	const OGSS_Ushort		numTiers,
+	const OGSS_Ushort		numVolumes,
+	const OGSS_Ushort		devicesByVolume,
+	const OGSS_Real			hostBandwidth,
+	const OGSS_Real			bandwidth,
+	const OGSS_Ulong		bufferSize) {
+	OGSS_Ushort				numBuses = 1 + numTiers + numVolumes;
+
+	arch.m_geometry = new Geometry ();
+	arch.m_geometry->m_numBuses = numBuses;
+	arch.m_geometry->m_numHosts = 1;
+	arch.m_geometry->m_numTiers = numTiers;
+	arch.m_geometry->m_numVolumes = numVolumes;
+	arch.m_geometry->m_numDevices = numVolumes * devicesByVolume;
+	arch.m_geometry->m_idxBus = 0;
+
+	arch.m_buses = new Bus [numBuses] ();
+	for (OGSS_Ushort i = 0; i < numBuses; ++i) {
+		arch.m_buses [i] .m_type = BST_SCSI;
+		arch.m_buses [i] .m_bandwidth = (i == 0) ? hostBandwidth : bandwidth;
+		arch.m_buses [i] .m_clock = .0;
+	}
+
+	// Only the default host, without adapter nor limit
+	arch.m_hosts = new Host [1] ();
+	arch.m_hosts [0] .m_idxBus = OGSS_USHORT_MAX;
+	arch.m_hosts [0] .m_idxFabricNode = OGSS_USHORT_MAX;
+
+	arch.m_tiers = new Tier [numTiers] ();
+	for (OGSS_Ushort i = 0; i < numTiers; ++i) {
+		arch.m_tiers [i] .m_idxBus = 1 + i;
+		arch.m_tiers [i] .m_bufferSize = bufferSize;
+	}
+
+	arch.m_volumes = new Volume [numVolumes] ();
+	for (OGSS_Ushort i = 0; i < numVolumes; ++i) {
+		arch.m_volumes [i] .m_idxFabricNode = OGSS_USHORT_MAX;
+		arch.m_volumes [i] .m_idxTier = i % numTiers;
+		arch.m_volumes [i] .m_idxBus = 1 + numTiers + i;
+		arch.m_volumes [i] .m_bufferSize = bufferSize;
+	}
+
+	arch.m_devices = new Device [arch.m_geometry->m_numDevices] ();
+	for (OGSS_Ushort i = 0; i < arch.m_geometry->m_numDevices; ++i) {
+		arch.m_devices [i] .m_type = DVT_HDD;
+		arch.m_devices [i] .m_idxVolume = i / devicesByVolume;
+		arch.m_devices [i] .m_clock = .0;
+		arch.m_devices [i] .m_parallel = false;
+		arch.m_devices [i] .m_bufferSize = bufferSize;
+	}
+}
+
+/**
+ * Put the volumes of each tier in a fabric enclosure. The host reaches 2
+ * spine switches, each enclosure is behind a leaf switch linked to both
+ * spines.
+ * @param	arch				Architecture.
+ */
+void
+initFabric (
+	Architecture			& arch) {
+	OGSS_Ushort				host;
+	OGSS_Ushort				spines [2];
+	OGSS_Ushort				leaf;
+	OGSS_Ushort				target;
+
+	arch.m_fabric = new Fabric ();
+	host = arch.m_fabric->addNode ("host", FNT_HOST, .0);
+	arch.m_fabric->setHostNode (host);
+
+	for (OGSS_Ushort i = 0; i < 2; ++i) {
+		spines [i] = arch.m_fabric->addNode ("spine" + to_string (i),
+			FNT_SWITCH, .0003);
+		arch.m_fabric->addLink (host, spines [i], BST_ETH, 25000, .0005);
+	}
+
+	for (OGSS_Ushort i = 0; i < arch.m_geometry->m_numTiers; ++i) {
+		leaf = arch.m_fabric->addNode ("leaf" + to_string (i),
+			FNT_SWITCH, .0003);
+		target = arch.m_fabric->addNode ("jbof" + to_string (i),
+			FNT_TARGET, .0);
+
+		arch.m_fabric->addLink (spines [0], leaf, BST_ETH, 12500, .0005);
+		arch.m_fabric->addLink (spines [1], leaf, BST_ETH, 12500, .0005);
+		arch.m_fabric->addLink (leaf, target, BST_ETH, 12500, .0005);
+
+		for (OGSS_Ushort j = 0; j < arch.m_geometry->m_numVolumes; ++j)
+			if (arch.m_volumes [j] .m_idxTier == i)
+				arch.m_volumes [j] .m_idxFabricNode = target;
+	}
+
+	arch.m_fabric->computeRoutes ();
+}
+
+/**
+ * Compute the whole trace with a bus model, on a new architecture.
+ * @param	name				Architecture name.
+ * @param	numRequests			Number of requests.
+ * @param	interarrival		Mean interarrival time (ms).
+ * @param	bufferSize			Buffer size of the components.
+ * @param	responseTimes		Response times.
+ * @param	busWaitingTime		Mean bus waiting time.
+ * @param	bufferWaitingTime	Mean buffer waiting time.
+ * @return						Requests computed by second.
+ */
+template < class Model >
+OGSS_Real
+run (
+	const char				* name,
+	const OGSS_Ulong		numRequests,
+	const OGSS_Real			interarrival,
+	const OGSS_Ulong		bufferSize,
+	vector < OGSS_Real >	& responseTimes,
+	OGSS_Real				& busWaitingTime,
+	OGSS_Real				& bufferWaitingTime) {
+	Architecture			arch;
+
+	if (strcmp (name, "jbod") == 0)
+		initArchitecture (arch, 1, 1, 5, 640, 640, bufferSize);
+	else if (strcmp (name, "raid1") == 0)
+		initArchitecture (arch, 1, 5, 2, 640, 640, bufferSize);
+	else
+		initArchitecture (arch, 15, 240, 4, 64000, 1200, bufferSize);
+
+	if (strcmp (name, "fabric") == 0)
+		initFabric (arch);
+
+	RequestArray_Type0 requests (numRequests, 0, 0);
+	ofstream results ("/dev/null");
+	Model model (&requests, &arch, &results, &results);
+	mt19937_64 generator (SEED);
+	exponential_distribution < OGSS_Real > arrival (1. / interarrival);
+	uniform_real_distribution < OGSS_Real > ratio (.0, 1.);
+	OGSS_Real date = .0;
+
+	for (OGSS_Ulong i = 0; i < numRequests; ++i) {
+		date += arrival (generator);
+		requests.initRequest (i, date, 0, 4096 << (generator () % 9),
+			(ratio (generator) < .4) ? RQT_WRITE : RQT_READ);
+		requests.setIdxDevice (i,
+			generator () % arch.m_geometry->m_numDevices);
+		requests.setServiceTime (i, .1 + 5 * ratio (generator) );
+		requests.setNumBusChild (i, 1);
+		requests.setNumEffBusChild (i, 0);
+	}
+
+	auto start = chrono::steady_clock::now ();
+
+	for (OGSS_Ulong i = 0; i < numRequests; ++i)
+		model.compute (i);
+
+	double seconds = chrono::duration < double > (
+		chrono::steady_clock::now () - start) .count ();
+
+	responseTimes.resize (numRequests);
+	busWaitingTime = .0;
+	bufferWaitingTime = .0;
+
+	for (OGSS_Ulong i = 0; i < numRequests; ++i) {
+		responseTimes [i] = requests.getResponseTime (i);
+		busWaitingTime += requests.getBusWaitingTime (i) / numRequests;
+		bufferWaitingTime += requests.getBufferWaitingTime (i) / numRequests;
+	}
+
+	return numRequests / seconds;
+}
+
+/**
+ * Print the results of a model against the reference.
+ * @param	name				Model name.
+ * @param	speed				Requests computed by second.
+ * @param	responseTimes		Response times.
+ * @param	busWaitingTime		Mean bus waiting time.
+ * @param	bufferWaitingTime	Mean buffer waiting time.
+ * @param	reference			Response times of the reference.
+ * @param	last				TRUE if it is the last model.
+ */
+void
+print (
+	const char				* name,
+	const OGSS_Real			speed,
+	const vector < OGSS_Real >	& responseTimes,
+	const OGSS_Real			busWaitingTime,
+	const OGSS_Real			bufferWaitingTime,
+	const vector < OGSS_Real >	& reference,
+	const OGSS_Bool			last) {
+	OGSS_Real				mean = .0;
+	OGSS_Real				meanReference = .0;
+	OGSS_Real				error = .0;
+
+	for (OGSS_Ulong i = 0; i < responseTimes.size (); ++i) {
+		mean += responseTimes [i] / responseTimes.size ();
+		meanReference += reference [i] / reference.size ();
+		error += fabs (responseTimes [i] - reference [i])
+			/ responseTimes.size ();
+	}
+
+	cout << "  \"" << name << "\": {\"requests_per_s\": "
+		<< (OGSS_Ulong) speed << ", \"mean_response_ms\": " << mean
+		<< ", \"mean_bus_wait_ms\": " << busWaitingTime
+		<< ", \"mean_buffer_wait_ms\": " << bufferWaitingTime
+		<< ", \"mean_error\": " << error / meanReference << "}"
+		<< (last ? "" : ",") << endl;
+}
+
+int
+main (
+	int						argc,
+	char					** argv) {
+	const char				* name = "raid1";
+	OGSS_Ulong				numRequests = 200000;
+	OGSS_Real				interarrival = .5;
+	OGSS_Ulong				bufferSize = BUFFER_SIZE;
+	const char				* trace = NULL;
+	int						opt;
+
+	vector < OGSS_Real >	responseTimes [3];
+	OGSS_Real				busWaitingTimes [3];
+	OGSS_Real				bufferWaitingTimes [3];
+	OGSS_Real				speeds [3];
+
+	while ( (opt = getopt (argc, argv, "a:n:i:b:t:") ) != -1) {
+		switch (opt) {
+		case 'a': name = optarg; break;
+		case 'n': numRequests = strtoull (optarg, NULL, 10); break;
+		case 'i': interarrival = atof (optarg); break;
+		case 'b': bufferSize = atof (optarg) * MEGABYTE; break;
+		case 't': trace = optarg; break;
+		default:
+			cerr << "Usage: " << argv [0] << " [-a jbod|raid1|large|fabric] "
+				<< "[-n requests] [-i interarrival (ms)] [-b buffer (MB)] "
+				<< "[-t trace]" << endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (trace != NULL)
+		EventTrace::start (trace, EventTrace::parseComponents ("all") );
+
+	speeds [0] = run < CMBusAdvanced > (name, numRequests, interarrival,
+		bufferSize, responseTimes [0], busWaitingTimes [0],
+		bufferWaitingTimes [0]);
+
+	EventTrace::stop ();
+
+	speeds [1] = run < CMBusDefault > (name, numRequests, interarrival,
+		bufferSize, responseTimes [1], busWaitingTimes [1],
+		bufferWaitingTimes [1]);
+	speeds [2] = run < CMBusFluid > (name, numRequests, interarrival,
+		bufferSize, responseTimes [2], busWaitingTimes [2],
+		bufferWaitingTimes [2]);
+
+	cout << "{" << endl << "  \"architecture\": \"" << name << "\","
+		<< endl << "  \"requests\": " << numRequests << ","
+		<< endl << "  \"interarrival_ms\": " << interarrival << "," << endl;
+
+	print ("advanced", speeds [0], responseTimes [0], busWaitingTimes [0],
+		bufferWaitingTimes [0], responseTimes [0], false);
+	print ("default", speeds [1], responseTimes [1], busWaitingTimes [1],
+		bufferWaitingTimes [1], responseTimes [0], false);
+	print ("fluid", speeds [2], responseTimes [2], busWaitingTimes [2],
+		bufferWaitingTimes [2], responseTimes [0], true);
+
+	cout << "}" << endl;
+
+	return EXIT_SUCCESS;
+}
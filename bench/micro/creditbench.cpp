@@ -0,0 +1,370 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+
+/**
+ * @file	creditbench.cpp
+ * @brief	Micro benchmark of the subrequest flow control of the execution
+ * module. It replays the pipeline in ticks: the volumes decompose their
+ * requests in the subrequest array, the execution module treats a few
+ * subrequests by tick and the bus model releases their slots some ticks later.
+ * A volume which finds the array full is blocked until the flow control wakes
+ * it up. One volume rebuilds a device: each of its requests takes a slot on
+ * every device of the volume.
+ *
+ * Three flow controls are compared: the previous heuristic (wake up after
+ * 10% of the array was treated), one credit pool shared by all the volumes,
+ * and one credit count by volume, returned when the slots are released. The
+ * measures are the ticks the execution module stayed idle while volumes were
+ * blocked, and the ticks the volumes stayed blocked.
+ *
+ * Usage: ogssim-creditbench [-s slots] [-v volumes] [-d devices]
+ *                           [-n requests] [-r rebuild blocks] [-l latency]
+ *                           [-e execution rate]
+ */
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Structures/types.hpp"
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+static const unsigned		SEED			= 42;
+static const OGSS_Real		PCTG_BUFFER		= .1;
+static const OGSS_Ulong		DECOMPOSITION	= 4;	/*!< Slots taken by a
+														 volume by tick. */
+
+/**************************************/
+/* TYPES ******************************/
+/**************************************/
+/**
+ * Flow control policy.
+ */
+enum FlowControl {
+	FLC_HEURISTIC,
+	FLC_SHARED,
+	FLC_VOLUME,
+	FLC_TOTAL
+};
+
+/**
+ * Volume of the pipeline.
+ */
+struct Volume {
+	deque < OGSS_Ulong >	m_requests;			/*!< Slots needed by the
+													 pending requests. */
+	OGSS_Ulong				m_taken;			/*!< Slots taken for the
+													 current request. */
+	OGSS_Ulong				m_grant;			/*!< Credit grant. */
+	OGSS_Bool				m_blocked;			/*!< Blocked volume. */
+	OGSS_Ulong				m_inFlight;			/*!< Subrequests sent and
+													 not released. */
+	OGSS_Ulong				m_credits;			/*!< Returned credits. */
+	OGSS_Ulong				m_counter;			/*!< Heuristic counter. */
+};
+
+/**
+ * Result of a run.
+ */
+struct Result {
+	OGSS_Ulong				m_ticks;			/*!< Ticks of the run. */
+	OGSS_Ulong				m_idleTicks;		/*!< Ticks without subrequest
+													 to treat, while volumes
+													 are blocked. */
+	OGSS_Ulong				m_stallTicks;		/*!< Ticks spent blocked by
+													 all the volumes. */
+	OGSS_Ulong				m_blocks;			/*!< Number of blocks. */
+	OGSS_Bool				m_deadlock;			/*!< TRUE if the run did not
+													 end. */
+};
+
+/**************************************/
+/* FUNCTIONS **************************/
+/**************************************/
+/**
+ * Wake up a blocked volume.
+ * @param	volume				Volume.
+ */
+void
+wakeup (
+	Volume					& volume) {
+	volume.m_blocked = false;
+}
+
+/**
+ * Replay the pipeline with a flow control.
+ * @param	policy				Flow control.
+ * @param	initial				Volumes and their requests.
+ * @param	numSlots			Size of the subrequest array.
+ * @param	latency				Ticks between the treatment of a subrequest
+ *								and the release of its slot.
+ * @param	rate				Subrequests treated by tick.
+ * @return						Measures.
+ */
+Result
+run (
+	const FlowControl		policy,
+	const vector < Volume >	& initial,
+	const OGSS_Ulong		numSlots,
+	const OGSS_Ulong		latency,
+	const OGSS_Ulong		rate) {
+	vector < Volume >		volumes = initial;
+	deque < OGSS_Ushort >	treatments;			// Sent subrequests
+	deque < pair < OGSS_Ulong, OGSS_Ushort > >	releases;
+	deque < OGSS_Ushort >	blocked;			// FIFO of the pool
+	OGSS_Ulong				freeSlots = numSlots;
+	OGSS_Ulong				sharedCredits = 0;
+	OGSS_Ulong				remaining = 0;
+	OGSS_Ulong				numBlocked = 0;
+	OGSS_Ulong				maxTicks;
+	Result					result = { 0, 0, 0, 0, false };
+
+	for (unsigned i = 0; i < volumes.size (); ++i)
+		for (unsigned j = 0; j < volumes [i] .m_requests.size (); ++j)
+			remaining += volumes [i] .m_requests [j];
+
+	maxTicks = 100 * (remaining + latency);
+
+	for (OGSS_Ulong tick = 0; remaining != 0; ++tick) {
+		if (tick > maxTicks) {
+			result.m_deadlock = true;
+			break;
+		}
+
+		// The bus model releases the slots
+		while (! releases.empty () && releases.front () .first == tick) {
+			OGSS_Ushort v = releases.front () .second;
+			Volume & vol = volumes [v];
+
+			releases.pop_front ();
+			freeSlots ++;
+			vol.m_inFlight --;
+			remaining --;
+
+			if (policy != FLC_VOLUME) continue;
+
+			if (vol.m_blocked && (++ vol.m_credits >= vol.m_grant
+				|| vol.m_inFlight == 0) ) {
+				wakeup (vol);
+				numBlocked --;
+			}
+
+			if (blocked.empty () ) continue;
+
+			sharedCredits ++;
+
+			while (! blocked.empty () ) {
+				if (! volumes [blocked.front ()] .m_blocked) {
+					blocked.pop_front ();
+					continue;
+				}
+				if (sharedCredits < volumes [blocked.front ()] .m_grant) break;
+
+				sharedCredits -= volumes [blocked.front ()] .m_grant;
+				wakeup (volumes [blocked.front ()]);
+				blocked.pop_front ();
+				numBlocked --;
+			}
+		}
+
+		// The execution module treats the subrequests
+		if (treatments.empty () && numBlocked != 0)
+			result.m_idleTicks ++;
+
+		for (OGSS_Ulong k = 0; k < rate && ! treatments.empty (); ++k) {
+			releases.push_back (make_pair (tick + 1 + latency,
+				treatments.front () ) );
+			treatments.pop_front ();
+
+			if (policy == FLC_HEURISTIC) {
+				for (unsigned i = 0; i < volumes.size (); ++i)
+					if (volumes [i] .m_blocked && -- volumes [i] .m_counter == 0) {
+						wakeup (volumes [i]);
+						numBlocked --;
+					}
+			} else if (policy == FLC_SHARED && ! blocked.empty () ) {
+				sharedCredits ++;
+
+				while (! blocked.empty ()
+					&& sharedCredits >= volumes [blocked.front ()] .m_grant) {
+					sharedCredits -= volumes [blocked.front ()] .m_grant;
+					wakeup (volumes [blocked.front ()]);
+					blocked.pop_front ();
+					numBlocked --;
+				}
+			}
+		}
+
+		result.m_stallTicks += numBlocked;
+
+		// The volumes decompose their requests
+		for (OGSS_Ushort v = 0; v < volumes.size (); ++v) {
+			Volume & vol = volumes [v];
+
+			if (vol.m_blocked) continue;
+
+			for (OGSS_Ulong k = 0; k < DECOMPOSITION
+				&& ! vol.m_requests.empty (); ++k) {
+				if (freeSlots == 0) {
+					vol.m_blocked = true;
+					numBlocked ++;
+					result.m_blocks ++;
+
+					if (policy == FLC_HEURISTIC)
+						vol.m_counter = numSlots * PCTG_BUFFER;
+					else if (policy == FLC_SHARED) {
+						if (blocked.empty () ) sharedCredits = 0;
+						blocked.push_back (v);
+					} else {
+						vol.m_credits = 0;
+						if (vol.m_inFlight == 0) {
+							if (blocked.empty () ) sharedCredits = 0;
+							blocked.push_back (v);
+						}
+					}
+					break;
+				}
+
+				freeSlots --;
+
+				// The subrequests are sent once the request is decomposed
+				if (++ vol.m_taken == vol.m_requests.front () ) {
+					for (OGSS_Ulong i = 0; i < vol.m_taken; ++i)
+						treatments.push_back (v);
+
+					vol.m_inFlight += vol.m_taken;
+					vol.m_taken = 0;
+					vol.m_requests.pop_front ();
+				}
+			}
+		}
+
+		result.m_ticks = tick + 1;
+	}
+
+	return result;
+}
+
+/**
+ * Print the measures of a run.
+ * @param	name				Flow control name.
+ * @param	result				Measures.
+ * @param	last				TRUE if it is the last run.
+ */
+void
+report (
+	const char				* name,
+	const Result			& result,
+	const OGSS_Bool			last) {
+	cout << "  \"" << name << "\": { \"ticks\": " << result.m_ticks
+		<< ", \"exec_idle_ticks\": " << result.m_idleTicks
+		<< ", \"volume_stall_ticks\": " << result.m_stallTicks
+		<< ", \"blocks\": " << result.m_blocks
+		<< ", \"deadlock\": " << (result.m_deadlock ? "true" : "false")
+		<< " }" << (last ? "" : ",") << endl;
+}
+
+int
+main (
+	int						argc,
+	char					** argv) {
+	OGSS_Ulong				numSlots = 1000;
+	OGSS_Ushort				numVolumes = 4;
+	OGSS_Ushort				numDevices = 8;
+	OGSS_Ulong				numRequests = 20000;
+	OGSS_Ulong				numRebuild = 5000;
+	OGSS_Ulong				latency = 32;
+	OGSS_Ulong				rate = 8;
+	int						opt;
+
+	while ( (opt = getopt (argc, argv, "s:v:d:n:r:l:e:") ) != -1) {
+		switch (opt) {
+		case 's': numSlots = strtoull (optarg, NULL, 10); break;
+		case 'v': numVolumes = atoi (optarg); break;
+		case 'd': numDevices = atoi (optarg); break;
+		case 'n': numRequests = strtoull (optarg, NULL, 10); break;
+		case 'r': numRebuild = strtoull (optarg, NULL, 10); break;
+		case 'l': latency = strtoull (optarg, NULL, 10); break;
+		case 'e': rate = strtoull (optarg, NULL, 10); break;
+		default:
+			cerr << "Usage: " << argv [0] << " [-s slots] [-v volumes] "
+				<< "[-d devices] [-n requests] [-r rebuild blocks] "
+				<< "[-l latency] [-e execution rate]" << endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (numVolumes == 0 || rate == 0 || numDevices + 1ul > numSlots) {
+		cerr << "There must be a volume, an execution rate, and enough slots "
+			<< "for a rebuild request" << endl;
+		return EXIT_FAILURE;
+	}
+
+	vector < Volume > volumes (numVolumes);
+	mt19937_64 generator (SEED);
+
+	for (OGSS_Ushort v = 0; v < numVolumes; ++v) {
+		volumes [v] .m_taken = 0;
+		volumes [v] .m_grant = numDevices + 1;
+		volumes [v] .m_blocked = false;
+		volumes [v] .m_inFlight = 0;
+		volumes [v] .m_credits = 0;
+		volumes [v] .m_counter = 0;
+
+		// The first volume rebuilds: a read on each device and a write
+		if (v == 0)
+			volumes [v] .m_requests.assign (numRebuild, numDevices + 1);
+
+		for (OGSS_Ulong i = 0; i < numRequests; ++i)
+			volumes [v] .m_requests.push_back (1 + generator () % 2);
+	}
+
+	cout << "{" << endl << "  \"slots\": " << numSlots << ","
+		<< endl << "  \"volumes\": " << numVolumes << ","
+		<< endl << "  \"devices\": " << numDevices << ","
+		<< endl << "  \"latency\": " << latency << ","
+		<< endl << "  \"rate\": " << rate << "," << endl;
+
+	report ("heuristic", run (FLC_HEURISTIC, volumes, numSlots, latency,
+		rate),
+		false);
+	report ("shared_credits", run (FLC_SHARED, volumes, numSlots, latency,
+		rate),
+		false);
+	report ("volume_credits", run (FLC_VOLUME, volumes, numSlots, latency,
+		rate),
+		true);
+
+	cout << "}" << endl;
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,233 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+
+/**
+ * @file	nvmebench.cpp
+ * @brief	Micro benchmark of the NVMe computation model. It gives the IOPS
+ * and the mean latency of 4K random reads for a sweep of queue depths, with a
+ * closed loop: a new request arrives each time one completes. The device is
+ * the one of example/nvme_intel_P4510.xml, and the results are compared to
+ * its datasheet (637K IOPS, 77 us). It then checks that the die works kept
+ * by the model from compute to serve go back to their pool, when the requests
+ * are served and when their slots are released without service.
+ *
+ * Usage: ogssim-nvmebench [-n requests] [-q max queue depth] [-w write ratio]
+ */
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "ComputationModels/cmdisknvme.hpp"
+#include "Structures/architecture.hpp"
+#include "Structures/nvmecontroller.hpp"
+#include "Structures/requestarray0.hpp"
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+static const unsigned		SEED			= 42;
+static const OGSS_Real		DATASHEET_IOPS	= 637000;
+static const OGSS_Real		DATASHEET_LATENCY	= .077;
+
+/**************************************/
+/* FUNCTIONS **************************/
+/**************************************/
+/**
+ * Fill a NVMe SSD with the parameters of example/nvme_intel_P4510.xml.
+ * @param	ssd					SSD device.
+ */
+void
+initNVMe (
+	SSDDevice				& ssd) {
+	ssd.m_pageSize = 4096;
+	ssd.m_pagesByBlock = 512;
+	ssd.m_blocksByDie = 40000;
+	ssd.m_numDies = 48;
+	ssd.m_numChannels = 48;
+	ssd.m_numPages = (OGSS_Ulong) ssd.m_pagesByBlock * ssd.m_blocksByDie
+		* ssd.m_numDies;
+	ssd.m_randomReadTime = .01;
+	ssd.m_randomWriteTime = .37;
+	ssd.m_sequentialReadTime = .06;
+	ssd.m_sequentialWriteTime = .06;
+	ssd.m_eraseTime = 3.5;
+	ssd.m_channelTime = 4096. / (800 * MILLISEC * MEGABYTE);
+	ssd.m_lastPageSeen = new OGSS_Ulong [ssd.m_numDies] ();
+	ssd.m_dieClock = new OGSS_Real [ssd.m_numDies] ();
+	ssd.m_channelClock = new OGSS_Real [ssd.m_numChannels] ();
+	ssd.m_ftl = NULL;
+
+	ssd.m_nvmeNumQueues = 8;
+	ssd.m_nvmeQueueDepth = 1024;
+	ssd.m_nvmeArbitration = ABT_RR;
+	ssd.m_nvmeHighQueues = 0;
+	ssd.m_nvmeMediumQueues = 0;
+	ssd.m_nvmeWeights [0] = 4;
+	ssd.m_nvmeWeights [1] = 2;
+	ssd.m_nvmeWeights [2] = 1;
+	ssd.m_nvmeCommandTime = 1.0 * MILLISEC;
+	ssd.m_nvmeLanes = 4;
+	ssd.m_nvmeLaneBandwidth = 985;
+	ssd.m_nvme = NULL;
+}
+
+/**
+ * Reset the clocks of the device and give it a new controller.
+ * @param	ssd					SSD device.
+ */
+void
+resetNVMe (
+	SSDDevice				& ssd) {
+	for (unsigned i = 0; i < ssd.m_numDies; ++i) {
+		ssd.m_lastPageSeen [i] = 0;
+		ssd.m_dieClock [i] = .0;
+	}
+	for (unsigned i = 0; i < ssd.m_numChannels; ++i)
+		ssd.m_channelClock [i] = .0;
+
+	delete ssd.m_nvme;
+	ssd.m_nvme = new NVMeController (ssd);
+}
+
+int
+main (
+	int						argc,
+	char					** argv) {
+	OGSS_Ulong				numRequests = 200000;
+	unsigned				maxDepth = 1024;
+	OGSS_Real				writeRatio = .0;
+	int						opt;
+
+	while ( (opt = getopt (argc, argv, "n:q:w:") ) != -1) {
+		switch (opt) {
+		case 'n': numRequests = strtoull (optarg, NULL, 10); break;
+		case 'q': maxDepth = atoi (optarg); break;
+		case 'w': writeRatio = atof (optarg); break;
+		default:
+			cerr << "Usage: " << argv [0] << " [-n requests] "
+				<< "[-q max queue depth] [-w write ratio]" << endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (numRequests == 0 || maxDepth == 0) {
+		cerr << "The number of requests and the queue depth must be positive"
+			<< endl;
+		return EXIT_FAILURE;
+	}
+
+	Architecture arch;
+	arch.m_geometry = new Geometry ();
+	arch.m_geometry->m_numDevices = 1;
+	arch.m_devices = new Device [1] ();
+	arch.m_devices [0] .m_type = DVT_NVME;
+	arch.m_devices [0] .m_parallel = true;
+	arch.m_devices [0] .m_cacheSegmentSize = 0;
+
+	SSDDevice & ssd = arch.m_devices [0] .m_hardware.m_ssd;
+	initNVMe (ssd);
+
+	RequestArray_Type0 requests (numRequests, 0, 0);
+	CMDiskNVMe model (&requests, &arch);
+	OGSS_Real qd1Latency = .0, maxIOPS = .0;
+
+	cout << "{" << endl << "  \"requests\": " << numRequests << ","
+		<< endl << "  \"write_ratio\": " << writeRatio << ","
+		<< endl << "  \"sweep\": [" << endl;
+
+	for (unsigned depth = 1; depth <= maxDepth; depth *= 2) {
+		priority_queue < OGSS_Real, vector < OGSS_Real >,
+			greater < OGSS_Real > > completions;
+		mt19937_64 generator (SEED);
+		uniform_real_distribution < OGSS_Real > ratio (.0, 1.);
+		OGSS_Real date, end, lastEnd = .0, totalLatency = .0;
+
+		resetNVMe (ssd);
+
+		// The requests of the closed loop come in arrival order
+		for (unsigned i = 0; i < depth; ++i)
+			completions.push (.0);
+
+		for (OGSS_Ulong i = 0; i < numRequests; ++i) {
+			date = completions.top ();
+			completions.pop ();
+
+			requests.initRequest (i, date, 0, 4096,
+				(ratio (generator) < writeRatio) ? RQT_WRITE : RQT_READ);
+			requests.setIdxDevice (i, 0);
+			requests.setDeviceAddress (i,
+				(generator () % ssd.m_numPages) * ssd.m_pageSize);
+
+			// The device is reached at the request date, without bus
+			model.compute (i);
+			end = model.serve (i, date) + requests.getServiceTime (i);
+			totalLatency += end - date;
+			lastEnd = max (lastEnd, end);
+			completions.push (end);
+		}
+
+		OGSS_Real iops = numRequests / (lastEnd * MILLISEC);
+		OGSS_Real latency = totalLatency / numRequests;
+
+		if (depth == 1) qd1Latency = latency;
+		maxIOPS = max (maxIOPS, iops);
+
+		cout << "    { \"qd\": " << depth << ", \"iops\": "
+			<< (OGSS_Ulong) iops << ", \"latency_us\": " << latency * 1000
+			<< " }" << ( (depth * 2 <= maxDepth) ? "," : "") << endl;
+	}
+
+	OGSS_Ulong servedPool = model.getDieWorkPoolSize ();
+	OGSS_Ulong servedPending = model.getNumPendingDieWorks ();
+
+	// Requests computed but released without service, as a failed request
+	resetNVMe (ssd);
+	for (OGSS_Ulong i = 0; i < numRequests; ++i)
+		model.compute (i);
+	for (OGSS_Ulong i = 0; i < numRequests; ++i)
+		model.release (i);
+
+	cout << "  ]," << endl
+		<< "  \"die_work_pool\": " << servedPool << ","
+		<< endl << "  \"pending_after_serve\": " << servedPending << ","
+		<< endl << "  \"pending_after_release\": "
+		<< model.getNumPendingDieWorks () << "," << endl
+		<< "  \"qd1_latency_error\": "
+		<< qd1Latency / DATASHEET_LATENCY - 1 << "," << endl
+		<< "  \"max_iops_error\": "
+		<< maxIOPS / DATASHEET_IOPS - 1 << endl << "}" << endl;
+
+	delete ssd.m_nvme;
+	ssd.m_nvme = NULL;
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+
+/**
+ * @file	qosbench.cpp
+ * @brief	Micro benchmark of the QoS scheduler. A saturated device is shared
+ * by a rate limited class of high priority and two classes of weights 3 and
+ * 1. It gives the number of scheduled requests per second, and the
+ * throughput of each class while all of them have requests, to check the
+ * rate limit and the weights.
+ *
+ * Usage: ogssim-qosbench [-n requests] [-c classes] [-r rate (MB/s)]
+ */
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "ComputationModels/qosscheduler.hpp"
+#include "Structures/architecture.hpp"
+#include "Structures/requestarray1.hpp"
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+static const unsigned		SEED			= 42;
+static const OGSS_Real		BANDWIDTH		= 200;
+
+/**************************************/
+/* FUNCTIONS **************************/
+/**************************************/
+/**
+ * Device model which transfers the requests at a fixed bandwidth.
+ */
+class FixedModel: public ComputationModel {
+public:
+	FixedModel (
+		RequestArray			* requests) :
+		ComputationModel (requests) {  }
+
+	OGSS_Real compute (
+		const OGSS_Ulong		idxRequest) {
+		OGSS_Real serviceTime = m_requests->getSize (idxRequest)
+			/ (BANDWIDTH * MEGABYTE * MILLISEC);
+
+		m_requests->setServiceTime (idxRequest, serviceTime);
+		return serviceTime;
+	}
+};
+
+/**
+ * Add a QoS class to the architecture.
+ * @param	arch				Architecture.
+ * @param	color				Color.
+ * @param	priority			Priority level.
+ * @param	weight				Weight.
+ * @param	rate				Rate limit (MB/s).
+ */
+void
+addClass (
+	Architecture			& arch,
+	const unsigned			color,
+	const int				priority,
+	const OGSS_Real			weight,
+	const OGSS_Real			rate) {
+	QoSClass				qos;
+
+	qos.m_color = color;
+	qos.m_priority = priority;
+	qos.m_weight = weight;
+	qos.m_rate = rate;
+	qos.m_burst = (rate > .0) ? MEGABYTE : 0;
+
+	arch.addIdxQoSClass (color, arch.m_qosClasses.size () );
+	arch.m_qosClasses.push_back (qos);
+}
+
+int
+main (
+	int						argc,
+	char					** argv) {
+	OGSS_Ulong				numRequests = 2000000;
+	unsigned				numClasses = 3;
+	OGSS_Real				rate = 50;
+	OGSS_Real				date = .0;
+	int						opt;
+
+	while ( (opt = getopt (argc, argv, "n:c:r:") ) != -1) {
+		switch (opt) {
+		case 'n': numRequests = strtoull (optarg, NULL, 10); break;
+		case 'c': numClasses = atoi (optarg); break;
+		case 'r': rate = atof (optarg); break;
+		default:
+			cerr << "Usage: " << argv [0] << " [-n requests] [-c classes] "
+				<< "[-r rate (MB/s)]" << endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (numClasses < 3) {
+		cerr << "The benchmark needs at least 3 classes" << endl;
+		return EXIT_FAILURE;
+	}
+
+	Architecture arch;
+	arch.m_geometry = new Geometry ();
+	arch.m_geometry->m_numDevices = 1;
+	arch.m_devices = new Device [1] ();
+	arch.m_devices [0] .m_type = DVT_SSD;
+
+	// The default class, then the measured ones, then the others which only
+	// make the heaps larger
+	addClass (arch, 0, 0, 1., .0);
+	addClass (arch, 1, 1, 1., rate);
+	addClass (arch, 2, 0, 3., .0);
+	addClass (arch, 3, 0, 1., .0);
+	for (unsigned c = 4; c <= numClasses; ++c)
+		addClass (arch, c, 0, 1., .0);
+
+	RequestArray_Type1 requests (numRequests, 0, 1);
+	mt19937_64 generator (SEED);
+
+	// Twice the device bandwidth is offered, the first classes get most of it
+	for (OGSS_Ulong i = 0; i < numRequests; ++i) {
+		OGSS_Ulong size = 4096 << (generator () % 5);
+		unsigned color = (generator () % 4 != 0) ?
+			1 + generator () % 3 : 1 + generator () % numClasses;
+
+		date += size / (2 * BANDWIDTH * MEGABYTE * MILLISEC);
+		requests.initRequest (i, date, 0, size, RQT_READ, color);
+		requests.setIdxDevice (i, 0);
+	}
+
+	FixedModel model (&requests);
+	QoSScheduler scheduler (&requests, &arch, &model, 0);
+	vector < OGSS_Ulong > released;
+	vector < OGSS_Real > volume (arch.m_qosClasses.size (), .0);
+	unsigned color;
+	unsigned pid;
+
+	auto start = chrono::steady_clock::now ();
+	for (OGSS_Ulong i = 0; i < numRequests; ++i)
+		scheduler.push (i, released);
+
+	// Only the requests served before the last arrival are measured
+	for (OGSS_Ulong i = 0; i < released.size (); ++i) {
+		requests.getOptions (released [i], color, pid);
+		volume [arch.getIdxQoSClass (color)] += requests.getSize (released [i]);
+	}
+
+	scheduler.flush (released);
+	double seconds = chrono::duration < double > (
+		chrono::steady_clock::now () - start) .count ();
+
+	cout << "{" << endl << "  \"requests\": " << numRequests << ","
+		<< endl << "  \"classes\": " << numClasses << ","
+		<< endl << "  \"scheduled_per_s\": "
+		<< (OGSS_Ulong) (numRequests / seconds) << ","
+		<< endl << "  \"released\": " << released.size () << ","
+		<< endl << "  \"throttled\": " << scheduler.getNumThrottled (1) << ","
+		<< endl << "  \"rate_limited_mb_s\": "
+		<< volume [1] / (date * MEGABYTE * MILLISEC) << ","
+		<< endl << "  \"weight3_mb_s\": "
+		<< volume [2] / (date * MEGABYTE * MILLISEC) << ","
+		<< endl << "  \"weight1_mb_s\": "
+		<< volume [3] / (date * MEGABYTE * MILLISEC) << endl
+		<< "}" << endl;
+
+	return EXIT_SUCCESS;
+}
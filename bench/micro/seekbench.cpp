@@ -0,0 +1,412 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+
+/**
+ * @file	seekbench.cpp
+ * @brief	Micro benchmark of the HDD computation model. It measures the
+ * number of service time computations per second with the analytic seek
+ * formula (and a constant rotational latency), the same computation with the
+ * precomputed coefficients of the seek curve, and the HDD model. It checks
+ * that the seek curve gives the same times as the formula, and that the
+ * platter keeps turning during idle gaps.
+ *
+ * Usage: ogssim-microbench [-n requests] [-d devices] [-r rounds] [-z zones]
+ * [-g idle gap]
+ */
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "ComputationModels/cmdiskhdd.hpp"
+#include "Structures/architecture.hpp"
+#include "Structures/requestarray0.hpp"
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+static const unsigned		SEED			= 42;
+
+/**************************************/
+/* FUNCTIONS **************************/
+/**************************************/
+/**
+ * Fill a HDD with the parameters of example/hdd_hitachi_A7K1000.xml.
+ * @param	hdd					HDD device.
+ */
+void
+initDevice (
+	HDDDevice				& hdd) {
+	hdd.m_sectorSize = 512;
+	hdd.m_sectorsByTrack = 1380;
+	hdd.m_tracksByPlatter = 117967;
+	hdd.m_numPlatters = 3;
+	hdd.m_numDataHeads = 6;
+	hdd.m_numCylinders = hdd.m_tracksByPlatter;
+	hdd.m_numSectors = (OGSS_Ulong) hdd.m_sectorsByTrack
+		* hdd.m_tracksByPlatter * hdd.m_numPlatters;
+	hdd.m_minRSeekTime = hdd.m_minWSeekTime = 1.1;
+	hdd.m_avgRSeekTime = hdd.m_avgWSeekTime = 8.7;
+	hdd.m_maxRSeekTime = hdd.m_maxWSeekTime = 15.2;
+	hdd.m_mediaTransferRate = 120;
+	hdd.m_maxRotationTime = 60000. / 7200;
+	hdd.m_ataNCQ = false;
+	hdd.m_trackPosition = 0;
+	hdd.m_headPosition = 0;
+	hdd.m_transferEnd = .0;
+	hdd.m_seekCurve = NULL;
+	hdd.m_zoneTable = NULL;
+}
+
+/**
+ * Split the platter of a HDD in zones, from 1.5x the mean track size on the
+ * outer tracks to 0.5x on the inner ones.
+ * @param	hdd					HDD device.
+ * @param	numZones			Number of zones.
+ * @return						Zone table.
+ */
+ZoneTable *
+createZones (
+	HDDDevice				& hdd,
+	const unsigned			numZones) {
+	ZoneTable				* table = new ZoneTable ();
+	Zone					zone;
+	OGSS_Ulong				numTracks;
+
+	table->m_numTracks = 0;
+	table->m_numSectors = 0;
+
+	for (unsigned i = 0; i < numZones; ++i) {
+		numTracks = hdd.m_tracksByPlatter / numZones;
+		if (i == numZones - 1)
+			numTracks = hdd.m_tracksByPlatter - table->m_numTracks;
+
+		zone.m_firstTrack = table->m_numTracks;
+		zone.m_firstSector = table->m_numSectors;
+		zone.m_sectorsByTrack = hdd.m_sectorsByTrack
+			* (1.5 - (OGSS_Real) i / max (numZones - 1, 1U) );
+		zone.m_mediaTransferRate = hdd.m_mediaTransferRate
+			* zone.m_sectorsByTrack / hdd.m_sectorsByTrack;
+
+		table->m_zones.push_back (zone);
+		table->m_numTracks += numTracks;
+		table->m_numSectors += numTracks * zone.m_sectorsByTrack;
+	}
+
+	hdd.m_zoneTable = table;
+	hdd.m_numSectors = table->m_numSectors * hdd.m_numPlatters;
+
+	return table;
+}
+
+/**
+ * Compute the service times with the analytic seek formula, as done before
+ * the seek curves.
+ * @param	requests			Request array.
+ * @param	arch				Architecture.
+ * @param	numRequests			Number of requests.
+ * @param	times				Service times (output).
+ */
+void
+computeFormula (
+	RequestArray			* requests,
+	Architecture			& arch,
+	const OGSS_Ulong		numRequests,
+	vector < OGSS_Real >	& times) {
+	for (OGSS_Ulong i = 0; i < numRequests; ++i) {
+		HDDDevice & hdd = arch.m_devices [requests->getIdxDevice (i)]
+			.m_hardware.m_hdd;
+		OGSS_Ulong start = requests->getDeviceAddress (i) / hdd.m_sectorSize;
+		OGSS_Ulong track = (start / hdd.m_sectorsByTrack)
+			% hdd.m_tracksByPlatter;
+		OGSS_Real dist = abs ( (long) hdd.m_trackPosition - (long) track);
+		OGSS_Real seek = 0;
+
+		if (dist != 0) {
+			OGSS_Real a = (-10 * hdd.m_minRSeekTime + 15 * hdd.m_avgRSeekTime
+				- 5 * hdd.m_maxRSeekTime) / (3 * sqrt (hdd.m_numCylinders) );
+			OGSS_Real b = (7 * hdd.m_minRSeekTime - 15 * hdd.m_avgRSeekTime
+				+ 8 * hdd.m_maxRSeekTime) / (3 * hdd.m_numCylinders);
+			seek = a * sqrt (dist) + b * (dist - 1) + hdd.m_minRSeekTime;
+		}
+
+		hdd.m_trackPosition = ( (start + requests->getSize (i)
+			/ hdd.m_sectorSize) / hdd.m_sectorsByTrack)
+			% hdd.m_tracksByPlatter;
+		hdd.m_headPosition = ( (requests->getDeviceAddress (i)
+			+ requests->getSize (i) ) / hdd.m_sectorSize)
+			% hdd.m_sectorsByTrack;
+
+		times [i] = seek + hdd.m_maxRotationTime / 2 + requests->getSize (i)
+			/ (hdd.m_mediaTransferRate * MILLISEC * MEGABYTE);
+	}
+}
+
+/**
+ * Compute the service times as computeFormula, with the coefficients of the
+ * seek curve of the devices instead of recomputing them.
+ * @param	requests			Request array.
+ * @param	arch				Architecture.
+ * @param	numRequests			Number of requests.
+ * @param	times				Service times (output).
+ */
+void
+computeCurve (
+	RequestArray			* requests,
+	Architecture			& arch,
+	const OGSS_Ulong		numRequests,
+	vector < OGSS_Real >	& times) {
+	for (OGSS_Ulong i = 0; i < numRequests; ++i) {
+		HDDDevice & hdd = arch.m_devices [requests->getIdxDevice (i)]
+			.m_hardware.m_hdd;
+		OGSS_Ulong start = requests->getDeviceAddress (i) / hdd.m_sectorSize;
+		OGSS_Ulong track = (start / hdd.m_sectorsByTrack)
+			% hdd.m_tracksByPlatter;
+		OGSS_Real seek = hdd.m_seekCurve->seekTime (
+			abs ( (long) hdd.m_trackPosition - (long) track), false);
+
+		hdd.m_trackPosition = ( (start + requests->getSize (i)
+			/ hdd.m_sectorSize) / hdd.m_sectorsByTrack)
+			% hdd.m_tracksByPlatter;
+		hdd.m_headPosition = ( (requests->getDeviceAddress (i)
+			+ requests->getSize (i) ) / hdd.m_sectorSize)
+			% hdd.m_sectorsByTrack;
+
+		times [i] = seek + hdd.m_maxRotationTime / 2 + requests->getSize (i)
+			/ (hdd.m_mediaTransferRate * MILLISEC * MEGABYTE);
+	}
+}
+
+/**
+ * Serve sequential 4K reads on the first track of the first device, each one
+ * arriving an idle gap after the previous one ended. Without the gaps, the
+ * head is on the next sector at once; with them, the platter turned by the
+ * gap and the head waits for the rest of the revolution.
+ * @param	arch				Architecture.
+ * @param	gap					Idle gap.
+ * @return						Max difference between the rotational latency
+ *								of the model and the expected one.
+ */
+OGSS_Real
+measureIdleGaps (
+	Architecture			& arch,
+	const OGSS_Real			gap) {
+	const HDDDevice			& hdd = arch.m_devices [0] .m_hardware.m_hdd;
+	OGSS_Ulong				numRequests = hdd.m_sectorsByTrack / 8 - 1;
+	RequestArray_Type0		requests (numRequests, 0, 0);
+	CMDiskHDD				model (&requests, &arch);
+	OGSS_Real				rotTime = hdd.m_maxRotationTime;
+	OGSS_Real				transfer = 4096.
+		/ (hdd.m_mediaTransferRate * MILLISEC * MEGABYTE);
+	OGSS_Real				expected, date = .0, maxMismatch = .0;
+
+	// Only the fraction of revolution of the gap matters
+	expected = rotTime - (gap - floor (gap / rotTime) * rotTime);
+	if (expected == rotTime) expected = .0;
+
+	for (OGSS_Ulong i = 0; i < numRequests; ++i) {
+		requests.initRequest (i, date, 0, 4096, RQT_READ);
+		requests.setIdxDevice (i, 0);
+		requests.setDeviceAddress (i, i * 4096);
+
+		model.compute (i);
+		date = model.serve (i, date) + requests.getServiceTime (i);
+		arch.m_devices [0] .m_clock = date;
+
+		// The first request starts under the head
+		if (i != 0)
+			maxMismatch = max (maxMismatch, fabs (requests.getServiceTime (i)
+				- transfer - expected) );
+
+		date += gap;
+	}
+
+	return maxMismatch;
+}
+
+/**
+ * Reset the head positions of all the devices.
+ * @param	arch				Architecture.
+ */
+void
+resetPositions (
+	Architecture			& arch) {
+	for (OGSS_Ushort i = 0; i < arch.m_geometry->m_numDevices; ++i) {
+		arch.m_devices [i] .m_hardware.m_hdd.m_trackPosition = 0;
+		arch.m_devices [i] .m_hardware.m_hdd.m_headPosition = 0;
+		arch.m_devices [i] .m_hardware.m_hdd.m_transferEnd = .0;
+		arch.m_devices [i] .m_clock = .0;
+	}
+}
+
+/**
+ * Print a measure.
+ * @param	name				Measure name.
+ * @param	numComputations		Number of computations.
+ * @param	start				Start time.
+ */
+void
+report (
+	const char				* name,
+	const OGSS_Ulong		numComputations,
+	const chrono::steady_clock::time_point	& start) {
+	double seconds = chrono::duration < double > (
+		chrono::steady_clock::now () - start) .count ();
+
+	cout << "  \"" << name << "\": " << (OGSS_Ulong) (numComputations / seconds);
+}
+
+int
+main (
+	int						argc,
+	char					** argv) {
+	OGSS_Ulong				numRequests = 1000000;
+	OGSS_Ushort				numDevices = 8;
+	unsigned				numRounds = 5;
+	unsigned				numZones = 0;
+	OGSS_Real				gap = 1.;
+	int						opt;
+
+	while ( (opt = getopt (argc, argv, "n:d:r:z:g:") ) != -1) {
+		switch (opt) {
+		case 'n': numRequests = strtoull (optarg, NULL, 10); break;
+		case 'd': numDevices = atoi (optarg); break;
+		case 'r': numRounds = atoi (optarg); break;
+		case 'z': numZones = atoi (optarg); break;
+		case 'g': gap = atof (optarg); break;
+		default:
+			cerr << "Usage: " << argv [0] << " [-n requests] [-d devices] "
+				<< "[-r rounds] [-z zones] [-g idle gap]" << endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (numDevices == 0) {
+		cerr << "The number of devices must be positive" << endl;
+		return EXIT_FAILURE;
+	}
+
+	if (gap < 0) {
+		cerr << "The idle gap must be positive" << endl;
+		return EXIT_FAILURE;
+	}
+
+	Architecture arch;
+	arch.m_geometry = new Geometry ();
+	arch.m_geometry->m_numDevices = numDevices;
+	arch.m_devices = new Device [numDevices];
+
+	for (OGSS_Ushort i = 0; i < numDevices; ++i) {
+		arch.m_devices [i] .m_type = DVT_HDD;
+		initDevice (arch.m_devices [i] .m_hardware.m_hdd);
+		arch.m_devices [i] .m_hardware.m_hdd.m_seekCurve =
+			arch.getSeekCurve (arch.m_devices [i] .m_hardware.m_hdd);
+		if (numZones != 0)
+			arch.m_zoneTables.push_back (createZones (
+				arch.m_devices [i] .m_hardware.m_hdd, numZones) );
+	}
+
+	RequestArray_Type0 requests (numRequests, 0, 0);
+	mt19937_64 generator (SEED);
+	OGSS_Ulong maxSector = arch.m_devices [0] .m_hardware.m_hdd.m_numSectors;
+
+	for (OGSS_Ulong i = 0; i < numRequests; ++i) {
+		requests.initRequest (i, i, 0, 4096 << (generator () % 5), RQT_READ);
+		requests.setIdxDevice (i, generator () % numDevices);
+		requests.setDeviceAddress (i, (generator () % maxSector) * 512);
+	}
+
+	CMDiskHDD model (&requests, &arch);
+	vector < OGSS_Real > reference (numRequests);
+	vector < OGSS_Real > curveTimes (numRequests);
+	vector < OGSS_Real > times (numRequests);
+	const HDDDevice & hdd = arch.m_devices [0] .m_hardware.m_hdd;
+	OGSS_Real maxError = 0;
+	OGSS_Real maxMismatch = 0;
+
+	cout << "{" << endl << "  \"requests\": " << numRequests << ","
+		<< endl << "  \"devices\": " << numDevices << ","
+		<< endl << "  \"zones\": " << numZones << ","
+		<< endl << "  \"seek_curves\": " << arch.m_seekCurves.size () << ","
+		<< endl;
+
+	auto start = chrono::steady_clock::now ();
+	for (unsigned r = 0; r < numRounds; ++r) {
+		resetPositions (arch);
+		computeFormula (&requests, arch, numRequests, reference);
+	}
+	report ("formula_per_s", numRequests * numRounds, start);
+	cout << "," << endl;
+
+	start = chrono::steady_clock::now ();
+	for (unsigned r = 0; r < numRounds; ++r) {
+		resetPositions (arch);
+		computeCurve (&requests, arch, numRequests, curveTimes);
+	}
+	report ("curve_per_s", numRequests * numRounds, start);
+	cout << "," << endl;
+
+	start = chrono::steady_clock::now ();
+	for (unsigned r = 0; r < numRounds; ++r) {
+		resetPositions (arch);
+		for (OGSS_Ulong i = 0; i < numRequests; ++i)
+			times [i] = model.compute (i);
+	}
+	report ("model_per_s", numRequests * numRounds, start);
+	cout << "," << endl;
+
+	// The seek curve against the formula, for all the distances
+	for (unsigned i = 1; i < hdd.m_numCylinders; ++i) {
+		OGSS_Real a = (-10 * hdd.m_minRSeekTime + 15 * hdd.m_avgRSeekTime
+			- 5 * hdd.m_maxRSeekTime) / (3 * sqrt (hdd.m_numCylinders) );
+		OGSS_Real b = (7 * hdd.m_minRSeekTime - 15 * hdd.m_avgRSeekTime
+			+ 8 * hdd.m_maxRSeekTime) / (3 * hdd.m_numCylinders);
+		OGSS_Real dist = i;
+
+		maxError = max (maxError, fabs (hdd.m_seekCurve->seekTime (i, false)
+			- (a * sqrt (dist) + b * (dist - 1) + hdd.m_minRSeekTime) ) );
+	}
+
+	for (OGSS_Ulong i = 0; i < numRequests; ++i)
+		maxMismatch = max (maxMismatch, fabs (curveTimes [i] - reference [i]) );
+
+	// The idle gaps, on the first device without zones
+	resetPositions (arch);
+	arch.m_devices [0] .m_hardware.m_hdd.m_zoneTable = NULL;
+
+	cout << "  \"seek_max_error_ms\": " << maxError << "," << endl
+		<< "  \"curve_max_mismatch_ms\": " << maxMismatch << "," << endl
+		<< "  \"idle_gap_ms\": " << gap << "," << endl
+		<< "  \"idle_max_mismatch_ms\": " << measureIdleGaps (arch, gap)
+		<< endl << "}" << endl;
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,416 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+
+/**
+ * @file	ogssim-bench.cpp
+ * @brief	Simulation throughput benchmark. It generates a fixed set of
+ * synthetic architectures and workloads, runs OGSSim on each pair and reports
+ * the wall time, the simulated requests per second, the peak RSS and the time
+ * spent in each simulation stage, as JSON.
+ *
+ * Usage: ogssim-bench [-s OGSSim] [-d devicefile] [-w workdir] [-n sizes]
+ *                     [-a architectures] [-t timeout] [-o output]
+ */
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+static const unsigned		SEED			= 42;
+static const uint64_t		ADDRESS_RANGE	= 1 << 24;	// data units
+static const double			ARRIVAL_STEP	= 1.;		// ms
+
+/**
+ * Architectures of the benchmark: each one is a volume (or a declustered
+ * RAID) of a single tier.
+ */
+static const vector < pair < string, string > >	ARCHITECTURES = {
+	{"jbod", "<volume nbdevices=\"5\" bus=\"B2\">"
+		"<config type=\"JBOD\" />%DEV%</volume>"},
+	{"raid1", "<volume nbdevices=\"2\" bus=\"B2\">"
+		"<config type=\"RAID1\" buffersize=\"64\" />%DEV%</volume>"},
+	{"raid01", "<volume nbdevices=\"10\" bus=\"B2\">"
+		"<config type=\"RAID01\" stripeunitsize=\"16384\" buffersize=\"32\" />"
+		"%DEV%</volume>"},
+	{"raidnp-nodecl", "<volume nbdevices=\"6\" bus=\"B2\">"
+		"<config type=\"RAIDNP\" stripeunitsize=\"16384\" nbpardisks=\"2\" "
+		"decl=\"no\" sreqoptim=\"off\" parityread=\"off\" buffersize=\"32\" />"
+		"%DEV%</volume>"},
+	{"raidnp-parity", "<volume nbdevices=\"6\" bus=\"B2\">"
+		"<config type=\"RAIDNP\" stripeunitsize=\"16384\" nbpardisks=\"2\" "
+		"decl=\"parity\" sreqoptim=\"off\" parityread=\"off\" buffersize=\"32\" />"
+		"%DEV%</volume>"},
+	{"raidnp-data", "<volume nbdevices=\"6\" bus=\"B2\">"
+		"<config type=\"RAIDNP\" stripeunitsize=\"16384\" nbpardisks=\"2\" "
+		"decl=\"data\" sreqoptim=\"off\" parityread=\"off\" buffersize=\"32\" />"
+		"%DEV%</volume>"},
+	{"sd2s", "<decraid type=\"sd2s\" nbsubvol=\"2\" nbdevices=\"15\" "
+		"nbspare=\"2\" decsize=\"16384\" bus=\"B2\" buffersize=\"64\">%DEV%"
+		"<volume nblogdevices=\"4\" bus=\"B2\">"
+		"<config type=\"RAID01\" stripeunitsize=\"16384\" /></volume>"
+		"<volume nblogdevices=\"9\" bus=\"B2\">"
+		"<config type=\"RAIDNP\" stripeunitsize=\"16384\" decl=\"parity\" "
+		"nbpardisks=\"1\" sreqoptim=\"no\" parityread=\"no\" /></volume>"
+		"</decraid>"},
+	{"crush", "<decraid type=\"crush\" nbsubvol=\"2\" nbdevices=\"15\" "
+		"nbspare=\"2\" decsize=\"16384\" bus=\"B2\" buffersize=\"64\">%DEV%"
+		"<volume nblogdevices=\"4\" bus=\"B2\">"
+		"<config type=\"RAID01\" stripeunitsize=\"16384\" /></volume>"
+		"<volume nblogdevices=\"9\" bus=\"B2\">"
+		"<config type=\"RAIDNP\" stripeunitsize=\"16384\" decl=\"parity\" "
+		"nbpardisks=\"1\" sreqoptim=\"no\" parityread=\"no\" /></volume>"
+		"</decraid>"}
+};
+
+/**
+ * Result of one benchmark run.
+ */
+struct BenchResult {
+	string						m_architecture;		/*!< Architecture. */
+	unsigned long				m_numRequests;		/*!< Workload size. */
+	int							m_status;			/*!< Exit status. */
+	double						m_wallTime;			/*!< Wall time (s). */
+	long						m_peakRSS;			/*!< Peak RSS (kB). */
+	string						m_stages;			/*!< Stage times (JSON). */
+};
+
+/**************************************/
+/* GENERATION *************************/
+/**************************************/
+static string
+replaceAll (
+	string					str,
+	const string			& pattern,
+	const string			& value) {
+	size_t					pos = 0;
+
+	while ( (pos = str.find (pattern, pos) ) != string::npos)
+	{
+		str.replace (pos, pattern.size (), value);
+		pos += value.size ();
+	}
+
+	return str;
+}
+
+static void
+writeArchitecture (
+	const string			& filename,
+	const string			& volume,
+	const string			& deviceFile) {
+	ofstream				file (filename.c_str () );
+
+	file << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+		<< "<architecture>\n"
+		<< "\t<buses nbbuses=\"3\">\n"
+		<< "\t\t<bus name=\"B0\" nbports=\"17\" bandwidth=\"640\" type=\"SCSI\" />\n"
+		<< "\t\t<bus name=\"B1\" nbports=\"17\" bandwidth=\"640\" type=\"SCSI\" />\n"
+		<< "\t\t<bus name=\"B2\" nbports=\"17\" bandwidth=\"640\" type=\"SCSI\" />\n"
+		<< "\t</buses>\n"
+		<< "\t<system nbtiers=\"1\" bus=\"B0\">\n"
+		<< "\t\t<tier nbvolumes=\"1\" bus=\"B1\">\n"
+		<< "\t\t\t" << replaceAll (volume, "%DEV%",
+			"<device file=\"" + deviceFile + "\" />") << "\n"
+		<< "\t\t</tier>\n"
+		<< "\t</system>\n"
+		<< "</architecture>\n";
+}
+
+static void
+writeWorkload (
+	const string			& filename,
+	const unsigned long		numRequests) {
+	ofstream				file (filename.c_str () );
+	mt19937_64				generator (SEED);
+	uniform_int_distribution <uint64_t>	address (0, ADDRESS_RANGE - 1);
+	uniform_int_distribution <unsigned>	size (1, 32);
+	bernoulli_distribution	write (.3);
+
+	file << "#Trace file generated by ogssim-bench\n";
+
+	for (unsigned long i = 0; i < numRequests; ++i)
+		file << (i + 1) * ARRIVAL_STEP << " " << write (generator) << " "
+			<< address (generator) << " " << 8 * size (generator) << "\n";
+}
+
+static void
+writeConfiguration (
+	const string			& filename,
+	const string			& prefix) {
+	ofstream				file (filename.c_str () );
+
+	file << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+		<< "<config>\n"
+		<< "\t<path>\n"
+		<< "\t\t<workloadfile>" << prefix << "trace.data</workloadfile>\n"
+		<< "\t\t<hardwarefile>" << prefix << "arch.xml</hardwarefile>\n"
+		<< "\t\t<resultfile>" << prefix << "result.data</resultfile>\n"
+		<< "\t\t<subresultfile>" << prefix << "sres.data</subresultfile>\n"
+		<< "\t</path>\n"
+		<< "\t<general>\n"
+		<< "\t\t<log mlvl=\"2\" file=\"" << prefix << "log_\" />\n"
+		<< "\t\t<timing file=\"" << prefix << "timing.json\" />\n"
+		<< "\t</general>\n"
+		<< "\t<event>\n"
+		<< "\t\t<zeromq intr=\"preproc\" prot=\"tcp\" addr=\"localhost\" port=\"5559\" />\n"
+		<< "\t</event>\n"
+		<< "\t<workload>\n"
+		<< "\t\t<zeromq intr=\"preproc\" prot=\"tcp\" addr=\"localhost\" port=\"5555\" />\n"
+		<< "\t\t<subreq bsiz=\"50000\" />\n"
+		<< "\t\t<reqdut size=\"512\" />\n"
+		<< "\t</workload>\n"
+		<< "\t<hardware>\n"
+		<< "\t\t<zeromq intr=\"preproc\" prot=\"tcp\" addr=\"localhost\" port=\"5556\" />\n"
+		<< "\t</hardware>\n"
+		<< "\t<preproc>\n"
+		<< "\t\t<zeromq intr=\"workload\" prot=\"tcp\" addr=\"*\" port=\"5555\" />\n"
+		<< "\t\t<zeromq intr=\"hardware\" prot=\"tcp\" addr=\"*\" port=\"5556\" />\n"
+		<< "\t\t<zeromq intr=\"event\" prot=\"tcp\" addr=\"*\" port=\"5559\" />\n"
+		<< "\t\t<zeromq intr=\"execution\" prot=\"tcp\" addr=\"localhost\" port=\"5557\" />\n"
+		<< "\t\t<zeromq intr=\"performance\" prot=\"tcp\" addr=\"localhost\" port=\"5560\" />\n"
+		<< "\t\t<zeromq intr=\"volumedriver\" prot=\"tcp\" addr=\"localhost\" port=\"5600\" />\n"
+		<< "\t</preproc>\n"
+		<< "\t<volumedriver>\n"
+		<< "\t\t<zeromq intr=\"devicedriver\" prot=\"tcp\" addr=\"localhost\" port=\"6000\" />\n"
+		<< "\t\t<zeromq intr=\"execution\" prot=\"tcp\" addr=\"localhost\" port=\"5558\" />\n"
+		<< "\t\t<zeromq intr=\"reply\" prot=\"tcp\" addr=\"*\" port=\"5800\" />\n"
+		<< "\t</volumedriver>\n"
+		<< "\t<devicedriver>\n"
+		<< "\t\t<zeromq intr=\"execution\" prot=\"tcp\" addr=\"localhost\" port=\"5558\" />\n"
+		<< "\t\t<zeromq intr=\"reply\" prot=\"tcp\" addr=\"*\" port=\"7000\" />\n"
+		<< "\t</devicedriver>\n"
+		<< "\t<execution>\n"
+		<< "\t\t<zeromq intr=\"preproc\" prot=\"tcp\" addr=\"*\" port=\"5557\" />\n"
+		<< "\t\t<zeromq intr=\"devicedriver\" prot=\"tcp\" addr=\"*\" port=\"5558\" />\n"
+		<< "\t\t<zeromq intr=\"volreply\" prot=\"tcp\" addr=\"localhost\" port=\"5800\" />\n"
+		<< "\t\t<zeromq intr=\"performance\" prot=\"tcp\" addr=\"localhost\" port=\"5561\" />\n"
+		<< "\t\t<zeromq intr=\"devreply\" prot=\"tcp\" addr=\"localhost\" port=\"7000\" />\n"
+		<< "\t\t<cmbus type=\"advanced\" />\n"
+		<< "\t</execution>\n"
+		<< "\t<performance>\n"
+		<< "\t\t<zeromq intr=\"preproc\" prot=\"tcp\" addr=\"*\" port=\"5560\" />\n"
+		<< "\t\t<zeromq intr=\"execution\" prot=\"tcp\" addr=\"*\" port=\"5561\" />\n"
+		<< "\t</performance>\n"
+		<< "</config>\n";
+}
+
+/**************************************/
+/* EXECUTION **************************/
+/**************************************/
+static string
+readFile (
+	const string			& filename) {
+	ifstream				file (filename.c_str () );
+	ostringstream			oss;
+
+	oss << file.rdbuf ();
+
+	return oss.str ();
+}
+
+static BenchResult
+runSimulation (
+	const string			& simulator,
+	const string			& configuration,
+	const unsigned			timeout) {
+	BenchResult				result;
+	struct rusage			usage;
+	pid_t					pid;
+	int						status = 0;
+
+	auto					start = chrono::steady_clock::now ();
+
+	pid = fork ();
+
+	if (pid == 0)
+	{
+		execl (simulator.c_str (), simulator.c_str (), configuration.c_str (),
+			(char *) NULL);
+		_exit (127);
+	}
+
+	memset (&usage, 0, sizeof (usage) );
+
+	// Poll, so that a stuck simulation can be killed
+	while (wait4 (pid, &status, WNOHANG, &usage) == 0)
+	{
+		if (chrono::steady_clock::now () - start > chrono::seconds (timeout) )
+		{
+			kill (pid, SIGKILL);
+			wait4 (pid, &status, 0, &usage);
+			break;
+		}
+
+		this_thread::sleep_for (chrono::milliseconds (5) );
+	}
+
+	result.m_wallTime = chrono::duration <double> (
+		chrono::steady_clock::now () - start) .count ();
+	result.m_peakRSS = usage.ru_maxrss;
+	result.m_status = WIFEXITED (status) ? WEXITSTATUS (status) : -1;
+
+	return result;
+}
+
+/**************************************/
+/* OUTPUT *****************************/
+/**************************************/
+static void
+writeResults (
+	ostream					& stream,
+	const string			& simulator,
+	const vector <BenchResult>	& results) {
+	stream << "{\n  \"simulator\": \"" << simulator << "\",\n"
+		<< "  \"runs\": [";
+
+	for (size_t i = 0; i < results.size (); ++i)
+	{
+		const BenchResult	& r = results [i];
+
+		stream << (i == 0 ? "\n" : ",\n")
+			<< "    {\"architecture\": \"" << r.m_architecture << "\", "
+			<< "\"requests\": " << r.m_numRequests << ", "
+			<< "\"status\": " << r.m_status << ", "
+			<< "\"wall_s\": " << r.m_wallTime << ", "
+			<< "\"requests_per_s\": " << (r.m_wallTime > 0 ?
+				r.m_numRequests / r.m_wallTime : 0) << ", "
+			<< "\"peak_rss_kb\": " << r.m_peakRSS << ", "
+			<< "\"stages\": " << (r.m_stages.empty () ? "null" : r.m_stages)
+			<< "}";
+	}
+
+	stream << "\n  ]\n}\n";
+}
+
+static vector <string>
+split (
+	const string			& str) {
+	vector <string>			items;
+	istringstream			iss (str);
+	string					item;
+
+	while (getline (iss, item, ',') )
+		if (! item.empty () ) items.push_back (item);
+
+	return items;
+}
+
+int
+main (
+	int						argc,
+	char					** argv) {
+	string					simulator = "./OGSSim";
+	string					deviceFile = "example/hdd_hitachi_A7K1000.xml";
+	string					workdir = "/tmp/ogssim-bench";
+	string					output;
+	vector <string>			sizes = {"1000", "10000", "100000"};
+	vector <string>			architectures;
+	unsigned				timeout = 600;
+	vector <BenchResult>	results;
+	int						opt;
+
+	while ( (opt = getopt (argc, argv, "s:d:w:n:a:t:o:") ) != -1)
+	{
+		switch (opt)
+		{
+		case 's': simulator = optarg; break;
+		case 'd': deviceFile = optarg; break;
+		case 'w': workdir = optarg; break;
+		case 'n': sizes = split (optarg); break;
+		case 'a': architectures = split (optarg); break;
+		case 't': timeout = atoi (optarg); break;
+		case 'o': output = optarg; break;
+		default:
+			cerr << "Usage: " << argv [0] << " [-s OGSSim] [-d devicefile] "
+				<< "[-w workdir] [-n sizes] [-a architectures] [-t timeout] "
+				<< "[-o output]" << endl;
+			return 1;
+		}
+	}
+
+	mkdir (workdir.c_str (), 0755);
+
+	for (auto & arch: ARCHITECTURES)
+	{
+		if (! architectures.empty ()
+			&& find (architectures.begin (), architectures.end (), arch.first)
+				== architectures.end () )
+			continue;
+
+		for (auto & size: sizes)
+		{
+			string			prefix = workdir + "/" + arch.first + "_" + size + "_";
+			BenchResult		result;
+
+			writeArchitecture (prefix + "arch.xml", arch.second, deviceFile);
+			writeWorkload (prefix + "trace.data", stoul (size) );
+			writeConfiguration (prefix + "config.xml", prefix);
+			remove ( (prefix + "timing.json") .c_str () );
+
+			cerr << "Running " << arch.first << " with " << size
+				<< " requests..." << endl;
+
+			result = runSimulation (simulator, prefix + "config.xml", timeout);
+			result.m_architecture = arch.first;
+			result.m_numRequests = stoul (size);
+			result.m_stages = readFile (prefix + "timing.json");
+
+			while (! result.m_stages.empty ()
+				&& isspace (result.m_stages.back () ) )
+				result.m_stages.pop_back ();
+
+			results.push_back (result);
+		}
+	}
+
+	if (output.empty () )
+		writeResults (cout, simulator, results);
+	else
+	{
+		ofstream			file (output.c_str () );
+		writeResults (file, simulator, results);
+	}
+
+	return 0;
+}
@@ -26,6 +26,10 @@
  * @brief   Computation model for transfer time by organizing requests
  * following their arrival date and their priority. Each bus is represented by
  * a waiting list where the requests are stored.
+ *
+ * A transfer to the device waits for room in the buffer it fills, in a
+ * waiting list of the buffer which is woken up by the releases. The answers
+ * are never stopped: they free the path, and could lock it if they waited.
  */
 
 #ifndef __OGSS_CMBUSADVANCED_HPP__
@@ -33,7 +37,10 @@
 
 #include "ComputationModels/computationmodel.hpp"
 
-#include <set>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <vector>
 
 class CMBusAdvanced: public ComputationModel {
 public:
@@ -83,6 +90,17 @@ public:
     OGSS_Real compute (
         const OGSS_Ulong        idxRequest);
 
+/**
+ * Use the arrival order instead of the request index to order transfer units
+ * with the same date. Subrequest indexes depend on thread scheduling, while
+ * the arrival order does not in deterministic mode.
+ *
+ * @param   arrivalOrdering     TRUE to use the arrival order.
+ */
+    inline void setArrivalOrdering (
+        const OGSS_Bool         arrivalOrdering)
+        { m_arrivalOrdering = arrivalOrdering; }
+
 protected:
 /**************************************/
 /* PRIVATE FUNCTIONS ******************/
@@ -98,9 +116,15 @@ protected:
     struct TransferUnit {
         OGSS_Real date;
         OGSS_Ulong idxRequest;
+        OGSS_Ulong order;
         OGSS_Ulong size;
+        OGSS_Ulong handle;
+        OGSS_Ulong next;
         OGSS_Ushort type;
         OGSS_Ushort step;
+        OGSS_Ushort host;
+        OGSS_Ushort reserved;
+        OGSS_Ushort bus;
         OGSS_Bool toDevice;
         OGSS_Bool user;
 
@@ -109,7 +133,7 @@ protected:
             return date < rhs.date
             || (date == rhs.date && user && (!rhs.user) )
             || (date == rhs.date && user == rhs.user
-                && idxRequest < rhs.idxRequest);
+                && order < rhs.order);
             }
 
 
@@ -140,26 +164,167 @@ protected:
         const OGSS_Ushort       idxBus,
         const OGSS_Real         newDate);
 
-    OGSS_Real computeTransferTime (
+    OGSS_Bool allArrived (
+        const OGSS_Real         date);
+
+    OGSS_Bool isBlocked (
+        const TransferUnit &    unit,
+        OGSS_Ulong &            idxRequest);
+
+    void insertUnit (
+        const OGSS_Ushort       idxBus,
+        const TransferUnit &    unit);
+
+    void eraseUnit (
+        const OGSS_Ushort       idxBus,
+        const TransferUnit &    unit);
+
+    void updateUnit (
+        const OGSS_Ushort       idxBus,
+        const TransferUnit &    unit);
+
+    OGSS_Ulong allocateUnit ();
+
+    void freeUnit (
+        const OGSS_Ulong        handle);
+
+    void pushUnit (
+        const OGSS_Ushort       idxBus,
+        const OGSS_Ulong        handle);
+
+    void siftUnit (
+        const OGSS_Ushort       idxBus,
+        OGSS_Ulong              pos);
+
+    void parkUnit (
+        std::vector <OGSS_Ulong> &  chains,
+        const OGSS_Ulong        idxRequest,
+        const OGSS_Ulong        handle);
+
+    OGSS_Ulong takeUnits (
+        std::vector <OGSS_Ulong> &  chains,
+        const OGSS_Ulong        idxRequest);
+
+    void releaseUnits (
+        const OGSS_Ulong        idxRequest);
+
+    OGSS_Ushort getHost (
+        const OGSS_Ulong        idxRequest);
+
+    OGSS_Bool admitUnit (
+        const TransferUnit &    unit,
+        const OGSS_Ulong        parent);
+
+    void admitPending (
+        const OGSS_Ushort       host,
+        const OGSS_Real         date);
+
+    void enterHost (
+        const TransferUnit &    unit);
+
+    OGSS_Bool hasRoom (
+        const OGSS_Ushort       idxBuffer,
+        const OGSS_Ulong        size);
+
+    void waitBuffer (
+        const OGSS_Ushort       idxBuffer,
+        const OGSS_Ushort       idxBus,
+        const TransferUnit &    unit);
+
+    void releaseBuffer (
+        const OGSS_Ushort       idxBuffer,
+        const OGSS_Ulong        size,
+        const OGSS_Real         date);
+
+    void turnBuffer (
+        const OGSS_Ushort       idxBuffer,
         const OGSS_Ulong        size,
+        const TransferUnit &    unit);
+
+    OGSS_Bool busHeadBefore (
+        const OGSS_Ushort       lhs,
+        const OGSS_Ushort       rhs);
+
+    void updateBusHeap (
         const OGSS_Ushort       idxBus);
 
+    void siftBusHeap (
+        OGSS_Ushort             pos);
+
+    OGSS_Real computeTransferTime (
+        const OGSS_Ulong        size,
+        const OGSS_Ushort       idxBus,
+        const OGSS_Ushort       idxHostBus = OGSS_USHORT_MAX);
+
     void finishRequest (
         const OGSS_Ulong        idxRequest);
 
 /**************************************/
 /* ATTRIBUTES *************************/
 /**************************************/
-    OGSS_Ulong                  m_lastParent;       /*!< Last parent checked by
-                                                         the main algorithm. */
     OGSS_Ulong                  m_nextParent;       /*!< Next parent to check by
-                                                         the main algorithm. */ 
-    std::set <TransferUnit> *   m_waitingList;      /*!< Bus waiting list. */
+                                                         the main algorithm:
+                                                         the arrival
+                                                         frontier. */
+    std::priority_queue <std::pair <OGSS_Real, OGSS_Ulong>,
+        std::vector <std::pair <OGSS_Real, OGSS_Ulong> >,
+        std::greater <std::pair <OGSS_Real, OGSS_Ulong> > >
+                                m_incompleteParents;/*!< Parents behind the
+                                                         frontier with bus
+                                                         children to come,
+                                                         by date. */
+    std::vector <TransferUnit>  m_units;            /*!< Transfer unit pool,
+                                                         indexed by handle. */
+    std::vector <OGSS_Ulong>    m_unitPosition;     /*!< Position of each unit
+                                                         in its waiting
+                                                         list. */
+    std::vector <OGSS_Ulong>    m_freeUnits;        /*!< Free unit handles. */
+    std::vector <OGSS_Ulong> *  m_waitingList;      /*!< Bus waiting list, a
+                                                         4-ary heap of the
+                                                         handles of the units
+                                                         which can go. */
+    std::vector <OGSS_Ushort>   m_busHeap;          /*!< Buses with waiting
+                                                         units, by date of
+                                                         their first unit. */
+    std::vector <OGSS_Ushort>   m_busHeapPosition;  /*!< Position of each bus
+                                                         in the heap. */
+    std::vector <OGSS_Ulong>    m_blockedUnits;     /*!< Last unit waiting for
+                                                         each request slot
+                                                         (pre-read, ghost),
+                                                         the units of a slot
+                                                         are chained in a
+                                                         ring by their next
+                                                         handle. */
+    OGSS_Bool                   m_arrivalOrdering;  /*!< TRUE if units are
+                                                         ordered by arrival. */
+    OGSS_Ulong                  m_numArrivals;      /*!< Number of arrived
+                                                         requests. */
     OGSS_Bool *                 m_bufferPresence;   /*!< TRUE if the component
                                                          has a buffer,
                                                          else FALSE. */
     OGSS_Ulong *                m_bufferSize;       /*!< Buffer available
                                                          sizes. */
+    std::vector <OGSS_Ulong>    m_bufferCapacity;   /*!< Buffer sizes, for
+                                                         the occupancy. */
+    std::vector <std::deque <std::pair <OGSS_Ushort, OGSS_Ulong> > >
+                                m_bufferWaiters;    /*!< Units waiting for
+                                                         room in each buffer,
+                                                         in blocking order:
+                                                         bus and handle. */
+    std::vector <unsigned>      m_hostOutstanding;  /*!< Requests in flight
+                                                         by host. */
+    std::vector <std::deque <OGSS_Ulong> >
+                                m_hostPending;      /*!< Requests waiting for
+                                                         a slot by host, in
+                                                         arrival order. */
+    std::vector <OGSS_Ulong>    m_heldUnits;        /*!< Last unit held by
+                                                         each request waiting
+                                                         for a slot of its
+                                                         host, chained in the
+                                                         same way. */
+    std::vector <bool>          m_admitted;         /*!< TRUE if the request
+                                                         has a slot of its
+                                                         host. */
 };
 
 #endif
@@ -0,0 +1,121 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	cmbusfluid.hpp
+ * @brief	Computation model for bus which queues the transfers on each bus,
+ * without simulating the buffers.
+ *
+ * Each bus is a first come, first served queue, not a shared bandwidth: its
+ * busy-until clock is the date when all the data sent to it are transfered,
+ * and a new transfer waits for it then gets the whole bandwidth. The
+ * request crosses the host, tier and device buses one after the other, with
+ * the same sizes as the advanced model. Both ways are charged on a bus when
+ * the request crosses it to the device, so that the bus load is right even if
+ * the return is not placed after the device.
+ *
+ * A volume attached to a fabric target is reached through the fabric route
+ * instead of the host and tier buses. The fabric links are full duplex: the
+ * answer is sent back on the route once the device is done.
+ *
+ * The host of the request adds its adapter bus before the host bus, and
+ * starts the fabric route from its own node if it has one. Its limit of
+ * requests in flight is only modeled by the advanced bus model.
+ */
+
+#ifndef __OGSS_CMBUSFLUID_HPP__
+#define __OGSS_CMBUSFLUID_HPP__
+
+#include "ComputationModels/cmbusdefault.hpp"
+
+class CMBusFluid: public CMBusDefault {
+public:
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+/**
+ * Default constructor.
+ * @param	requests			Request array.
+ * @param	architecture		Architecture.
+ * @param	resultFile			Result file.
+ * @param	subresultFile		Subresult file.
+ */
+	CMBusFluid (
+		RequestArray			* requests = NULL,
+		Architecture			* architecture = NULL,
+		std::ofstream			* resultFile = NULL,
+		std::ofstream			* subresultFile = NULL);
+
+/**
+ * Copy constructor.
+ * @param	cm					Copy.
+ */
+	CMBusFluid (
+		const CMBusFluid		& cm);
+
+/**
+ * Destructor.
+ */
+	~CMBusFluid ();
+
+/**
+ * Copy operator.
+ * @param	cm					Copy.
+ * @return						Current item.
+ */
+	CMBusFluid & operator= (
+		const CMBusFluid		& cm);
+
+/**
+ * Function which computes the execution time of a given request for the
+ * simulated component of the system.
+ *
+ * @param	idxRequest			Request index.
+ * @return						Execution time.
+ */
+	OGSS_Real compute (
+		const OGSS_Ulong		idxRequest);
+
+protected:
+/**************************************/
+/* PRIVATE FUNCTIONS ******************/
+/**************************************/
+/**
+ * Queue a transfer on a bus.
+ *
+ * @param	idxBus				Bus index.
+ * @param	date				Arrival date on the bus.
+ * @param	transferTime		Transfer time.
+ * @return						Waiting time.
+ */
+	OGSS_Real queueTransfer (
+		const OGSS_Ushort		idxBus,
+		const OGSS_Real			date,
+		const OGSS_Real			transferTime);
+
+/**************************************/
+/* ATTRIBUTES *************************/
+/**************************************/
+};
+
+#endif
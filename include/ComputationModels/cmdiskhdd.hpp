@@ -29,6 +29,8 @@
 #ifndef __OGSS_CMDISKHDD_HPP__
 #define __OGSS_CMDISKHDD_HPP__
 
+#include <vector>
+
 #include "ComputationModels/computationmodel.hpp"
 
 class CMDiskHDD: public ComputationModel {
@@ -79,20 +81,111 @@ public:
 	OGSS_Real compute (
 		const OGSS_Ulong		idxRequest);
 
+/**
+ * Function which places a request on its device, once the request reached
+ * it. The platter kept turning since the last transfer: the rotational
+ * latency of the request is updated with the head angle at its start.
+ *
+ * @param	idxRequest			Request index.
+ * @param	arrival				Date the request reaches the device.
+ * @return						Date the service starts.
+ */
+	OGSS_Real serve (
+		const OGSS_Ulong		idxRequest,
+		const OGSS_Real			arrival);
+
+/**
+ * Function which forgets the rotational latency kept for a request.
+ *
+ * @param	idxRequest			Request index.
+ */
+	void release (
+		const OGSS_Ulong		idxRequest);
+
+/**
+ * Get the track targeted by a given request.
+ *
+ * @param	idxRequest			Request index.
+ * @return						Track.
+ */
+	OGSS_Ulong getTrack (
+		const OGSS_Ulong		idxRequest) const;
+
+/**
+ * Estimate the positioning time (seek and rotational latency) of a given
+ * request from the current track and head positions, without updating them.
+ *
+ * @param	idxRequest			Request index.
+ * @return						Positioning time.
+ */
+	OGSS_Real estimateAccessTime (
+		const OGSS_Ulong		idxRequest) const;
+
 protected:
 /**************************************/
 /* PRIVATE FUNCTIONS ******************/
 /**************************************/
-	OGSS_Real cpt_seekTime (
-		const OGSS_Ulong		idxRequest);
-	OGSS_Real cpt_rotTime (
-		const OGSS_Ulong		idxRequest);
-	OGSS_Real cpt_tsfTime (
+/**
+ * Get the access time (seek, rotational latency and transfer) of a device
+ * area, and move the head after it.
+ * @param	idxDevice			Device index.
+ * @param	write				TRUE for a write seek.
+ * @param	address				Device address.
+ * @param	size				Size.
+ * @return						Access time.
+ */
+	OGSS_Real cpt_access (
+		const OGSS_Ushort		idxDevice,
+		const OGSS_Bool			write,
+		const OGSS_Ulong		address,
+		const OGSS_Ulong		size);
+/**
+ * Get the track, the sector in the track and the track size of a device
+ * sector, depending on the device zones.
+ * @return						Transfer rate of the sector zone.
+ */
+	OGSS_Real cpt_location (
+		const OGSS_Ushort		idxDevice,
+		const OGSS_Ulong		sector,
+		OGSS_Ulong				& track,
+		OGSS_Ulong				& trackSector,
+		unsigned				& trackSize) const;
+/**
+ * Get the head angle at the end of the last transfer, as a fraction of
+ * rotation, from the track and head positions.
+ */
+	OGSS_Real cpt_headAngle (
+		const OGSS_Ushort		idxDevice) const;
+/**
+ * Get the rotational latency to reach the target angle once the seek is done.
+ */
+	OGSS_Real cpt_rotLatency (
+		const OGSS_Ushort		idxDevice,
+		const OGSS_Real			headAngle,
+		const OGSS_Real			seekTime,
+		const OGSS_Real			targetAngle) const;
+	OGSS_Real cpt_seekCurve (
+		const OGSS_Ulong		idxRequest,
+		const OGSS_Ulong		dist) const;
+/**
+ * Keep the rotational latency of the last access for a request until it
+ * reaches its device.
+ * @param	idxRequest			Request index.
+ */
+	void keepRotation (
 		const OGSS_Ulong		idxRequest);
 
 /**************************************/
 /* ATTRIBUTES *************************/
 /**************************************/
+	OGSS_Real					m_rotLatency;		/*!< Rotational latency of
+														 the last access. */
+	std::vector < OGSS_Real >	m_pendingRotation;	/*!< Rotational latency
+														 of the first access
+														 by request slot,
+														 negative once the
+														 request reached its
+														 device. */
 };
 
 #endif
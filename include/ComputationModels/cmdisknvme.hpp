@@ -0,0 +1,99 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	cmdisknvme.hpp
+ * @brief	Computation model for NVMe SSD.
+ */
+
+#ifndef __OGSS_CMDISKNVME_HPP__
+#define __OGSS_CMDISKNVME_HPP__
+
+#include "ComputationModels/cmdiskssd.hpp"
+
+class CMDiskNVMe: public CMDiskSSD {
+public:
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+/**
+ * Default constructor.
+ * @param	requests			Request array.
+ * @param	architecture		Architecture.
+ * @param	resultFile			Result file.
+ * @param	subresultFile		Subresult file.
+ */
+	CMDiskNVMe (
+		RequestArray			* requests = NULL,
+		Architecture			* architecture = NULL,
+		std::ofstream			* resultFile = NULL,
+		std::ofstream			* subresultFile = NULL);
+
+/**
+ * Copy constructor.
+ * @param	cm					Copy.
+ */
+	CMDiskNVMe (
+		const CMDiskNVMe		& cm);
+
+/**
+ * Destructor.
+ */
+	~CMDiskNVMe ();
+
+/**
+ * Copy operator.
+ * @param	cm					Copy.
+ * @return						Current item.
+ */
+	CMDiskNVMe & operator= (
+		const CMDiskNVMe		& cm);
+
+/**
+ * Function which computes the execution time of a given request for the
+ * simulated component of the system, on an idle device: the flash work of
+ * each die, and the data crossing the PCIe link.
+ *
+ * @param	idxRequest			Request index.
+ * @return						Execution time.
+ */
+	OGSS_Real compute (
+		const OGSS_Ulong		idxRequest);
+
+/**
+ * Function which places a request on its device, once the request reached
+ * it. The request goes through its submission queue and the command
+ * processor, then the flash dies, the data crossing the PCIe link before a
+ * write or after a read. The service starts when the processor takes the
+ * command.
+ *
+ * @param	idxRequest			Request index.
+ * @param	arrival				Date the request reaches the device.
+ * @return						Date the service starts.
+ */
+	OGSS_Real serve (
+		const OGSS_Ulong		idxRequest,
+		const OGSS_Real			arrival);
+};
+
+#endif
@@ -0,0 +1,85 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	cmdisksmr.hpp
+ * @brief	Computation model for SMR (shingled) HDD.
+ */
+
+#ifndef __OGSS_CMDISKSMR_HPP__
+#define __OGSS_CMDISKSMR_HPP__
+
+#include "ComputationModels/cmdiskhdd.hpp"
+
+class CMDiskSMR: public CMDiskHDD {
+public:
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+/**
+ * Default constructor.
+ * @param	requests			Request array.
+ * @param	architecture		Architecture.
+ * @param	resultFile			Result file.
+ * @param	subresultFile		Subresult file.
+ */
+	CMDiskSMR (
+		RequestArray			* requests = NULL,
+		Architecture			* architecture = NULL,
+		std::ofstream			* resultFile = NULL,
+		std::ofstream			* subresultFile = NULL);
+
+/**
+ * Copy constructor.
+ * @param	cm					Copy.
+ */
+	CMDiskSMR (
+		const CMDiskSMR			& cm);
+
+/**
+ * Destructor.
+ */
+	~CMDiskSMR ();
+
+/**
+ * Copy operator.
+ * @param	cm					Copy.
+ * @return						Current item.
+ */
+	CMDiskSMR & operator= (
+		const CMDiskSMR			& cm);
+
+/**
+ * Function which computes the execution time of a given request for the
+ * simulated component of the system. The writes are placed by the zone
+ * state of the device, and the band cleanings they trigger are included.
+ * An erasure resets the write pointers of the zones it covers.
+ *
+ * @param	idxRequest			Request index.
+ * @return						Execution time.
+ */
+	OGSS_Real compute (
+		const OGSS_Ulong		idxRequest);
+};
+
+#endif
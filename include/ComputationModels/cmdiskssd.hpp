@@ -29,6 +29,8 @@
 #ifndef __OGSS_CMDISKSSD_HPP__
 #define __OGSS_CMDISKSSD_HPP__
 
+#include <vector>
+
 #include "ComputationModels/computationmodel.hpp"
 
 class CMDiskSSD: public ComputationModel {
@@ -79,7 +81,58 @@ public:
 	OGSS_Real compute (
 		const OGSS_Ulong		idxRequest);
 
+/**
+ * Function which places a request on its device, once the request reached
+ * it. If the dies of the device work concurrently, the die and channel
+ * clocks are booked from the arrival date, and the service time of the
+ * request goes from the first die start to the last die end.
+ *
+ * @param	idxRequest			Request index.
+ * @param	arrival				Date the request reaches the device.
+ * @return						Date the service starts.
+ */
+	OGSS_Real serve (
+		const OGSS_Ulong		idxRequest,
+		const OGSS_Real			arrival);
+
+/**
+ * Function which forgets the die work kept for a request.
+ *
+ * @param	idxRequest			Request index.
+ */
+	void release (
+		const OGSS_Ulong		idxRequest);
+
+/**
+ * Get the number of die works of the pool.
+ *
+ * @return						Pool size.
+ */
+	inline OGSS_Ulong getDieWorkPoolSize () const
+		{ return m_dieWorks.size (); }
+
+/**
+ * Get the number of die works kept for the requests which did not reach
+ * their device yet.
+ *
+ * @return						Number of die works in use.
+ */
+	inline OGSS_Ulong getNumPendingDieWorks () const
+		{ return m_numPendingDieWorks; }
+
 protected:
+/**
+ * DieWork is the flash work of a request on one of the dies, kept from the
+ * compute of the request to its service. The works of a request are chained
+ * by increasing die.
+ */
+	struct DieWork {
+		OGSS_Real				time;
+		OGSS_Ulong				pages;
+		OGSS_Ulong				next;
+		unsigned				die;
+	};
+
 /**************************************/
 /* PRIVATE FUNCTIONS ******************/
 /**************************************/
@@ -87,10 +140,66 @@ protected:
 		const OGSS_Ulong		idxRequest);
 	OGSS_Real cpt_writeServTime (
 		const OGSS_Ulong		idxRequest);
-	
+	OGSS_Real cpt_ftlServTime (
+		const OGSS_Ulong		idxRequest);
+/**
+ * Keep the die times of the last request until it reaches the device.
+ * @param	idxRequest			Request index.
+ * @return						Service time on idle dies and channels.
+ */
+	OGSS_Real cpt_parallelServTime (
+		const OGSS_Ulong		idxRequest);
+/**
+ * Keep the die times and pages of the last request until it reaches its
+ * device.
+ * @param	idxRequest			Request index.
+ */
+	void keepDieWork (
+		const OGSS_Ulong		idxRequest);
+/**
+ * Get back the die times and pages kept for a request.
+ * @param	idxRequest			Request index.
+ * @return						FALSE if nothing was kept for the request.
+ */
+	OGSS_Bool takeDieWork (
+		const OGSS_Ulong		idxRequest);
+/**
+ * Give the die works of a request back to the pool.
+ * @param	idxRequest			Request index.
+ */
+	void dropDieWork (
+		const OGSS_Ulong		idxRequest);
+/**
+ * Place the die times of the last request on the die and channel clocks.
+ * @param	idxDevice			Device index.
+ * @param	read				TRUE for a read.
+ * @param	arrival				Date the request reaches the flash.
+ * @param	start				Date the first die starts (output).
+ * @return						Date the last die ends.
+ */
+	OGSS_Real cpt_dieSchedule (
+		const OGSS_Ushort		idxDevice,
+		const OGSS_Bool			read,
+		const OGSS_Real			arrival,
+		OGSS_Real				& start);
+
 /**************************************/
 /* ATTRIBUTES *************************/
 /**************************************/
+	std::vector < OGSS_Real >	m_dieTimes;			/*!< Flash time by die of
+														 the last request. */
+	std::vector < OGSS_Ulong >	m_diePages;			/*!< Pages by die of the
+														 last request. */
+	std::vector < DieWork >		m_dieWorks;			/*!< Die work pool,
+														 indexed by handle. */
+	OGSS_Ulong					m_freeDieWork;		/*!< First free die work
+														 of the pool. */
+	OGSS_Ulong					m_numPendingDieWorks;/*!< Die works in use. */
+	std::vector < OGSS_Ulong >	m_pendingWork;		/*!< First die work by
+														 request slot, for the
+														 requests which did
+														 not reach their
+														 device yet. */
 };
 
 #endif
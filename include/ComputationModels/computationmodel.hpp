@@ -37,11 +37,14 @@
 
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 #include "Structures/architecture.hpp"
 #include "Structures/requestarray.hpp"
 #include "Structures/types.hpp"
 
+#include "Utils/livestats.hpp"
+
 class ComputationModel {
 public:
 /**************************************/
@@ -70,6 +73,55 @@ public:
 	virtual OGSS_Real compute (
 		const OGSS_Ulong		idxRequest) = 0;
 
+/**
+ * Function which places a request on its device, once the request reached
+ * it. The default implementation serves the requests of the device one at a
+ * time, on the device clock. The device models which keep internal clocks
+ * override it to book them at the arrival date, they can then update the
+ * service time of the request.
+ *
+ * @param	idxRequest			Request index.
+ * @param	arrival				Date the request reaches the device.
+ * @return						Date the service starts.
+ */
+	virtual OGSS_Real serve (
+		const OGSS_Ulong		idxRequest,
+		const OGSS_Real			arrival);
+
+/**
+ * Function which forgets the state kept for a request between its compute
+ * and its service, once the request is done and its slot can be used again.
+ * The default implementation keeps nothing.
+ *
+ * @param	idxRequest			Request index.
+ */
+	virtual void release (
+		const OGSS_Ulong		idxRequest);
+
+/**
+ * Set the live statistics updated when a user request is done.
+ *
+ * @param	liveStats			Live statistics, NULL if not used.
+ */
+	inline void setLiveStats (
+		LiveStats				* liveStats);
+
+/**
+ * Set the list where the subrequest slots are stored when they are released.
+ *
+ * @param	releasedSlots		Released slots, NULL if not used.
+ */
+	inline void setReleasedSlots (
+		std::vector < OGSS_Ulong >	* releasedSlots);
+
+/**
+ * Set the models which place the requests on the devices, by device.
+ *
+ * @param	deviceModels		Device models, NULL to use the device clocks.
+ */
+	inline void setDeviceModels (
+		std::vector < ComputationModel * >	* deviceModels);
+
 protected:
 /**************************************/
 /* PRIVATE FUNCTIONS ******************/
@@ -82,6 +134,28 @@ protected:
 	ComputationModel (
 		const ComputationModel	& cm);
 
+/**
+ * Mark a request as done. The model of its device forgets the request, and
+ * the slot of a subrequest can then be used again, it is added to the
+ * released slots.
+ *
+ * @param	idxRequest			Request index.
+ */
+	inline void releaseRequest (
+		const OGSS_Ulong		idxRequest);
+
+/**
+ * Place a request on its device once it reached it: the device waiting time
+ * of the request is set and the device clock goes to the end of its service.
+ *
+ * @param	idxRequest			Request index.
+ * @param	arrival				Date the request reaches the device.
+ * @return						Date the service ends.
+ */
+	OGSS_Real placeOnDevice (
+		const OGSS_Ulong		idxRequest,
+		const OGSS_Real			arrival);
+
 /**************************************/
 /* ATTRIBUTES *************************/
 /**************************************/
@@ -90,6 +164,48 @@ protected:
 
 	std::ofstream				* m_resultFile;
 	std::ofstream				* m_subresultFile;
+
+	LiveStats					* m_liveStats;
+	std::vector < OGSS_Ulong >	* m_releasedSlots;	/*!< Released subrequest
+														 slots. */
+	std::vector < ComputationModel * >
+								* m_deviceModels;	/*!< Models which place
+														 the requests on the
+														 devices. */
 };
 
+/**************************************/
+/* INLINE FUNCTIONS *******************/
+/**************************************/
+inline void
+ComputationModel::setLiveStats (
+	LiveStats				* liveStats)
+	{ m_liveStats = liveStats; }
+
+inline void
+ComputationModel::setReleasedSlots (
+	std::vector < OGSS_Ulong >	* releasedSlots)
+	{ m_releasedSlots = releasedSlots; }
+
+inline void
+ComputationModel::setDeviceModels (
+	std::vector < ComputationModel * >	* deviceModels)
+	{ m_deviceModels = deviceModels; }
+
+inline void
+ComputationModel::releaseRequest (
+	const OGSS_Ulong		idxRequest) {
+	OGSS_Ushort				idxDevice = m_requests->getIdxDevice (idxRequest);
+
+	m_requests->isDone (idxRequest);
+
+	// The parent requests have no device
+	if (m_deviceModels != NULL && idxDevice < m_deviceModels->size ()
+		&& (* m_deviceModels) [idxDevice] != NULL)
+		(* m_deviceModels) [idxDevice] ->release (idxRequest);
+
+	if (m_releasedSlots != NULL && idxRequest >= m_requests->getNumRequests () )
+		m_releasedSlots->push_back (idxRequest);
+}
+
 #endif
@@ -0,0 +1,258 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	devicecache.hpp
+ * @brief	DeviceCache is the on-board DRAM cache of a device. It wraps the
+ * computation model of the device: the read hits and the absorbed writes are
+ * served at the cache latency, the other requests by the device.
+ *
+ * The cache is divided in fixed-size segments, keyed on the device address
+ * and replaced with the CLOCK algorithm. A read miss loads the next segments
+ * too (read-ahead). In write-back mode, the written data are destaged by the
+ * device as soon as it is idle, the reads having the priority; a write only
+ * waits when the dirty data would overflow the buffer.
+ */
+
+#ifndef __OGSS_DEVICECACHE_HPP__
+#define __OGSS_DEVICECACHE_HPP__
+
+#include <deque>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+#include "ComputationModels/computationmodel.hpp"
+
+class DeviceCache: public ComputationModel {
+public:
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+/**
+ * Constructor. The cache parameters are given by the device.
+ * @param	requests			Request array.
+ * @param	architecture		Architecture.
+ * @param	disk				Computation model of the device.
+ * @param	idxDevice			Device index.
+ */
+	DeviceCache (
+		RequestArray			* requests,
+		Architecture			* architecture,
+		ComputationModel		* disk,
+		const OGSS_Ushort		idxDevice);
+
+/**
+ * Destructor.
+ */
+	~DeviceCache ();
+
+/**
+ * Function which computes the execution time of a given request, at the
+ * cache latency if the cache can serve it.
+ *
+ * @param	idxRequest			Request index.
+ * @return						Execution time.
+ */
+	OGSS_Real compute (
+		const OGSS_Ulong		idxRequest);
+
+/**
+ * Function which places a request on the device, once the request reached
+ * it. The requests served by the cache wait for the device clock, the
+ * others are placed by the device model.
+ *
+ * @param	idxRequest			Request index.
+ * @param	arrival				Date the request reaches the device.
+ * @return						Date the service starts.
+ */
+	OGSS_Real serve (
+		const OGSS_Ulong		idxRequest,
+		const OGSS_Real			arrival);
+
+/**
+ * Function which forgets the state kept for a request, by the cache and by
+ * the device model.
+ *
+ * @param	idxRequest			Request index.
+ */
+	void release (
+		const OGSS_Ulong		idxRequest);
+
+/**
+ * Get the computation model of the device.
+ * @return						Device model.
+ */
+	inline ComputationModel * getDisk () const;
+
+/**
+ * Get the number of reads.
+ * @return						Number of reads.
+ */
+	inline OGSS_Ulong getNumReads () const;
+
+/**
+ * Get the number of reads served by the cache.
+ * @return						Number of hits.
+ */
+	inline OGSS_Ulong getNumReadHits () const;
+
+/**
+ * Get the number of writes.
+ * @return						Number of writes.
+ */
+	inline OGSS_Ulong getNumWrites () const;
+
+/**
+ * Get the number of writes completed without waiting for a destage.
+ * @return						Number of absorbed writes.
+ */
+	inline OGSS_Ulong getNumAbsorbedWrites () const;
+
+/**
+ * Get the max amount of dirty data waiting for destage.
+ * @return						Max backlog in bytes.
+ */
+	inline OGSS_Ulong getMaxBacklog () const;
+
+/**
+ * Get the amount of dirty data still waiting for destage at a date.
+ * @param	date				Date.
+ * @return						Backlog in bytes.
+ */
+	OGSS_Ulong getBacklog (
+		const OGSS_Real			date) const;
+
+/**
+ * Get the time spent by the writes to wait for buffer space.
+ * @return						Stall time.
+ */
+	inline OGSS_Real getStallTime () const;
+
+/**
+ * Get the device time spent by the destages.
+ * @return						Destage time.
+ */
+	inline OGSS_Real getDestageTime () const;
+
+/**
+ * Get the date of the end of the last destage.
+ * @return						Date.
+ */
+	inline OGSS_Real getDestageEnd () const;
+
+protected:
+/**************************************/
+/* PRIVATE FUNCTIONS ******************/
+/**************************************/
+/**
+ * Check if segments are all in the cache, and mark them as referenced.
+ * @param	first				First segment.
+ * @param	last				Last segment.
+ * @return						TRUE if all are present.
+ */
+	OGSS_Bool lookup (
+		const OGSS_Ulong		first,
+		const OGSS_Ulong		last);
+
+/**
+ * Insert segments in the cache, evicting with CLOCK if needed.
+ * @param	first				First segment.
+ * @param	last				Last segment.
+ */
+	void insert (
+		const OGSS_Ulong		first,
+		const OGSS_Ulong		last);
+
+/**************************************/
+/* ATTRIBUTES *************************/
+/**************************************/
+	ComputationModel			* m_disk;			/*!< Device model. */
+	OGSS_Ushort					m_idxDevice;		/*!< Device index. */
+
+	OGSS_Ulong					m_segmentSize;		/*!< Segment size. */
+	OGSS_Ulong					m_readAhead;		/*!< Read-ahead segments. */
+	OGSS_Bool					m_writeBack;		/*!< Write-back mode. */
+	OGSS_Real					m_latency;			/*!< Hit latency. */
+	OGSS_Ulong					m_capacity;			/*!< Buffer size. */
+
+	std::vector < OGSS_Ulong >	m_keys;				/*!< Segment of each slot,
+														 + 1, 0 if empty. */
+	std::vector < uint8_t >		m_referenced;		/*!< CLOCK bits. */
+	std::unordered_map < OGSS_Ulong, uint32_t >
+								m_slots;			/*!< Slot of a segment. */
+	uint32_t					m_hand;				/*!< CLOCK hand. */
+
+	std::deque < std::pair < OGSS_Real, OGSS_Ulong > >
+								m_destages;			/*!< End dates and sizes of
+														 the pending destages. */
+	OGSS_Ulong					m_dirty;			/*!< Pending dirty bytes. */
+	OGSS_Real					m_destageEnd;		/*!< End of the last
+														 destage. */
+
+	OGSS_Ulong					m_numReads;			/*!< Reads. */
+	OGSS_Ulong					m_numReadHits;		/*!< Read hits. */
+	OGSS_Ulong					m_numWrites;		/*!< Writes. */
+	OGSS_Ulong					m_numAbsorbed;		/*!< Absorbed writes. */
+	OGSS_Ulong					m_maxBacklog;		/*!< Max dirty bytes. */
+	OGSS_Real					m_stallTime;		/*!< Write stall time. */
+	OGSS_Real					m_destageTime;		/*!< Destage time. */
+};
+
+inline ComputationModel *
+DeviceCache::getDisk () const
+	{ return m_disk; }
+
+inline OGSS_Ulong
+DeviceCache::getNumReads () const
+	{ return m_numReads; }
+
+inline OGSS_Ulong
+DeviceCache::getNumReadHits () const
+	{ return m_numReadHits; }
+
+inline OGSS_Ulong
+DeviceCache::getNumWrites () const
+	{ return m_numWrites; }
+
+inline OGSS_Ulong
+DeviceCache::getNumAbsorbedWrites () const
+	{ return m_numAbsorbed; }
+
+inline OGSS_Ulong
+DeviceCache::getMaxBacklog () const
+	{ return m_maxBacklog; }
+
+inline OGSS_Real
+DeviceCache::getStallTime () const
+	{ return m_stallTime; }
+
+inline OGSS_Real
+DeviceCache::getDestageTime () const
+	{ return m_destageTime; }
+
+inline OGSS_Real
+DeviceCache::getDestageEnd () const
+	{ return m_destageEnd; }
+
+#endif
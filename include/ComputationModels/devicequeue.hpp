@@ -0,0 +1,193 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	devicequeue.hpp
+ * @brief	DeviceQueue is the command queue (NCQ) of a device. It holds the
+ * requests which arrive while the device is busy, and chooses the next one
+ * to serve depending on a reordering policy.
+ *
+ * The queue keeps its own estimation of the device busy period: a request is
+ * only released when the device would have finished the previous ones, so
+ * the reordering happens only when requests really wait.
+ */
+
+#ifndef __OGSS_DEVICEQUEUE_HPP__
+#define __OGSS_DEVICEQUEUE_HPP__
+
+#include <deque>
+#include <vector>
+
+#include "ComputationModels/cmdiskhdd.hpp"
+#include "ComputationModels/computationmodel.hpp"
+
+class DeviceQueue {
+public:
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+/**
+ * Constructor. The queue depth and policy are given by the device NCQ
+ * parameters.
+ * @param	requests			Request array.
+ * @param	architecture		Architecture.
+ * @param	disk				Computation model of the device.
+ * @param	idxDevice			Device index.
+ */
+	DeviceQueue (
+		RequestArray			* requests,
+		Architecture			* architecture,
+		ComputationModel		* disk,
+		const OGSS_Ushort		idxDevice);
+
+/**
+ * Destructor.
+ */
+	~DeviceQueue ();
+
+/**
+ * Add a request to the queue. The requests which would have been served
+ * before its arrival are released, with their service time computed.
+ * @param	idxRequest			Request index.
+ * @param	released			Released requests.
+ */
+	void push (
+		const OGSS_Ulong		idxRequest,
+		std::vector < OGSS_Ulong >	& released);
+
+/**
+ * Release all the requests of the queue, in the policy order.
+ * @param	released			Released requests.
+ */
+	void flush (
+		std::vector < OGSS_Ulong >	& released);
+
+/**
+ * Check if the queue is empty.
+ * @return						TRUE if empty.
+ */
+	inline OGSS_Bool isEmpty () const;
+
+/**
+ * Get the number of requests which passed through the queue.
+ * @return						Number of requests.
+ */
+	inline OGSS_Ulong getNumRequests () const;
+
+/**
+ * Get the mean queue depth seen by the arriving requests.
+ * @return						Mean depth.
+ */
+	inline OGSS_Real getMeanDepth () const;
+
+/**
+ * Get the max queue depth.
+ * @return						Max depth.
+ */
+	inline OGSS_Ulong getMaxDepth () const;
+
+/**
+ * Get the number of requests served before an older one.
+ * @return						Number of reordered requests.
+ */
+	inline OGSS_Ulong getNumReordered () const;
+
+private:
+/**************************************/
+/* PRIVATE FUNCTIONS ******************/
+/**************************************/
+/**
+ * Choose the next request to serve among the first ones of the queue.
+ * @return						Position in the queue.
+ */
+	OGSS_Ulong select () const;
+
+/**
+ * Remove the next request from the queue, compute its service time and
+ * update the busy period.
+ * @param	released			Released requests.
+ */
+	void serve (
+		std::vector < OGSS_Ulong >	& released);
+
+/**
+ * Get the position (track for HDD, page for SSD) targeted by a request.
+ * @param	idxRequest			Request index.
+ * @return						Position.
+ */
+	OGSS_Ulong getPosition (
+		const OGSS_Ulong		idxRequest) const;
+
+/**
+ * Get the current position of the device.
+ * @return						Position.
+ */
+	OGSS_Ulong getCurrentPosition () const;
+
+/**************************************/
+/* ATTRIBUTES *************************/
+/**************************************/
+	RequestArray				* m_requests;		/*!< Request array. */
+	Architecture				* m_architecture;	/*!< Architecture. */
+	ComputationModel			* m_disk;			/*!< Device model. */
+	CMDiskHDD					* m_hdd;			/*!< Device model if HDD,
+														 else NULL. */
+
+	OGSS_Ushort					m_idxDevice;		/*!< Device index. */
+	OGSS_Ulong					m_depth;			/*!< Queue depth. */
+	QueuePolicyType				m_policy;			/*!< Reordering policy. */
+
+	std::deque < OGSS_Ulong >	m_queue;			/*!< Waiting requests. */
+	OGSS_Real					m_busyUntil;		/*!< End of the device
+														 busy period. */
+	OGSS_Ulong					m_position;			/*!< Last page (SSD). */
+
+	OGSS_Ulong					m_numRequests;		/*!< Queued requests. */
+	OGSS_Ulong					m_sumDepth;			/*!< Sum of the depths. */
+	OGSS_Ulong					m_maxDepth;			/*!< Max depth. */
+	OGSS_Ulong					m_numReordered;		/*!< Reordered requests. */
+};
+
+inline OGSS_Bool
+DeviceQueue::isEmpty () const
+	{ return m_queue.empty (); }
+
+inline OGSS_Ulong
+DeviceQueue::getNumRequests () const
+	{ return m_numRequests; }
+
+inline OGSS_Real
+DeviceQueue::getMeanDepth () const {
+	if (m_numRequests == 0) return .0;
+	return (OGSS_Real) m_sumDepth / m_numRequests;
+}
+
+inline OGSS_Ulong
+DeviceQueue::getMaxDepth () const
+	{ return m_maxDepth; }
+
+inline OGSS_Ulong
+DeviceQueue::getNumReordered () const
+	{ return m_numReordered; }
+
+#endif
@@ -0,0 +1,264 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	qosscheduler.hpp
+ * @brief	QoSScheduler is the stage in front of a device which shares it
+ * between the QoS classes. It holds the requests which arrive while the
+ * device is busy, and chooses the next one to serve by strict priority, then
+ * by weighted fair queuing in a priority level. A class with a rate limit is
+ * only served when its token bucket holds the request.
+ *
+ * The classes which have requests are kept in two heaps: the ready
+ * ones by priority and finish tag, the throttled ones by the date their
+ * bucket refills, so a choice costs O(log classes). The requests of a class
+ * are kept in a ring which only grows, there is no allocation by request.
+ */
+
+#ifndef __OGSS_QOSSCHEDULER_HPP__
+#define __OGSS_QOSSCHEDULER_HPP__
+
+#include <vector>
+
+#include "ComputationModels/computationmodel.hpp"
+
+class QoSScheduler {
+public:
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+/**
+ * Constructor. The classes are given by the architecture.
+ * @param	requests			Request array.
+ * @param	architecture		Architecture.
+ * @param	disk				Computation model of the device.
+ * @param	idxDevice			Device index.
+ */
+	QoSScheduler (
+		RequestArray			* requests,
+		Architecture			* architecture,
+		ComputationModel		* disk,
+		const OGSS_Ushort		idxDevice);
+
+/**
+ * Destructor.
+ */
+	~QoSScheduler ();
+
+/**
+ * Add a request to the scheduler. The requests which would have been served
+ * before its arrival are released, with their service time computed.
+ * @param	idxRequest			Request index.
+ * @param	released			Released requests.
+ */
+	void push (
+		const OGSS_Ulong		idxRequest,
+		std::vector < OGSS_Ulong >	& released);
+
+/**
+ * Release all the requests of the scheduler, in the QoS order.
+ * @param	released			Released requests.
+ */
+	void flush (
+		std::vector < OGSS_Ulong >	& released);
+
+/**
+ * Check if the scheduler is empty.
+ * @return						TRUE if empty.
+ */
+	inline OGSS_Bool isEmpty () const;
+
+/**
+ * Get the number of requests of a class which passed through the scheduler.
+ * @param	idxClass			Class index.
+ * @return						Number of requests.
+ */
+	inline OGSS_Ulong getNumRequests (
+		const OGSS_Ushort		idxClass) const;
+
+/**
+ * Get the number of requests of a class delayed by its rate limit.
+ * @param	idxClass			Class index.
+ * @return						Number of throttled requests.
+ */
+	inline OGSS_Ulong getNumThrottled (
+		const OGSS_Ushort		idxClass) const;
+
+/**
+ * Get the time the device stayed idle because of the rate limits.
+ * @return						Idle time (ms).
+ */
+	inline OGSS_Real getThrottleTime () const;
+
+private:
+/**
+ * Request waiting in a class.
+ */
+	struct Entry {
+		OGSS_Ulong				m_idxRequest;		/*!< Request index. */
+		OGSS_Real				m_tag;				/*!< Finish tag. */
+	};
+
+/**
+ * State of a class in the scheduler.
+ */
+	struct Class {
+		std::vector < Entry >	m_ring;				/*!< Waiting requests. */
+		OGSS_Ulong				m_head;				/*!< First request. */
+		OGSS_Ulong				m_count;			/*!< Number of requests. */
+		OGSS_Real				m_lastTag;			/*!< Tag of the last
+														 request. */
+		OGSS_Ushort				m_level;			/*!< Priority level. */
+		OGSS_Real				m_tokens;			/*!< Tokens (bytes). */
+		OGSS_Real				m_refill;			/*!< Date of the tokens. */
+		OGSS_Real				m_eligible;			/*!< Date the head can
+														 be served. */
+		OGSS_Ulong				m_numRequests;		/*!< Queued requests. */
+		OGSS_Ulong				m_numThrottled;		/*!< Throttled requests. */
+	};
+
+/**************************************/
+/* PRIVATE FUNCTIONS ******************/
+/**************************************/
+/**
+ * Get the date the next request can start.
+ * @return						Start date, or the max value if the
+ *								scheduler is empty.
+ */
+	OGSS_Real nextStart ();
+
+/**
+ * Remove the next request from the scheduler, compute its service time and
+ * update the busy period.
+ * @param	released			Released requests.
+ */
+	void serve (
+		std::vector < OGSS_Ulong >	& released);
+
+/**
+ * Move the throttled classes which can be served at a date to the ready heap.
+ * @param	date				Date.
+ */
+	void promote (
+		const OGSS_Real			date);
+
+/**
+ * Put a class which has requests in its heap, depending on its head.
+ * @param	idxClass			Class index.
+ */
+	void schedule (
+		const OGSS_Ushort		idxClass);
+
+/**
+ * Get the size of a request, as seen by the fair queuing and the buckets.
+ * @param	idxRequest			Request index.
+ * @return						Size (bytes).
+ */
+	OGSS_Ulong getCost (
+		const OGSS_Ulong		idxRequest) const;
+
+/**
+ * Compare two classes of a heap.
+ * @param	throttled			TRUE for the throttled heap.
+ * @param	lhs					First class.
+ * @param	rhs					Second class.
+ * @return						TRUE if the first class comes first.
+ */
+	OGSS_Bool before (
+		const OGSS_Bool			throttled,
+		const OGSS_Ushort		lhs,
+		const OGSS_Ushort		rhs) const;
+
+/**
+ * Insert a class in a heap.
+ * @param	throttled			TRUE for the throttled heap.
+ * @param	idxClass			Class index.
+ */
+	void pushClass (
+		const OGSS_Bool			throttled,
+		const OGSS_Ushort		idxClass);
+
+/**
+ * Remove the first class of a heap.
+ * @param	throttled			TRUE for the throttled heap.
+ * @return						Class index.
+ */
+	OGSS_Ushort popClass (
+		const OGSS_Bool			throttled);
+
+/**
+ * Move a class of a heap to its place.
+ * @param	throttled			TRUE for the throttled heap.
+ * @param	pos					Position of the class.
+ */
+	void siftClass (
+		const OGSS_Bool			throttled,
+		OGSS_Ushort				pos);
+
+/**************************************/
+/* ATTRIBUTES *************************/
+/**************************************/
+	RequestArray				* m_requests;		/*!< Request array. */
+	Architecture				* m_architecture;	/*!< Architecture. */
+	ComputationModel			* m_disk;			/*!< Device model. */
+
+	OGSS_Ushort					m_idxDevice;		/*!< Device index. */
+	OGSS_Bool					m_colored;			/*!< TRUE if the requests
+														 have a color. */
+
+	std::vector < Class >		m_classes;			/*!< Class states. */
+	std::vector < OGSS_Ushort >	m_ready;			/*!< Heap of the classes
+														 which can be
+														 served. */
+	std::vector < OGSS_Ushort >	m_throttled;		/*!< Heap of the classes
+														 waiting for tokens. */
+	OGSS_Ulong					m_numWaiting;		/*!< Waiting requests. */
+
+	OGSS_Real					m_busyUntil;		/*!< End of the device
+														 busy period. */
+	std::vector < OGSS_Real >	m_virtualTime;		/*!< Tag of the last
+														 served request, by
+														 priority level. */
+	OGSS_Real					m_throttleTime;		/*!< Idle time because of
+														 the rate limits. */
+};
+
+inline OGSS_Bool
+QoSScheduler::isEmpty () const
+	{ return m_numWaiting == 0; }
+
+inline OGSS_Ulong
+QoSScheduler::getNumRequests (
+	const OGSS_Ushort		idxClass) const
+	{ return m_classes [idxClass] .m_numRequests; }
+
+inline OGSS_Ulong
+QoSScheduler::getNumThrottled (
+	const OGSS_Ushort		idxClass) const
+	{ return m_classes [idxClass] .m_numThrottled; }
+
+inline OGSS_Real
+QoSScheduler::getThrottleTime () const
+	{ return m_throttleTime; }
+
+#endif
@@ -33,6 +33,7 @@
 #include <thread>
 
 #include "Structures/architecture.hpp"
+#include "Structures/horizon.hpp"
 #include "Structures/requestarray.hpp"
 #include "Structures/types.hpp"
 
@@ -135,6 +136,16 @@ protected:
 	inline void sendRequest (
 		const OGSS_Ulong				idxRequest);
 
+/**
+ * Send an horizon to the execution in deterministic mode: the volume will not
+ * send any further request dated before it. It goes through the first device
+ * driver to keep its place in the volume stream.
+ *
+ * @param	date				Horizon date.
+ */
+	inline void sendHorizon (
+		const OGSS_Real			date);
+
 /**
  * Send the shared memory pointer to the device driver.
  */
@@ -208,6 +219,14 @@ protected:
 	std::map <OGSS_Real, OGSS_Ulong>	m_failedDevices;	/*!< List of failed
 															 devices with the
 															 failure date. */
+
+	OGSS_Bool					m_deterministic;		/*!< TRUE if the
+															 deterministic mode
+															 is on. */
+	OGSS_Ulong					m_sequence;				/*!< Next sequence
+															 number. */
+	OGSS_Real					m_horizonDate;			/*!< Last horizon
+															 received. */
 };
 
 inline void
@@ -255,6 +274,9 @@ IVolume::receiveRequest (
 
 	if (idxRequest == OGSS_ULONG_MAX)
 		return false;
+
+	if (idxRequest == OGSS_HORIZON)
+		m_horizonDate = ( (Horizon *) mess.data () ) ->m_date;
 	 
 	return true;
 }
@@ -269,11 +291,35 @@ IVolume::sendRequest (
 	memcpy ((void *) mess.data (), (void *) &idxRequest, 8);
 	iDev = m_requests->getIdxDevice (idxRequest);
 
+	// Fault events stop at the device driver, they are not in the stream
+	if (m_requests->getType (idxRequest) != RQT_FAULT)
+		m_requests->setSequence (idxRequest, m_sequence++);
+
 	if (! m_mapping [iDev] ->send (mess) )
 		DLOG(ERROR) << "[V" << m_idxVolume << "] Error with sending: "
 			<< strerror (errno);
 }
 
+inline void
+IVolume::sendHorizon (
+	const OGSS_Real				date)
+{
+	Horizon						horizon;
+	zmq::message_t				mess (sizeof (Horizon) );
+
+	if (! m_deterministic || m_mapping.empty () )
+		return;
+
+	horizon.m_marker = OGSS_HORIZON;
+	horizon.m_date = date;
+	horizon.m_sequence = m_sequence++;
+	horizon.m_idxVolume = m_idxVolume;
+
+	memcpy ((void *) mess.data (), (void *) &horizon, sizeof (Horizon) );
+
+	m_mapping.begin () ->second->send (mess);
+}
+
 inline void
 IVolume::sendWakeupRequest ()
 {
@@ -303,6 +349,8 @@ IVolume::retrieveInformation () {
 	m_zmqExecution = m_parent->m_zmqExecution;
 	m_zmqExecutionReply = m_parent->m_zmqExecutionReply;
 
+	m_deterministic = m_parent->m_deterministic;
+
 	m_idxParent = m_parent->m_idxVolume;
 }
 
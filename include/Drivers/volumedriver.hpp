@@ -46,6 +46,7 @@
 #include "LayoutModels/layoutmodel.hpp"
 
 #include "Structures/architecture.hpp"
+#include "Structures/volumecache.hpp"
 
 class VolumeDriver: public IVolume {
 public:
@@ -112,10 +113,37 @@ protected:
 		const OGSS_Real			date,
 		const OGSS_Ushort		idxDevice);
 
+/**
+ * Look the request up in the volume cache. A request served by the cache is
+ * completed at the volume.
+ *
+ * @param	idxRequest			Request index.
+ * @return						TRUE if the request is served by the cache.
+ */
+	OGSS_Bool lookupCache (
+		const OGSS_Ulong		idxRequest);
+
+/**
+ * Complete a request at the volume, without decomposing it: it is sent
+ * through the first device of the volume, and the execution turns it around
+ * at the volume.
+ *
+ * @param	idxRequest			Request index.
+ * @param	serviceTime			Service time at the volume.
+ */
+	void completeAtVolume (
+		const OGSS_Ulong		idxRequest,
+		const OGSS_Real			serviceTime);
+
 /**************************************/
 /* ATTRIBUTES *************************/
 /**************************************/
 	LayoutModel					* m_layout;				/*!< Layout model. */
+	VolumeCache					* m_cache;				/*!< Volume cache,
+															 NULL if none. */
+	OGSS_Bool					m_trimWarning;			/*!< A TRIM was
+															 completed by the
+															 volume. */
 };
 
 #endif
@@ -0,0 +1,185 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+
+/**
+ * @file	coordinator.hpp
+ * @brief	Coordinator is the class which drives a distributed simulation,
+ * where groups of tiers are simulated by separate OGSSim worker processes.
+ *
+ * The coordinator reads the whole trace and the whole architecture, does the
+ * redirection the PreProcessing would do and sends to each worker the request
+ * descriptors targeting its tiers, then releases the trace. Once the workers
+ * are done, it gathers their results and streams them to the global result
+ * file in request order, through a reorder window of bounded size.
+ *
+ * Workers only share the trace: a worker gets its full input, in date order,
+ * before starting, so it never receives a request dated in its past. The
+ * synchronization is thus conservative with an unbounded lookahead.
+ */
+
+#ifndef __OGSS_COORDINATOR_HPP__
+#define __OGSS_COORDINATOR_HPP__
+
+#include <fstream>
+#include <map>
+#include <vector>
+
+#include <zmq.hpp>
+
+#include "Modules/workload.hpp"
+
+#include "Structures/architecture.hpp"
+#include "Structures/distributed.hpp"
+#include "Structures/types.hpp"
+
+class Coordinator {
+public:
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+/**
+ * Default constructor which extracts the trace, the architecture and the
+ * worker descriptions, then binds the worker endpoints.
+ *
+ * @param	configurationFile	XML configuration file.
+ */
+	Coordinator (
+		const OGSS_String		& configurationFile);
+
+/**
+ * Destructor.
+ */
+	~Coordinator ();
+
+/**
+ * Build the mapping between the global address space and the workers. Each
+ * worker gets the contiguous address range of the volumes of its tiers.
+ */
+	void updateWorkerMapping ();
+
+/**
+ * Send the request descriptors to the workers. Each worker first receives
+ * its number of requests, then the descriptors by batches. The trace is
+ * released once it is sent.
+ */
+	void dispatchRequests ();
+
+/**
+ * Receive the results from the workers and write the global result file, by
+ * request index. The results which come before their turn wait in a window
+ * of bounded size; a result which comes after its turn, when the workers
+ * returned their results too far from the request order, is written out of
+ * order.
+ */
+	void collectResults ();
+
+private:
+/**************************************/
+/* PRIVATE FUNCTIONS ******************/
+/**************************************/
+/**
+ * Search the worker which owns an address.
+ *
+ * @param	address				Global address.
+ * @return						Worker index, OGSS_USHORT_MAX if none.
+ */
+	OGSS_Ushort searchWorker (
+		const OGSS_Ulong		address);
+
+/**
+ * Search the next result to write in the result file.
+ *
+ * @param	cursors				Next request of each worker to write.
+ * @param	owner				Worker of the result (output).
+ * @return						Request index, OGSS_ULONG_MAX if none.
+ */
+	OGSS_Ulong searchNextResult (
+		const std::vector <OGSS_Ulong>	& cursors,
+		OGSS_Ushort				& owner);
+
+/**
+ * Write a result in the result file and count it in the statistics.
+ *
+ * @param	resultFile			Result file.
+ * @param	result				Result, with its global index and volume.
+ */
+	void writeResult (
+		std::ofstream			& resultFile,
+		const ResultDescriptor	& result);
+
+/**
+ * Send a message to a worker.
+ *
+ * @param	idxWorker			Worker index.
+ * @param	data				Message content.
+ * @param	size				Message size.
+ */
+	void sendToWorker (
+		const OGSS_Ushort		idxWorker,
+		const void				* data,
+		const size_t			size);
+
+/**************************************/
+/* ATTRIBUTES *************************/
+/**************************************/
+	OGSS_String					m_configurationFile;	/*!< Configuration
+															 file. */
+
+	std::vector <WorkerDescription>	m_workers;			/*!< Workers. */
+	std::vector <OGSS_Ulong>	m_bases;				/*!< First address of
+															 each worker. */
+	std::vector <OGSS_Ushort>	m_firstVolumes;			/*!< First volume of
+															 each worker. */
+	std::vector < std::vector <OGSS_Ulong> >	m_globalIds;	/*!< Global
+															 index of the
+															 requests sent to
+															 each worker. */
+	std::map <OGSS_Ulong, OGSS_Ushort>	m_redirectionTable;	/*!< Address
+															 upper bound to
+															 worker. */
+
+	zmq::context_t				m_context;				/*!< ZMQ context. */
+	std::vector <zmq::socket_t *>	m_requestSockets;	/*!< Sockets to the
+															 workers. */
+	std::vector <zmq::socket_t *>	m_resultSockets;	/*!< Sockets from the
+															 workers. */
+
+	Workload					* m_workload;			/*!< Trace, NULL once
+															 it is sent. */
+
+	OGSS_Ulong					m_numRequests;			/*!< Number of
+															 requests of the
+															 trace. */
+	OGSS_Ulong					m_numResults;			/*!< Written
+															 results. */
+	OGSS_Ulong					m_numFaulty;			/*!< Faulty
+															 results. */
+	OGSS_Real					m_sumResponseTime;		/*!< Sum of the
+															 response times. */
+	OGSS_Real					m_totalExecutionTime;	/*!< End of the last
+															 request. */
+	Architecture				* m_architecture;		/*!< Architecture. */
+};
+
+#endif
@@ -33,20 +33,32 @@
 #ifndef __OGSS_EXECUTION_HPP__
 #define __OGSS_EXECUTION_HPP__
 
+#include <algorithm>
+#include <deque>
 #include <fstream>
+#include <limits>
 #include <map>
 #include <queue>
 #include <set>
+#include <vector>
 
 #include <zmq.hpp>
 
 #include "ComputationModels/computationmodel.hpp"
+#include "ComputationModels/devicecache.hpp"
+#include "ComputationModels/devicequeue.hpp"
+#include "ComputationModels/qosscheduler.hpp"
 
 #include "Structures/architecture.hpp"
+#include "Structures/horizon.hpp"
 #include "Structures/requestarray0.hpp"
 #include "Structures/requestarray1.hpp"
 #include "Structures/requestarray2.hpp"
 
+#include "Utils/chrono.hpp"
+#include "Utils/eventtrace.hpp"
+#include "Utils/livestats.hpp"
+
 class Execution {
 public:
 /**************************************/
@@ -88,10 +100,65 @@ private:
 	void initReplyZMQ ();
 
 /**
- * Receive request from device.
- * @return						Request index.
+ * Delivery stored by the merge stage in deterministic mode.
+ */
+	struct Delivery {
+		OGSS_Real				m_date;				/*!< Request date. */
+		OGSS_Ulong				m_idxRequest;		/*!< Request index, or
+														 OGSS_HORIZON. */
+	};
+
+/**
+ * Receive message from device.
+ * @param	msg					Received message.
+ * @return						FALSE if the reception timed out.
+ */
+	OGSS_Bool receiveRequest (
+		zmq::message_t			& msg);
+
+/**
+ * Treat a request and return the released credits. Fake requests are
+ * ignored.
+ * @param	idxRequest			Request index.
+ */
+	void dispatchRequest (
+		const OGSS_Ulong		idxRequest);
+
+/**
+ * Initialize the merge stage used in deterministic mode: one stream per
+ * volume driver, which is not a subvolume.
+ */
+	void initMerge ();
+
+/**
+ * Store a delivery in the stream of its volume. Deliveries are put back in
+ * sequence order before being merged.
+ * @param	idxVolume			Volume index.
+ * @param	sequence			Sequence number in the volume stream.
+ * @param	delivery			Delivery.
+ */
+	void deliverRequest (
+		const OGSS_Ushort		idxVolume,
+		const OGSS_Ulong		sequence,
+		const Delivery			& delivery);
+
+/**
+ * Release the deliveries in (date, volume, sequence) order. A delivery is
+ * released only if no idle volume can still send a lower one.
+ * @param	force				TRUE to release out of order while volumes are
+ *								blocked, to prevent a deadlock.
+ */
+	void releaseDeliveries (
+		const OGSS_Bool			force);
+
+/**
+ * Remove or insert a volume in the merge sets, depending on its state.
+ * @param	idxVolume			Volume index.
+ * @param	insert				TRUE to insert, FALSE to remove.
  */
-	OGSS_Ulong receiveRequest ();
+	inline void updateMergeState (
+		const OGSS_Ushort		idxVolume,
+		const OGSS_Bool			insert);
 
 /**
  * Execute the right process depending on the request type.
@@ -109,6 +176,35 @@ private:
 		const OGSS_Ulong		idxRequest,
 		const OGSS_Ushort		idxDevice);
 
+/**
+ * Account the service time of a request and give it to the bus model.
+ * @param	idxRequest			Request index.
+ * @param	serviceTime			Service time.
+ */
+	void releaseEffectiveRequest (
+		const OGSS_Ulong		idxRequest,
+		const OGSS_Real			serviceTime);
+
+/**
+ * Release all the requests held by the device command queues and the QoS
+ * schedulers.
+ */
+	void flushDeviceQueues ();
+
+/**
+ * Log the requests of each QoS class which waited for their rate limit.
+ */
+	void logQoSStatistics ();
+
+/**
+ * Get the model which computes the service time of a device: its cache if
+ * modeled, else the device model.
+ * @param	idxDevice			Device index.
+ * @return						Computation model.
+ */
+	inline ComputationModel * getDeviceModel (
+		const OGSS_Ushort		idxDevice) const;
+
 /**
  * Send a wake up request to the given volume.
  * @param	idxVolume			Volume index.
@@ -116,11 +212,69 @@ private:
 	inline void wakeupVolumeDriver (
 		const OGSS_Ushort		idxVolume);
 
+/**
+ * Register a volume driver which cannot find a free subrequest slot. It
+ * will be woken up once enough of its credits are returned.
+ * @param	idxVolume			Volume index.
+ */
+	void blockVolumeDriver (
+		const OGSS_Ushort		idxVolume);
+
+/**
+ * Wake up a blocked volume driver and account its stall time.
+ * @param	idxVolume			Volume index.
+ */
+	void unblockVolumeDriver (
+		const OGSS_Ushort		idxVolume);
+
+/**
+ * Take the credit of a subrequest sent by a volume: it is returned when the
+ * slot of the subrequest is released.
+ * @param	idxRequest			Request index.
+ */
+	inline void takeCredit (
+		const OGSS_Ulong		idxRequest);
+
+/**
+ * Return the credits of the slots released by the bus model.
+ */
+	void returnCredits ();
+
+/**
+ * Return the credit of a released subrequest slot to its volume, and wake
+ * up the volume if it has now enough credits to go on. A volume which has no
+ * subrequest in flight can not get its own credits back: it takes the
+ * credits of the other volumes, in FIFO order.
+ * @param	idxRequest			Request index.
+ */
+	void returnCredit (
+		const OGSS_Ulong		idxRequest);
+
+/**
+ * Get the number of credits a blocked volume needs before being woken up.
+ * @param	idxVolume			Volume index.
+ * @return						Credit grant.
+ */
+	inline OGSS_Ulong getCreditGrant (
+		const OGSS_Ushort		idxVolume);
+
 /**
  * Initialize the computation models which will be used.
  */
 	void initComputationModels ();
 
+/**
+ * Initialize the live statistics if a stream is configured, and give them to
+ * the bus computation model.
+ */
+	void initLiveStats ();
+
+/**
+ * Log the share of time each bus spent in each state, and write the bus
+ * profiles if an output is configured, one "bus date state" line by entry.
+ */
+	void exportBusProfiles ();
+
 /**
  * Send a wake up request to the performance module.
  */
@@ -142,15 +296,91 @@ private:
 	std::map < OGSS_Ushort, zmq::socket_t * >
 								m_zmqVDReply;
 
-	std::map < OGSS_Ushort, OGSS_Ulong >	m_wakeupVD;
+	std::vector < OGSS_Bool >	m_blockedVD;		/*!< Blocked volumes. */
+	OGSS_Ushort					m_numBlockedVD;		/*!< Number of blocked
+														 volumes. */
+	std::vector < OGSS_Ulong >	m_credits;			/*!< Credits returned to
+														 each blocked
+														 volume. */
+	std::vector < OGSS_Ulong >	m_inFlight;			/*!< Subrequests in
+														 flight by volume. */
+	std::vector < OGSS_Ushort >	m_slotVolume;		/*!< Volume of each
+														 subrequest slot in
+														 flight. */
+	std::deque < OGSS_Ushort >	m_starvedVD;		/*!< Blocked volumes
+														 without subrequest in
+														 flight (FIFO). */
+	OGSS_Ulong					m_sharedCredits;	/*!< Credits given to the
+														 starved volumes. */
+	std::vector < OGSS_Ulong >	m_releasedSlots;	/*!< Slots released by
+														 the bus model. */
+	std::vector < Chrono >		m_stallChrono;		/*!< Stall chronos. */
+	std::vector < int64_t >		m_stallTime;		/*!< Stall times (us). */
+
+	OGSS_Bool					m_deterministic;	/*!< Deterministic mode. */
+	std::vector < std::map < OGSS_Ulong, Delivery > >
+								m_pending;			/*!< Out of sequence
+														 deliveries. */
+	std::vector < OGSS_Ulong >	m_nextSequence;		/*!< Next sequence. */
+	std::vector < std::deque < Delivery > >
+								m_ready;			/*!< Deliveries waiting
+														 for the merge. */
+	std::vector < OGSS_Real >	m_horizon;			/*!< Volume horizons. */
+	std::set < std::pair < OGSS_Real, OGSS_Ushort > >
+								m_heads;			/*!< Heads of the
+														 non-empty streams. */
+	std::set < std::pair < OGSS_Real, OGSS_Ushort > >
+								m_idleBounds;		/*!< Horizons of the
+														 empty streams. */
+	OGSS_Ulong					m_unorderedReleases;/*!< Deliveries released
+														 out of order. */
+
+	OGSS_Real					m_streamInterval;	/*!< Live statistics
+														 interval. */
+	OGSS_String					m_streamOutput;		/*!< Live statistics
+														 output. */
+	LiveStats					* m_liveStats;		/*!< Live statistics. */
+
+	OGSS_Ulong					m_busProfileCapacity;/*!< Max number of
+														 entries by bus
+														 profile, 0 for the
+														 default one. */
+	OGSS_String					m_busProfileOutput;	/*!< Bus profile
+														 output. */
+
+	OGSS_String					m_traceOutput;		/*!< Event trace file. */
+	OGSS_String					m_traceComponents;	/*!< Traced
+														 components. */
 
 	RequestArray				* m_requests;
 	Architecture				* m_architecture;
 
+	std::vector < DeviceQueue * >
+								m_deviceQueues;		/*!< Command queues, NULL
+														 without NCQ. */
+	std::vector < QoSScheduler * >
+								m_qosSchedulers;	/*!< QoS schedulers, NULL
+														 without QoS
+														 classes. */
+	std::vector < DeviceCache * >
+								m_deviceCaches;		/*!< Device caches, NULL
+														 if not modeled. */
+	std::vector < ComputationModel * >
+								m_deviceModels;		/*!< Model of each
+														 device. */
+
 	ComputationModel			* m_cmDisks [DVT_TOTAL];
 	ComputationModel			* m_cmBus;
 };
 
+inline ComputationModel *
+Execution::getDeviceModel (
+	const OGSS_Ushort		idxDevice) const {
+	if (m_deviceCaches [idxDevice] != NULL)
+		return m_deviceCaches [idxDevice];
+	return m_cmDisks [m_architecture->m_devices [idxDevice] .m_type];
+}
+
 inline void
 Execution::receiveData () {
 	zmq::message_t				msgRequest;
@@ -163,7 +393,18 @@ Execution::receiveData () {
 	m_architecture = * (Architecture **) msgArchitecture.data ();
 
 	initComputationModels ();
+	initLiveStats ();
 	initReplyZMQ ();
+	initMerge ();
+
+	m_blockedVD.assign (m_architecture->m_geometry->m_numVolumes, false);
+	m_credits.assign (m_architecture->m_geometry->m_numVolumes, 0);
+	m_inFlight.assign (m_architecture->m_geometry->m_numVolumes, 0);
+	m_slotVolume.assign (m_requests->getNumSubrequests (), OGSS_USHORT_MAX);
+	m_stallChrono.resize (m_architecture->m_geometry->m_numVolumes);
+	m_stallTime.assign (m_architecture->m_geometry->m_numVolumes, 0);
+
+	m_cmBus->setReleasedSlots (& m_releasedSlots);
 }
 
 inline void
@@ -177,6 +418,51 @@ Execution::wakeupVolumeDriver (
 	m_zmqVDReply [idxVolume] ->send (msg);
 }
 
+inline void
+Execution::updateMergeState (
+	const OGSS_Ushort			idxVolume,
+	const OGSS_Bool				insert) {
+	std::pair < OGSS_Real, OGSS_Ushort >	key;
+
+	if (! m_ready [idxVolume] .empty () ) {
+		key = std::make_pair (m_ready [idxVolume] .front () .m_date, idxVolume);
+
+		if (insert) m_heads.insert (key);
+		else m_heads.erase (key);
+	} else {
+		key = std::make_pair (m_horizon [idxVolume], idxVolume);
+
+		// A finished volume is no more an idle one
+		if (! insert) m_idleBounds.erase (key);
+		else if (key.first != std::numeric_limits <OGSS_Real> ::infinity () )
+			m_idleBounds.insert (key);
+	}
+}
+
+inline void
+Execution::takeCredit (
+	const OGSS_Ulong			idxRequest) {
+	OGSS_Ushort					idxVolume;
+
+	if (idxRequest < m_requests->getNumRequests () ) return;
+
+	idxVolume = m_architecture->m_devices [
+		m_requests->getIdxDevice (idxRequest)] .m_idxVolume;
+
+	m_slotVolume [idxRequest - m_requests->getNumRequests ()] = idxVolume;
+	m_inFlight [idxVolume] ++;
+}
+
+inline OGSS_Ulong
+Execution::getCreditGrant (
+	const OGSS_Ushort			idxVolume) {
+	OGSS_Ulong					grant;
+
+	grant = m_architecture->m_volumes [idxVolume] .m_numDevices + 1;
+
+	return std::min (grant, m_requests->getNumSubrequests () );
+}
+
 inline void
 Execution::wakeupPerformanceModule () {
 	char						a ='0';
@@ -38,6 +38,8 @@
 #include "Structures/architecture.hpp"
 #include "Structures/requestarray.hpp"
 
+#include "Utils/livestats.hpp"
+
 #include "XMLParsers/xmlparser.hpp"
 
 class PerformanceEvaluation {
@@ -67,6 +69,23 @@ public:
 	void process ();
 
 private:
+/**
+ * Statistics of the requests of a color.
+ */
+	struct ColorStatistics {
+		OGSS_Ulong				m_numRequests;		/*!< Requests. */
+		OGSS_Ulong				m_volume;			/*!< Transfered bytes. */
+		OGSS_Real				m_first;			/*!< First arrival. */
+		OGSS_Real				m_last;				/*!< Last completion. */
+		OGSS_Real				m_sumLatency;		/*!< Sum of the response
+														 times. */
+		OGSS_Ulong				m_histogram [LiveStats::NUM_BUCKETS];
+													/*!< Latency histogram,
+														 bucket b counts the
+														 response times lower
+														 than 2^b us. */
+	};
+
 /**************************************/
 /* PRIVATE FUNCTIONS ******************/
 /**************************************/
@@ -87,6 +106,18 @@ private:
  */
 	void processGeneration ();
 
+/**
+ * Log the throughput and the latency of each host, if the system has more
+ * than the default one.
+ */
+	void logHostStatistics ();
+
+/**
+ * Log the throughput and the latency histogram of each color, if the trace
+ * has colors.
+ */
+	void logColorStatistics ();
+
 /**************************************/
 /* ATTRIBUTES *************************/
 /**************************************/
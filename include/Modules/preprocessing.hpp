@@ -45,6 +45,7 @@
 
 #include "Structures/architecture.hpp"
 #include "Structures/event.hpp"
+#include "Structures/horizon.hpp"
 #include "Structures/requestarray0.hpp"
 #include "Structures/requestarray1.hpp"
 #include "Structures/requestarray2.hpp"
@@ -136,6 +137,14 @@ private:
 		const OGSS_Ulong		idxRequest,
 		const OGSS_Ulong		idxVolumeDriver);
 
+/**
+ * Send an horizon to all volume drivers in deterministic mode: no further
+ * request dated before it will be redirected.
+ * @param	date				Horizon date.
+ */
+	inline void sendHorizon (
+		const OGSS_Real			date);
+
 	void DBG_printEventList ();
 
 /**************************************/
@@ -164,6 +173,13 @@ private:
 	std::vector < std::thread * >
 								m_threads;				/*!< Volume driver
 															 threads. */
+
+	OGSS_Bool					m_deterministic;		/*!< TRUE if the
+															 deterministic mode
+															 is on. */
+	OGSS_Real					m_quantum;				/*!< Simulated time
+															 between two
+															 horizons. */
 };
 
 /**************************************/
@@ -243,4 +259,24 @@ PreProcessing::sendRequest (
 	m_mapping [idxVolumeDriver] ->send (mgsRequest);
 }
 
+inline void
+PreProcessing::sendHorizon (
+	const OGSS_Real				date) {
+	Horizon						horizon;
+
+	horizon.m_marker = OGSS_HORIZON;
+	horizon.m_date = date;
+	horizon.m_sequence = 0;
+	horizon.m_idxVolume = 0;
+
+	for (auto elt: m_mapping) {
+		zmq::message_t			msgHorizon (sizeof (Horizon) );
+
+		memcpy ((void *) msgHorizon.data (), (void *) &horizon,
+			sizeof (Horizon) );
+
+		elt.second->send (msgHorizon);
+	}
+}
+
 #endif
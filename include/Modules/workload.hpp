@@ -49,12 +49,16 @@ public:
 /**
  * Default constructor.
  * 
- * If the trace file does not exist, an exception is thrown.
+ * If the trace file does not exist, an exception is thrown. In remote mode,
+ * the requests are not read from the trace file but received from the
+ * coordinator of a distributed simulation.
  *
  * @param	configurationFile	XML configuration file.
+ * @param	remote				TRUE if the process is a worker.
  */
 	Workload (
-		const OGSS_String		& configurationFile);
+		const OGSS_String		& configurationFile,
+		const OGSS_Bool			remote = false);
 
 /**
  * Destructor.
@@ -79,6 +83,24 @@ public:
  */
 	inline void	sendData ();
 
+/**
+ * Get the request array, for modules which use the workload outside of the
+ * simulation threads.
+ *
+ * @return						Request array.
+ */
+	inline RequestArray * getRequests ();
+
+/**
+ * Send the results of a worker back to the coordinator. The result file
+ * written by the Execution is read again, so that the coordinator gets
+ * exactly what a single process simulation would have written.
+ *
+ * @param	configurationFile	XML configuration file.
+ */
+	static void returnResults (
+		const OGSS_String		& configurationFile);
+
 private:
 /**************************************/
 /* PRIVATE FUNCTIONS ******************/
@@ -100,6 +122,12 @@ private:
 	OGSS_Ushort extractRequestFormat (
 		const OGSS_String		& filename);
 
+/**
+ * Receive the requests from the coordinator of a distributed simulation.
+ * The request array is sized with the header sent by the coordinator.
+ */
+	void receiveRequests ();
+
 /**
  * Extract requests of type 0.
  * @param	filename			Workload file.
@@ -159,4 +187,8 @@ Workload::sendData ()
 	socket.close ();
 }
 
+RequestArray *
+Workload::getRequests ()
+	{ return m_requests; }
+
 #endif
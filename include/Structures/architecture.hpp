@@ -29,10 +29,17 @@
 #ifndef __OGSS_ARCHITECTURE_HPP__
 #define __OGSS_ARCHITECTURE_HPP__
 
+#include <cmath>
+#include <utility>
 #include <vector>
 
 #include "Structures/types.hpp"
 
+class Fabric;
+class FlashTranslationLayer;
+class NVMeController;
+class ShingledZones;
+
 /**
  * Bus is the structure which represents a hardware bus. It allows the data
  * transmission.
@@ -54,6 +61,21 @@ struct Bus {
 								m_profile;			/*!< Utilization profile. */
 	OGSS_Real					m_lastProfileEntry;	/*!< Last time entry in the
 														 bus profile. */
+	OGSS_Ulong					m_profileCapacity;	/*!< Max number of profile
+														 entries, 0 if the
+														 profile is off. */
+	OGSS_Real					m_profileResolution;/*!< Size of the profile
+														 bins, 0 while the
+														 profile is exact. */
+	OGSS_Real					m_profileBin;		/*!< Start of the open
+														 profile bin. */
+	OGSS_Real					m_profileDate;		/*!< Date of the last
+														 state change. */
+	BusStateType				m_profileState;		/*!< Current state. */
+	OGSS_Real					m_profileTime [BSS_TOTAL];
+													/*!< Time spent in each
+														 state in the open
+														 bin. */
 
 /**
  * Default constructor which gets parameters extracted from an XML file.
@@ -73,6 +95,107 @@ struct Bus {
  * Check if the bus can have another device connected to it.
  */
 	void addDevice ();
+
+/**
+ * Record a transfer in the utilization profile. The transfers of a bus are
+ * serialized: a transfer starts at its arrival date or at the end of the
+ * previous one, and its state depends on the time it waited.
+ *
+ * @param		date			Arrival date of the transfer.
+ * @param		transferTime	Transfer time.
+ */
+	void recordTransfer (
+		const OGSS_Real			date,
+		const OGSS_Real			transferTime);
+
+/**
+ * Close the open bin of the utilization profile, at the end of the
+ * simulation.
+ */
+	void closeProfile ();
+
+/**
+ * Add a state change to the utilization profile. The profile is exact until
+ * its first downsampling, then its entries are bins which keep the state the
+ * bus spent the most time in.
+ *
+ * @param		date			Date of the change.
+ * @param		state			New state.
+ */
+	void addProfileEntry (
+		const OGSS_Real			date,
+		const BusStateType		state);
+
+/**
+ * Account the current state until a date in the profile bins, and close the
+ * bins which end before it.
+ *
+ * @param		date			Date.
+ */
+	void advanceProfile (
+		const OGSS_Real			date);
+
+/**
+ * Add the open bin to the profile with its main state.
+ */
+	void closeProfileBin ();
+
+/**
+ * Add an entry to the profile if its state is not the one of the last entry.
+ *
+ * @param		date			Date of the entry.
+ * @param		state			State.
+ */
+	void pushProfileEntry (
+		const OGSS_Real			date,
+		const BusStateType		state);
+
+/**
+ * Halve the number of profile entries by doubling the bin size and adding
+ * them again.
+ */
+	void downsampleProfile ();
+};
+
+/**
+ * Host is an initiator of the requests, identified by the host field of the
+ * traces in format 2. The host 0 is the default one: it sends the requests of
+ * the other traces and of the undeclared identifiers, without adapter nor
+ * limit.
+ */
+struct Host {
+	unsigned					m_id;				/*!< Identifier in the
+														 trace. */
+	OGSS_Ushort					m_idxBus;			/*!< Host adapter bus,
+														 OGSS_USHORT_MAX if
+														 none. */
+	OGSS_Ulong					m_bufferSize;		/*!< Buffer size, 0 if
+														 unlimited. */
+	unsigned					m_maxOutstanding;	/*!< Max number of
+														 requests in flight,
+														 0 if unlimited. */
+	OGSS_Ushort					m_idxFabricNode;	/*!< Fabric node,
+														 OGSS_USHORT_MAX for
+														 the fabric host. */
+};
+
+/**
+ * QoSClass gathers the requests of a color (tenant or application), given by
+ * the color field of the traces in format 1, in the schedulers which are in
+ * front of the devices. The class 0 is the default one: it gets the requests
+ * of the other traces and of the undeclared colors.
+ */
+struct QoSClass {
+	unsigned					m_color;			/*!< Color in the trace. */
+	int							m_priority;			/*!< Priority level, the
+														 highest is served
+														 first. */
+	OGSS_Real					m_weight;			/*!< Share of the device
+														 in its level. */
+	OGSS_Real					m_rate;				/*!< Rate limit by device
+														 in MB/s, 0 if
+														 unlimited. */
+	OGSS_Ulong					m_burst;			/*!< Token bucket size. */
 };
 
 /**
@@ -144,8 +267,28 @@ struct Volume {
 	OGSS_Ushort					m_numDevices;		/*!< Number of devices. */
 	OGSS_Ushort					m_idxDevices;		/*!< First device index. */
 	OGSS_Ulong					m_bufferSize;		/*!< Buffer size. */
+	OGSS_Ushort					m_idxFabricNode;	/*!< Fabric target of the
+														 volume,
+														 OGSS_USHORT_MAX if it
+														 is reached by the
+														 tier bus. */
+
+	OGSS_Ulong					m_cacheSize;		/*!< Cache size, 0 if no
+														 cache. */
+	OGSS_Ulong					m_cacheBlockSize;	/*!< Cache block size. */
+	CachePolicyType				m_cachePolicy;		/*!< Replacement policy. */
+	OGSS_Bool					m_cacheWriteBack;	/*!< Writes are absorbed
+														 by the cache. */
+	OGSS_Real					m_cacheLatency;		/*!< Cache hit time. */
+	OGSS_Real					m_cacheDirtyRatio;	/*!< Max dirty part of
+														 the cache. */
+	OGSS_Real					m_cacheFlushRate;	/*!< Destage rate, in
+														 bytes by ms. */
 };
 
+struct SeekCurve;
+struct ZoneTable;
+
 /**
  * HDDDevice is the structure which implements a HDD device kind.
  */
@@ -180,13 +323,149 @@ struct HDDDevice {
 	OGSS_Bool					m_ataExtended;		/*!< Extended set of ATA. */
 	OGSS_Bool					m_ataNCQ;			/*!< NCQ set of ATA. */
 	unsigned					m_ataNCQDepth;		/*!< NCQ depth. */
+	QueuePolicyType				m_ataNCQPolicy;		/*!< NCQ reordering
+														 policy. */
 
 	OGSS_Ulong					m_sataBandwidth;	/*!< SATA bandwidth. */
 
 	OGSS_Ulong					m_trackPosition;	/*!< Last track position. */
 	OGSS_Ulong					m_headPosition;		/*!< Last head position. */
+	OGSS_Real					m_transferEnd;		/*!< Date the head left
+														 the last transferred
+														 sector. */
+
+	const SeekCurve				* m_seekCurve;		/*!< Seek curve, shared by
+														 identical devices. */
+	ZoneTable					* m_zoneTable;		/*!< Recording zones, NULL
+														 if not zoned. */
+
+	ZoneManagementType			m_smrManagement;	/*!< Zone management
+														 (SMR). */
+	OGSS_Ulong					m_smrZoneSize;		/*!< Size of a shingled
+														 zone (SMR). */
+	OGSS_Ulong					m_smrMediaCacheSize;/*!< Size of the media
+														 cache (SMR). */
+	OGSS_Real					m_smrCleaningThreshold;	/*!< Media cache
+														 ratio which triggers
+														 the band cleaning
+														 (SMR). */
+	ShingledZones				* m_smrZones;		/*!< Zone states, NULL if
+														 not SMR. */
+};
+
+/**
+ * Zone is a set of contiguous tracks of a HDD which have the same number of
+ * sectors (zoned bit recording).
+ */
+struct Zone {
+	OGSS_Ulong					m_firstTrack;		/*!< First track. */
+	OGSS_Ulong					m_firstSector;		/*!< First sector of the
+														 platter. */
+	unsigned					m_sectorsByTrack;	/*!< Number of sectors per
+														 track. */
+	OGSS_Real					m_mediaTransferRate;/*!< Transfer rate, 0 for
+														 the device one. */
 };
 
+/**
+ * ZoneTable is the list of the zones of a HDD platter, from the outer to the
+ * inner tracks.
+ */
+struct ZoneTable {
+	std::vector < Zone >		m_zones;			/*!< Zones. */
+	OGSS_Ulong					m_numTracks;		/*!< Number of tracks per
+														 platter. */
+	OGSS_Ulong					m_numSectors;		/*!< Number of sectors per
+														 platter. */
+
+/**
+ * Search the zone which contains a sector of the platter.
+ *
+ * @param	sector				Sector of the platter.
+ * @return						Zone.
+ */
+	const Zone & searchBySector (
+		const OGSS_Ulong		sector) const;
+
+/**
+ * Search the zone which contains a track.
+ *
+ * @param	track				Track.
+ * @return						Zone.
+ */
+	const Zone & searchByTrack (
+		const OGSS_Ulong		track) const;
+};
+
+/**
+ * SeekCurve holds the coefficients of the seek time formula of a HDD model,
+ * seek (d) = a * sqrt (d) + b * d + c for a distance d > 0 (in cylinders).
+ * They are computed once when the architecture is loaded and shared by the
+ * identical devices.
+ */
+struct SeekCurve {
+	unsigned					m_numCylinders;		/*!< Number of cylinders. */
+	OGSS_Real					m_minRSeekTime;		/*!< Min read seek time. */
+	OGSS_Real					m_avgRSeekTime;		/*!< Avg read seek time. */
+	OGSS_Real					m_maxRSeekTime;		/*!< Max read seek time. */
+	OGSS_Real					m_minWSeekTime;		/*!< Min write seek time. */
+	OGSS_Real					m_avgWSeekTime;		/*!< Avg write seek time. */
+	OGSS_Real					m_maxWSeekTime;		/*!< Max write seek time. */
+
+	OGSS_Real					m_readA;			/*!< Read sqrt coefficient. */
+	OGSS_Real					m_readB;			/*!< Read linear
+														 coefficient. */
+	OGSS_Real					m_readC;			/*!< Read constant. */
+	OGSS_Real					m_writeA;			/*!< Write sqrt
+														 coefficient. */
+	OGSS_Real					m_writeB;			/*!< Write linear
+														 coefficient. */
+	OGSS_Real					m_writeC;			/*!< Write constant. */
+
+/**
+ * Constructor which computes the coefficients from the device seek
+ * parameters.
+ *
+ * @param	device				HDD device.
+ */
+	SeekCurve (
+		const HDDDevice			& device);
+
+/**
+ * Check if the curve was computed from the same parameters.
+ *
+ * @param	device				HDD device.
+ * @return						TRUE if the curve can be used by the device.
+ */
+	OGSS_Bool matches (
+		const HDDDevice			& device) const;
+
+/**
+ * Get the seek time of a distance.
+ *
+ * @param	dist				Seek distance (in cylinders).
+ * @param	write				TRUE for a write seek.
+ * @return						Seek time.
+ */
+	inline OGSS_Real seekTime (
+		const OGSS_Ulong		dist,
+		const OGSS_Bool			write) const;
+};
+
+inline OGSS_Real
+SeekCurve::seekTime (
+	const OGSS_Ulong		dist,
+	const OGSS_Bool			write) const {
+	if (dist == 0)
+		return .0;
+
+	if (write)
+		return m_writeA * sqrt ( (OGSS_Real) dist) + m_writeB * dist
+			+ m_writeC;
+
+	return m_readA * sqrt ( (OGSS_Real) dist) + m_readB * dist + m_readC;
+}
+
 /**
  * SSDDevice is the structure which implements a SSD device kind.
  */
@@ -198,6 +477,9 @@ struct SSDDevice {
 	unsigned					m_blockSize;		/*!< Size of block. */
 	unsigned					m_planeSize;		/*!< Size of plane. */
 	unsigned					m_numDies;			/*!< Number of dies. */
+	unsigned					m_numChannels;		/*!< Number of channels,
+														 0 if the dies are
+														 not modeled. */
 
 	unsigned					m_pagesByBlock;		/*!< Number of pages
 														 by block. */
@@ -209,10 +491,14 @@ struct SSDDevice {
 	float						m_sequentialReadTime;	/*!< Seq read time. */
 	float						m_sequentialWriteTime;	/*!< Seq write time. */
 	float						m_eraseTime;		/*!< Erase time. */
+	float						m_channelTime;		/*!< Page transfer time
+														 on a channel. */
 
 	OGSS_Bool					m_ataExtended;		/*!< Extended set of ATA. */
 	OGSS_Bool					m_ataNCQ;			/*!< NCQ set of ATA. */
 	unsigned					m_ataNCQDepth;		/*!< NCQ depth. */
+	QueuePolicyType				m_ataNCQPolicy;		/*!< NCQ reordering
+														 policy. */
 
 	OGSS_Ulong					m_sataBandwidth;	/*!< SATA bandwidth. */
 
@@ -225,11 +511,48 @@ struct SSDDevice {
 
 	OGSS_Ulong					* m_lastPageSeen;	/*!< Last page seen for
 													   a chip.*/
+	OGSS_Real					* m_dieClock;		/*!< Busy-until date by
+														 die. */
+	OGSS_Real					* m_channelClock;	/*!< Busy-until date by
+														 channel. */
+
+	OGSS_Real					m_overprovisioning;	/*!< Over-provisioning
+														 ratio (FTL). */
+	GCPolicyType				m_gcPolicy;			/*!< Garbage collection
+														 policy (FTL). */
+	OGSS_Real					m_gcThreshold;		/*!< Free block ratio
+														 which triggers the
+														 GC (FTL). */
+	FlashTranslationLayer		* m_ftl;			/*!< Page-mapped FTL, NULL
+														 if not modeled. */
+
+	unsigned					m_nvmeNumQueues;	/*!< Number of submission
+														 queues (NVMe). */
+	unsigned					m_nvmeQueueDepth;	/*!< Submission queue
+														 depth (NVMe). */
+	ArbitrationType				m_nvmeArbitration;	/*!< Queue arbitration
+														 (NVMe). */
+	unsigned					m_nvmeHighQueues;	/*!< High priority
+														 queues (NVMe). */
+	unsigned					m_nvmeMediumQueues;	/*!< Medium priority
+														 queues (NVMe). */
+	unsigned					m_nvmeWeights [3];	/*!< High, medium and low
+														 priority weights
+														 (NVMe). */
+	OGSS_Real					m_nvmeCommandTime;	/*!< Controller time by
+														 command (NVMe). */
+	unsigned					m_nvmeLanes;		/*!< PCIe lanes (NVMe). */
+	OGSS_Real					m_nvmeLaneBandwidth;/*!< Bandwidth by lane,
+														 in MB/s (NVMe). */
+	NVMeController				* m_nvme;			/*!< Queue and link
+														 states, NULL if not
+														 NVMe. */
 };
 
 /**
  * Hardware is a union which allows the system to use a SSD or a
- * HDD. Other devices can be added in further versions.
+ * HDD. The SMR devices use the HDD kind, the NVMe devices the SSD kind. Other
+ * devices can be added in further versions.
  */
 union DeviceHardware {
 	HDDDevice					m_hdd;				/*!< HDD kind. */
@@ -246,18 +569,45 @@ struct Device {
 	OGSS_Ushort					m_idxVolume;		/*!< Index of parent
 														 volume. */
 	OGSS_Real					m_clock;			/*!< Device clock. */
+	OGSS_Bool					m_parallel;			/*!< The device serves
+														 its requests
+														 concurrently, it is
+														 not serialized on
+														 its clock. */
 	OGSS_Real					m_workingTime;		/*!< Device working time. */
 	OGSS_Ulong					m_idxLastRequest;	/*!< Last request processed
 														 by the device. */
 	OGSS_Ulong					m_bufferSize;		/*!< Size of buffer. */
+	OGSS_Ulong					m_cacheSegmentSize;	/*!< Size of a cache
+														 segment, 0 if the
+														 cache is not
+														 modeled. */
+	unsigned					m_cacheReadAhead;	/*!< Segments read after
+														 a miss. */
+	OGSS_Bool					m_cacheWriteBack;	/*!< Write-back mode. */
+	OGSS_Real					m_cacheLatency;		/*!< Cache hit latency. */
+
+/**
+ * Check if the device uses the SSD hardware kind.
+ *
+ * @return						TRUE for a SSD or a NVMe device.
+ */
+	inline OGSS_Bool isFlash () const;
 };
 
+inline OGSS_Bool
+Device::isFlash () const
+	{ return m_type == DVT_SSD || m_type == DVT_NVME; }
+
 /**
  * Geometry is the structure which gets information about the
  * system size. It also gets the information about the host/tiers bus.
  */
 struct Geometry {
 	OGSS_Ushort					m_numBuses;			/*!< Number of buses. */
+	OGSS_Ushort					m_numHosts;			/*!< Number of hosts,
+														 with the default
+														 one. */
 	OGSS_Ushort					m_numTiers;			/*!< Number of tiers. */
 	OGSS_Ushort					m_numVolumes;		/*!< Number of volumes. */
 	OGSS_Ushort					m_numDevices;		/*!< Number of devices. */
@@ -272,11 +622,30 @@ struct Geometry {
 struct Architecture {
 	Geometry					* m_geometry;		/*!< Geometry. */
 	Bus							* m_buses;			/*!< Buses. */
+	Host						* m_hosts;			/*!< Hosts. */
+	std::vector < std::pair < unsigned, OGSS_Ushort > >
+								m_hostIndex;		/*!< Host index by trace
+														 identifier, sorted by
+														 identifier. */
+	std::vector < QoSClass >	m_qosClasses;		/*!< QoS classes, with the
+														 default one. */
+	std::vector < std::pair < unsigned, OGSS_Ushort > >
+								m_qosIndex;			/*!< QoS class index by
+														 color, sorted by
+														 color. */
 	Tier						* m_tiers;			/*!< Tiers. */
 	Volume						* m_volumes;		/*!< Volumes. */
 	Device						* m_devices;		/*!< Devices. */
+	Fabric						* m_fabric;			/*!< Switched fabric, NULL
+														 if the volumes are
+														 only reached by the
+														 buses. */
 	OGSS_Real					m_totalExecutionTime;	/*!< Simulation total
 														 execution time. */
+	std::vector < SeekCurve * >	m_seekCurves;		/*!< Seek curves of the
+														 HDD models. */
+	std::vector < ZoneTable * >	m_zoneTables;		/*!< Zone tables of the
+														 HDD models. */
 
 /**
  * Default constructor. Initialize pointers to NULL.
@@ -287,6 +656,68 @@ struct Architecture {
  * Destructor.
  */
 	~Architecture ();
+
+/**
+ * Compute the capacity a root volume exposes to the host, in bytes. For a
+ * declustered RAID, the capacity of all its subvolumes is summed.
+ *
+ * @param	idxVolume			Root volume index.
+ * @return						Volume capacity.
+ */
+	OGSS_Ulong getVolumeCapacity (
+		const OGSS_Ushort		idxVolume) const;
+
+/**
+ * Get the seek curve of a HDD. The curve is shared with the devices which have
+ * the same seek parameters, and computed if none of them was already loaded.
+ *
+ * @param	device				HDD device.
+ * @return						Seek curve.
+ */
+	const SeekCurve * getSeekCurve (
+		const HDDDevice			& device);
+
+/**
+ * Get the host which sends the requests of a trace identifier.
+ *
+ * @param	id					Host identifier in the trace.
+ * @return						Host index, 0 if the identifier is not
+ *								declared.
+ */
+	OGSS_Ushort getIdxHost (
+		const unsigned			id) const;
+
+/**
+ * Declare the host which sends the requests of a trace identifier.
+ *
+ * @param	id					Host identifier in the trace.
+ * @param	idxHost				Host index.
+ * @return						False if the identifier is already declared.
+ */
+	OGSS_Bool addIdxHost (
+		const unsigned			id,
+		const OGSS_Ushort		idxHost);
+
+/**
+ * Get the QoS class of a color.
+ *
+ * @param	color				Color in the trace.
+ * @return						Class index, 0 if the color is not
+ *								declared.
+ */
+	OGSS_Ushort getIdxQoSClass (
+		const unsigned			color) const;
+
+/**
+ * Declare the QoS class of a color.
+ *
+ * @param	color				Color in the trace.
+ * @param	idxClass			QoS class index.
+ * @return						False if the color is already declared.
+ */
+	OGSS_Bool addIdxQoSClass (
+		const unsigned			color,
+		const OGSS_Ushort		idxClass);
 };
 
 #endif
@@ -0,0 +1,92 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+
+/**
+ * @file	distributed.hpp
+ * @brief	Structures exchanged between the coordinator and the worker
+ * processes of a distributed simulation. Only plain descriptors cross the
+ * process boundary, never pointers to a RequestArray or an Architecture.
+ */
+
+#ifndef __OGSS_DISTRIBUTED_HPP__
+#define __OGSS_DISTRIBUTED_HPP__
+
+#include "Structures/types.hpp"
+
+/**************************************/
+/* STRUCTURES *************************/
+/**************************************/
+/**
+ * WorkerDescription gets the tier range simulated by a worker process and the
+ * endpoints used to reach it.
+ */
+struct WorkerDescription {
+	OGSS_Ushort					m_firstTier;		/*!< First tier. */
+	OGSS_Ushort					m_lastTier;			/*!< Last tier. */
+	OGSS_String					m_requests;			/*!< Request endpoint. */
+	OGSS_String					m_results;			/*!< Result endpoint. */
+};
+
+/**
+ * DistributedHeader is the first message sent to a worker. It gives the size
+ * of the request array the worker has to allocate.
+ */
+struct DistributedHeader {
+	OGSS_Ulong					m_numRequests;		/*!< Number of requests. */
+	OGSS_Ushort					m_requestFormat;	/*!< Request format. */
+};
+
+/**
+ * RequestDescriptor is a user request as sent by the coordinator. The address
+ * is already local to the worker address space.
+ */
+struct RequestDescriptor {
+	OGSS_Ulong					m_idxRequest;		/*!< Global index. */
+	OGSS_Real					m_date;				/*!< Arrival date. */
+	OGSS_Ulong					m_address;			/*!< Local address. */
+	OGSS_Ulong					m_size;				/*!< Request size. */
+	RequestType					m_type;				/*!< Request type. */
+	unsigned					m_option1;			/*!< Color or host. */
+	unsigned					m_option2;			/*!< Pid. */
+};
+
+/**
+ * ResultDescriptor is a completed user request as sent back by a worker. The
+ * request index is local to the worker.
+ */
+struct ResultDescriptor {
+	OGSS_Ulong					m_idxRequest;		/*!< Local index. */
+	OGSS_Real					m_date;				/*!< Arrival date. */
+	OGSS_Ushort					m_type;				/*!< Request type. */
+	OGSS_Ushort					m_idxVolume;		/*!< Local volume. */
+	OGSS_Real					m_busWaitingTime;	/*!< Bus waiting time. */
+	OGSS_Real					m_transferTime;		/*!< Transfer time. */
+	OGSS_Real					m_deviceWaitingTime;/*!< Device waiting time. */
+	OGSS_Real					m_serviceTime;		/*!< Service time. */
+	OGSS_Real					m_responseTime;		/*!< Response time. */
+	OGSS_Bool					m_isFaulty;			/*!< Faulty request. */
+	OGSS_Real					m_bufferWaitingTime;/*!< Buffer waiting time. */
+};
+
+#endif
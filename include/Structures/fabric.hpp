@@ -0,0 +1,237 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	fabric.hpp
+ * @brief	Fabric is a switched network (Ethernet, InfiniBand) between the
+ * host and the storage enclosures, which replaces the host and tier buses of
+ * the volumes attached to it.
+ *
+ * The fabric is a graph of nodes (host adapters, switches and targets) and of
+ * full duplex links. Each link has a clock by direction, a channel serves its
+ * transfers in order and the switches store and forward the data. The routes
+ * are computed once, when the architecture is loaded: the one between two
+ * nodes has the lowest latency, then the fewest hops.
+ */
+
+#ifndef __OGSS_FABRIC_HPP__
+#define __OGSS_FABRIC_HPP__
+
+#include <vector>
+
+#include "Structures/types.hpp"
+
+class Fabric {
+public:
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+/**
+ * Constructor.
+ */
+	Fabric ();
+
+/**
+ * Destructor.
+ */
+	~Fabric ();
+
+/**
+ * Add a node.
+ * @param	name				Node name.
+ * @param	type				Kind of node.
+ * @param	latency				Forwarding latency of a switch.
+ * @return						Node index.
+ */
+	OGSS_Ushort addNode (
+		const OGSS_String		name,
+		const FabricNodeType	type,
+		const OGSS_Real			latency);
+
+/**
+ * Add a full duplex link between two nodes.
+ * @param	from				First node.
+ * @param	to					Second node.
+ * @param	type				Kind of link.
+ * @param	bandwidth			Bandwidth by direction, in MB/s.
+ * @param	latency				Propagation latency.
+ */
+	void addLink (
+		const OGSS_Ushort		from,
+		const OGSS_Ushort		to,
+		const BusType			type,
+		const OGSS_Real			bandwidth,
+		const OGSS_Real			latency);
+
+/**
+ * Search a node by its name.
+ * @param	name				Node name.
+ * @return						Node index, OGSS_USHORT_MAX if unknown.
+ */
+	OGSS_Ushort getNode (
+		const OGSS_String		name) const;
+
+/**
+ * Compute the routes between the hosts and the targets. The table is filled
+ * once, a route is then read in constant time.
+ */
+	void computeRoutes ();
+
+/**
+ * Check if a route exists between two nodes.
+ * @param	src					Source node.
+ * @param	dst					Destination node.
+ * @return						TRUE if the destination can be reached.
+ */
+	inline OGSS_Bool hasRoute (
+		const OGSS_Ushort		src,
+		const OGSS_Ushort		dst) const;
+
+/**
+ * Send data along the route between two nodes. Each channel of the route is
+ * taken in turn, after the transfers which were sent on it before.
+ * @param	src					Source node.
+ * @param	dst					Destination node.
+ * @param	size				Data size.
+ * @param	date				Date the data are ready (input), date they
+ *								reach the destination (output).
+ * @param	transferTime		Transfer and propagation time, added to the
+ *								current value.
+ * @return						Time waited for the channels.
+ */
+	OGSS_Real send (
+		const OGSS_Ushort		src,
+		const OGSS_Ushort		dst,
+		const OGSS_Ulong		size,
+		OGSS_Real				& date,
+		OGSS_Real				& transferTime);
+
+/**
+ * Get the host node.
+ * @return						Node index.
+ */
+	inline OGSS_Ushort getHostNode () const;
+
+/**
+ * Set the host node.
+ * @param	node				Node index.
+ */
+	inline void setHostNode (
+		const OGSS_Ushort		node);
+
+/**
+ * Get the number of nodes.
+ * @return						Number of nodes.
+ */
+	inline OGSS_Ushort getNumNodes () const;
+
+/**
+ * Get the number of links.
+ * @return						Number of links.
+ */
+	inline OGSS_Ushort getNumLinks () const;
+
+/**
+ * Get the busy time of a link in a direction.
+ * @param	link				Link index.
+ * @param	reverse				TRUE for the second to the first node.
+ * @return						Busy time.
+ */
+	inline OGSS_Real getLinkBusyTime (
+		const OGSS_Ushort		link,
+		const OGSS_Bool			reverse) const;
+
+private:
+/**************************************/
+/* ATTRIBUTES *************************/
+/**************************************/
+	/**
+	 * A channel is a link direction, the channel 2i goes from the first to
+	 * the second node of the link i.
+	 */
+	struct Channel {
+		OGSS_Ushort				m_from;				/*!< Sending node. */
+		OGSS_Ushort				m_to;				/*!< Receiving node. */
+		BusType					m_type;				/*!< Kind of link. */
+		OGSS_Real				m_bandwidth;		/*!< Bandwidth, in bytes
+														 by ms. */
+		OGSS_Real				m_latency;			/*!< Propagation latency,
+														 with the forwarding
+														 one of the receiving
+														 switch. */
+		OGSS_Real				m_clock;			/*!< Busy-until date. */
+		OGSS_Real				m_busyTime;			/*!< Busy time. */
+	};
+
+	std::vector < OGSS_String >	m_nodeNames;		/*!< Node names. */
+	std::vector < FabricNodeType >
+								m_nodeTypes;		/*!< Node kinds. */
+	std::vector < OGSS_Real >	m_nodeLatency;		/*!< Forwarding latency
+														 of the switches. */
+	std::vector < Channel >		m_channels;			/*!< Link directions. */
+	std::vector < std::vector < OGSS_Ushort > >
+								m_adjacency;		/*!< Channels leaving
+														 each node. */
+
+	std::vector < OGSS_Ushort >	m_hops;				/*!< Channels of all the
+														 routes. */
+	std::vector < std::pair < OGSS_Ulong, OGSS_Ushort > >
+								m_routes;			/*!< First hop and number
+														 of hops of the route
+														 between two nodes,
+														 indexed by source and
+														 destination. */
+	OGSS_Ushort					m_hostNode;			/*!< Host node. */
+};
+
+inline OGSS_Bool
+Fabric::hasRoute (
+	const OGSS_Ushort		src,
+	const OGSS_Ushort		dst) const
+	{ return src == dst
+		|| m_routes [src * m_nodeNames.size () + dst] .second != 0; }
+
+inline OGSS_Ushort
+Fabric::getHostNode () const
+	{ return m_hostNode; }
+
+inline void
+Fabric::setHostNode (
+	const OGSS_Ushort		node)
+	{ m_hostNode = node; }
+
+inline OGSS_Ushort
+Fabric::getNumNodes () const
+	{ return m_nodeNames.size (); }
+
+inline OGSS_Ushort
+Fabric::getNumLinks () const
+	{ return m_channels.size () / 2; }
+
+inline OGSS_Real
+Fabric::getLinkBusyTime (
+	const OGSS_Ushort		link,
+	const OGSS_Bool			reverse) const
+	{ return m_channels [2 * link + (reverse ? 1 : 0)] .m_busyTime; }
+
+#endif
@@ -0,0 +1,314 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	ftl.hpp
+ * @brief	FlashTranslationLayer is the page-mapped FTL of a SSD. It maps the
+ * logical pages to physical pages, writes out-of-place in the active block
+ * of each die, and reclaims the blocks with a garbage collector when the
+ * free blocks of a die run low.
+ *
+ * The mapping tables are flat arrays of 32-bit page numbers, allocated with
+ * calloc: the pages of the tables which are never touched by the workload
+ * are never committed. The functions return the flash time spent by an
+ * access, the garbage collection time included.
+ */
+
+#ifndef __OGSS_FTL_HPP__
+#define __OGSS_FTL_HPP__
+
+#include <stdint.h>
+#include <vector>
+
+#include "Structures/architecture.hpp"
+
+class FlashTranslationLayer {
+public:
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+/**
+ * Constructor. The physical geometry and the timings are given by the
+ * device, the number of logical pages by the over-provisioning ratio.
+ * @param	device				SSD device.
+ */
+	FlashTranslationLayer (
+		const SSDDevice			& device);
+
+/**
+ * Destructor.
+ */
+	~FlashTranslationLayer ();
+
+/**
+ * Read logical pages.
+ * @param	firstPage			First logical page.
+ * @param	numPages			Number of pages.
+ * @return						Flash time.
+ */
+	OGSS_Real read (
+		const OGSS_Ulong		firstPage,
+		const OGSS_Ulong		numPages);
+
+/**
+ * Write logical pages. The time of the garbage collections triggered by
+ * the write is included.
+ * @param	firstPage			First logical page.
+ * @param	numPages			Number of pages.
+ * @param	date				Request date.
+ * @return						Flash time.
+ */
+	OGSS_Real write (
+		const OGSS_Ulong		firstPage,
+		const OGSS_Ulong		numPages,
+		const OGSS_Real			date);
+
+/**
+ * Invalidate logical pages (TRIM).
+ * @param	firstPage			First logical page.
+ * @param	numPages			Number of pages.
+ * @param	date				Request date.
+ */
+	void trim (
+		const OGSS_Ulong		firstPage,
+		const OGSS_Ulong		numPages,
+		const OGSS_Real			date);
+
+/**
+ * Get the flash time spent by each die during the last access.
+ * @return						Time by die.
+ */
+	inline const std::vector < OGSS_Real > & getDieTimes () const;
+
+/**
+ * Get the host pages handled by each die during the last access.
+ * @return						Pages by die.
+ */
+	inline const std::vector < OGSS_Ulong > & getDiePages () const;
+
+/**
+ * Get the number of pages written by the host.
+ * @return						Number of pages.
+ */
+	inline OGSS_Ulong getHostWrites () const;
+
+/**
+ * Get the number of pages programmed in the flash, relocations included.
+ * @return						Number of pages.
+ */
+	inline OGSS_Ulong getFlashWrites () const;
+
+/**
+ * Get the write amplification.
+ * @return						Flash writes by host writes.
+ */
+	inline OGSS_Real getWriteAmplification () const;
+
+/**
+ * Get the time spent by the garbage collector.
+ * @return						GC time.
+ */
+	inline OGSS_Real getGCTime () const;
+
+/**
+ * Get the number of block erasures.
+ * @return						Number of erasures.
+ */
+	inline OGSS_Ulong getNumErases () const;
+
+/**
+ * Get the max erase count of a block.
+ * @return						Max erase count.
+ */
+	inline OGSS_Ulong getMaxEraseCount () const;
+
+/**
+ * Get the number of trimmed pages.
+ * @return						Number of pages.
+ */
+	inline OGSS_Ulong getTrimmedPages () const;
+
+private:
+/**************************************/
+/* PRIVATE FUNCTIONS ******************/
+/**************************************/
+/**
+ * Program a logical page in the active block of a die.
+ * @param	logicalPage			Logical page.
+ * @param	die					Die index.
+ * @param	active				Active block of the die (host or GC).
+ * @param	date				Request date.
+ * @return						Flash time.
+ */
+	OGSS_Real program (
+		const uint32_t			logicalPage,
+		const uint32_t			die,
+		std::vector < uint32_t >	& active,
+		const OGSS_Real			date);
+
+/**
+ * Invalidate a physical page.
+ * @param	physicalPage		Physical page.
+ * @param	date				Request date.
+ */
+	void invalidate (
+		const uint32_t			physicalPage,
+		const OGSS_Real			date);
+
+/**
+ * Run the garbage collector of a die until it has enough free blocks.
+ * @param	die					Die index.
+ * @param	date				Request date.
+ * @return						Flash time.
+ */
+	OGSS_Real collect (
+		const uint32_t			die,
+		const OGSS_Real			date);
+
+/**
+ * Choose the block to reclaim in a die.
+ * @param	die					Die index.
+ * @param	date				Request date.
+ * @return						Block index, m_numBlocks if none.
+ */
+	uint32_t selectVictim (
+		const uint32_t			die,
+		const OGSS_Real			date) const;
+
+/**
+ * Get the access time of a physical page, sequential if it follows the
+ * last page accessed on its die.
+ * @param	physicalPage		Physical page.
+ * @param	randomTime			Random access time.
+ * @param	sequentialTime		Sequential access time.
+ * @return						Access time.
+ */
+	OGSS_Real access (
+		const uint32_t			physicalPage,
+		const OGSS_Real			randomTime,
+		const OGSS_Real			sequentialTime);
+
+/**************************************/
+/* ATTRIBUTES *************************/
+/**************************************/
+	uint32_t					m_pagesByBlock;		/*!< Pages by block. */
+	uint32_t					m_blocksByDie;		/*!< Blocks by die. */
+	uint32_t					m_numDies;			/*!< Number of dies. */
+	uint32_t					m_numBlocks;		/*!< Physical blocks. */
+	uint32_t					m_numPhysicalPages;	/*!< Physical pages. */
+	uint32_t					m_numLogicalPages;	/*!< Logical pages. */
+	uint32_t					m_gcThreshold;		/*!< Free blocks by die
+														 under which the GC
+														 is triggered. */
+	GCPolicyType				m_gcPolicy;			/*!< GC policy. */
+
+	OGSS_Real					m_randomReadTime;	/*!< Random read time. */
+	OGSS_Real					m_randomWriteTime;	/*!< Random write time. */
+	OGSS_Real					m_sequentialReadTime;	/*!< Seq read time. */
+	OGSS_Real					m_sequentialWriteTime;	/*!< Seq write time. */
+	OGSS_Real					m_eraseTime;		/*!< Erase time. */
+
+	uint32_t					* m_logicalToPhysical;	/*!< Mapping table,
+														 physical page + 1,
+														 0 if unmapped. */
+	uint32_t					* m_physicalToLogical;	/*!< Reverse table,
+														 logical page + 1,
+														 0 if invalid. */
+	uint32_t					* m_validPages;		/*!< Valid pages by
+														 block. */
+	uint32_t					* m_eraseCount;		/*!< Erasures by block. */
+	uint32_t					* m_writePointer;	/*!< Next free page by
+														 block. */
+	float						* m_lastUpdate;		/*!< Last invalidation
+														 date by block. */
+	uint8_t						* m_blockState;		/*!< Free, active or
+														 full. */
+
+	std::vector < std::vector < uint32_t > >
+								m_freeBlocks;		/*!< Free blocks by die. */
+	std::vector < uint32_t >	m_hostBlock;		/*!< Active host block
+														 by die. */
+	std::vector < uint32_t >	m_gcBlock;			/*!< Active GC block
+														 by die. */
+	std::vector < uint32_t >	m_lastPage;			/*!< Last page accessed
+														 by die. */
+	uint32_t					m_nextDie;			/*!< Next die written. */
+	std::vector < OGSS_Real >	m_dieTimes;			/*!< Flash time by die
+														 of the last access. */
+	std::vector < OGSS_Ulong >	m_diePages;			/*!< Host pages by die
+														 of the last access. */
+
+	OGSS_Ulong					m_hostWrites;		/*!< Host page writes. */
+	OGSS_Ulong					m_flashWrites;		/*!< Flash page writes. */
+	OGSS_Ulong					m_numErases;		/*!< Block erasures. */
+	OGSS_Ulong					m_trimmedPages;		/*!< Trimmed pages. */
+	OGSS_Real					m_gcTime;			/*!< GC flash time. */
+	OGSS_Bool					m_gcStuck;			/*!< The GC found no block
+														 to reclaim. */
+};
+
+inline const std::vector < OGSS_Real > &
+FlashTranslationLayer::getDieTimes () const
+	{ return m_dieTimes; }
+
+inline const std::vector < OGSS_Ulong > &
+FlashTranslationLayer::getDiePages () const
+	{ return m_diePages; }
+
+inline OGSS_Ulong
+FlashTranslationLayer::getHostWrites () const
+	{ return m_hostWrites; }
+
+inline OGSS_Ulong
+FlashTranslationLayer::getFlashWrites () const
+	{ return m_flashWrites; }
+
+inline OGSS_Real
+FlashTranslationLayer::getWriteAmplification () const {
+	if (m_hostWrites == 0) return .0;
+	return (OGSS_Real) m_flashWrites / m_hostWrites;
+}
+
+inline OGSS_Real
+FlashTranslationLayer::getGCTime () const
+	{ return m_gcTime; }
+
+inline OGSS_Ulong
+FlashTranslationLayer::getNumErases () const
+	{ return m_numErases; }
+
+inline OGSS_Ulong
+FlashTranslationLayer::getMaxEraseCount () const {
+	uint32_t				m = 0;
+
+	for (uint32_t i = 0; i < m_numBlocks; ++i)
+		if (m_eraseCount [i] > m) m = m_eraseCount [i];
+
+	return m;
+}
+
+inline OGSS_Ulong
+FlashTranslationLayer::getTrimmedPages () const
+	{ return m_trimmedPages; }
+
+#endif
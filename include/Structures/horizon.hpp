@@ -0,0 +1,51 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+
+/**
+ * @file	horizon.hpp
+ * @brief	Horizon is the message used in deterministic mode to tell the
+ * Execution that a volume will not send any request dated before a given date.
+ */
+
+#ifndef __OGSS_HORIZON_HPP__
+#define __OGSS_HORIZON_HPP__
+
+#include "Structures/types.hpp"
+
+/**************************************/
+/* STRUCTURE **************************/
+/**************************************/
+struct Horizon {
+	OGSS_Ulong					m_marker;			/*!< Always OGSS_HORIZON,
+														 to distinguish it from
+														 a request index. */
+	OGSS_Real					m_date;				/*!< No further request of
+														 the volume is dated
+														 before it. */
+	OGSS_Ulong					m_sequence;			/*!< Sequence number in the
+														 volume stream. */
+	OGSS_Ulong					m_idxVolume;		/*!< Sending volume. */
+};
+
+#endif
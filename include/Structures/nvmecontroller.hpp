@@ -0,0 +1,194 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	nvmecontroller.hpp
+ * @brief	NVMeController is the host interface of a NVMe device: the
+ * submission queues, the arbitration of the command processor between them
+ * and the PCIe link.
+ *
+ * A command first waits for a free slot in its submission queue, then for
+ * its share of the command processor: the processor is shared between the
+ * backlogged queues by their weights, as a round robin (all the weights are
+ * 1) or a weighted round robin does. The data go through the PCIe link, one
+ * clock by direction.
+ */
+
+#ifndef __OGSS_NVMECONTROLLER_HPP__
+#define __OGSS_NVMECONTROLLER_HPP__
+
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "Structures/architecture.hpp"
+
+class NVMeController {
+public:
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+/**
+ * Constructor. The queues, the arbitration and the link are given by the
+ * device.
+ * @param	device				SSD device.
+ */
+	NVMeController (
+		const SSDDevice			& device);
+
+/**
+ * Destructor.
+ */
+	~NVMeController ();
+
+/**
+ * Submit a command: it waits for a free slot of its queue, then for its
+ * share of the command processor.
+ * @param	queue				Submission queue.
+ * @param	date				Submission date.
+ * @param	start				Date the processor starts the command
+ *								(output).
+ * @return						Date the command is ready for the flash.
+ */
+	OGSS_Real submit (
+		const unsigned			queue,
+		const OGSS_Real			date,
+		OGSS_Real				& start);
+
+/**
+ * Transfer data on the PCIe link.
+ * @param	size				Data size.
+ * @param	toHost				TRUE for read data.
+ * @param	date				Date the data are ready.
+ * @return						Transfer end date.
+ */
+	OGSS_Real transfer (
+		const OGSS_Ulong		size,
+		const OGSS_Bool			toHost,
+		const OGSS_Real			date);
+
+/**
+ * Complete a command, its queue slot is freed.
+ * @param	queue				Submission queue.
+ * @param	date				Completion date.
+ */
+	void complete (
+		const unsigned			queue,
+		const OGSS_Real			date);
+
+/**
+ * Get the number of submission queues.
+ * @return						Number of queues.
+ */
+	inline unsigned getNumQueues () const;
+
+/**
+ * Get the link bandwidth.
+ * @return						Bandwidth, in bytes by ms.
+ */
+	inline OGSS_Real getLinkBandwidth () const;
+
+/**
+ * Get the number of submitted commands.
+ * @return						Number of commands.
+ */
+	inline OGSS_Ulong getNumCommands () const;
+
+/**
+ * Get the number of commands which waited for a queue slot.
+ * @return						Number of commands.
+ */
+	inline OGSS_Ulong getNumQueueFull () const;
+
+/**
+ * Get the max time waited for a queue slot.
+ * @return						Waiting time.
+ */
+	inline OGSS_Real getMaxQueueWait () const;
+
+/**
+ * Get the busy time of the link in a direction.
+ * @param	toHost				TRUE for the read data.
+ * @return						Busy time.
+ */
+	inline OGSS_Real getLinkBusyTime (
+		const OGSS_Bool			toHost) const;
+
+private:
+/**************************************/
+/* ATTRIBUTES *************************/
+/**************************************/
+	typedef std::priority_queue < OGSS_Real, std::vector < OGSS_Real >,
+		std::greater < OGSS_Real > >	CompletionQueue;
+
+	unsigned					m_numQueues;		/*!< Submission queues. */
+	unsigned					m_queueDepth;		/*!< Queue depth. */
+	OGSS_Real					m_commandTime;		/*!< Processor time by
+														 command. */
+	OGSS_Real					m_linkBandwidth;	/*!< Link bandwidth, in
+														 bytes by ms. */
+
+	std::vector < unsigned >	m_weights;			/*!< Weight by queue. */
+	std::vector < OGSS_Real >	m_queueClock;		/*!< Date the last command
+														 of each queue leaves
+														 the processor. */
+	std::vector < CompletionQueue >	m_outstanding;	/*!< Completion dates of
+														 the commands of each
+														 queue. */
+	OGSS_Real					m_linkClock [2];	/*!< Link clocks, to the
+														 device and to the
+														 host. */
+
+	OGSS_Ulong					m_numCommands;		/*!< Commands. */
+	OGSS_Ulong					m_numQueueFull;		/*!< Commands which
+														 waited for a slot. */
+	OGSS_Real					m_maxQueueWait;		/*!< Max slot wait. */
+	OGSS_Real					m_linkBusyTime [2];	/*!< Link busy times. */
+};
+
+inline unsigned
+NVMeController::getNumQueues () const
+	{ return m_numQueues; }
+
+inline OGSS_Real
+NVMeController::getLinkBandwidth () const
+	{ return m_linkBandwidth; }
+
+inline OGSS_Ulong
+NVMeController::getNumCommands () const
+	{ return m_numCommands; }
+
+inline OGSS_Ulong
+NVMeController::getNumQueueFull () const
+	{ return m_numQueueFull; }
+
+inline OGSS_Real
+NVMeController::getMaxQueueWait () const
+	{ return m_maxQueueWait; }
+
+inline OGSS_Real
+NVMeController::getLinkBusyTime (
+	const OGSS_Bool			toHost) const
+	{ return m_linkBusyTime [toHost ? 1 : 0]; }
+
+#endif
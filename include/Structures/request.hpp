@@ -67,6 +67,7 @@ struct Request {
 														 for a bus. */
 
 	OGSS_Real					m_busWaitingTime;	/*!< Bus waiting time. */
+	OGSS_Real					m_bufferWaitingTime;/*!< Buffer waiting time. */
 	OGSS_Real					m_transferTime;		/*!< Transfer time. */
 	OGSS_Real					m_deviceWaitingTime;/*!< Device waiting time. */
 	OGSS_Real					m_serviceTime;		/*!< Service time. */
@@ -81,6 +82,9 @@ struct Request {
 	OGSS_Real					m_childDate;		/*!< Max arrival date of
 														 child requests. */
 
+	OGSS_Ulong					m_sequence;			/*!< Sequence number in the
+														 volume stream. */
+
 	OGSS_Bool					m_isFaulty;			/*!< true if the request can
 														 not be terminated,
 														 false if not. */
@@ -88,6 +92,12 @@ struct Request {
 														 done, false if not. */
 	OGSS_Bool					m_isUserRequest;	/*!< true if the request is
 														 a user one. */
+	OGSS_Bool					m_isCacheHit;		/*!< true if the request is
+														 served by the volume
+														 cache. */
+	OGSS_Bool					m_isDeviceCacheHit;	/*!< true if the request is
+														 served by the device
+														 cache. */
 };
 
 /**
@@ -98,27 +108,10 @@ struct Request {
  * <li>the date on which the request is sent,
  * <li>the target address of the request,
  * <li>the size of the request.</ul>
+ * The optional parameters of the other formats (the color for the format 1,
+ * the host and process indicators for the format 2) are stored aside by their
+ * request array, which is indexed with the size of <code>Request</code>.
  */
 struct Request_Type0: public Request { };
 
-/**
- * <code>Request_Type1</code> is an advanced structure for storing requests. In
- * addition to <code>Request_Type0</code> parameters, it stores the color of
- * the request, which is a group indicator.
- */
-struct Request_Type1: public Request {
-	unsigned					m_color;			/*!< Group indicator of
-														 the request. */
-};
-
-/**
- * <code>Request_Type2</code> is an advanced structure for storing requests. In
- * addition to <code>Request_Type0</code> parameters, it stores the host
- * indicator and the process indicator.
- */
-struct Request_Type2: public Request {
-	unsigned					m_host;				/*!< Host indicator. */
-	unsigned					m_pid;				/*!< Process indicator. */
-};
-
 #endif
@@ -70,6 +70,18 @@ public:
 	virtual OGSS_Ulong searchNewSubrequest (
 		OGSS_Ulong				idxParent = OGSS_ULONG_MAX) = 0;
 
+/**
+ * Get the optional parameters given to initRequest.
+ *
+ * @param	idxRequest			Request index.
+ * @param	option1				Optional parameter (for color or hid).
+ * @param	option2				Optional parameter (for pid).
+ */
+	virtual void getOptions (
+		const OGSS_Ulong		idxRequest,
+		unsigned				& option1,
+		unsigned				& option2) const = 0;
+
 /**
  * Get request date.
  * @param 	idxRequest			Request index.
@@ -378,6 +390,25 @@ public:
  		const OGSS_Real			time)
  		{ return m_array [idxRequest] .m_busWaitingTime += time; }
 
+/**
+ * Get buffer waiting time.
+ * @param	idxRequest			Request index.
+ * @return						Buffer waiting time.
+ */
+	inline OGSS_Real getBufferWaitingTime (
+		const OGSS_Ulong		idxRequest) const
+		{ return m_array [idxRequest] .m_bufferWaitingTime; }
+/**
+ * Add time to the buffer waiting time.
+ * @param	idxRequest			Request index.
+ * @param	time				Time to add.
+ * @return						Buffer waiting time.
+ */
+	inline OGSS_Real addBufferWaitingTime (
+		const OGSS_Ulong		idxRequest,
+		const OGSS_Real			time)
+		{ return m_array [idxRequest] .m_bufferWaitingTime += time; }
+
 /**
  * Get device waiting time.
  * @param	idxRequest			Request index.
@@ -608,6 +639,24 @@ public:
 			m_array [idxRequest] .m_childDate);
 	}
 
+/**
+ * Get request sequence number.
+ * @param	idxRequest			Request index.
+ * @return						Sequence number.
+ */
+	inline OGSS_Ulong getSequence (
+		const OGSS_Ulong		idxRequest) const
+		{ return m_array [idxRequest] .m_sequence; }
+/**
+ * Set request sequence number.
+ * @param	idxRequest			Request index.
+ * @param	sequence			Sequence number.
+ */
+	inline void setSequence (
+		const OGSS_Ulong		idxRequest,
+		const OGSS_Ulong		sequence)
+		{ m_array [idxRequest] .m_sequence = sequence; }
+
 /**
  * Get request isFaulty state.
  *
@@ -655,6 +704,46 @@ public:
 		const OGSS_Bool			userRequest)
 		{ m_array [idxRequest] .m_isUserRequest = userRequest; }
 
+/**
+ * Get request isCacheHit state.
+ *
+ * @param	idxRequest			Request index.
+ * @return						TRUE if the request is served by the volume
+ 								cache, FALSE if not.
+ */
+	inline OGSS_Bool getIsCacheHit (
+		const OGSS_Ulong		idxRequest) const
+		{ return m_array [idxRequest] .m_isCacheHit; }
+/**
+ * Change the request status to indicate it is served by the volume cache.
+ *
+ * @param	idxRequest			Request index.
+ */
+	inline void isCacheHit (
+		const OGSS_Ulong		idxRequest)
+		{ m_array [idxRequest] .m_isCacheHit = true; }
+
+/**
+ * Get request isDeviceCacheHit state.
+ *
+ * @param	idxRequest			Request index.
+ * @return						TRUE if the request is served by the device
+ 								cache, FALSE if not.
+ */
+	inline OGSS_Bool getIsDeviceCacheHit (
+		const OGSS_Ulong		idxRequest) const
+		{ return m_array [idxRequest] .m_isDeviceCacheHit; }
+/**
+ * Change the request status to indicate if it is served by the device cache.
+ *
+ * @param	idxRequest			Request index.
+ * @param	deviceCacheHit		TRUE if served by the device cache.
+ */
+	inline void isDeviceCacheHit (
+		const OGSS_Ulong		idxRequest,
+		const OGSS_Bool			deviceCacheHit)
+		{ m_array [idxRequest] .m_isDeviceCacheHit = deviceCacheHit; }
+
 
 /******************************************************************************/
 
@@ -85,7 +85,21 @@ public:
 	OGSS_Ulong searchNewSubrequest (
 		OGSS_Ulong				parentIndex = OGSS_ULONG_MAX);
 
+/**
+ * Get the optional parameters given to initRequest.
+ *
+ * @param	idxRequest			Request index.
+ * @param	option1				Optional parameter (for color or hid).
+ * @param	option2				Optional parameter (for pid).
+ */
+	void getOptions (
+		const OGSS_Ulong		idxRequest,
+		unsigned				& option1,
+		unsigned				& option2) const;
+
 protected:
+	unsigned					* m_colors;			/*!< Color of each
+														 request. */
 };
 
 #endif
@@ -0,0 +1,290 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	shingledzones.hpp
+ * @brief	ShingledZones is the zone state of a SMR device. Each zone has a
+ * write pointer, under which the data can only be rewritten with the whole
+ * band. A host-managed device appends the writes at the write pointer, and
+ * fails the writes which do not fit in the rest of their zone. A
+ * drive-managed device writes in place at or after the write pointer, and
+ * logs the other writes in a persistent media cache, which is cleaned by
+ * rewriting the oldest bands (read-modify-write) when it fills up.
+ *
+ * The state takes four 32-bit words by zone (write pointer, cached and stale
+ * sectors, cleaning queue), about 1.3 MB for a 20 TB device with 256 MB
+ * zones. The media cache is located on the outer tracks, before the zones.
+ */
+
+#ifndef __OGSS_SHINGLEDZONES_HPP__
+#define __OGSS_SHINGLEDZONES_HPP__
+
+#include <stdint.h>
+
+#include "Structures/architecture.hpp"
+
+class ShingledZones {
+public:
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+/**
+ * Constructor. The zone size, the media cache size and the management are
+ * given by the device.
+ * @param	device				HDD device.
+ */
+	ShingledZones (
+		const HDDDevice			& device);
+
+/**
+ * Destructor.
+ */
+	~ShingledZones ();
+
+/**
+ * Place a write and update the write pointers. A host-managed device appends
+ * it at the write pointer of its zone, if it fits in the rest of the zone. A
+ * drive-managed device writes it in place if it does not start under the
+ * write pointer of a zone, else in the media cache.
+ * @param	firstSector			First sector.
+ * @param	numSectors			Number of sectors.
+ * @return						Physical sector of the write, OGSS_ULONG_MAX
+ *								if the write fails.
+ */
+	OGSS_Ulong write (
+		const OGSS_Ulong		firstSector,
+		const OGSS_Ulong		numSectors);
+
+/**
+ * Check if some data of the zones of a read are in the media cache.
+ * @param	firstSector			First sector.
+ * @param	numSectors			Number of sectors.
+ * @return						TRUE if the media cache is read too.
+ */
+	OGSS_Bool isCached (
+		const OGSS_Ulong		firstSector,
+		const OGSS_Ulong		numSectors) const;
+
+/**
+ * Reset the write pointers of the zones fully covered by an erasure. Their
+ * data in the media cache is dropped, its room is freed when the cleaning
+ * reaches it.
+ * @param	firstSector			First sector.
+ * @param	numSectors			Number of sectors.
+ */
+	void reset (
+		const OGSS_Ulong		firstSector,
+		const OGSS_Ulong		numSectors);
+
+/**
+ * Clean the oldest band of the media cache: the band is read, merged with
+ * its cached data and rewritten. The sectors are 0 if the band was reset
+ * since it entered the media cache, only the room of its dropped data is
+ * freed.
+ * @param	firstSector			First physical sector of the band (output).
+ * @param	numSectors			Written sectors of the band (output).
+ * @param	cacheSector			Physical sector of the cached data (output).
+ * @param	cachedSectors		Cached sectors of the band (output).
+ */
+	void clean (
+		OGSS_Ulong				& firstSector,
+		OGSS_Ulong				& numSectors,
+		OGSS_Ulong				& cacheSector,
+		OGSS_Ulong				& cachedSectors);
+
+/**
+ * Check if the media cache is filled over the cleaning threshold.
+ * @return						TRUE if a band must be cleaned.
+ */
+	inline OGSS_Bool needsCleaning () const;
+
+/**
+ * Get the physical sector of a sector, after the media cache.
+ * @param	sector				Sector.
+ * @return						Physical sector.
+ */
+	inline OGSS_Ulong getPhysicalSector (
+		const OGSS_Ulong		sector) const;
+
+/**
+ * Get the physical sector of the oldest data of the media cache.
+ * @return						Physical sector.
+ */
+	inline OGSS_Ulong getCacheSector () const;
+
+/**
+ * Add the time spent to clean a band.
+ * @param	time				Cleaning time.
+ */
+	inline void addCleaningTime (
+		const OGSS_Real			time);
+
+/**
+ * Get the number of sectors written by the host.
+ * @return						Number of sectors.
+ */
+	inline OGSS_Ulong getHostWrites () const;
+
+/**
+ * Get the number of sectors written in the media cache.
+ * @return						Number of sectors.
+ */
+	inline OGSS_Ulong getCacheWrites () const;
+
+/**
+ * Get the write amplification.
+ * @return						Media writes by host writes.
+ */
+	inline OGSS_Real getWriteAmplification () const;
+
+/**
+ * Get the number of cleaned bands.
+ * @return						Number of bands.
+ */
+	inline OGSS_Ulong getCleanedBands () const;
+
+/**
+ * Get the time spent to clean the bands.
+ * @return						Cleaning time.
+ */
+	inline OGSS_Real getCleaningTime () const;
+
+/**
+ * Get the number of writes which were not placed at their address
+ * (host-managed).
+ * @return						Number of writes.
+ */
+	inline OGSS_Ulong getRelocatedWrites () const;
+
+/**
+ * Get the number of zone resets.
+ * @return						Number of resets.
+ */
+	inline OGSS_Ulong getNumResets () const;
+
+/**
+ * Get the number of failed writes, which did not fit in the rest of their
+ * zone (host-managed).
+ * @return						Number of writes.
+ */
+	inline OGSS_Ulong getRejectedWrites () const;
+
+private:
+/**************************************/
+/* ATTRIBUTES *************************/
+/**************************************/
+	ZoneManagementType			m_management;		/*!< Zone management. */
+	uint32_t					m_sectorsByZone;	/*!< Sectors by zone. */
+	uint32_t					m_numZones;			/*!< Number of zones. */
+	OGSS_Ulong					m_numCacheSectors;	/*!< Media cache
+														 sectors. */
+	OGSS_Ulong					m_cleaningLimit;	/*!< Cached sectors over
+														 which the bands are
+														 cleaned. */
+
+	uint32_t					* m_writePointer;	/*!< Written sectors by
+														 zone. */
+	uint32_t					* m_cachedSectors;	/*!< Media cache sectors
+														 by zone, the high bit
+														 is set if the zone is
+														 queued. */
+	uint32_t					* m_staleSectors;	/*!< Media cache sectors
+														 by zone dropped by a
+														 reset, not freed
+														 yet. */
+	uint32_t					* m_cleanQueue;		/*!< Zones in the media
+														 cache, oldest first
+														 (ring). */
+	uint32_t					m_queueHead;		/*!< First queued zone. */
+	uint32_t					m_queueSize;		/*!< Queued zones. */
+	OGSS_Ulong					m_cacheTail;		/*!< Oldest media cache
+														 sector. */
+	OGSS_Ulong					m_cacheFill;		/*!< Used media cache
+														 sectors. */
+
+	OGSS_Ulong					m_hostWrites;		/*!< Host sectors. */
+	OGSS_Ulong					m_cacheWrites;		/*!< Media cache
+														 sectors. */
+	OGSS_Ulong					m_rewrittenSectors;	/*!< Sectors rewritten by
+														 the cleaning. */
+	OGSS_Ulong					m_cleanedBands;		/*!< Cleaned bands. */
+	OGSS_Real					m_cleaningTime;		/*!< Cleaning time. */
+	OGSS_Ulong					m_relocatedWrites;	/*!< Appends not at their
+														 address. */
+	OGSS_Ulong					m_numResets;		/*!< Zone resets. */
+	OGSS_Ulong					m_rejectedWrites;	/*!< Failed appends. */
+};
+
+inline OGSS_Bool
+ShingledZones::needsCleaning () const
+	{ return m_queueSize != 0 && m_cacheFill > m_cleaningLimit; }
+
+inline OGSS_Ulong
+ShingledZones::getPhysicalSector (
+	const OGSS_Ulong		sector) const
+	{ return sector + m_numCacheSectors; }
+
+inline OGSS_Ulong
+ShingledZones::getCacheSector () const
+	{ return m_cacheTail; }
+
+inline void
+ShingledZones::addCleaningTime (
+	const OGSS_Real			time)
+	{ m_cleaningTime += time; }
+
+inline OGSS_Ulong
+ShingledZones::getHostWrites () const
+	{ return m_hostWrites; }
+
+inline OGSS_Ulong
+ShingledZones::getCacheWrites () const
+	{ return m_cacheWrites; }
+
+inline OGSS_Real
+ShingledZones::getWriteAmplification () const {
+	if (m_hostWrites == 0) return .0;
+	return (OGSS_Real) (m_hostWrites + m_rewrittenSectors) / m_hostWrites;
+}
+
+inline OGSS_Ulong
+ShingledZones::getCleanedBands () const
+	{ return m_cleanedBands; }
+
+inline OGSS_Real
+ShingledZones::getCleaningTime () const
+	{ return m_cleaningTime; }
+
+inline OGSS_Ulong
+ShingledZones::getRelocatedWrites () const
+	{ return m_relocatedWrites; }
+
+inline OGSS_Ulong
+ShingledZones::getNumResets () const
+	{ return m_numResets; }
+
+inline OGSS_Ulong
+ShingledZones::getRejectedWrites () const
+	{ return m_rejectedWrites; }
+
+#endif
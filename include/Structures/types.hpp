@@ -71,6 +71,7 @@ typedef							std::string		OGSS_String;
  */
 const OGSS_Ushort				OGSS_USHORT_MAX	= UINT16_MAX;
 const OGSS_Long					OGSS_ULONG_MAX	= UINT64_MAX;
+const OGSS_Long					OGSS_HORIZON	= UINT64_MAX - 1;
 const OGSS_Long					MEGABYTE		= 1024*1024;
 const OGSS_Long					GIGABYTE		= 1024*MEGABYTE;
 const OGSS_Real					MILLISEC		= .001;
@@ -88,11 +89,18 @@ const OGSS_String				OGSS_NAME_PERF = "performance";
 const OGSS_String				OGSS_NAME_RPLY = "reply";
 const OGSS_String				OGSS_NAME_VDRV = "volumedriver";
 const OGSS_String				OGSS_NAME_WORK = "workload";
+const OGSS_String				OGSS_NAME_CORD = "coordinator";
+const OGSS_String				OGSS_NAME_WRKR = "worker";
+const OGSS_String				OGSS_NAME_DIST = "distributed";
 
 /**
  * Constant strings representing computation model names for the XML Parsing.
  */
 const OGSS_String 				OGSS_NAME_MBUS = "cmbus";
+const OGSS_String				OGSS_NAME_ORDR = "ordering";
+const OGSS_String				OGSS_NAME_STRM = "stream";
+const OGSS_String				OGSS_NAME_BPRF = "busprofile";
+const OGSS_String				OGSS_NAME_TRCE = "trace";
 
 /**
  * Constant strings 
@@ -143,6 +151,44 @@ enum BusType {
 	BST_TOTAL
 };
 
+/**
+ * <code>BusStateType</code> references the states of a bus in its utilization
+ * profile, from the least to the most loaded. The values are the ones plotted
+ * by the bus behavior graph.
+ */
+enum BusStateType {
+	BSS_IDLE,					/*!< No transfer. */
+	BSS_USE,					/*!< Transfer started at its arrival. */
+	BSS_WAIT,					/*!< Transfer which waited for the bus. */
+	BSS_CONGESTED,				/*!< Transfer which waited longer than its
+									 own duration. */
+	BSS_TOTAL
+};
+
+/**
+ * <code>FabricNodeType</code> references the kinds of node of a switched
+ * fabric. Only the switches forward the data.
+ */
+enum FabricNodeType {
+	FNT_HOST,					/*!< Host adapter. */
+	FNT_SWITCH,					/*!< Switch. */
+	FNT_TARGET,					/*!< Storage enclosure, its volumes are
+									 reached through the fabric. */
+	FNT_TOTAL
+};
+
+/**
+ * <code>TraceComponentType</code> references the components which can write
+ * events in the binary trace.
+ */
+enum TraceComponentType {
+	TRC_BUS,					/*!< Bus hops of the advanced bus model. */
+	TRC_DEVICE,					/*!< Device services of the advanced bus
+									 model. */
+	TRC_QOS,					/*!< Choices of the QoS schedulers. */
+	TRC_TOTAL
+};
+
 /**
  * <code>VolumeSchemeType</code> references all kind of volume which can be
  * encountered.
@@ -187,9 +233,68 @@ enum DeclusteringType {
 enum DeviceType {
 	DVT_HDD,					/*!< Hard Disk Drive. */
 	DVT_SSD,					/*!< Single State Drive. */
+	DVT_SMR,					/*!< Shingled Magnetic Recording HDD. */
+	DVT_NVME,					/*!< NVMe SSD, on PCI express. */
 	DVT_TOTAL
 };
 
+/**
+ * <code>ZoneManagementType</code> references all kind of management of the
+ * shingled zones of a SMR device.
+ */
+enum ZoneManagementType {
+	ZMT_DRIVE,					/*!< Drive-managed, random writes are
+									 absorbed by a media cache. */
+	ZMT_HOST,					/*!< Host-managed, writes are appended at
+									 the zone write pointer. */
+	ZMT_TOTAL
+};
+
+/**
+ * <code>QueuePolicyType</code> references all kind of reordering policies
+ * which can be used by the device command queue (NCQ).
+ */
+enum QueuePolicyType {
+	QPT_FIFO,					/*!< First in, first out. */
+	QPT_SSTF,					/*!< Shortest seek time first. */
+	QPT_CLOOK,					/*!< Circular LOOK. */
+	QPT_SATF,					/*!< Shortest access time first (HDD). */
+	QPT_TOTAL
+};
+
+/**
+ * <code>ArbitrationType</code> references all kind of arbitrations which
+ * can be used between the submission queues of a NVMe device.
+ */
+enum ArbitrationType {
+	ABT_RR,						/*!< Round robin. */
+	ABT_WRR,					/*!< Weighted round robin, by queue
+									 priority. */
+	ABT_TOTAL
+};
+
+/**
+ * <code>GCPolicyType</code> references all kind of victim selection
+ * policies which can be used by the SSD garbage collector.
+ */
+enum GCPolicyType {
+	GCP_GREEDY,					/*!< Fewest valid pages. */
+	GCP_COSTBENEFIT,			/*!< Best age/utilization ratio. */
+	GCP_TOTAL
+};
+
+/**
+ * <code>CachePolicyType</code> references all kind of replacement policies
+ * which can be used by a volume cache.
+ */
+enum CachePolicyType {
+	CPT_LRU,					/*!< Least recently used. */
+	CPT_ARC,					/*!< Adaptive replacement cache. */
+	CPT_2Q,						/*!< Two queues. */
+	CPT_S3FIFO,					/*!< Small, main and ghost FIFOs. */
+	CPT_TOTAL
+};
+
 /**
  * <code>VolumeType</code> references all kind of volume which can be
  * encountered.
@@ -217,6 +322,7 @@ enum DeclusteredRaidType {
 enum ComputationModelType {
 	CMT_BUS_DEFAULT,			/*!< Default algorithm. */
 	CMT_BUS_ADVANCED,			/*!< Advanced algorithm. */
+	CMT_BUS_FLUID,				/*!< FCFS busy-until queue by bus. */
 	CMT_TOTAL
 };
 
@@ -255,4 +361,18 @@ enum GraphType {
 	GPH_TOTAL
 };
 
+/**
+ * <code>StageType</code> references the simulation stages which can be timed.
+ * The decomposition is done by the volume drivers during the execution, so
+ * its time overlaps the execution one.
+ */
+enum StageType {
+	STG_LOAD,					/*!< Trace and architecture extraction. */
+	STG_PREPROCESSING,			/*!< Driver creation and mapping. */
+	STG_DECOMPOSITION,			/*!< Request decomposition. */
+	STG_EXECUTION,				/*!< Request execution. */
+	STG_OUTPUT,					/*!< Graph generation. */
+	STG_TOTAL
+};
+
 #endif
@@ -0,0 +1,333 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	volumecache.hpp
+ * @brief	VolumeCache is the controller cache placed in front of a volume.
+ * It keeps the last blocks accessed by the host with a LRU, ARC, 2Q or
+ * S3-FIFO replacement policy, and tells the volume driver whether a request
+ * is served by the cache or has to go down to the devices.
+ *
+ * The index is made of flat arrays: each entry holds its block number, the
+ * links of its list and two bytes of state, and an open-addressing table
+ * maps the block numbers to the entries. All operations are in constant
+ * time. The write-back dirty data is not tracked by block: it is an amount
+ * which drains at the flush rate, and the writes which would overflow the
+ * dirty limit go through to the devices.
+ */
+
+#ifndef __OGSS_VOLUMECACHE_HPP__
+#define __OGSS_VOLUMECACHE_HPP__
+
+#include <stdint.h>
+
+#include "Structures/architecture.hpp"
+
+class VolumeCache {
+public:
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+/**
+ * Constructor.
+ * @param	volume				Volume, with its cache parameters.
+ */
+	VolumeCache (
+		const Volume			& volume);
+
+/**
+ * Destructor.
+ */
+	~VolumeCache ();
+
+/**
+ * Read a volume extent. The missing blocks are loaded in the cache.
+ * @param	address				Volume address.
+ * @param	size				Request size.
+ * @return						TRUE if all the blocks were in the cache.
+ */
+	OGSS_Bool read (
+		const OGSS_Ulong		address,
+		const OGSS_Ulong		size);
+
+/**
+ * Write a volume extent. The blocks are loaded in the cache.
+ * @param	address				Volume address.
+ * @param	size				Request size.
+ * @param	date				Request date.
+ * @return						TRUE if the write is absorbed by the cache.
+ */
+	OGSS_Bool write (
+		const OGSS_Ulong		address,
+		const OGSS_Ulong		size,
+		const OGSS_Real			date);
+
+/**
+ * Drop a volume extent from the cache (TRIM).
+ * @param	address				Volume address.
+ * @param	size				Request size.
+ */
+	void trim (
+		const OGSS_Ulong		address,
+		const OGSS_Ulong		size);
+
+/**
+ * Get the number of blocks the cache can hold.
+ * @return						Number of blocks.
+ */
+	inline OGSS_Ulong getNumBlocks () const;
+
+/**
+ * Get the number of read requests.
+ * @return						Number of reads.
+ */
+	inline OGSS_Ulong getNumReads () const;
+
+/**
+ * Get the number of read requests entirely served by the cache.
+ * @return						Number of read hits.
+ */
+	inline OGSS_Ulong getNumReadHits () const;
+
+/**
+ * Get the number of write requests.
+ * @return						Number of writes.
+ */
+	inline OGSS_Ulong getNumWrites () const;
+
+/**
+ * Get the number of write requests absorbed by the cache.
+ * @return						Number of writes.
+ */
+	inline OGSS_Ulong getNumAbsorbedWrites () const;
+
+/**
+ * Get the number of write requests sent to the devices because the dirty
+ * limit was reached.
+ * @return						Number of writes.
+ */
+	inline OGSS_Ulong getNumThrottledWrites () const;
+
+/**
+ * Get the block hit ratio.
+ * @return						Block hits by block accesses.
+ */
+	inline OGSS_Real getBlockHitRatio () const;
+
+/**
+ * Get the number of evicted blocks.
+ * @return						Number of blocks.
+ */
+	inline OGSS_Ulong getNumEvictions () const;
+
+/**
+ * Get the number of accesses which hit a ghost entry.
+ * @return						Number of ghost hits.
+ */
+	inline OGSS_Ulong getNumGhostHits () const;
+
+private:
+/**************************************/
+/* PRIVATE FUNCTIONS ******************/
+/**************************************/
+/**
+ * Access a block with the cache policy, and load it on a miss.
+ * @param	block				Block number.
+ * @return						TRUE if the block was in the cache.
+ */
+	OGSS_Bool access (
+		const uint64_t			block);
+
+/**
+ * Access a block with a given policy.
+ * @param	block				Block number.
+ * @return						TRUE if the block was in the cache.
+ */
+	OGSS_Bool accessLRU (
+		const uint64_t			block);
+	OGSS_Bool accessARC (
+		const uint64_t			block);
+	OGSS_Bool access2Q (
+		const uint64_t			block);
+	OGSS_Bool accessS3FIFO (
+		const uint64_t			block);
+
+/**
+ * Make room for a block in the ARC cache.
+ * @param	ghostHit			TRUE if the block was found in the second
+ *								ghost list.
+ */
+	void replaceARC (
+		const OGSS_Bool			ghostHit);
+
+/**
+ * Make room for a block in the 2Q cache.
+ */
+	void reclaim2Q ();
+
+/**
+ * Make room for a block in the S3-FIFO cache.
+ */
+	void evictS3FIFO ();
+
+/**
+ * Search the entry of a block.
+ * @param	block				Block number.
+ * @return						Entry index, NIL_ENTRY if absent.
+ */
+	uint32_t lookup (
+		const uint64_t			block) const;
+
+/**
+ * Get a free entry for a block and index it.
+ * @param	block				Block number.
+ * @return						Entry index.
+ */
+	uint32_t allocate (
+		const uint64_t			block);
+
+/**
+ * Remove an entry from its list and from the index.
+ * @param	entry				Entry index.
+ */
+	void release (
+		const uint32_t			entry);
+
+/**
+ * Remove an entry from its list.
+ * @param	entry				Entry index.
+ */
+	void unlink (
+		const uint32_t			entry);
+
+/**
+ * Insert an entry at the head of a list.
+ * @param	entry				Entry index.
+ * @param	list				List index.
+ */
+	void pushHead (
+		const uint32_t			entry,
+		const uint8_t			list);
+
+/**
+ * Get the slot of a block in the index table.
+ * @param	block				Block number.
+ * @return						Slot.
+ */
+	inline uint32_t hash (
+		const uint64_t			block) const;
+
+/**************************************/
+/* ATTRIBUTES *************************/
+/**************************************/
+	CachePolicyType				m_policy;			/*!< Replacement policy. */
+	OGSS_Ulong					m_blockSize;		/*!< Block size. */
+	uint32_t					m_capacity;			/*!< Cached blocks. */
+	uint32_t					m_numEntries;		/*!< Entries, ghosts
+														 included. */
+
+	uint64_t					* m_blocks;			/*!< Block by entry. */
+	uint32_t					* m_prev;			/*!< Previous entry. */
+	uint32_t					* m_next;			/*!< Next entry, or next
+														 free entry. */
+	uint8_t						* m_list;			/*!< List by entry. */
+	uint8_t						* m_frequency;		/*!< S3-FIFO access
+														 counter. */
+	uint32_t					* m_table;			/*!< Index table, entry
+														 + 1, 0 if empty. */
+	uint32_t					m_tableMask;		/*!< Table size - 1. */
+	unsigned					m_tableShift;		/*!< Hash shift. */
+	uint32_t					m_freeEntry;		/*!< First free entry. */
+
+	uint32_t					m_head [4];			/*!< Newest entry by
+														 list. */
+	uint32_t					m_tail [4];			/*!< Oldest entry by
+														 list. */
+	uint32_t					m_length [4];		/*!< Length by list. */
+	OGSS_Real					m_arcTarget;		/*!< ARC target size of
+														 the first list. */
+
+	OGSS_Bool					m_writeBack;		/*!< Write-back mode. */
+	OGSS_Real					m_dirty;			/*!< Dirty bytes. */
+	OGSS_Real					m_dirtyLimit;		/*!< Max dirty bytes. */
+	OGSS_Real					m_flushRate;		/*!< Destage rate, in
+														 bytes by ms. */
+	OGSS_Real					m_lastDate;			/*!< Date of the last
+														 dirty update. */
+
+	OGSS_Ulong					m_numReads;			/*!< Read requests. */
+	OGSS_Ulong					m_numReadHits;		/*!< Read hits. */
+	OGSS_Ulong					m_numWrites;		/*!< Write requests. */
+	OGSS_Ulong					m_numAbsorbedWrites;/*!< Absorbed writes. */
+	OGSS_Ulong					m_numThrottledWrites;	/*!< Throttled
+														 writes. */
+	OGSS_Ulong					m_blockAccesses;	/*!< Block accesses. */
+	OGSS_Ulong					m_blockHits;		/*!< Block hits. */
+	OGSS_Ulong					m_numEvictions;		/*!< Evicted blocks. */
+	OGSS_Ulong					m_numGhostHits;		/*!< Ghost hits. */
+};
+
+inline OGSS_Ulong
+VolumeCache::getNumBlocks () const
+	{ return m_capacity; }
+
+inline OGSS_Ulong
+VolumeCache::getNumReads () const
+	{ return m_numReads; }
+
+inline OGSS_Ulong
+VolumeCache::getNumReadHits () const
+	{ return m_numReadHits; }
+
+inline OGSS_Ulong
+VolumeCache::getNumWrites () const
+	{ return m_numWrites; }
+
+inline OGSS_Ulong
+VolumeCache::getNumAbsorbedWrites () const
+	{ return m_numAbsorbedWrites; }
+
+inline OGSS_Ulong
+VolumeCache::getNumThrottledWrites () const
+	{ return m_numThrottledWrites; }
+
+inline OGSS_Real
+VolumeCache::getBlockHitRatio () const {
+	if (m_blockAccesses == 0) return .0;
+	return (OGSS_Real) m_blockHits / m_blockAccesses;
+}
+
+inline OGSS_Ulong
+VolumeCache::getNumEvictions () const
+	{ return m_numEvictions; }
+
+inline OGSS_Ulong
+VolumeCache::getNumGhostHits () const
+	{ return m_numGhostHits; }
+
+inline uint32_t
+VolumeCache::hash (
+	const uint64_t			block) const
+	{ return (uint32_t) ( (block * 0x9E3779B97F4A7C15ULL) >> m_tableShift); }
+
+#endif
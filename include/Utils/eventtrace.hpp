@@ -0,0 +1,233 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	eventtrace.hpp
+ * @brief	EventTrace records the events of the computation models in a
+ * binary file, as fixed-size records.
+ *
+ * Each thread writes its records in its own ring, without any lock; a writer
+ * thread drains the rings to the file. The tracing is enabled by component,
+ * and the trace points only test a global mask when it is disabled. The file
+ * is converted to CSV or Chrome trace JSON by the ogssim-tracedecode tool.
+ */
+
+#ifndef __OGSS_EVENTTRACE_HPP__
+#define __OGSS_EVENTTRACE_HPP__
+
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Structures/types.hpp"
+
+#define TRACE_MAGIC				"OGSSTRC"
+#define TRACE_VERSION			1
+
+/**
+ * Header of a trace file.
+ */
+struct TraceHeader {
+	char						m_magic [8];		/*!< File signature. */
+	uint32_t					m_version;			/*!< Format version. */
+	uint32_t					m_recordSize;		/*!< Size of a record. */
+};
+
+/**
+ * Record of a trace file. The dates are in simulated ms.
+ */
+struct TraceRecord {
+	OGSS_Real					m_start;			/*!< Start date. */
+	OGSS_Real					m_end;				/*!< End date. */
+	OGSS_Ulong					m_idxRequest;		/*!< Request index. */
+	OGSS_Ulong					m_occupancy;		/*!< Buffer occupancy (B),
+														 or waiting requests
+														 for the QoS. */
+	uint16_t					m_component;		/*!< Traced component. */
+	uint16_t					m_id;				/*!< Bus, device or class
+														 index. */
+	uint16_t					m_thread;			/*!< Thread index. */
+	uint8_t						m_step;				/*!< Step reached by the
+														 hop, or priority
+														 level for the QoS. */
+	uint8_t						m_toDevice;			/*!< TRUE if the hop goes
+														 to the device. */
+};
+
+static_assert (sizeof (TraceRecord) == 40,
+	"The trace records must keep the same size on all the platforms");
+
+class EventTrace {
+public:
+/**
+ * Number of records of a thread ring.
+ */
+	static const unsigned		RING_SIZE = 1 << 16;
+
+/**
+ * Open the trace file and launch the writer thread.
+ * @param	output				Trace file.
+ * @param	components			Mask of the traced components.
+ */
+	static void start (
+		const OGSS_String		& output,
+		const unsigned			components);
+
+/**
+ * Disable the tracing and stop the writer thread, after the last records are
+ * written.
+ */
+	static void stop ();
+
+/**
+ * Convert a list of component names to a mask.
+ * @param	components			Names separated by commas ("bus", "device",
+ *								"qos" or "all").
+ * @return						Mask of the components.
+ */
+	static unsigned parseComponents (
+		const OGSS_String		& components);
+
+/**
+ * Check if a component is traced. This is the only cost of a disabled trace
+ * point.
+ * @param	component			Component.
+ * @return						TRUE if the component is traced.
+ */
+	static inline OGSS_Bool isEnabled (
+		const TraceComponentType	component);
+
+/**
+ * Record an event. The caller waits for the writer if its ring is full.
+ * @param	component			Component.
+ * @param	id					Bus, device or class index.
+ * @param	step				Hop step.
+ * @param	toDevice			TRUE if the hop goes to the device.
+ * @param	idxRequest			Request index.
+ * @param	start				Start date.
+ * @param	end					End date.
+ * @param	occupancy			Buffer occupancy or waiting requests.
+ */
+	static inline void record (
+		const TraceComponentType	component,
+		const OGSS_Ushort		id,
+		const OGSS_Ushort		step,
+		const OGSS_Bool			toDevice,
+		const OGSS_Ulong		idxRequest,
+		const OGSS_Real			start,
+		const OGSS_Real			end,
+		const OGSS_Ulong		occupancy);
+
+private:
+/**
+ * Ring of a thread, with one writer and one reader.
+ */
+	struct Ring {
+		TraceRecord				m_records [RING_SIZE];	/*!< Records. */
+		std::atomic <OGSS_Ulong>	m_head;			/*!< Next written
+														 record. */
+		std::atomic <OGSS_Ulong>	m_tail;			/*!< Next drained
+														 record. */
+		uint16_t				m_thread;			/*!< Thread index. */
+	};
+
+/**
+ * Create the ring of the current thread.
+ * @return						Ring.
+ */
+	static Ring * registerThread ();
+
+/**
+ * Writer thread loop.
+ */
+	static void write ();
+
+/**
+ * Write the pending records of all the rings.
+ * @return						TRUE if records were written.
+ */
+	static OGSS_Bool drain ();
+
+	static unsigned				s_components;		/*!< Mask of the traced
+														 components. */
+	static std::atomic <OGSS_Bool>	s_running;		/*!< Writer state. */
+	static std::thread			* s_writer;			/*!< Writer thread. */
+	static std::ofstream		s_file;				/*!< Trace file. */
+	static std::mutex			s_mutex;			/*!< Ring list lock. */
+	static std::vector <std::unique_ptr <Ring> >	s_rings;	/*!< Rings,
+														 kept until the end
+														 of the process. */
+	static thread_local Ring	* t_ring;			/*!< Ring of the current
+														 thread. */
+};
+
+/**************************************/
+/* INLINE FUNCTIONS *******************/
+/**************************************/
+inline OGSS_Bool
+EventTrace::isEnabled (
+	const TraceComponentType	component) {
+	return (s_components >> component) & 1;
+}
+
+inline void
+EventTrace::record (
+	const TraceComponentType	component,
+	const OGSS_Ushort		id,
+	const OGSS_Ushort		step,
+	const OGSS_Bool			toDevice,
+	const OGSS_Ulong		idxRequest,
+	const OGSS_Real			start,
+	const OGSS_Real			end,
+	const OGSS_Ulong		occupancy) {
+	Ring					* ring = t_ring;
+	OGSS_Ulong				head;
+
+	if (ring == NULL)
+		ring = registerThread ();
+
+	head = ring->m_head.load (std::memory_order_relaxed);
+
+	// The records are never dropped: the thread waits for the writer instead
+	while (head - ring->m_tail.load (std::memory_order_acquire) >= RING_SIZE)
+		std::this_thread::yield ();
+
+	TraceRecord				& r = ring->m_records [head % RING_SIZE];
+
+	r.m_start = start;
+	r.m_end = end;
+	r.m_idxRequest = idxRequest;
+	r.m_occupancy = occupancy;
+	r.m_component = component;
+	r.m_id = id;
+	r.m_thread = ring->m_thread;
+	r.m_step = step;
+	r.m_toDevice = toDevice;
+
+	ring->m_head.store (head + 1, std::memory_order_release);
+}
+
+#endif
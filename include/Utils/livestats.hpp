@@ -0,0 +1,232 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+
+/**
+ * @file	livestats.hpp
+ * @brief	LiveStats gathers statistics while the simulation runs and
+ * publishes them periodically, in JSON lines, to a file or a ZMQ socket.
+ *
+ * The Execution thread updates the counters and detects, from the date of the
+ * completions, each interval of simulated time it crosses: it copies the
+ * counters in one snapshot by interval and gives them, without any lock, to a
+ * publisher thread which formats and writes them. The Execution loop is never
+ * stopped.
+ */
+
+#ifndef __OGSS_LIVESTATS_HPP__
+#define __OGSS_LIVESTATS_HPP__
+
+#include <atomic>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "Structures/types.hpp"
+
+class LiveStats {
+public:
+/**
+ * Number of buckets of the latency histogram. Bucket b counts response times
+ * lower than 2^b microseconds.
+ */
+	static const unsigned		NUM_BUCKETS = 40;
+
+/**
+ * Number of snapshots waiting for the publisher. The Execution thread waits
+ * for room when they are all taken.
+ */
+	static const unsigned		RING_SIZE = 256;
+
+/**
+ * Constructor.
+ * @param	numDevices			Number of devices.
+ * @param	interval			Simulated time between two snapshots (ms).
+ * @param	output				Output file, or ipc:// / tcp:// endpoint.
+ */
+	LiveStats (
+		const OGSS_Ushort		numDevices,
+		const OGSS_Real			interval,
+		const OGSS_String		& output);
+
+/**
+ * Destructor.
+ */
+	~LiveStats ();
+
+/**
+ * Launch the publisher thread.
+ */
+	void start ();
+
+/**
+ * Stop the publisher thread, after a last snapshot of the whole simulation.
+ * Must be called by the Execution thread.
+ */
+	void stop ();
+
+/**
+ * Record the completion of a user request.
+ * @param	date				Completion date.
+ * @param	responseTime		Response time (ms).
+ * @param	isFaulty			TRUE if the request is faulty.
+ */
+	inline void recordCompletion (
+		const OGSS_Real			date,
+		const OGSS_Real			responseTime,
+		const OGSS_Bool			isFaulty);
+
+/**
+ * Add working time to a device.
+ * @param	idxDevice			Device index.
+ * @param	time				Working time (ms).
+ */
+	inline void addDeviceTime (
+		const OGSS_Ushort		idxDevice,
+		const OGSS_Real			time);
+
+private:
+/**
+ * Copy of the counters at the end of an interval.
+ */
+	struct Snapshot {
+		OGSS_Real				m_date;				/*!< Simulated time. */
+		OGSS_Ulong				m_numCompleted;		/*!< Completed
+														 requests. */
+		OGSS_Ulong				m_numFaulty;		/*!< Faulty requests. */
+		OGSS_Ulong				m_histogram [NUM_BUCKETS];	/*!< Latency
+														 histogram. */
+		std::vector <OGSS_Real>	m_deviceTime;		/*!< Device working
+														 times. */
+	};
+
+/**
+ * Take a snapshot for each interval which ends before a date.
+ * @param	date				Date reached by the simulation.
+ */
+	void takeSnapshots (
+		const OGSS_Real			date);
+
+/**
+ * Copy the counters in the ring of snapshots.
+ * @param	date				Date of the snapshot.
+ */
+	void pushSnapshot (
+		const OGSS_Real			date);
+
+/**
+ * Publisher thread loop.
+ */
+	void publish ();
+
+/**
+ * Write a snapshot.
+ * @param	stream				Output stream.
+ * @param	snapshot			Snapshot.
+ */
+	void writeSnapshot (
+		std::ostream			& stream,
+		const Snapshot			& snapshot);
+
+/**
+ * Search the percentile of a histogram.
+ * @param	histogram			Histogram.
+ * @param	total				Number of values.
+ * @param	percentile			Searched percentile (between 0 and 1).
+ * @return						Upper bound of the bucket (ms).
+ */
+	OGSS_Real searchPercentile (
+		const OGSS_Ulong		* histogram,
+		const OGSS_Ulong		total,
+		const OGSS_Real			percentile);
+
+	OGSS_Ushort					m_numDevices;		/*!< Number of devices. */
+	OGSS_Real					m_interval;			/*!< Snapshot interval. */
+	OGSS_String					m_output;			/*!< Output. */
+
+	OGSS_Ulong					m_numCompleted;		/*!< Completed requests. */
+	OGSS_Ulong					m_numFaulty;		/*!< Faulty requests. */
+	OGSS_Real					m_simulatedTime;	/*!< Simulated time. */
+	OGSS_Real					m_nextSnapshot;		/*!< End of the current
+														 interval. */
+	OGSS_Ulong					m_histogram [NUM_BUCKETS];	/*!< Latency
+														 histogram. */
+	std::vector <OGSS_Real>		m_deviceTime;		/*!< Device working
+														 times. */
+
+	std::vector <Snapshot>		m_snapshots;		/*!< Ring of
+														 snapshots. */
+	std::atomic <OGSS_Ulong>	m_head;				/*!< Next taken
+														 snapshot. */
+	std::atomic <OGSS_Ulong>	m_tail;				/*!< Next published
+														 snapshot. */
+
+	OGSS_Ulong					m_lastHistogram [NUM_BUCKETS];	/*!< Histogram
+														 at the last
+														 snapshot. */
+	OGSS_Ulong					m_lastCompleted;	/*!< Completed requests at
+														 the last snapshot. */
+
+	std::atomic <OGSS_Bool>		m_running;			/*!< Publisher state. */
+	std::thread					* m_publisher;		/*!< Publisher thread. */
+};
+
+/**************************************/
+/* INLINE FUNCTIONS *******************/
+/**************************************/
+inline void
+LiveStats::recordCompletion (
+	const OGSS_Real			date,
+	const OGSS_Real			responseTime,
+	const OGSS_Bool			isFaulty) {
+	OGSS_Ulong				us;
+	unsigned				bucket = 0;
+
+	// The intervals which end before the completion are published first
+	if (date >= m_nextSnapshot)
+		takeSnapshots (date);
+
+	if (isFaulty)
+		m_numFaulty ++;
+	else
+	{
+		us = (OGSS_Ulong) (responseTime * 1000);
+		while (us != 0 && bucket < NUM_BUCKETS - 1)
+			{ us >>= 1; ++bucket; }
+
+		m_histogram [bucket] ++;
+	}
+
+	if (date > m_simulatedTime)
+		m_simulatedTime = date;
+
+	m_numCompleted ++;
+}
+
+inline void
+LiveStats::addDeviceTime (
+	const OGSS_Ushort		idxDevice,
+	const OGSS_Real			time)
+	{ m_deviceTime [idxDevice] += time; }
+
+#endif
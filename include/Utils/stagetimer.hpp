@@ -0,0 +1,79 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+
+/**
+ * @file	stagetimer.hpp
+ * @brief	StageTimer accumulates the wall time spent in each stage of the
+ * simulation, so that benchmarks can see where the time goes.
+ */
+
+#ifndef __OGSS_STAGETIMER_HPP__
+#define __OGSS_STAGETIMER_HPP__
+
+#include <atomic>
+
+#include "Structures/types.hpp"
+
+class StageTimer {
+public:
+/**
+ * Enable the timers. Until this call, the stages are not timed.
+ */
+	static void enable ();
+
+/**
+ * Check if the timers are enabled.
+ * @return						TRUE if the stages are timed.
+ */
+	static inline OGSS_Bool isEnabled ();
+
+/**
+ * Add time to a stage. Modules can call it concurrently.
+ * @param	stage				Stage.
+ * @param	time				Time (us).
+ */
+	static void add (
+		const StageType			stage,
+		const int64_t			time);
+
+/**
+ * Write the stage times in a JSON file.
+ * @param	filename			Output file.
+ */
+	static void write (
+		const OGSS_String		& filename);
+
+private:
+	static std::atomic <OGSS_Bool>	m_enabled;			/*!< Timer state. */
+	static std::atomic <int64_t>	m_times [STG_TOTAL];/*!< Stage times. */
+};
+
+/**************************************/
+/* INLINE FUNCTIONS *******************/
+/**************************************/
+inline OGSS_Bool
+StageTimer::isEnabled ()
+	{ return m_enabled.load (std::memory_order_relaxed); }
+
+#endif
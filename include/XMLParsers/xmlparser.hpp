@@ -39,6 +39,7 @@
 #include <xercesc/util/PlatformUtils.hpp>
 
 #include "Structures/architecture.hpp"
+#include "Structures/distributed.hpp"
 #include "Structures/event.hpp"
 #include "Structures/graphrequest.hpp"
 #include "Structures/types.hpp"
@@ -271,6 +272,84 @@ namespace XMLParser
 		const OGSS_String		moduleType,
 		ComputationModelType	& type);
 
+/**
+ * Extract request ordering information from the configuration file. The
+ * ordering node is optional: without it, the deterministic mode is off.
+ *
+ * @param	filename			XMLfile.
+ * @param	deterministic		TRUE if deliveries to the Execution are ordered.
+ * @param	quantum				Simulated time between two horizons (ms).
+ */
+	void getOrderingInformation (
+		const OGSS_String		filename,
+		OGSS_Bool				& deterministic,
+		OGSS_Real				& quantum);
+
+/**
+ * Extract the file where the stage times are written. The timing node is
+ * optional: without it, the stages are not timed.
+ *
+ * @param	filename			XMLfile.
+ * @return						Timing file, empty if the timing is off.
+ */
+	OGSS_String getTimingInformation (
+		const OGSS_String		filename);
+
+/**
+ * Extract live statistics streaming information from the configuration file.
+ * The stream node is optional: without it, nothing is streamed.
+ *
+ * @param	filename			XMLfile.
+ * @param	interval			Simulated time between two snapshots (ms), 0
+ *								if the streaming is off.
+ * @param	output				Output file or ZMQ endpoint.
+ */
+	void getStreamInformation (
+		const OGSS_String		filename,
+		OGSS_Real				& interval,
+		OGSS_String				& output);
+
+/**
+ * Extract bus profile information from the configuration file. The busprofile
+ * node is optional: without it, the profiles are kept for the graphs but not
+ * exported.
+ *
+ * @param	filename			XMLfile.
+ * @param	capacity			Max number of entries by bus profile, 0 if not
+ *								given.
+ * @param	output				Output file.
+ */
+	void getBusProfileInformation (
+		const OGSS_String		filename,
+		OGSS_Ulong				& capacity,
+		OGSS_String				& output);
+
+/**
+ * Extract event trace information from the configuration file. The trace node
+ * is optional: without it, nothing is traced.
+ *
+ * @param	filename			XMLfile.
+ * @param	output				Trace file, empty if the tracing is off.
+ * @param	components			Traced components, separated by commas.
+ */
+	void getTraceInformation (
+		const OGSS_String		filename,
+		OGSS_String				& output,
+		OGSS_String				& components);
+
+/**
+ * Extract the worker processes of a distributed simulation from the
+ * configuration file. A coordinator gets one worker per node, a worker
+ * configuration gets only the node describing itself. The tier range is
+ * written "first-last" or "tier".
+ *
+ * @param	filename			XMLfile.
+ * @param	workers				Worker descriptions.
+ */
+	void getDistributedInformation (
+		const OGSS_String		filename,
+		std::vector <WorkerDescription>	& workers);
+
 /**************************************/
 /* PRIVATE FUNCTIONS ******************/
 /**************************************/
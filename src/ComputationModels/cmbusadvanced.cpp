@@ -29,6 +29,7 @@
  */
 
 #include "ComputationModels/cmbusadvanced.hpp"
+#include "Utils/eventtrace.hpp"
 
 #include <glog/logging.h>
 
@@ -36,6 +37,8 @@ using namespace std;
 
 #define REQUEST_SIZE 			128
 #define ACKNOWLEDGMENT_SIZE 	128
+#define WAITING_LIST_ARITY		4
+#define NO_UNIT					OGSS_ULONG_MAX
 
 #define _BUS(bus)			m_architecture->m_buses[bus]
 #define _TIER(tier)			m_architecture->m_tiers[tier]
@@ -73,12 +76,15 @@ using namespace std;
 #define _getDeviceID(idxRequest) \
 	m_requests->getIdxDevice (idxRequest)
 
-#define _getHostBuffer() 0
-#define _getTierBuffer(idxRequest) 1 + _getTierID (idxRequest)
-#define _getVolumeBuffer(idxRequest) 1 \
+#define _getHostBusID(unit) m_architecture->m_hosts [(unit) .host] .m_idxBus
+
+#define _getHostBuffer(unit) (unit) .host
+#define _getTierBuffer(idxRequest) m_architecture->m_geometry->m_numHosts \
+	+ _getTierID (idxRequest)
+#define _getVolumeBuffer(idxRequest) m_architecture->m_geometry->m_numHosts \
 	+ m_architecture->m_geometry->m_numTiers \
 	+ _getVolumeID (idxRequest)
-#define _getDeviceBuffer(idxRequest) 1 \
+#define _getDeviceBuffer(idxRequest) m_architecture->m_geometry->m_numHosts \
 	+ m_architecture->m_geometry->m_numTiers \
 	+ m_architecture->m_geometry->m_numVolumes \
 	+ _getDeviceID (idxRequest)
@@ -112,21 +118,36 @@ CMBusAdvanced::CMBusAdvanced (
 		subresultFile) {
 	int						idx = 0;
 
-	m_lastParent = -1;
 	m_nextParent = 0;
+	m_arrivalOrdering = false;
+	m_numArrivals = 0;
 
-	m_waitingList = new set <TransferUnit>
+	m_waitingList = new vector <OGSS_Ulong>
 		[architecture->m_geometry->m_numBuses];
-	m_bufferSize = new OGSS_Ulong [1 + architecture->m_geometry->m_numTiers
+	m_busHeapPosition.assign (architecture->m_geometry->m_numBuses,
+		OGSS_USHORT_MAX);
+	m_bufferSize = new OGSS_Ulong [architecture->m_geometry->m_numHosts
+		+ architecture->m_geometry->m_numTiers
 		+ architecture->m_geometry->m_numVolumes
 		+ architecture->m_geometry->m_numDevices];
-	m_bufferPresence = new OGSS_Bool [1 + architecture->m_geometry->m_numTiers
+	m_bufferPresence = new OGSS_Bool [architecture->m_geometry->m_numHosts
+		+ architecture->m_geometry->m_numTiers
 		+ architecture->m_geometry->m_numVolumes
 		+ architecture->m_geometry->m_numDevices];
 
-// buffer of Host, considerate infinite
-	m_bufferPresence [idx] = true;
-	m_bufferSize [idx++] = OGSS_ULONG_MAX;
+// buffers of the hosts, considerate infinite if no size is given
+	for (auto i = 0; i < architecture->m_geometry->m_numHosts; ++i, ++idx) {
+		m_bufferPresence [idx] = true;
+		m_bufferSize [idx] = (architecture->m_hosts [i] .m_bufferSize != 0) ?
+			architecture->m_hosts [i] .m_bufferSize : OGSS_ULONG_MAX;
+	}
+
+	m_hostOutstanding.assign (architecture->m_geometry->m_numHosts, 0);
+	m_hostPending.resize (architecture->m_geometry->m_numHosts);
+	m_admitted.assign (requests->getNumRequests (), false);
+	m_blockedUnits.assign (requests->getNumRequests ()
+		+ requests->getNumSubrequests (), NO_UNIT);
+	m_heldUnits.assign (requests->getNumRequests (), NO_UNIT);
 
 // initialization of bufferSize vectors, by searching information in
 // architecture structure
@@ -148,26 +169,47 @@ CMBusAdvanced::CMBusAdvanced (
 		if (m_bufferSize [idx] != 0) m_bufferPresence [idx] = true;
 		else m_bufferPresence [idx] = false;
 	}
+
+	m_bufferCapacity.assign (m_bufferSize, m_bufferSize + idx);
+	m_bufferWaiters.resize (idx);
 }
 
 CMBusAdvanced::CMBusAdvanced (
 	const CMBusAdvanced		& cm) :
 	ComputationModel (cm) {
-	m_lastParent = cm.m_lastParent;
 	m_nextParent = cm.m_nextParent;
-	m_waitingList = new set <TransferUnit>
+	m_incompleteParents = cm.m_incompleteParents;
+	m_arrivalOrdering = cm.m_arrivalOrdering;
+	m_numArrivals = cm.m_numArrivals;
+	m_waitingList = new vector <OGSS_Ulong>
 		[m_architecture->m_geometry->m_numBuses];
-	m_bufferSize = new OGSS_Ulong [1 + m_architecture->m_geometry->m_numTiers
+	m_bufferSize = new OGSS_Ulong [m_architecture->m_geometry->m_numHosts
+		+ m_architecture->m_geometry->m_numTiers
 		+ m_architecture->m_geometry->m_numVolumes
 		+ m_architecture->m_geometry->m_numDevices];
-	m_bufferPresence = new OGSS_Bool [1 + m_architecture->m_geometry->m_numTiers
+	m_bufferPresence = new OGSS_Bool [m_architecture->m_geometry->m_numHosts
+		+ m_architecture->m_geometry->m_numTiers
 		+ m_architecture->m_geometry->m_numVolumes
 		+ m_architecture->m_geometry->m_numDevices];
 
 	for (auto i = 0; i < m_architecture->m_geometry->m_numBuses; ++i)
 		m_waitingList [i] = cm.m_waitingList [i];
 
-	for (auto i = 0; i < 1 + m_architecture->m_geometry->m_numTiers
+	m_units = cm.m_units;
+	m_unitPosition = cm.m_unitPosition;
+	m_freeUnits = cm.m_freeUnits;
+	m_busHeap = cm.m_busHeap;
+	m_busHeapPosition = cm.m_busHeapPosition;
+	m_blockedUnits = cm.m_blockedUnits;
+	m_hostOutstanding = cm.m_hostOutstanding;
+	m_hostPending = cm.m_hostPending;
+	m_heldUnits = cm.m_heldUnits;
+	m_admitted = cm.m_admitted;
+	m_bufferCapacity = cm.m_bufferCapacity;
+	m_bufferWaiters = cm.m_bufferWaiters;
+
+	for (auto i = 0; i < m_architecture->m_geometry->m_numHosts
+		+ m_architecture->m_geometry->m_numTiers
 		+ m_architecture->m_geometry->m_numVolumes
 		+ m_architecture->m_geometry->m_numDevices; ++i) {
 		m_bufferSize [i] = cm.m_bufferSize [i];
@@ -213,14 +255,18 @@ CMBusAdvanced::addNewRequest (
 	unit.date = m_requests->getDate (idxRequest);
 
 	unit.idxRequest = idxRequest;
+	unit.order = m_arrivalOrdering ? m_numArrivals++ : idxRequest;
 	unit.size = REQUEST_SIZE;
 	unit.type = _TU_REQ;
 	unit.step = 1; // from host
 	unit.toDevice = true;
 	unit.user = m_requests->getIsUserRequest (idxRequest);
+	unit.host = getHost (idxRequest);
+	unit.reserved = OGSS_USHORT_MAX;
+	unit.handle = allocateUnit ();
 
-	// If write request need to add data size
-	if (RQT_WRITE & type) {
+	// If write request need to add data size (a TRIM does not carry data)
+	if (RQT_WRITE & type && RQT_ERASE != type) {
 		unit.type |= _TU_DATA;
 		unit.size += m_requests->getSize (idxRequest);
 	}
@@ -230,13 +276,11 @@ CMBusAdvanced::addNewRequest (
 	// If only transfer between volume and device
 	if (RQT_PRERD & type) {
 		unit.step = 3; // from volume
-		m_waitingList [_getDeviceBusID (idxRequest)] .insert (unit);
+		insertUnit (_getDeviceBusID (idxRequest), unit);
 		m_bufferSize [_getVolumeBuffer (idxRequest)] -= unit.size;
 	}
-	else {
-		m_waitingList [_getTierBusID ()] .insert (unit);
-		m_bufferSize [_getHostBuffer ()] -= unit.size;
-	}
+	else if (admitUnit (unit, parent) )
+		enterHost (unit);
 }
 
 void
@@ -267,54 +311,17 @@ CMBusAdvanced::process () {
 CMBusAdvanced::TransferUnit
 CMBusAdvanced::searchFirstRequest (
 	OGSS_Ushort				& idxBus) {
-	OGSS_Real				nextDate = numeric_limits <OGSS_Real> ::max ();
 	TransferUnit			unit;
 
 	// Initialization in case no good units were found
 	unit.idxRequest = OGSS_ULONG_MAX;
 
-	for (auto i = 0; i < m_architecture->m_geometry->m_numBuses; ++i) {
-		if (m_waitingList [i] .empty () ) continue;
-
-		// Search for the first tu, BUT not take into account the tu which point
-		// to requests which have to wait (like pre-read or write par)
-		auto ptr = m_waitingList [i] .begin ();
-		do {
-			// If pre-read or write parity
-			if (m_requests->getType (ptr->idxRequest) == RQT_READ
-				|| m_requests->getType (ptr->idxRequest) == RQT_WRITE)
-				break;
-
-			if ( (m_requests->getType (ptr->idxRequest) == RQT_GHSTW
-				|| m_requests->getType (ptr->idxRequest) == RQT_GHSTR)
-				&& (ptr->toDevice != 0
-				|| m_requests->getNumBusChild (ptr->idxRequest) == 1) ) {
-				break;
-			}
-		
-			if (m_requests->getType (ptr->idxRequest) == RQT_PRERD
-				&& m_requests->getGhostDate (
-					m_requests->getIdxParent (ptr->idxRequest) ) != .0) {
-				break;
-			}
-
-			if (m_requests->getType (ptr->idxRequest) == RQT_WRTPR
-				&& m_requests->getNumPrereadChild (
-					m_requests->getIdxParent (ptr->idxRequest) ) == 0) {
-				break;
-			}
-
-			++ptr;
-		} while (ptr != m_waitingList [i] .end () );
+	// The waiting lists only hold the units which can go, the first one of
+	// the bus on top of the heap is the earliest
+	if (m_busHeap.empty () ) return unit;
 
-		if (ptr == m_waitingList [i] .end () ) continue;
-
-		if (ptr->date < nextDate) {
-			nextDate = ptr->date;
-			idxBus = i;
-			unit = *ptr;
-		}
-	}
+	idxBus = m_busHeap [0];
+	unit = m_units [m_waitingList [idxBus] [0] ];
 
 	return unit;
 }
@@ -326,6 +333,7 @@ CMBusAdvanced::canBeProcessed (
 	OGSS_Real				nextDate = unit.date;
 	OGSS_Ushort				nextStep = unit.step;
 	OGSS_Ushort				nextBus;
+	OGSS_Ushort				hostBus;
 	OGSS_Ushort				nextBuffer;
 
 	// Before everything, update requests which waited for another one
@@ -337,9 +345,8 @@ CMBusAdvanced::canBeProcessed (
 				m_requests->getResponseTime (unit.idxRequest) - unit.date
 				- m_requests->getServiceTime (unit.idxRequest) );
 
-			m_waitingList [idxBus] .erase (unit);
 			unit.date = m_requests->getResponseTime (unit.idxRequest);
-			m_waitingList [idxBus] .insert (unit);
+			updateUnit (idxBus, unit);
 
 			return 1;
 		}
@@ -348,10 +355,9 @@ CMBusAdvanced::canBeProcessed (
 		&& unit.toDevice == 1)
 		if (unit.date < m_requests->getGhostDate (
 			m_requests->getIdxParent (unit.idxRequest) ) ) {
-			m_waitingList [idxBus] .erase (unit);
 			unit.date = m_requests->getGhostDate (
 				m_requests->getIdxParent (unit.idxRequest) );
-			m_waitingList [idxBus] .insert (unit);
+			updateUnit (idxBus, unit);
 			return 1;				
 		}
 
@@ -359,51 +365,25 @@ CMBusAdvanced::canBeProcessed (
 		&& unit.toDevice == 1)
 		if (unit.date < m_requests->getPrereadDate (
 			m_requests->getIdxParent (unit.idxRequest) ) ) {
-			m_waitingList [idxBus] .erase (unit);
 			unit.date = m_requests->getPrereadDate (
 				m_requests->getIdxParent (unit.idxRequest) );
-			m_waitingList [idxBus] .insert (unit);
+			updateUnit (idxBus, unit);
 			return 1;				
 		}
 
 	// First check if all requests are in waiting lists (return 0 if not)
-	for (auto i = m_nextParent; i < m_requests->getNumRequests (); ++i) {
-		if (m_requests->getDate (i) > unit.date)
-			break;
-
-		if ( (m_requests->getNumBusChild (i) == OGSS_USHORT_MAX
-			&& !m_requests->getIsDone (i) )
-			|| (m_requests->getNumBusChild (i)
-			!= m_requests->getNumEffBusChild (i) ) )
-			return 0;
-
-        m_nextParent = i + 1;
-	}
-
-
+	if (! allArrived (unit.date) ) return 0;
 
 	// Then check if all necessary bus are ready
 	if (unit.toDevice) {
 		// If going to the device
 		do {
-			// If no buffer until the device, problem with parameter:
-			// consider the request as faulty, and remove the request from
-			// the bus
-			if (nextStep > 3) {
-				LOG(WARNING) << "Request #" << unit.idxRequest << " can not be "
-					<< "processed because there is no buffer available (to "
-					<< "device #" << _getDeviceID (unit.idxRequest) << ")";
-
-				m_requests->isFaulty (unit.idxRequest);
-				m_waitingList [idxBus] .erase (unit);
-				finishRequest (unit.idxRequest);
-				
-				return 1;
-			}
+			hostBus = OGSS_USHORT_MAX;
 
 			switch (nextStep) {
 				case 1:
 					nextBus    = _getTierBusID ();
+					hostBus    = _getHostBusID (unit);
 					nextBuffer = _getTierBuffer (unit.idxRequest); break;
 				case 2:
 					nextBus	   = _getVolumeBusID (unit.idxRequest);
@@ -413,6 +393,16 @@ CMBusAdvanced::canBeProcessed (
 					nextBuffer = _getDeviceBuffer (unit.idxRequest); break;
 			}
 
+			// If the buffer to fill has no room, or other units wait for it,
+			// the unit leaves its bus until a release gives it its room
+			if (nextBuffer != unit.reserved
+				&& (! m_bufferWaiters [nextBuffer] .empty ()
+				|| ! hasRoom (nextBuffer, unit.size) ) ) {
+				eraseUnit (idxBus, unit);
+				waitBuffer (nextBuffer, idxBus, unit);
+				return 1;
+			}
+
 			// If a buffer is found not empty, can store the request data, but
 			// is not available yet, update the date of the unit and relaunch an
 			// iteration of process
@@ -423,33 +413,28 @@ CMBusAdvanced::canBeProcessed (
 				return 1;
 			}
 
+			// The host adapter is crossed with the host bus
+			if (hostBus != OGSS_USHORT_MAX
+				&& m_architecture->m_buses [hostBus] .m_clock > nextDate) {
+				updateTransferUnit (unit, idxBus, unit.date
+					+ (m_architecture->m_buses [hostBus] .m_clock - nextDate) );
+				return 1;
+			}
+
 			++nextStep;
-			nextDate += computeTransferTime (unit.size, nextBus);
-		} while (! m_bufferPresence [nextBuffer]);
+			nextDate += computeTransferTime (unit.size, nextBus, hostBus);
+		} while (! m_bufferPresence [nextBuffer] && nextStep <= 3
+			&& ! (nextStep == 3 && m_requests->getIsCacheHit (unit.idxRequest) ) );
 	} else {
 		// If quitting the device
 		do {
-			// If no buffer until the host OR volume, problem with parameter:
-			// consider the request as faulty, and remove the request from
-			// the bus
-			if (nextStep < 1 || (nextStep < 3
-				&& RQT_PRERD & m_requests->getType (unit.idxRequest) ) ) {
-				LOG(WARNING) << "Request #" << unit.idxRequest << " can not be "
-					<< "processed because there is no buffer available (to "
-					<< "host OR volume #" << _getVolumeID (unit.idxRequest)
-					<< ")";
-
-				m_requests->isFaulty (unit.idxRequest);
-				m_waitingList [idxBus] .erase (unit);
-				finishRequest (unit.idxRequest);
-				
-				return 1;
-			}
+			hostBus = OGSS_USHORT_MAX;
 
 			switch (nextStep) {
 				case 1:
 					nextBus    = _getTierBusID ();
-					nextBuffer = _getHostBuffer (); break;
+					hostBus    = _getHostBusID (unit);
+					nextBuffer = _getHostBuffer (unit); break;
 				case 2:
 					nextBus    = _getVolumeBusID (unit.idxRequest);
 					nextBuffer = _getTierBuffer (unit.idxRequest); break;
@@ -468,9 +453,18 @@ CMBusAdvanced::canBeProcessed (
 				return 1;
 			}
 
+			if (hostBus != OGSS_USHORT_MAX
+				&& m_architecture->m_buses [hostBus] .m_clock > nextDate) {
+				updateTransferUnit (unit, idxBus, unit.date
+					+ (m_architecture->m_buses [hostBus] .m_clock - nextDate) );
+				return 1;
+			}
+
 			-- nextStep;
-			nextDate += computeTransferTime (unit.size, nextBus);
-		} while (! m_bufferPresence [nextBuffer] );
+			nextDate += computeTransferTime (unit.size, nextBus, hostBus);
+		} while (! m_bufferPresence [nextBuffer] && nextStep > 0
+			&& ! (nextStep < 3
+			&& RQT_PRERD & m_requests->getType (unit.idxRequest) ) );
 	}
 
 	return 2;
@@ -482,8 +476,13 @@ CMBusAdvanced::processRequest (
 	OGSS_Ushort				nextBus) {
 	OGSS_Ushort				nextBuffer;
 	OGSS_Ushort				oldBuffer;
+	OGSS_Ushort				hostBus;
+	OGSS_Real				transferTime;
+	OGSS_Real				start;
+	OGSS_Real				arrival = unit.date;
+	OGSS_Ulong				size = unit.size;
 
-	m_waitingList [nextBus] .erase (unit);
+	eraseUnit (nextBus, unit);
 
 	// Update launch transfert date to bus clock if needed
 	if (unit.date < m_architecture->m_buses [nextBus] .m_clock) {
@@ -496,10 +495,13 @@ CMBusAdvanced::processRequest (
 	if (unit.toDevice) {
 		// If going to the device
 		do {
+			hostBus = OGSS_USHORT_MAX;
+
 			switch (unit.step) {
 				case 1:
 					nextBus    = _getTierBusID ();
-					oldBuffer  = _getHostBuffer ();
+					hostBus    = _getHostBusID (unit);
+					oldBuffer  = _getHostBuffer (unit);
 					nextBuffer = _getTierBuffer (unit.idxRequest); break;
 				case 2:
 					nextBus	   = _getVolumeBusID (unit.idxRequest);
@@ -511,20 +513,37 @@ CMBusAdvanced::processRequest (
 					nextBuffer = _getDeviceBuffer (unit.idxRequest); break;
 			}
 
-			if (RQT_WRITE & m_requests->getType (unit.idxRequest) ) {
-				m_bufferSize [nextBuffer] -= unit.size;
-				m_bufferSize [oldBuffer] += unit.size - REQUEST_SIZE;
-			} else {
+			// The room may be already taken when the unit was woken up
+			if (nextBuffer == unit.reserved)
+				unit.reserved = OGSS_USHORT_MAX;
+			else
 				m_bufferSize [nextBuffer] -= unit.size;
-			}
 
 			++unit.step;
+			transferTime = computeTransferTime (unit.size, nextBus, hostBus);
 			m_requests->setTransferTime (unit.idxRequest,
-				m_requests->getTransferTime (unit.idxRequest)
-				+ computeTransferTime (unit.size, nextBus) );
-			unit.date += computeTransferTime (unit.size, nextBus);
+				m_requests->getTransferTime (unit.idxRequest) + transferTime);
+			m_architecture->m_buses [nextBus] .recordTransfer (arrival,
+				transferTime);
+			if (hostBus != OGSS_USHORT_MAX)
+				m_architecture->m_buses [hostBus] .recordTransfer (arrival,
+					transferTime);
+			unit.date += transferTime;
+			if (EventTrace::isEnabled (TRC_BUS) )
+				EventTrace::record (TRC_BUS, nextBus, unit.step, unit.toDevice,
+					unit.idxRequest, arrival, unit.date,
+					m_bufferCapacity [nextBuffer] - m_bufferSize [nextBuffer]);
+			arrival = unit.date;
 			m_architecture->m_buses [nextBus] .m_clock = unit.date;
-		} while (! m_bufferPresence [nextBuffer] );
+			if (hostBus != OGSS_USHORT_MAX)
+				m_architecture->m_buses [hostBus] .m_clock = unit.date;
+
+			// A write moves its data, only the request stays in the previous
+			// buffer until the answer
+			if (RQT_WRITE & m_requests->getType (unit.idxRequest) )
+				releaseBuffer (oldBuffer, unit.size - REQUEST_SIZE, unit.date);
+		} while (! m_bufferPresence [nextBuffer] && unit.step <= 3
+			&& ! (unit.step == 3 && m_requests->getIsCacheHit (unit.idxRequest) ) );
 
 		// Add the transfer unit to the new waiting list
 		// Need to change the direction if arrived to device
@@ -532,20 +551,15 @@ CMBusAdvanced::processRequest (
 			unit.step = 3;
 			unit.toDevice = false;
 			
-			if (unit.date 
-				< m_architecture->m_devices [_getDeviceID (unit.idxRequest)] .m_clock) {
-				m_requests->setDeviceWaitingTime (unit.idxRequest,
-					m_architecture->m_devices [_getDeviceID (unit.idxRequest)] .m_clock
-					- unit.date);
-				unit.date = m_architecture->m_devices [_getDeviceID (unit.idxRequest)] .m_clock;
-			}
-			else
-				m_requests->setDeviceWaitingTime (unit.idxRequest, .0);
-		
-			unit.date += m_requests->getServiceTime (unit.idxRequest);
+			start = unit.date;
+			unit.date = placeOnDevice (unit.idxRequest, start);
+			start += m_requests->getDeviceWaitingTime (unit.idxRequest);
 
-			m_architecture->m_devices [_getDeviceID (unit.idxRequest)] .m_clock
-				= unit.date;
+			if (EventTrace::isEnabled (TRC_DEVICE) )
+				EventTrace::record (TRC_DEVICE, _getDeviceID (unit.idxRequest),
+					unit.step, true, unit.idxRequest, start, unit.date,
+					m_bufferCapacity [_getDeviceBuffer (unit.idxRequest)]
+					- m_bufferSize [_getDeviceBuffer (unit.idxRequest)]);
 
 			unit.size = ACKNOWLEDGMENT_SIZE;
 
@@ -556,8 +570,26 @@ CMBusAdvanced::processRequest (
 				unit.size += m_requests->getSize (unit.idxRequest);
 			}
 
-			m_waitingList [_getDeviceBusID (unit.idxRequest) ]
-				.insert (unit);
+			turnBuffer (_getDeviceBuffer (unit.idxRequest), size, unit);
+			insertUnit (_getDeviceBusID (unit.idxRequest), unit);
+		} else if (m_requests->getIsCacheHit (unit.idxRequest)
+			&& unit.step == 3) {
+			// Served by the volume cache, turn around at the volume
+			unit.step = 2;
+			unit.toDevice = false;
+			m_requests->setDeviceWaitingTime (unit.idxRequest, .0);
+			unit.date += m_requests->getServiceTime (unit.idxRequest);
+			unit.size = ACKNOWLEDGMENT_SIZE;
+
+			if (RQT_WRITE & m_requests->getType (unit.idxRequest) ) {
+				unit.type = _TU_ACK;
+			} else {
+				unit.type = _TU_DATA | _TU_ACK;
+				unit.size += m_requests->getSize (unit.idxRequest);
+			}
+
+			turnBuffer (_getVolumeBuffer (unit.idxRequest), size, unit);
+			insertUnit (_getVolumeBusID (unit.idxRequest), unit);
 		} else if (m_requests->getType (unit.idxRequest) == RQT_GHSTR
 			&& unit.step == 3) {
 			unit.step = 2;
@@ -565,7 +597,9 @@ CMBusAdvanced::processRequest (
 			unit.size = ACKNOWLEDGMENT_SIZE + m_requests->getSize (unit.idxRequest);
 			unit.type = _TU_ACK | _TU_DATA;
 			m_requests->setGhostDate (unit.idxRequest, unit.date);
-			m_waitingList [_getVolumeBusID (unit.idxRequest)] .insert (unit);
+			turnBuffer (_getVolumeBuffer (unit.idxRequest), size, unit);
+			insertUnit (_getVolumeBusID (unit.idxRequest), unit);
+			releaseUnits (unit.idxRequest);
 		} else if (m_requests->getType (unit.idxRequest) == RQT_GHSTW
 			&& unit.step == 3) {
 			unit.step = 2;
@@ -573,27 +607,30 @@ CMBusAdvanced::processRequest (
 			unit.size = ACKNOWLEDGMENT_SIZE;
 			unit.type = _TU_ACK;
 			m_requests->setGhostDate (unit.idxRequest, unit.date);
-			m_waitingList [_getVolumeBusID (unit.idxRequest)] .insert (unit);
+			turnBuffer (_getVolumeBuffer (unit.idxRequest), size, unit);
+			insertUnit (_getVolumeBusID (unit.idxRequest), unit);
+			releaseUnits (unit.idxRequest);
 		} else {
 			switch (unit.step) {
 				case 2:
-					m_waitingList [_getVolumeBusID (unit.idxRequest) ]
-						.insert (unit);
+					insertUnit (_getVolumeBusID (unit.idxRequest), unit);
 					break;
 				case 3:
-					m_waitingList [_getDeviceBusID (unit.idxRequest) ]
-						.insert (unit);
+					insertUnit (_getDeviceBusID (unit.idxRequest), unit);
 					break;
 			}
 		}
 	} else {
 		// If quitting the device
 		do {
+			hostBus = OGSS_USHORT_MAX;
+
 			switch (unit.step) {
 				case 1:
 					nextBus    = _getTierBusID ();
+					hostBus    = _getHostBusID (unit);
 					oldBuffer  = _getTierBuffer (unit.idxRequest);
-					nextBuffer = _getHostBuffer (); break;
+					nextBuffer = _getHostBuffer (unit); break;
 				case 2:
 					nextBus    = _getVolumeBusID (unit.idxRequest);
 					oldBuffer  = _getVolumeBuffer (unit.idxRequest);
@@ -604,31 +641,40 @@ CMBusAdvanced::processRequest (
 					nextBuffer = _getVolumeBuffer (unit.idxRequest); break;
 			}
 
-			if (RQT_WRITE & m_requests->getType (unit.idxRequest) ) {
-				m_bufferSize [nextBuffer] -= unit.size;
-				m_bufferSize [oldBuffer] += unit.size + REQUEST_SIZE;
-			} else {
-				m_bufferSize [nextBuffer] -= unit.size;
-				m_bufferSize [oldBuffer] += unit.size + REQUEST_SIZE;
-			}
+			m_bufferSize [nextBuffer] -= unit.size;
 
 			--unit.step;
+			transferTime = computeTransferTime (unit.size, nextBus, hostBus);
 			m_requests->setTransferTime (unit.idxRequest,
-				m_requests->getTransferTime (unit.idxRequest)
-				+ computeTransferTime (unit.size, nextBus) );
-			unit.date += computeTransferTime (unit.size, nextBus);
+				m_requests->getTransferTime (unit.idxRequest) + transferTime);
+			m_architecture->m_buses [nextBus] .recordTransfer (arrival,
+				transferTime);
+			if (hostBus != OGSS_USHORT_MAX)
+				m_architecture->m_buses [hostBus] .recordTransfer (arrival,
+					transferTime);
+			unit.date += transferTime;
+			if (EventTrace::isEnabled (TRC_BUS) )
+				EventTrace::record (TRC_BUS, nextBus, unit.step, unit.toDevice,
+					unit.idxRequest, arrival, unit.date,
+					m_bufferCapacity [nextBuffer] - m_bufferSize [nextBuffer]);
+			arrival = unit.date;
 			m_architecture->m_buses [nextBus] .m_clock = unit.date;
-		} while (! m_bufferPresence [nextBuffer] );
+			if (hostBus != OGSS_USHORT_MAX)
+				m_architecture->m_buses [hostBus] .m_clock = unit.date;
+
+			releaseBuffer (oldBuffer, unit.size + REQUEST_SIZE, unit.date);
+		} while (! m_bufferPresence [nextBuffer] && unit.step > 0
+			&& ! (unit.step < 3
+			&& RQT_PRERD & m_requests->getType (unit.idxRequest) ) );
 
 		if (unit.step > 0 &&
 			(! (RQT_PRERD & m_requests->getType (unit.idxRequest) ) ) ) {
 			switch (unit.step) {
 				case 1:
-					m_waitingList [_getTierBusID () ] .insert (unit);
+					insertUnit (_getTierBusID (), unit);
 					break;
 				case 2:
-					m_waitingList [_getVolumeBusID (unit.idxRequest) ]
-						.insert (unit);
+					insertUnit (_getVolumeBusID (unit.idxRequest), unit);
 					break;
 			}
 		}
@@ -636,6 +682,7 @@ CMBusAdvanced::processRequest (
 			if (RQT_PRERD == m_requests->getType (unit.idxRequest) ) {
 				m_requests->setResponseTime (unit.idxRequest,
 					m_requests->getBusWaitingTime (unit.idxRequest)
+					+ m_requests->getBufferWaitingTime (unit.idxRequest)
 					+ m_requests->getTransferTime (unit.idxRequest)
 					+ m_requests->getDeviceWaitingTime (unit.idxRequest)
 					+ m_requests->getServiceTime (unit.idxRequest) );
@@ -653,6 +700,7 @@ CMBusAdvanced::processRequest (
 			} else if (RQT_WRTPR == m_requests->getType (unit.idxRequest) ) {
 				m_requests->setResponseTime (unit.idxRequest,
 					m_requests->getBusWaitingTime (unit.idxRequest)
+					+ m_requests->getBufferWaitingTime (unit.idxRequest)
 					+ m_requests->getTransferTime (unit.idxRequest)
 					+ m_requests->getDeviceWaitingTime (unit.idxRequest)
 					+ m_requests->getServiceTime (unit.idxRequest) );
@@ -664,6 +712,10 @@ CMBusAdvanced::processRequest (
 					m_requests->getServiceTime (unit.idxRequest) ) );
 			}
 
+			// The request leaves the buffer it came back to, with its answer
+			releaseBuffer (nextBuffer, unit.size + REQUEST_SIZE, unit.date);
+
+			freeUnit (unit.handle);
 			finishRequest (unit.idxRequest);
 		}
 	}
@@ -675,20 +727,507 @@ CMBusAdvanced::updateTransferUnit (
 	TransferUnit			unit,
 	const OGSS_Ushort		idxBus,
 	const OGSS_Real			newDate) {
-	m_waitingList [idxBus] .erase (unit);
 	m_requests->setBusWaitingTime (unit.idxRequest,
 		m_requests->getBusWaitingTime (unit.idxRequest)
 		+ (newDate - unit.date) );
 	unit.date = newDate;
-	m_waitingList [idxBus] .insert (unit);
+	updateUnit (idxBus, unit);
+}
+
+OGSS_Bool
+CMBusAdvanced::allArrived (
+	const OGSS_Real			date) {
+	OGSS_Ulong				idx;
+
+	// The parents behind the frontier which were incomplete wait in the
+	// heap, the earliest one stops the units after its date
+	while (! m_incompleteParents.empty () ) {
+		idx = m_incompleteParents.top () .second;
+
+		if (m_requests->getNumBusChild (idx)
+			!= m_requests->getNumEffBusChild (idx) )
+			break;
+
+		m_incompleteParents.pop ();
+	}
+
+	if (! m_incompleteParents.empty ()
+		&& m_incompleteParents.top () .first <= date)
+		return false;
+
+	// Move the frontier over the parents which arrived before the date
+	for (; m_nextParent < m_requests->getNumRequests (); ++m_nextParent) {
+		idx = m_nextParent;
+
+		if (m_requests->getDate (idx) > date)
+			break;
+
+		// Not decomposed yet
+		if (m_requests->getNumBusChild (idx) == OGSS_USHORT_MAX
+			&& ! m_requests->getIsDone (idx) )
+			return false;
+
+		if (m_requests->getNumBusChild (idx)
+			!= m_requests->getNumEffBusChild (idx) ) {
+			m_incompleteParents.push (make_pair (
+				m_requests->getDate (idx), idx) );
+			++m_nextParent;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+OGSS_Bool
+CMBusAdvanced::isBlocked (
+	const TransferUnit		& unit,
+	OGSS_Ulong				& idxRequest) {
+	RequestType				type = m_requests->getType (unit.idxRequest);
+
+	idxRequest = unit.idxRequest;
+
+	if (type == RQT_READ || type == RQT_WRITE || type == RQT_ERASE)
+		return false;
+
+	// A ghost goes back when its pre-reads and writes are done
+	if (type == RQT_GHSTW || type == RQT_GHSTR)
+		return unit.toDevice == 0
+			&& m_requests->getNumBusChild (unit.idxRequest) != 1;
+
+	// A pre-read waits for its ghost, a write for the pre-reads
+	if (type == RQT_PRERD) {
+		idxRequest = m_requests->getIdxParent (unit.idxRequest);
+		return m_requests->getGhostDate (idxRequest) == .0;
+	}
+
+	if (type == RQT_WRTPR) {
+		idxRequest = m_requests->getIdxParent (unit.idxRequest);
+		return m_requests->getNumPrereadChild (idxRequest) != 0;
+	}
+
+	return true;
+}
+
+void
+CMBusAdvanced::insertUnit (
+	const OGSS_Ushort		idxBus,
+	const TransferUnit		& unit) {
+	OGSS_Ulong				idxRequest;
+
+	m_units [unit.handle] = unit;
+
+	if (isBlocked (unit, idxRequest) ) {
+		m_units [unit.handle] .bus = idxBus;
+		parkUnit (m_blockedUnits, idxRequest, unit.handle);
+		return;
+	}
+
+	pushUnit (idxBus, unit.handle);
+}
+
+void
+CMBusAdvanced::eraseUnit (
+	const OGSS_Ushort		idxBus,
+	const TransferUnit		& unit) {
+	vector <OGSS_Ulong>		& list = m_waitingList [idxBus];
+	OGSS_Ulong				pos = m_unitPosition [unit.handle];
+
+	// Replace the unit by the last one of the list, its slot is kept
+	list [pos] = list.back ();
+	m_unitPosition [list [pos] ] = pos;
+	list.pop_back ();
+
+	if (pos < list.size () ) siftUnit (idxBus, pos);
+	updateBusHeap (idxBus);
+}
+
+void
+CMBusAdvanced::updateUnit (
+	const OGSS_Ushort		idxBus,
+	const TransferUnit		& unit) {
+	m_units [unit.handle] = unit;
+	siftUnit (idxBus, m_unitPosition [unit.handle]);
+	updateBusHeap (idxBus);
+}
+
+OGSS_Ulong
+CMBusAdvanced::allocateUnit () {
+	OGSS_Ulong				handle;
+
+	if (m_freeUnits.empty () ) {
+		m_units.push_back (TransferUnit () );
+		m_unitPosition.push_back (0);
+		return m_units.size () - 1;
+	}
+
+	handle = m_freeUnits.back ();
+	m_freeUnits.pop_back ();
+
+	return handle;
+}
+
+void
+CMBusAdvanced::freeUnit (
+	const OGSS_Ulong		handle) {
+	m_freeUnits.push_back (handle);
+}
+
+void
+CMBusAdvanced::pushUnit (
+	const OGSS_Ushort		idxBus,
+	const OGSS_Ulong		handle) {
+	m_unitPosition [handle] = m_waitingList [idxBus] .size ();
+	m_waitingList [idxBus] .push_back (handle);
+
+	siftUnit (idxBus, m_unitPosition [handle]);
+	updateBusHeap (idxBus);
+}
+
+void
+CMBusAdvanced::siftUnit (
+	const OGSS_Ushort		idxBus,
+	OGSS_Ulong				pos) {
+	vector <OGSS_Ulong>		& list = m_waitingList [idxBus];
+	OGSS_Ulong				handle = list [pos];
+	OGSS_Ulong				child, last, parent;
+
+	while (pos > 0) {
+		parent = (pos - 1) / WAITING_LIST_ARITY;
+		if (! (m_units [handle] < m_units [list [parent] ] ) ) break;
+
+		list [pos] = list [parent];
+		m_unitPosition [list [pos] ] = pos;
+		pos = parent;
+	}
+
+	while ( (child = WAITING_LIST_ARITY * pos + 1) < list.size () ) {
+		last = min (child + WAITING_LIST_ARITY, (OGSS_Ulong) list.size () );
+
+		for (OGSS_Ulong i = child + 1; i < last; ++i)
+			if (m_units [list [i] ] < m_units [list [child] ])
+				child = i;
+
+		if (! (m_units [list [child] ] < m_units [handle]) ) break;
+
+		list [pos] = list [child];
+		m_unitPosition [list [pos] ] = pos;
+		pos = child;
+	}
+
+	list [pos] = handle;
+	m_unitPosition [handle] = pos;
+}
+
+void
+CMBusAdvanced::parkUnit (
+	vector <OGSS_Ulong>		& chains,
+	const OGSS_Ulong		idxRequest,
+	const OGSS_Ulong		handle) {
+	OGSS_Ulong				last = chains [idxRequest];
+
+	// The slot keeps its last unit, whose next handle is the first one
+	if (last == NO_UNIT)
+		m_units [handle] .next = handle;
+	else {
+		m_units [handle] .next = m_units [last] .next;
+		m_units [last] .next = handle;
+	}
+
+	chains [idxRequest] = handle;
+}
+
+OGSS_Ulong
+CMBusAdvanced::takeUnits (
+	vector <OGSS_Ulong>		& chains,
+	const OGSS_Ulong		idxRequest) {
+	OGSS_Ulong				last = chains [idxRequest];
+	OGSS_Ulong				first;
+
+	if (last == NO_UNIT) return NO_UNIT;
+
+	// The ring is opened after its last unit
+	first = m_units [last] .next;
+	m_units [last] .next = NO_UNIT;
+	chains [idxRequest] = NO_UNIT;
+
+	return first;
+}
+
+void
+CMBusAdvanced::releaseUnits (
+	const OGSS_Ulong		idxRequest) {
+	OGSS_Ulong				handle = takeUnits (m_blockedUnits, idxRequest);
+	OGSS_Ulong				next;
+	OGSS_Ulong				dependency;
+
+	// The units still blocked go back to the slot, in the same order
+	for (; handle != NO_UNIT; handle = next) {
+		next = m_units [handle] .next;
+
+		if (isBlocked (m_units [handle], dependency) )
+			parkUnit (m_blockedUnits, idxRequest, handle);
+		else
+			pushUnit (m_units [handle] .bus, handle);
+	}
+}
+
+OGSS_Bool
+CMBusAdvanced::busHeadBefore (
+	const OGSS_Ushort		lhs,
+	const OGSS_Ushort		rhs) {
+	OGSS_Real				lhsDate = m_units [m_waitingList [lhs] [0] ] .date;
+	OGSS_Real				rhsDate = m_units [m_waitingList [rhs] [0] ] .date;
+
+	// Same order as a scan of the buses by index
+	return lhsDate < rhsDate || (lhsDate == rhsDate && lhs < rhs);
+}
+
+void
+CMBusAdvanced::updateBusHeap (
+	const OGSS_Ushort		idxBus) {
+	OGSS_Ushort				pos = m_busHeapPosition [idxBus];
+	OGSS_Ushort				last;
+
+	if (m_waitingList [idxBus] .empty () ) {
+		if (pos == OGSS_USHORT_MAX) return;
+
+		// Replace the bus by the last one of the heap
+		last = m_busHeap.back ();
+		m_busHeap.pop_back ();
+		m_busHeapPosition [idxBus] = OGSS_USHORT_MAX;
+
+		if (last == idxBus) return;
+
+		m_busHeap [pos] = last;
+		m_busHeapPosition [last] = pos;
+		siftBusHeap (pos);
+		return;
+	}
+
+	if (pos == OGSS_USHORT_MAX) {
+		pos = m_busHeap.size ();
+		m_busHeap.push_back (idxBus);
+		m_busHeapPosition [idxBus] = pos;
+	}
+
+	siftBusHeap (pos);
+}
+
+void
+CMBusAdvanced::siftBusHeap (
+	OGSS_Ushort				pos) {
+	OGSS_Ushort				idxBus = m_busHeap [pos];
+	OGSS_Ushort				child;
+
+	while (pos > 0 && busHeadBefore (idxBus, m_busHeap [(pos - 1) / 2]) ) {
+		m_busHeap [pos] = m_busHeap [(pos - 1) / 2];
+		m_busHeapPosition [m_busHeap [pos] ] = pos;
+		pos = (pos - 1) / 2;
+	}
+
+	while ( (child = 2 * pos + 1) < m_busHeap.size () ) {
+		if (child + 1u < m_busHeap.size ()
+			&& busHeadBefore (m_busHeap [child + 1], m_busHeap [child]) )
+			++child;
+
+		if (! busHeadBefore (m_busHeap [child], idxBus) ) break;
+
+		m_busHeap [pos] = m_busHeap [child];
+		m_busHeapPosition [m_busHeap [pos] ] = pos;
+		pos = child;
+	}
+
+	m_busHeap [pos] = idxBus;
+	m_busHeapPosition [idxBus] = pos;
+}
+
+OGSS_Ushort
+CMBusAdvanced::getHost (
+	const OGSS_Ulong		idxRequest) {
+	unsigned				host;
+	unsigned				pid;
+
+	if (m_requests->getFormat () != 2) return 0;
+
+	m_requests->getOptions (idxRequest, host, pid);
+
+	return m_architecture->getIdxHost (host);
+}
+
+OGSS_Bool
+CMBusAdvanced::admitUnit (
+	const TransferUnit		& unit,
+	const OGSS_Ulong		parent) {
+	const Host				& host = m_architecture->m_hosts [unit.host];
+
+	if (host.m_maxOutstanding == 0 || parent >= m_admitted.size ()
+		|| m_admitted [parent])
+		return true;
+
+	// The parent takes a slot of its host if there is one free and no other
+	// parent is waiting before it
+	if (m_hostOutstanding [unit.host] < host.m_maxOutstanding
+		&& m_hostPending [unit.host] .empty () ) {
+		m_admitted [parent] = true;
+		++m_hostOutstanding [unit.host];
+		return true;
+	}
+
+	// Otherwise the unit is held until a slot is released
+	m_units [unit.handle] = unit;
+
+	if (m_heldUnits [parent] == NO_UNIT)
+		m_hostPending [unit.host] .push_back (parent);
+	parkUnit (m_heldUnits, parent, unit.handle);
+
+	return false;
+}
+
+void
+CMBusAdvanced::admitPending (
+	const OGSS_Ushort		host,
+	const OGSS_Real			date) {
+	OGSS_Ulong				parent;
+	OGSS_Ulong				handle, next;
+
+	while (! m_hostPending [host] .empty ()
+		&& m_hostOutstanding [host]
+			< m_architecture->m_hosts [host] .m_maxOutstanding) {
+		parent = m_hostPending [host] .front ();
+		m_hostPending [host] .pop_front ();
+
+		m_admitted [parent] = true;
+		++m_hostOutstanding [host];
+
+		handle = takeUnits (m_heldUnits, parent);
+
+		for (; handle != NO_UNIT; handle = next) {
+			TransferUnit	unit = m_units [handle];
+
+			next = unit.next;
+
+			// The time spent for a slot is a waiting time before the host bus
+			if (unit.date < date) {
+				m_requests->setBusWaitingTime (unit.idxRequest,
+					m_requests->getBusWaitingTime (unit.idxRequest)
+					+ date - unit.date);
+				unit.date = date;
+			}
+
+			enterHost (unit);
+		}
+	}
+}
+
+void
+CMBusAdvanced::enterHost (
+	const TransferUnit		& unit) {
+	OGSS_Ushort				idxBuffer = _getHostBuffer (unit);
+
+	// A new unit takes its room in the host buffer before the host bus, after
+	// the units which already wait for it
+	if (! m_bufferWaiters [idxBuffer] .empty ()
+		|| ! hasRoom (idxBuffer, unit.size) ) {
+		waitBuffer (idxBuffer, OGSS_USHORT_MAX, unit);
+		return;
+	}
+
+	insertUnit (_getTierBusID (), unit);
+	m_bufferSize [idxBuffer] -= unit.size;
+}
+
+OGSS_Bool
+CMBusAdvanced::hasRoom (
+	const OGSS_Ushort		idxBuffer,
+	const OGSS_Ulong		size) {
+	OGSS_Ulong				available = m_bufferSize [idxBuffer];
+
+	// No limit for the components without buffer and the default hosts
+	if (! m_bufferPresence [idxBuffer]
+		|| m_bufferCapacity [idxBuffer] == OGSS_ULONG_MAX)
+		return true;
+
+	// The answers may overfill the buffer, the available size is then beyond
+	// the capacity
+	if (available > m_bufferCapacity [idxBuffer])
+		return false;
+
+	// A unit larger than the buffer goes alone in it
+	return available >= size || available == m_bufferCapacity [idxBuffer];
+}
+
+void
+CMBusAdvanced::waitBuffer (
+	const OGSS_Ushort		idxBuffer,
+	const OGSS_Ushort		idxBus,
+	const TransferUnit		& unit) {
+	m_units [unit.handle] = unit;
+	m_bufferWaiters [idxBuffer] .push_back (make_pair (idxBus, unit.handle) );
+}
+
+void
+CMBusAdvanced::releaseBuffer (
+	const OGSS_Ushort		idxBuffer,
+	const OGSS_Ulong		size,
+	const OGSS_Real			date) {
+	deque <pair <OGSS_Ushort, OGSS_Ulong> >	& waiters
+							= m_bufferWaiters [idxBuffer];
+	OGSS_Ushort				idxBus;
+
+	m_bufferSize [idxBuffer] += size;
+
+	// The waiting units take the room released in order, and go back to
+	// their bus
+	while (! waiters.empty () ) {
+		TransferUnit		unit = m_units [waiters.front () .second];
+
+		if (! hasRoom (idxBuffer, unit.size) ) break;
+
+		idxBus = waiters.front () .first;
+		waiters.pop_front ();
+		m_bufferSize [idxBuffer] -= unit.size;
+
+		if (unit.date < date) {
+			m_requests->addBufferWaitingTime (unit.idxRequest,
+				date - unit.date);
+			unit.date = date;
+		}
+
+		// A new unit was not on a bus yet
+		if (idxBus == OGSS_USHORT_MAX)
+			idxBus = _getTierBusID ();
+		else
+			unit.reserved = idxBuffer;
+
+		insertUnit (idxBus, unit);
+	}
+}
+
+void
+CMBusAdvanced::turnBuffer (
+	const OGSS_Ushort		idxBuffer,
+	const OGSS_Ulong		size,
+	const TransferUnit		& unit) {
+	// The answer takes the place of the request in the buffer where it turns
+	// around, with the room of the request kept until it leaves
+	m_bufferSize [idxBuffer] -= unit.size + REQUEST_SIZE;
+	releaseBuffer (idxBuffer, size, unit.date);
 }
 
 OGSS_Real
 CMBusAdvanced::computeTransferTime (
 	const OGSS_Ulong		size,
-	const OGSS_Ushort		idxBus) {
-	return ( (OGSS_Real) size) 
-		/ (m_architecture->m_buses [idxBus] .m_bandwidth * MEGABYTE * MILLISEC);
+	const OGSS_Ushort		idxBus,
+	const OGSS_Ushort		idxHostBus) {
+	OGSS_Real				bandwidth = m_architecture->m_buses [idxBus] .m_bandwidth;
+
+	// The host adapter limits the transfer on the host bus
+	if (idxHostBus != OGSS_USHORT_MAX)
+		bandwidth = min (bandwidth,
+			m_architecture->m_buses [idxHostBus] .m_bandwidth);
+
+	return ( (OGSS_Real) size) / (bandwidth * MEGABYTE * MILLISEC);
 }
 
 void
@@ -702,6 +1241,7 @@ CMBusAdvanced::finishRequest (
 	// Update request response time
 	m_requests->setResponseTime (idxRequest, 
 		m_requests->getBusWaitingTime (idxRequest) +
+		m_requests->getBufferWaitingTime (idxRequest) +
 		m_requests->getTransferTime (idxRequest) +
 		m_requests->getDeviceWaitingTime (idxRequest) +
 		m_requests->getServiceTime (idxRequest) );
@@ -709,12 +1249,8 @@ CMBusAdvanced::finishRequest (
 	m_requests->decNumBusChild (parent);
 	m_requests->decNumEffBusChild (parent);
 
-	for (++m_lastParent; m_lastParent < m_requests->getNumRequests ();
-		++m_lastParent) {
-		if (m_requests->getNumBusChild (m_lastParent) != 0) {
-			--m_lastParent; break;
-		}
-	}
+	// The units of the parent may wait for its remaining children
+	if (parent != idxRequest) releaseUnits (parent);
 
 	if (parent != idxRequest) {
 		m_requests->setDeviceWaitingTime (parent,
@@ -722,7 +1258,7 @@ CMBusAdvanced::finishRequest (
 				 m_requests->getDeviceWaitingTime (idxRequest) ) );
 
 		if (m_requests->getNumChild (parent) == 0) {
-			m_requests->isDone (parent);
+			releaseRequest (parent);
 			m_requests->setServiceTime (parent,
 				m_requests->getResponseTime (parent)
 				- m_requests->getDeviceWaitingTime (parent) );
@@ -736,7 +1272,7 @@ CMBusAdvanced::finishRequest (
 				<< m_requests->getDate (idxRequest) << " "
 				<< m_requests->getType (idxRequest) << " "
                 << m_requests->getSize (idxRequest) << " "
-				<< _getVolumeID (idxRequest) << " -1 -1 -1 -1 -1 1" << endl;
+				<< _getVolumeID (idxRequest) << " -1 -1 -1 -1 -1 1 -1" << endl;
 		else
 			*m_subresultFile << idxRequest << " "
 				<< parent << " "
@@ -749,7 +1285,8 @@ CMBusAdvanced::finishRequest (
 				<< m_requests->getTransferTime (idxRequest) << " "
 				<< m_requests->getDeviceWaitingTime (idxRequest) << " "
 				<< m_requests->getServiceTime (idxRequest) << " "
-				<< m_requests->getResponseTime (idxRequest) << " 0" << endl;
+				<< m_requests->getResponseTime (idxRequest) << " 0 "
+				<< m_requests->getBufferWaitingTime (idxRequest) << endl;
 	}
 
 	if (parent == idxRequest ||
@@ -761,7 +1298,7 @@ CMBusAdvanced::finishRequest (
 			*m_resultFile << idxRequest << " "
 				<< m_requests->getDate (idxRequest) << " "
 				<< m_requests->getType (idxRequest) << " "
-				<< _getVolumeID (idxRequest) << " -1 -1 -1 -1 -1 1" << endl;
+				<< _getVolumeID (idxRequest) << " -1 -1 -1 -1 -1 1 -1" << endl;
 		} else {
 			*m_resultFile << idxRequest << " "
 				<< m_requests->getDate (idxRequest) << " "
@@ -771,7 +1308,27 @@ CMBusAdvanced::finishRequest (
 				<< m_requests->getTransferTime (idxRequest) << " "
 				<< m_requests->getDeviceWaitingTime (idxRequest) << " "
 				<< m_requests->getServiceTime (idxRequest) << " "
-				<< m_requests->getResponseTime (idxRequest) << " 0" << endl;
+				<< m_requests->getResponseTime (idxRequest) << " 0 "
+				<< m_requests->getBufferWaitingTime (idxRequest) << endl;
+		}
+
+		if (m_liveStats != NULL)
+			m_liveStats->recordCompletion (
+				m_requests->getDate (idxRequest)
+				+ m_requests->getResponseTime (idxRequest),
+				m_requests->getDate (idxRequest)
+				+ m_requests->getResponseTime (idxRequest)
+				- m_requests->getDate (parent),
+				m_requests->getIsFaulty (idxRequest) );
+
+		// The slot of the host is given to the next waiting parent
+		if (parent < m_admitted.size () && m_admitted [parent]) {
+			OGSS_Ushort		host = getHost (parent);
+
+			m_admitted [parent] = false;
+			--m_hostOutstanding [host];
+			admitPending (host, m_requests->getDate (idxRequest)
+				+ m_requests->getResponseTime (idxRequest) );
 		}
 	}
 
@@ -780,5 +1337,5 @@ CMBusAdvanced::finishRequest (
 		m_requests->getDate (idxRequest)
 		+ m_requests->getResponseTime (idxRequest) );
 
-	m_requests->isDone (idxRequest);
+	releaseRequest (idxRequest);
 }
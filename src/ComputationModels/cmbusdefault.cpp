@@ -64,6 +64,9 @@ CMBusDefault::operator= (
 	m_architecture	= cm.m_architecture;
 	m_resultFile	= cm.m_resultFile;
 	m_subresultFile	= cm.m_subresultFile;
+	m_liveStats		= cm.m_liveStats;
+	m_releasedSlots	= cm.m_releasedSlots;
+	m_deviceModels	= cm.m_deviceModels;
 
 	return *this;
 }
@@ -74,14 +77,15 @@ CMBusDefault::compute (
 	const OGSS_Ulong		idxRequest) {
 	OGSS_Real 				transferTime;
 	OGSS_Real				date;
-	OGSS_Real				devClock;
 
 	OGSS_Ushort 			dev;
 	OGSS_Ushort				bus;
 	OGSS_Ulong				size;
 
 	dev = m_requests->getIdxDevice (idxRequest);
-	size = m_requests->getSize (idxRequest);
+	// A TRIM does not carry data
+	size = (m_requests->getType (idxRequest) == RQT_ERASE) ?
+		0 : m_requests->getSize (idxRequest);
 	bus = m_architecture->m_volumes [_DEV(dev) .m_idxVolume] .m_idxBus;
 	date = m_requests->getDate (idxRequest);
 
@@ -91,20 +95,21 @@ CMBusDefault::compute (
 	m_requests->setTransferTime (idxRequest, 2 * transferTime);
 	m_requests->setBusWaitingTime (idxRequest, .0);
 
+	// The transfers are not ordered on the bus: the profile charges both ways
+	// at the arrival date
+	m_architecture->m_buses [bus] .recordTransfer (date, 2 * transferTime);
+
 	date += transferTime;
-	devClock = m_architecture->m_devices [m_requests->getIdxDevice (idxRequest)]
-		.m_clock;
 
-	if (date < devClock) {
-		m_requests->setDeviceWaitingTime (idxRequest, devClock - date);
-		date = devClock;
-	}
-	else
+	if (m_requests->getIsCacheHit (idxRequest) ) {
+		// Served by the volume cache: the device clock is not involved
 		m_requests->setDeviceWaitingTime (idxRequest, .0);
+		finishRequest (idxRequest);
 
-	date += m_requests->getServiceTime (idxRequest);
-	m_architecture->m_devices [m_requests->getIdxDevice (idxRequest)]
-		.m_clock = date;
+		return 2*transferTime;
+	}
+
+	placeOnDevice (idxRequest, date);
 
 	finishRequest (idxRequest);
 
@@ -136,7 +141,7 @@ CMBusDefault::finishRequest (
 				 m_requests->getDeviceWaitingTime (idxRequest) ) );
 
 		if (m_requests->getNumChild (parent) == 0) {
-			m_requests->isDone (parent);
+			releaseRequest (parent);
 			m_requests->setServiceTime (parent,
 				m_requests->getResponseTime (parent)
 				- m_requests->getDeviceWaitingTime (parent) );
@@ -150,7 +155,7 @@ CMBusDefault::finishRequest (
 				<< m_requests->getDate (idxRequest) << " "
 				<< m_requests->getType (idxRequest) << " "
 				<< m_architecture->m_devices [m_requests->getIdxDevice (
-					idxRequest)] .m_idxVolume << " -1 -1 -1 -1 -1 1" << endl;
+					idxRequest)] .m_idxVolume << " -1 -1 -1 -1 -1 1 -1" << endl;
 		else
 			*m_subresultFile << idxRequest << " "
 				<< parent << " "
@@ -162,7 +167,8 @@ CMBusDefault::finishRequest (
 				<< m_requests->getTransferTime (idxRequest) << " "
 				<< m_requests->getDeviceWaitingTime (idxRequest) << " "
 				<< m_requests->getServiceTime (idxRequest) << " "
-				<< m_requests->getResponseTime (idxRequest) << " 0" << endl;
+				<< m_requests->getResponseTime (idxRequest) << " 0 "
+				<< m_requests->getBufferWaitingTime (idxRequest) << endl;
 	}
 
 	if (parent == idxRequest ||
@@ -175,7 +181,7 @@ CMBusDefault::finishRequest (
 				<< m_requests->getDate (idxRequest) << " "
 				<< m_requests->getType (idxRequest) << " "
 				<< m_architecture->m_devices [m_requests->getIdxDevice (
-					idxRequest)] .m_idxVolume << " -1 -1 -1 -1 -1 1" << endl;
+					idxRequest)] .m_idxVolume << " -1 -1 -1 -1 -1 1 -1" << endl;
 		} else {
 			*m_resultFile << idxRequest << " "
 				<< m_requests->getDate (idxRequest) << " "
@@ -186,14 +192,24 @@ CMBusDefault::finishRequest (
 				<< m_requests->getTransferTime (idxRequest) << " "
 				<< m_requests->getDeviceWaitingTime (idxRequest) << " "
 				<< m_requests->getServiceTime (idxRequest) << " "
-				<< m_requests->getResponseTime (idxRequest) << " 0" << endl;
+				<< m_requests->getResponseTime (idxRequest) << " 0 "
+				<< m_requests->getBufferWaitingTime (idxRequest) << endl;
 		}
 
 		m_architecture->m_totalExecutionTime = max (
 			m_architecture->m_totalExecutionTime,
 			m_requests->getDate (parent)
 			+ m_requests->getResponseTime (parent) );
+
+		if (m_liveStats != NULL)
+			m_liveStats->recordCompletion (
+				m_requests->getDate (idxRequest)
+				+ m_requests->getResponseTime (idxRequest),
+				m_requests->getDate (idxRequest)
+				+ m_requests->getResponseTime (idxRequest)
+				- m_requests->getDate (parent),
+				m_requests->getIsFaulty (idxRequest) );
 	}
 
-	m_requests->isDone (idxRequest);
+	releaseRequest (idxRequest);
 }
@@ -0,0 +1,192 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	cmbusfluid.cpp
+ * @brief	Computation model for bus which queues the transfers on each bus,
+ * without simulating the buffers.
+ */
+
+#include "ComputationModels/cmbusfluid.hpp"
+#include "Structures/fabric.hpp"
+
+#include <glog/logging.h>
+
+using namespace std;
+
+#define REQUEST_SIZE 			128
+#define ACKNOWLEDGMENT_SIZE 	128
+
+#define _BUS(bus) m_architecture->m_buses[bus]
+#define _TIER(tier) m_architecture->m_tiers[tier]
+#define _VOL(vol) m_architecture->m_volumes[vol]
+#define _DEV(dev) m_architecture->m_devices[dev]
+
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+
+CMBusFluid::CMBusFluid (
+	RequestArray			* requests,
+	Architecture			* architecture,
+	ofstream				* resultFile,
+	ofstream				* subresultFile) :
+	CMBusDefault (requests,
+		architecture,
+		resultFile,
+		subresultFile) {  }
+
+CMBusFluid::CMBusFluid (
+	const CMBusFluid		& cm) :
+	CMBusDefault (cm) {  }
+
+CMBusFluid::~CMBusFluid () {  }
+
+CMBusFluid &
+CMBusFluid::operator= (
+	const CMBusFluid		& cm) {
+	m_requests		= cm.m_requests;
+	m_architecture	= cm.m_architecture;
+	m_resultFile	= cm.m_resultFile;
+	m_subresultFile	= cm.m_subresultFile;
+	m_liveStats		= cm.m_liveStats;
+	m_releasedSlots	= cm.m_releasedSlots;
+	m_deviceModels	= cm.m_deviceModels;
+
+	return *this;
+}
+
+OGSS_Real
+CMBusFluid::compute (
+	const OGSS_Ulong		idxRequest) {
+	OGSS_Real				transferTime = .0;
+	OGSS_Real				waitingTime = .0;
+	OGSS_Real				returnTime = .0;
+	OGSS_Real				date;
+	OGSS_Real				hopTime;
+	OGSS_Real				hopWait;
+
+	OGSS_Ushort				dev;
+	OGSS_Ushort				target;
+	OGSS_Ushort				source;
+	OGSS_Ushort				host = 0;
+	OGSS_Ushort				buses [4];
+	OGSS_Ushort				numBuses = 0;
+	OGSS_Ulong				toDevice = REQUEST_SIZE;
+	OGSS_Ulong				toHost = ACKNOWLEDGMENT_SIZE;
+	RequestType				type;
+	unsigned				hid;
+	unsigned				pid;
+
+	dev = m_requests->getIdxDevice (idxRequest);
+	type = m_requests->getType (idxRequest);
+	date = m_requests->getDate (idxRequest);
+
+	// A TRIM does not carry data
+	if (! (RQT_WRITE & type) )
+		toHost += m_requests->getSize (idxRequest);
+	else if (RQT_ERASE != type)
+		toDevice += m_requests->getSize (idxRequest);
+
+	if (m_requests->getFormat () == 2) {
+		m_requests->getOptions (idxRequest, hid, pid);
+		host = m_architecture->getIdxHost (hid);
+	}
+
+	// A volume in a fabric enclosure is reached through the fabric instead
+	// of the host and tier buses
+	target = (RQT_PRERD & type) ?
+		OGSS_USHORT_MAX : _VOL (_DEV (dev) .m_idxVolume) .m_idxFabricNode;
+
+	source = m_architecture->m_hosts [host] .m_idxFabricNode;
+	if (source == OGSS_USHORT_MAX && target != OGSS_USHORT_MAX)
+		source = m_architecture->m_fabric->getHostNode ();
+
+	if (target != OGSS_USHORT_MAX)
+		waitingTime += m_architecture->m_fabric->send (
+			source, target, toDevice, date, transferTime);
+
+	// Same paths as the advanced model: the pre-reads and the writes which
+	// need them only cross the device bus, a volume cache hit turns around
+	// at the volume
+	if (! (RQT_PRERD & type) && target == OGSS_USHORT_MAX) {
+		if (m_architecture->m_hosts [host] .m_idxBus != OGSS_USHORT_MAX)
+			buses [numBuses++] = m_architecture->m_hosts [host] .m_idxBus;
+		buses [numBuses++] = m_architecture->m_geometry->m_idxBus;
+		buses [numBuses++] = _TIER (_VOL (_DEV (dev) .m_idxVolume)
+			.m_idxTier) .m_idxBus;
+	}
+
+	if (! m_requests->getIsCacheHit (idxRequest) || (RQT_PRERD & type) )
+		buses [numBuses++] = _VOL (_DEV (dev) .m_idxVolume) .m_idxBus;
+
+	for (OGSS_Ushort i = 0; i < numBuses; ++i) {
+		hopTime = (toDevice + toHost)
+			/ (_BUS (buses [i]) .m_bandwidth * MILLISEC * MEGABYTE);
+		hopWait = queueTransfer (buses [i], date, hopTime);
+
+		transferTime += hopTime;
+		waitingTime += hopWait;
+		date += hopWait + hopTime * toDevice / (toDevice + toHost);
+		returnTime += hopTime * toHost / (toDevice + toHost);
+	}
+
+	if (m_requests->getIsCacheHit (idxRequest) ) {
+		// Served by the volume cache: the device clock is not involved
+		m_requests->setDeviceWaitingTime (idxRequest, .0);
+	}
+	else
+		date = placeOnDevice (idxRequest, date);
+
+	// The fabric links are full duplex: the answer goes back on their other
+	// direction, once the device is done
+	if (target != OGSS_USHORT_MAX) {
+		date += returnTime;
+		waitingTime += m_architecture->m_fabric->send (target, source,
+			toHost, date, transferTime);
+	}
+
+	m_requests->setTransferTime (idxRequest, transferTime);
+	m_requests->setBusWaitingTime (idxRequest, waitingTime);
+
+	finishRequest (idxRequest);
+
+	return transferTime;
+}
+
+/**************************************/
+/* PRIVATE FUNCTIONS ******************/
+/**************************************/
+OGSS_Real
+CMBusFluid::queueTransfer (
+	const OGSS_Ushort		idxBus,
+	const OGSS_Real			date,
+	const OGSS_Real			transferTime) {
+	OGSS_Real				waitingTime;
+
+	waitingTime = max (.0, _BUS (idxBus) .m_clock - date);
+	_BUS (idxBus) .m_clock = date + waitingTime + transferTime;
+	_BUS (idxBus) .recordTransfer (date, transferTime);
+
+	return waitingTime;
+}
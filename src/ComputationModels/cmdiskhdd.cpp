@@ -35,6 +35,11 @@ using namespace std;
 
 #define _HDD(dev) m_architecture->m_devices[dev].m_hardware.m_hdd
 
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+static const OGSS_Real		NO_ROTATION		= -1.;
+
 /**************************************/
 /* PUBLIC FUNCTIONS *******************/
 /**************************************/
@@ -48,11 +53,15 @@ CMDiskHDD::CMDiskHDD (
 		requests,
 		architecture,
 		resultFile,
-		subresultFile) {  }
+		subresultFile) {
+	m_rotLatency = .0;
+}
 
 CMDiskHDD::CMDiskHDD (
 	const CMDiskHDD			& cm) :
-	ComputationModel (cm) {  }
+	ComputationModel (cm) {
+	m_rotLatency = .0;
+}
 
 CMDiskHDD::~CMDiskHDD () {  }
 
@@ -63,6 +72,9 @@ CMDiskHDD::operator= (
 	m_architecture	= cm.m_architecture;
 	m_resultFile	= cm.m_resultFile;
 	m_subresultFile	= cm.m_subresultFile;
+	m_liveStats		= cm.m_liveStats;
+	m_releasedSlots	= cm.m_releasedSlots;
+	m_deviceModels	= cm.m_deviceModels;
 
 	return *this;
 }
@@ -72,103 +84,211 @@ CMDiskHDD::compute (
 	const OGSS_Ulong		index) {
 	OGSS_Real 				serviceTime;
 
-	serviceTime = cpt_seekTime (index) + cpt_rotTime (index)
-		+ cpt_tsfTime (index);
+	serviceTime = cpt_access (m_requests->getIdxDevice (index),
+		m_requests->getType (index) & RQT_WRITE,
+		m_requests->getDeviceAddress (index),
+		m_requests->getSize (index) );
+	keepRotation (index);
 
 	m_requests->setServiceTime (index, serviceTime);
 
 	return serviceTime;
 }
 
-/**************************************/
-/* PRIVATE FUNCTIONS ******************/
-/**************************************/
-
 OGSS_Real
-CMDiskHDD::cpt_seekTime (
+CMDiskHDD::serve (
+	const OGSS_Ulong		index,
+	const OGSS_Real			arrival) {
+	OGSS_Real				start, serviceTime, rotTime, idleAngle;
+	OGSS_Real				rotLatency;
+	OGSS_Ushort				dev;
+
+	start = ComputationModel::serve (index, arrival);
+
+	if (index >= m_pendingRotation.size ()
+		|| m_pendingRotation [index] == NO_ROTATION)
+		return start;
+
+	rotLatency = m_pendingRotation [index];
+	m_pendingRotation [index] = NO_ROTATION;
+
+	dev = m_requests->getIdxDevice (index);
+	serviceTime = m_requests->getServiceTime (index);
+	rotTime = _HDD (dev) .m_maxRotationTime;
+
+	// The rotational latency was computed with the head angle at the end of
+	// the last transfer, the platter turned since then
+	if (start > _HDD (dev) .m_transferEnd) {
+		idleAngle = (start - _HDD (dev) .m_transferEnd) / rotTime;
+		serviceTime += cpt_rotLatency (dev, idleAngle - floor (idleAngle), .0,
+			rotLatency / rotTime) - rotLatency;
+		m_requests->setServiceTime (index, serviceTime);
+	}
+
+	_HDD (dev) .m_transferEnd = start + serviceTime;
+
+	return start;
+}
+
+void
+CMDiskHDD::release (
 	const OGSS_Ulong		index) {
-	OGSS_Real a, b, dist, seekTime;
-	OGSS_Real minSeek, avgSeek, maxSeek;
-	unsigned numCyl;
-	OGSS_Ulong pTrack, nTrack, start;
+	if (index < m_pendingRotation.size () )
+		m_pendingRotation [index] = NO_ROTATION;
+}
+
+OGSS_Ulong
+CMDiskHDD::getTrack (
+	const OGSS_Ulong		index) const {
+	OGSS_Ulong track, sector;
+	unsigned trackSize;
 	OGSS_Ushort dev;
 
 	dev = m_requests->getIdxDevice (index);
 
-	if (m_requests->getType (index) & RQT_WRITE) {
-		minSeek = _HDD (dev) .m_minWSeekTime;
-		avgSeek = _HDD (dev) .m_avgWSeekTime;
-		maxSeek = _HDD (dev) .m_maxWSeekTime;
-	} else {
-		minSeek = _HDD (dev) .m_minRSeekTime;
-		avgSeek = _HDD (dev) .m_avgRSeekTime;
-		maxSeek = _HDD (dev) .m_maxRSeekTime;
-	}
+	// The device size is given in num of sectors ans not in num of bytes
+	cpt_location (dev,
+		m_requests->getDeviceAddress (index) / _HDD (dev) .m_sectorSize,
+		track, sector, trackSize);
 
-	numCyl  = _HDD (dev) .m_numCylinders;
-	pTrack  = _HDD (dev) .m_trackPosition;
+	return track;
+}
 
-	start   = m_requests->getDeviceAddress (index) / _HDD (dev) .m_sectorSize;
+OGSS_Real
+CMDiskHDD::estimateAccessTime (
+	const OGSS_Ulong		index) const {
+	OGSS_Real seekTime;
+	OGSS_Ulong track, sector;
+	unsigned trackSize;
+	OGSS_Ushort dev;
 
-	// The device size is given in num of sectors ans not in num of bytes
-	nTrack = start / _HDD (dev) .m_sectorsByTrack;
-	nTrack = nTrack % _HDD (dev) .m_tracksByPlatter;
+	dev = m_requests->getIdxDevice (index);
 
-	dist = abs ( (long) pTrack - (long) nTrack);
+	cpt_location (dev,
+		m_requests->getDeviceAddress (index) / _HDD (dev) .m_sectorSize,
+		track, sector, trackSize);
 
-	// Set the new track position
-	pTrack = (start + m_requests->getSize (index) / _HDD (dev) .m_sectorSize)
-		/ _HDD (dev) .m_sectorsByTrack;
-	pTrack = pTrack % _HDD (dev) .m_tracksByPlatter;
+	seekTime = cpt_seekCurve (index,
+		abs ( (long) _HDD (dev) .m_trackPosition - (long) track) );
 
-	_HDD (dev) .m_trackPosition = pTrack;
+	return seekTime + cpt_rotLatency (dev, cpt_headAngle (dev), seekTime,
+		(OGSS_Real) sector / trackSize);
+}
 
-	if (dist == 0)
-		seekTime = 0;
-	else
-	{
-		a = (-10 * minSeek + 15 * avgSeek - 5 * maxSeek) / (3 * sqrt (numCyl) );
-		b = (7 * minSeek - 15 * avgSeek + 8 * maxSeek) / (3 * numCyl);
-		seekTime = a * sqrt (dist) + b * (dist - 1) + minSeek;
+/**************************************/
+/* PRIVATE FUNCTIONS ******************/
+/**************************************/
+
+OGSS_Real
+CMDiskHDD::cpt_access (
+	const OGSS_Ushort		dev,
+	const OGSS_Bool			write,
+	const OGSS_Ulong		address,
+	const OGSS_Ulong		size) {
+	OGSS_Real				seekTime;
+	OGSS_Real				serviceTime;
+	OGSS_Real				rate;
+	OGSS_Ulong				track, sector, dist;
+	unsigned				trackSize;
+
+	HDDDevice & hdd = _HDD (dev);
+
+	rate = cpt_location (dev, address / hdd.m_sectorSize,
+		track, sector, trackSize);
+
+	dist = abs ( (long) hdd.m_trackPosition - (long) track);
+	seekTime = hdd.m_seekCurve->seekTime (dist, write);
+
+	// The head angle depends on the track before the seek
+	m_rotLatency = cpt_rotLatency (dev, cpt_headAngle (dev), seekTime,
+		(OGSS_Real) sector / trackSize);
+	serviceTime = seekTime + m_rotLatency + size / (rate * MILLISEC * MEGABYTE);
+
+	// The head stays right after the last transferred sector
+	cpt_location (dev, (address + size) / hdd.m_sectorSize,
+		hdd.m_trackPosition, hdd.m_headPosition, trackSize);
+
+	return serviceTime;
+}
+
+OGSS_Real
+CMDiskHDD::cpt_location (
+	const OGSS_Ushort		dev,
+	const OGSS_Ulong		sector,
+	OGSS_Ulong				& track,
+	OGSS_Ulong				& trackSector,
+	unsigned				& trackSize) const {
+	OGSS_Ulong platterSector;
+
+	if (_HDD (dev) .m_zoneTable == NULL) {
+		trackSize = _HDD (dev) .m_sectorsByTrack;
+		track = (sector / trackSize) % _HDD (dev) .m_tracksByPlatter;
+		trackSector = sector % trackSize;
+		return _HDD (dev) .m_mediaTransferRate;
 	}
 
-	return seekTime;
+	platterSector = sector % _HDD (dev) .m_zoneTable->m_numSectors;
+
+	const Zone & zone =
+		_HDD (dev) .m_zoneTable->searchBySector (platterSector);
+
+	trackSize = zone.m_sectorsByTrack;
+	track = zone.m_firstTrack
+		+ (platterSector - zone.m_firstSector) / trackSize;
+	trackSector = (platterSector - zone.m_firstSector) % trackSize;
+
+	if (zone.m_mediaTransferRate > 0)
+		return zone.m_mediaTransferRate;
+
+	return _HDD (dev) .m_mediaTransferRate;
 }
 
 OGSS_Real
-CMDiskHDD::cpt_rotTime (
-	const OGSS_Ulong		index) {
-	OGSS_Real rotTime = .0;
+CMDiskHDD::cpt_headAngle (
+	const OGSS_Ushort		dev) const {
 	unsigned trackSize;
-	OGSS_Ulong pRot = 0;
-	OGSS_Ushort dev;
 
-	dev = m_requests->getIdxDevice (index);
-	rotTime = _HDD (dev) .m_maxRotationTime / 2;
-	
-	pRot = _HDD (dev) .m_headPosition;
+	if (_HDD (dev) .m_zoneTable == NULL)
+		trackSize = _HDD (dev) .m_sectorsByTrack;
+	else
+		trackSize = _HDD (dev) .m_zoneTable->searchByTrack (
+			_HDD (dev) .m_trackPosition) .m_sectorsByTrack;
+
+	return (OGSS_Real) _HDD (dev) .m_headPosition / trackSize;
+}
 
-	trackSize = _HDD (dev) .m_sectorsByTrack;
+OGSS_Real
+CMDiskHDD::cpt_rotLatency (
+	const OGSS_Ushort		dev,
+	const OGSS_Real			headAngle,
+	const OGSS_Real			seekTime,
+	const OGSS_Real			targetAngle) const {
+	OGSS_Real rotTime, angle;
 
-	pRot = ( ( (m_requests->getDeviceAddress (index)
-		+ m_requests->getSize (index) )
-		/ _HDD (dev) .m_sectorSize) % trackSize);
+	rotTime = _HDD (dev) .m_maxRotationTime;
 
-	_HDD (dev) .m_headPosition = pRot;
+	// The platter keeps turning during the seek
+	angle = targetAngle - headAngle - seekTime / rotTime;
+	angle -= floor (angle);
 
-	return rotTime;
+	return angle * rotTime;
 }
 
 OGSS_Real
-CMDiskHDD::cpt_tsfTime (
-	const OGSS_Ulong				index) {
-	OGSS_Real transferTime = .0;
-	OGSS_Ushort dev;
-
-	dev = m_requests->getIdxDevice (index);
+CMDiskHDD::cpt_seekCurve (
+	const OGSS_Ulong		index,
+	const OGSS_Ulong		dist) const {
+	return _HDD (m_requests->getIdxDevice (index) ) .m_seekCurve->seekTime (
+		dist, m_requests->getType (index) & RQT_WRITE);
+}
 
-	transferTime = m_requests->getSize (index)
-		/ (_HDD (dev) .m_mediaTransferRate * MILLISEC * MEGABYTE);
+void
+CMDiskHDD::keepRotation (
+	const OGSS_Ulong		index) {
+	// One entry by slot of the request array, allocated with the first one
+	if (m_pendingRotation.empty () )
+		m_pendingRotation.assign (m_requests->getNumRequests ()
+			+ m_requests->getNumSubrequests (), NO_ROTATION);
 
-	return transferTime;
+	m_pendingRotation [index] = m_rotLatency;
 }
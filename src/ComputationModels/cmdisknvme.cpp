@@ -0,0 +1,149 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	cmdisknvme.cpp
+ * @brief	Computation model for NVMe SSD.
+ */
+
+#include "ComputationModels/cmdisknvme.hpp"
+
+#include "Structures/nvmecontroller.hpp"
+
+using namespace std;
+
+#define _SSD(dev) m_architecture->m_devices[dev].m_hardware.m_ssd
+
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+
+CMDiskNVMe::CMDiskNVMe (
+	RequestArray			* requests,
+	Architecture			* architecture,
+	ofstream				* resultFile,
+	ofstream				* subresultFile) :
+	CMDiskSSD (
+		requests,
+		architecture,
+		resultFile,
+		subresultFile) {  }
+
+CMDiskNVMe::CMDiskNVMe (
+	const CMDiskNVMe		& cm) :
+	CMDiskSSD (cm) {  }
+
+CMDiskNVMe::~CMDiskNVMe () {  }
+
+CMDiskNVMe &
+CMDiskNVMe::operator= (
+	const CMDiskNVMe		& cm) {
+	m_requests		= cm.m_requests;
+	m_architecture	= cm.m_architecture;
+	m_resultFile	= cm.m_resultFile;
+	m_subresultFile	= cm.m_subresultFile;
+	m_liveStats		= cm.m_liveStats;
+	m_releasedSlots	= cm.m_releasedSlots;
+	m_deviceModels	= cm.m_deviceModels;
+
+	return *this;
+}
+
+OGSS_Real
+CMDiskNVMe::compute (
+	const OGSS_Ulong		index) {
+	OGSS_Real				serviceTime;
+	OGSS_Ulong				size;
+	RequestType				type;
+	OGSS_Ushort				dev;
+
+	dev = m_requests->getIdxDevice (index);
+	type = m_requests->getType (index);
+
+	// A TRIM does not carry data
+	size = (type == RQT_ERASE) ? 0 : m_requests->getSize (index);
+
+	// Flash work by die
+	if (_SSD (dev) .m_ftl != NULL)
+		cpt_ftlServTime (index);
+	else if (type == RQT_ERASE) {
+		m_dieTimes.assign (_SSD (dev) .m_numDies, .0);
+		m_diePages.assign (_SSD (dev) .m_numDies, 0);
+	}
+	else if (type & RQT_WRITE)
+		cpt_writeServTime (index);
+	else
+		cpt_readServTime (index);
+
+	// The queues, the link and the dies are booked once the request reaches
+	// the device
+	serviceTime = cpt_parallelServTime (index)
+		+ size / _SSD (dev) .m_nvme->getLinkBandwidth ();
+
+	m_requests->setServiceTime (index, serviceTime);
+
+	return serviceTime;
+}
+
+OGSS_Real
+CMDiskNVMe::serve (
+	const OGSS_Ulong		index,
+	const OGSS_Real			arrival) {
+	OGSS_Real				start, ready, flashStart, end;
+	OGSS_Ulong				parent, size;
+	RequestType				type;
+	OGSS_Bool				read;
+	unsigned				queue;
+	OGSS_Ushort				dev;
+
+	if (! takeDieWork (index) )
+		return ComputationModel::serve (index, arrival);
+
+	dev = m_requests->getIdxDevice (index);
+	type = m_requests->getType (index);
+	read = ! (type & RQT_WRITE);
+	size = (type == RQT_ERASE) ? 0 : m_requests->getSize (index);
+
+	NVMeController * nvme = _SSD (dev) .m_nvme;
+
+	// The subrequests of a host request share its queue
+	parent = m_requests->getIdxParent (index);
+	queue = ( (parent == OGSS_ULONG_MAX) ? index : parent)
+		% nvme->getNumQueues ();
+
+	ready = nvme->submit (queue, arrival, start);
+
+	if (! read)
+		ready = nvme->transfer (size, false, ready);
+
+	end = cpt_dieSchedule (dev, read, ready, flashStart);
+
+	if (read)
+		end = nvme->transfer (size, true, end);
+
+	nvme->complete (queue, end);
+
+	m_requests->setServiceTime (index, end - start);
+
+	return start;
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	cmdisksmr.cpp
+ * @brief	Computation model for SMR (shingled) HDD.
+ */
+
+#include "ComputationModels/cmdisksmr.hpp"
+
+#include "Structures/shingledzones.hpp"
+
+using namespace std;
+
+#define _HDD(dev) m_architecture->m_devices[dev].m_hardware.m_hdd
+
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+
+CMDiskSMR::CMDiskSMR (
+	RequestArray			* requests,
+	Architecture			* architecture,
+	ofstream				* resultFile,
+	ofstream				* subresultFile) :
+	CMDiskHDD (
+		requests,
+		architecture,
+		resultFile,
+		subresultFile) {  }
+
+CMDiskSMR::CMDiskSMR (
+	const CMDiskSMR			& cm) :
+	CMDiskHDD (cm) {  }
+
+CMDiskSMR::~CMDiskSMR () {  }
+
+CMDiskSMR &
+CMDiskSMR::operator= (
+	const CMDiskSMR			& cm) {
+	m_requests		= cm.m_requests;
+	m_architecture	= cm.m_architecture;
+	m_resultFile	= cm.m_resultFile;
+	m_subresultFile	= cm.m_subresultFile;
+	m_liveStats		= cm.m_liveStats;
+	m_releasedSlots	= cm.m_releasedSlots;
+	m_deviceModels	= cm.m_deviceModels;
+
+	return *this;
+}
+
+OGSS_Real
+CMDiskSMR::compute (
+	const OGSS_Ulong		index) {
+	OGSS_Real				serviceTime;
+	OGSS_Real				cleaningTime;
+	OGSS_Ulong				address, size, sector, numSectors, parent;
+	OGSS_Ulong				bandSector, bandSectors;
+	OGSS_Ulong				cacheSector, cachedSectors;
+	OGSS_Bool				cached;
+	RequestType				type;
+	OGSS_Ushort				dev;
+
+	dev = m_requests->getIdxDevice (index);
+	address = m_requests->getDeviceAddress (index);
+	size = m_requests->getSize (index);
+	type = m_requests->getType (index);
+
+	HDDDevice & hdd = _HDD (dev);
+	ShingledZones * zones = hdd.m_smrZones;
+
+	sector = address / hdd.m_sectorSize;
+	numSectors = (size + hdd.m_sectorSize - 1) / hdd.m_sectorSize;
+
+	if (type == RQT_ERASE) {
+		zones->reset (sector, numSectors);
+		serviceTime = .0;
+	} else if (type & RQT_WRITE) {
+		sector = zones->write (sector, numSectors);
+
+		if (sector == OGSS_ULONG_MAX) {
+			// The host-managed device fails a write which does not fit in
+			// its zone, the media is not accessed
+			m_requests->isFaulty (index);
+			parent = m_requests->getIdxParent (index);
+			if (parent < m_requests->getNumRequests () )
+				m_requests->isFaulty (parent);
+
+			m_requests->setServiceTime (index, .0);
+			return .0;
+		}
+
+		serviceTime = cpt_access (dev, true, sector * hdd.m_sectorSize, size);
+		keepRotation (index);
+
+		// Foreground cleaning: read-modify-write of the oldest bands
+		while (zones->needsCleaning () ) {
+			zones->clean (bandSector, bandSectors,
+				cacheSector, cachedSectors);
+			if (cachedSectors == 0) continue;
+
+			cleaningTime = cpt_access (dev, false,
+				bandSector * hdd.m_sectorSize,
+				bandSectors * hdd.m_sectorSize)
+				+ cpt_access (dev, false, cacheSector * hdd.m_sectorSize,
+				cachedSectors * hdd.m_sectorSize)
+				+ cpt_access (dev, true, bandSector * hdd.m_sectorSize,
+				bandSectors * hdd.m_sectorSize);
+
+			zones->addCleaningTime (cleaningTime);
+			serviceTime += cleaningTime;
+		}
+	} else {
+		// The newest data of the band can be in the media cache
+		cached = zones->isCached (sector, numSectors);
+
+		serviceTime = cpt_access (dev, false,
+			zones->getPhysicalSector (sector) * hdd.m_sectorSize, size);
+		keepRotation (index);
+
+		if (cached)
+			serviceTime += cpt_access (dev, false,
+				zones->getCacheSector () * hdd.m_sectorSize, size);
+	}
+
+	m_requests->setServiceTime (index, serviceTime);
+
+	return serviceTime;
+}
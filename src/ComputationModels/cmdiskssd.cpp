@@ -29,11 +29,20 @@
 #include "ComputationModels/cmdiskssd.hpp"
 
 #include <glog/logging.h>
+#include <limits>
+
+#include "Structures/ftl.hpp"
 
 using namespace std;
 
 #define _SSD(dev) m_architecture->m_devices[dev].m_hardware.m_ssd
 
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+static const OGSS_Ulong		NOT_PENDING		= OGSS_ULONG_MAX;
+static const OGSS_Ulong		END_OF_WORK		= OGSS_ULONG_MAX - 1;
+
 /**************************************/
 /* PUBLIC FUNCTIONS *******************/
 /**************************************/
@@ -46,11 +55,17 @@ CMDiskSSD::CMDiskSSD (
 	ComputationModel (requests,
 		architecture,
 		resultFile,
-		subresultFile) {  }
+		subresultFile) {
+	m_freeDieWork = END_OF_WORK;
+	m_numPendingDieWorks = 0;
+}
 
 CMDiskSSD::CMDiskSSD (
 	const CMDiskSSD			& cm) :
-	ComputationModel (cm) {  }
+	ComputationModel (cm) {
+	m_freeDieWork = END_OF_WORK;
+	m_numPendingDieWorks = 0;
+}
 
 CMDiskSSD::~CMDiskSSD () {  }
 
@@ -61,6 +76,9 @@ CMDiskSSD::operator= (
 	m_architecture	= cm.m_architecture;
 	m_resultFile	= cm.m_resultFile;
 	m_subresultFile	= cm.m_subresultFile;
+	m_liveStats		= cm.m_liveStats;
+	m_releasedSlots	= cm.m_releasedSlots;
+	m_deviceModels	= cm.m_deviceModels;
 
 	return *this;
 }
@@ -70,20 +88,53 @@ CMDiskSSD::compute (
 	const OGSS_Ulong		id)
 {
 	OGSS_Real				serviceTime;
-
-	if (m_requests->getType (id) == RQT_READ)
+	OGSS_Ushort				dev = m_requests->getIdxDevice (id);
+
+	if (_SSD (dev) .m_ftl != NULL)
+		serviceTime = cpt_ftlServTime (id);
+	else if (m_requests->getType (id) == RQT_ERASE) {
+		serviceTime = .0;
+		m_dieTimes.assign (_SSD (dev) .m_numDies, .0);
+		m_diePages.assign (_SSD (dev) .m_numDies, 0);
+	}
+	else if (m_requests->getType (id) == RQT_READ)
 		serviceTime = cpt_readServTime (id);
 	else
 		serviceTime = cpt_writeServTime (id);
 
+	if (m_architecture->m_devices [dev] .m_parallel)
+		serviceTime = cpt_parallelServTime (id);
+
 	m_requests->setServiceTime (id, serviceTime);
 
 	return serviceTime;
 }
 
-/**************************************/
-/* PRIVATE FUNCTIONS ******************/
-/**************************************/
+OGSS_Real
+CMDiskSSD::serve (
+	const OGSS_Ulong		id,
+	const OGSS_Real			arrival)
+{
+	OGSS_Real   start, end;
+
+	if (! takeDieWork (id) )
+		return ComputationModel::serve (id, arrival);
+
+	end = cpt_dieSchedule (m_requests->getIdxDevice (id),
+		! (m_requests->getType (id) & RQT_WRITE), arrival, start);
+
+	m_requests->setServiceTime (id, end - start);
+
+	return start;
+}
+
+void
+CMDiskSSD::release (
+	const OGSS_Ulong		id)
+{
+	if (id < m_pendingWork.size () )
+		dropDieWork (id);
+}
 
 OGSS_Real
 CMDiskSSD::cpt_readServTime (
@@ -108,6 +159,9 @@ CMDiskSSD::cpt_readServTime (
 
 	OGSS_Ulong   c, d, e, f;
 
+	m_dieTimes.assign (_SSD (dev) .m_numDies, .0);
+	m_diePages.assign (_SSD (dev) .m_numDies, 0);
+
 	rt = _SSD (dev) .m_randomReadTime;
 	st = _SSD (dev) .m_sequentialReadTime;
 
@@ -128,6 +182,9 @@ CMDiskSSD::cpt_readServTime (
 		r += rt * e;
 		r += st * ( (f < 1) ? 1 : f);
 
+		m_dieTimes [i] += rt * e + st * ( (f < 1) ? 1 : f);
+		m_diePages [i] += (d - c) / ps + 1;
+
 		t [i] = (d + 1) % (pb * bd * ps);
 	}
 
@@ -157,6 +214,9 @@ CMDiskSSD::cpt_writeServTime (
 
 	OGSS_Ulong   c, d, e, f;
 
+	m_dieTimes.assign (_SSD (dev) .m_numDies, .0);
+	m_diePages.assign (_SSD (dev) .m_numDies, 0);
+
 	rt = _SSD (dev) .m_randomWriteTime;
 	st = _SSD (dev) .m_sequentialWriteTime;
 
@@ -177,8 +237,191 @@ CMDiskSSD::cpt_writeServTime (
 		r += rt * e;
 		r += st * ( (f < 1) ? 1 : f);
 
+		m_dieTimes [i] += rt * e + st * ( (f < 1) ? 1 : f);
+		m_diePages [i] += (d - c) / ps + 1;
+
 		t [i] = (d + 1) % (pb * bd * ps);
 	}
 
 	return r;
-}	
+}
+
+OGSS_Real
+CMDiskSSD::cpt_ftlServTime (
+	const OGSS_Ulong		id)
+{
+	OGSS_Ulong   a = m_requests->getDeviceAddress (id);
+	OGSS_Ulong   b = m_requests->getSize (id);
+	OGSS_Ushort dev = m_requests->getIdxDevice (id);
+	RequestType  type = m_requests->getType (id);
+
+	OGSS_Ulong   ps = _SSD (dev) .m_pageSize;
+
+	FlashTranslationLayer * ftl = _SSD (dev) .m_ftl;
+
+	OGSS_Real r;
+
+	OGSS_Ulong   first = a / ps;
+	OGSS_Ulong   num = (b == 0) ? 0 : (a + b - 1) / ps - first + 1;
+
+	// TRIM only updates the mapping, the blocks are reclaimed later by
+	// the garbage collector
+	if (type == RQT_ERASE) {
+		if (_SSD (dev) .m_advanceTRIM)
+			ftl->trim (first, num, m_requests->getDate (id) );
+		r = .0;
+	}
+	else if (! (type & RQT_WRITE) )
+		r = ftl->read (first, num);
+	else
+		r = ftl->write (first, num, m_requests->getDate (id) );
+
+	m_dieTimes = ftl->getDieTimes ();
+	m_diePages = ftl->getDiePages ();
+
+	return r;
+}
+
+OGSS_Real
+CMDiskSSD::cpt_parallelServTime (
+	const OGSS_Ulong		id)
+{
+	OGSS_Ushort dev = m_requests->getIdxDevice (id);
+	OGSS_Real   serviceTime = .0;
+
+	// The dies and the channels are booked once the request reaches the
+	// device, which is only known by the bus model
+	for (OGSS_Ulong i = 0; i < m_dieTimes.size (); ++i)
+		serviceTime = max (serviceTime, m_dieTimes [i]
+			+ m_diePages [i] * _SSD (dev) .m_channelTime);
+
+	keepDieWork (id);
+
+	return serviceTime;
+}
+
+void
+CMDiskSSD::keepDieWork (
+	const OGSS_Ulong		id)
+{
+	OGSS_Ulong  handle;
+
+	// One chain by slot of the request array, the heads are allocated with
+	// the first one, the works come from the pool
+	if (m_pendingWork.empty () )
+		m_pendingWork.assign (m_requests->getNumRequests ()
+			+ m_requests->getNumSubrequests (), NOT_PENDING);
+
+	dropDieWork (id);
+	m_pendingWork [id] = END_OF_WORK;
+
+	for (OGSS_Ulong i = m_dieTimes.size (); i-- != 0; )
+	{
+		if (m_dieTimes [i] == .0 && m_diePages [i] == 0) continue;
+
+		if (m_freeDieWork != END_OF_WORK) {
+			handle = m_freeDieWork;
+			m_freeDieWork = m_dieWorks [handle] .next;
+		} else {
+			handle = m_dieWorks.size ();
+			m_dieWorks.push_back (DieWork ());
+		}
+
+		m_dieWorks [handle] .time = m_dieTimes [i];
+		m_dieWorks [handle] .pages = m_diePages [i];
+		m_dieWorks [handle] .die = i;
+		m_dieWorks [handle] .next = m_pendingWork [id];
+		m_pendingWork [id] = handle;
+		m_numPendingDieWorks ++;
+	}
+}
+
+OGSS_Bool
+CMDiskSSD::takeDieWork (
+	const OGSS_Ulong		id)
+{
+	OGSS_Ushort dev = m_requests->getIdxDevice (id);
+
+	if (id >= m_pendingWork.size () || m_pendingWork [id] == NOT_PENDING)
+		return false;
+
+	m_dieTimes.assign (_SSD (dev) .m_numDies, .0);
+	m_diePages.assign (_SSD (dev) .m_numDies, 0);
+
+	for (OGSS_Ulong h = m_pendingWork [id]; h != END_OF_WORK;
+		h = m_dieWorks [h] .next)
+	{
+		m_dieTimes [m_dieWorks [h] .die] = m_dieWorks [h] .time;
+		m_diePages [m_dieWorks [h] .die] = m_dieWorks [h] .pages;
+	}
+
+	dropDieWork (id);
+
+	return true;
+}
+
+void
+CMDiskSSD::dropDieWork (
+	const OGSS_Ulong		id)
+{
+	OGSS_Ulong  handle = m_pendingWork [id];
+	OGSS_Ulong  next;
+
+	while (handle != NOT_PENDING && handle != END_OF_WORK)
+	{
+		next = m_dieWorks [handle] .next;
+		m_dieWorks [handle] .next = m_freeDieWork;
+		m_freeDieWork = handle;
+		m_numPendingDieWorks --;
+		handle = next;
+	}
+
+	m_pendingWork [id] = NOT_PENDING;
+}
+
+OGSS_Real
+CMDiskSSD::cpt_dieSchedule (
+	const OGSS_Ushort		dev,
+	const OGSS_Bool			read,
+	const OGSS_Real			arrival,
+	OGSS_Real				& start)
+{
+	OGSS_Real   * dc = _SSD (dev) .m_dieClock;
+	OGSS_Real   * cc = _SSD (dev) .m_channelClock;
+	OGSS_Ulong  nc = _SSD (dev) .m_numChannels;
+
+	OGSS_Real   end = arrival;
+	OGSS_Real   tx, first, last;
+
+	start = numeric_limits < OGSS_Real > ::max ();
+
+	// Each die works on its part of the request, the data go through the
+	// channel of the die: after the array access for a read, before the
+	// program for a write
+	for (OGSS_Ulong i = 0; i < m_dieTimes.size (); ++i)
+	{
+		if (m_dieTimes [i] == .0 && m_diePages [i] == 0) continue;
+
+		tx = m_diePages [i] * _SSD (dev) .m_channelTime;
+
+		if (read) {
+			first = max (arrival, dc [i]);
+			last = max (first + m_dieTimes [i], cc [i % nc]) + tx;
+		} else {
+			first = max (arrival, cc [i % nc]);
+			last = max (first + tx, dc [i]) + m_dieTimes [i];
+		}
+
+		// The die register is busy until the data left it
+		dc [i] = last;
+		if (tx > .0)
+			cc [i % nc] = read ? last : first + tx;
+
+		start = min (start, first);
+		end = max (end, last);
+	}
+
+	if (start > end) start = end = arrival;
+
+	return end;
+}
@@ -34,6 +34,8 @@
 
 #include "ComputationModels/computationmodel.hpp"
 
+#include <algorithm>
+
 /**************************************/
 /* PUBLIC FUNCTIONS *******************/
 /**************************************/
@@ -47,14 +49,52 @@ ComputationModel::operator= (
 	m_architecture 	= cm.m_architecture;
 	m_resultFile	= cm.m_resultFile;
 	m_subresultFile = cm.m_subresultFile;
+	m_liveStats		= cm.m_liveStats;
+	m_releasedSlots	= cm.m_releasedSlots;
+	m_deviceModels	= cm.m_deviceModels;
 
 	return *this;
 }
 
+OGSS_Real
+ComputationModel::serve (
+	const OGSS_Ulong		idxRequest,
+	const OGSS_Real			arrival) {
+	return std::max (arrival, m_architecture->m_devices [
+		m_requests->getIdxDevice (idxRequest) ] .m_clock);
+}
+
+void
+ComputationModel::release (
+	const OGSS_Ulong		idxRequest) {
+	(void) idxRequest;	// nothing is kept by default
+}
+
 /**************************************/
 /* PRIVATE FUNCTIONS ******************/
 /**************************************/
 
+OGSS_Real
+ComputationModel::placeOnDevice (
+	const OGSS_Ulong		idxRequest,
+	const OGSS_Real			arrival) {
+	OGSS_Ushort				idxDevice = m_requests->getIdxDevice (idxRequest);
+	Device					& device = m_architecture->m_devices [idxDevice];
+	OGSS_Real				start, end;
+
+	if (m_deviceModels != NULL && (* m_deviceModels) [idxDevice] != NULL)
+		start = (* m_deviceModels) [idxDevice] ->serve (idxRequest, arrival);
+	else
+		start = ComputationModel::serve (idxRequest, arrival);
+
+	m_requests->setDeviceWaitingTime (idxRequest, start - arrival);
+
+	end = start + m_requests->getServiceTime (idxRequest);
+	device.m_clock = std::max (end, device.m_clock);
+
+	return end;
+}
+
 ComputationModel::ComputationModel (
 	RequestArray			* requests,
 	Architecture			* architecture,
@@ -64,6 +104,9 @@ ComputationModel::ComputationModel (
 	m_architecture	= architecture;
 	m_resultFile	= resultFile;
 	m_subresultFile	= subresultFile;
+	m_liveStats		= NULL;
+	m_releasedSlots	= NULL;
+	m_deviceModels	= NULL;
 }
 
 ComputationModel::ComputationModel (
@@ -72,4 +115,7 @@ ComputationModel::ComputationModel (
 	m_architecture 	= cm.m_architecture;
 	m_resultFile	= cm.m_resultFile;
 	m_subresultFile = cm.m_subresultFile;
+	m_liveStats		= cm.m_liveStats;
+	m_releasedSlots	= cm.m_releasedSlots;
+	m_deviceModels	= cm.m_deviceModels;
 }
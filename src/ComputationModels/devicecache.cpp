@@ -0,0 +1,250 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	devicecache.cpp
+ * @brief	DeviceCache is the on-board DRAM cache of a device. It wraps the
+ * computation model of the device: the read hits and the absorbed writes are
+ * served at the cache latency, the other requests by the device.
+ */
+
+#include "ComputationModels/devicecache.hpp"
+
+#include <algorithm>
+#include <glog/logging.h>
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+#define 					_DEV(i)			m_architecture->m_devices[i]
+
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+DeviceCache::DeviceCache (
+	RequestArray			* requests,
+	Architecture			* architecture,
+	ComputationModel		* disk,
+	const OGSS_Ushort		idxDevice) :
+	ComputationModel (requests, architecture) {
+	OGSS_Ulong				numSegments;
+
+	m_disk = disk;
+	m_idxDevice = idxDevice;
+
+	m_segmentSize = _DEV (idxDevice) .m_cacheSegmentSize;
+	m_readAhead = _DEV (idxDevice) .m_cacheReadAhead;
+	m_writeBack = _DEV (idxDevice) .m_cacheWriteBack;
+	m_latency = _DEV (idxDevice) .m_cacheLatency;
+	m_capacity = _DEV (idxDevice) .m_bufferSize;
+
+	numSegments = max < OGSS_Ulong > (1, m_capacity / m_segmentSize);
+
+	m_keys.assign (numSegments, 0);
+	m_referenced.assign (numSegments, 0);
+	m_slots.reserve (numSegments);
+	m_hand = 0;
+
+	m_dirty = 0;
+	m_destageEnd = .0;
+
+	m_numReads = 0;
+	m_numReadHits = 0;
+	m_numWrites = 0;
+	m_numAbsorbed = 0;
+	m_maxBacklog = 0;
+	m_stallTime = .0;
+	m_destageTime = .0;
+}
+
+DeviceCache::~DeviceCache () {  }
+
+OGSS_Real
+DeviceCache::compute (
+	const OGSS_Ulong		idxRequest) {
+	OGSS_Real				date = m_requests->getDate (idxRequest);
+	OGSS_Ulong				address = m_requests->getDeviceAddress (idxRequest);
+	OGSS_Ulong				size = m_requests->getSize (idxRequest);
+	RequestType				type = m_requests->getType (idxRequest);
+	OGSS_Ulong				first, last;
+	OGSS_Real				serviceTime;
+	OGSS_Real				stall = .0;
+
+	m_requests->isDeviceCacheHit (idxRequest, false);
+
+	if (type == RQT_ERASE || size == 0)
+		return m_disk->compute (idxRequest);
+
+	first = address / m_segmentSize;
+	last = (address + size - 1) / m_segmentSize;
+
+	// Forget the destages which ended before this request
+	while (! m_destages.empty () && m_destages.front () .first <= date) {
+		m_dirty -= m_destages.front () .second;
+		m_destages.pop_front ();
+	}
+
+	if (! (type & RQT_WRITE) ) {
+		m_numReads++;
+
+		if (lookup (first, last) ) {
+			m_numReadHits++;
+			m_requests->isDeviceCacheHit (idxRequest, true);
+			m_requests->setDeviceWaitingTime (idxRequest, .0);
+			m_requests->setServiceTime (idxRequest, m_latency);
+			return m_latency;
+		}
+
+		serviceTime = m_disk->compute (idxRequest);
+
+		// The reads have the priority, the pending destages are delayed
+		if (m_destageEnd > date) {
+			for (unsigned i = 0; i < m_destages.size (); ++i)
+				m_destages [i] .first += serviceTime;
+			m_destageEnd += serviceTime;
+		}
+
+		insert (first, last + m_readAhead);
+
+		return serviceTime;
+	}
+
+	m_numWrites++;
+
+	if (! m_writeBack) {
+		serviceTime = m_disk->compute (idxRequest);
+		insert (first, last);
+		return serviceTime;
+	}
+
+	// Wait for enough destages to make room in the buffer
+	while (! m_destages.empty () && m_dirty + size > m_capacity) {
+		stall = m_destages.front () .first - date;
+		m_dirty -= m_destages.front () .second;
+		m_destages.pop_front ();
+	}
+
+	if (stall > .0) m_stallTime += stall;
+	else m_numAbsorbed++;
+
+	// The device time of the write is spent by its destage, which books the
+	// internal clocks of the device from its start
+	m_disk->compute (idxRequest);
+	m_disk->serve (idxRequest, max (m_destageEnd, date) );
+	serviceTime = m_requests->getServiceTime (idxRequest);
+	m_destageTime += serviceTime;
+	m_destageEnd = max (m_destageEnd, date) + serviceTime;
+
+	m_destages.push_back (make_pair (m_destageEnd, size) );
+	m_dirty += size;
+	m_maxBacklog = max (m_maxBacklog, m_dirty);
+
+	insert (first, last);
+
+	serviceTime = max (stall, .0) + m_latency;
+	m_requests->isDeviceCacheHit (idxRequest, true);
+	m_requests->setDeviceWaitingTime (idxRequest, .0);
+	m_requests->setServiceTime (idxRequest, serviceTime);
+
+	return serviceTime;
+}
+
+OGSS_Real
+DeviceCache::serve (
+	const OGSS_Ulong		idxRequest,
+	const OGSS_Real			arrival) {
+	if (m_requests->getIsDeviceCacheHit (idxRequest) ) {
+		m_requests->isDeviceCacheHit (idxRequest, false);
+		return ComputationModel::serve (idxRequest, arrival);
+	}
+	return m_disk->serve (idxRequest, arrival);
+}
+
+void
+DeviceCache::release (
+	const OGSS_Ulong		idxRequest) {
+	m_requests->isDeviceCacheHit (idxRequest, false);
+	m_disk->release (idxRequest);
+}
+
+OGSS_Ulong
+DeviceCache::getBacklog (
+	const OGSS_Real			date) const {
+	OGSS_Ulong				backlog = 0;
+
+	for (unsigned i = 0; i < m_destages.size (); ++i)
+		if (m_destages [i] .first > date)
+			backlog += m_destages [i] .second;
+
+	return backlog;
+}
+
+/**************************************/
+/* PRIVATE FUNCTIONS ******************/
+/**************************************/
+OGSS_Bool
+DeviceCache::lookup (
+	const OGSS_Ulong		first,
+	const OGSS_Ulong		last) {
+	unordered_map < OGSS_Ulong, uint32_t > ::const_iterator
+							iter;
+	OGSS_Bool				present = true;
+
+	for (OGSS_Ulong i = first; i <= last; ++i) {
+		iter = m_slots.find (i);
+
+		if (iter == m_slots.end () ) present = false;
+		else m_referenced [iter->second] = 1;
+	}
+
+	return present;
+}
+
+void
+DeviceCache::insert (
+	const OGSS_Ulong		first,
+	const OGSS_Ulong		last) {
+	unordered_map < OGSS_Ulong, uint32_t > ::const_iterator
+							iter;
+
+	for (OGSS_Ulong i = first; i <= last; ++i) {
+		iter = m_slots.find (i);
+
+		if (iter != m_slots.end () ) continue;
+
+		// CLOCK: skip and clear the referenced slots
+		while (m_referenced [m_hand]) {
+			m_referenced [m_hand] = 0;
+			m_hand = (m_hand + 1) % m_keys.size ();
+		}
+
+		if (m_keys [m_hand] != 0)
+			m_slots.erase (m_keys [m_hand] - 1);
+
+		m_keys [m_hand] = i + 1;
+		m_slots [i] = m_hand;
+		m_hand = (m_hand + 1) % m_keys.size ();
+	}
+}
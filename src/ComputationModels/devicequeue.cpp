@@ -0,0 +1,238 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	devicequeue.cpp
+ * @brief	DeviceQueue is the command queue (NCQ) of a device. It holds the
+ * requests which arrive while the device is busy, and chooses the next one
+ * to serve depending on a reordering policy.
+ */
+
+#include "ComputationModels/devicequeue.hpp"
+#include "ComputationModels/devicecache.hpp"
+
+#include <algorithm>
+#include <glog/logging.h>
+#include <limits>
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+#define 					_DEV(i)			m_architecture->m_devices[i]
+#define 					_HDD(i)			_DEV(i).m_hardware.m_hdd
+#define 					_SSD(i)			_DEV(i).m_hardware.m_ssd
+
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+DeviceQueue::DeviceQueue (
+	RequestArray			* requests,
+	Architecture			* architecture,
+	ComputationModel		* disk,
+	const OGSS_Ushort		idxDevice) {
+	m_requests = requests;
+	m_architecture = architecture;
+	m_disk = disk;
+	m_idxDevice = idxDevice;
+
+	if (! _DEV (idxDevice) .isFlash () ) {
+		// The cache, if any, wraps the HDD (or SMR) model
+		DeviceCache		* cache = dynamic_cast < DeviceCache * > (disk);
+
+		m_hdd = static_cast < CMDiskHDD * > (
+			(cache != NULL) ? cache->getDisk () : disk);
+		m_depth = _HDD (idxDevice) .m_ataNCQDepth;
+		m_policy = _HDD (idxDevice) .m_ataNCQPolicy;
+	} else {
+		m_hdd = NULL;
+		m_depth = _SSD (idxDevice) .m_ataNCQDepth;
+		m_policy = _SSD (idxDevice) .m_ataNCQPolicy;
+
+		// No rotational position on a SSD
+		if (m_policy == QPT_SATF) {
+			LOG(WARNING) << "Device #" << idxDevice << ": SATF is only "
+				<< "available for HDD, SSTF is used";
+			m_policy = QPT_SSTF;
+		}
+	}
+
+	if (m_depth == 0) m_depth = 1;
+
+	m_busyUntil = .0;
+	m_position = 0;
+
+	m_numRequests = 0;
+	m_sumDepth = 0;
+	m_maxDepth = 0;
+	m_numReordered = 0;
+}
+
+DeviceQueue::~DeviceQueue () {  }
+
+void
+DeviceQueue::push (
+	const OGSS_Ulong		idxRequest,
+	vector < OGSS_Ulong >	& released) {
+	OGSS_Real				date = m_requests->getDate (idxRequest);
+
+	// Serve the requests the device would have started before this arrival
+	while (! m_queue.empty () && m_busyUntil <= date)
+		serve (released);
+
+	m_queue.push_back (idxRequest);
+
+	m_numRequests ++;
+	m_sumDepth += m_queue.size ();
+	m_maxDepth = max (m_maxDepth, (OGSS_Ulong) m_queue.size () );
+
+	// Idle device: nothing to reorder
+	if (m_busyUntil <= date)
+		serve (released);
+}
+
+void
+DeviceQueue::flush (
+	vector < OGSS_Ulong >	& released) {
+	while (! m_queue.empty () )
+		serve (released);
+}
+
+/**************************************/
+/* PRIVATE FUNCTIONS ******************/
+/**************************************/
+OGSS_Ulong
+DeviceQueue::select () const {
+	OGSS_Ulong				window;
+	OGSS_Ulong				best = 0;
+	OGSS_Ulong				current;
+	OGSS_Ulong				position;
+	OGSS_Ulong				distance;
+	OGSS_Ulong				bestDistance;
+	OGSS_Real				access;
+	OGSS_Real				bestAccess;
+	OGSS_Bool				bestAhead;
+
+	// The device only sees the first requests, up to its NCQ depth
+	window = min (m_depth, (OGSS_Ulong) m_queue.size () );
+
+	if (m_policy == QPT_FIFO || window == 1)
+		return 0;
+
+	current = getCurrentPosition ();
+
+	switch (m_policy) {
+	case QPT_SSTF:
+		bestDistance = numeric_limits <OGSS_Ulong> ::max ();
+		for (OGSS_Ulong i = 0; i < window; ++i) {
+			position = getPosition (m_queue [i]);
+			distance = position > current ?
+				position - current : current - position;
+			if (distance < bestDistance) {
+				bestDistance = distance;
+				best = i;
+			}
+		}
+		break;
+
+	case QPT_CLOOK:
+		// Take the nearest position ahead of the head, or wrap to the lowest
+		bestAhead = false;
+		bestDistance = numeric_limits <OGSS_Ulong> ::max ();
+		for (OGSS_Ulong i = 0; i < window; ++i) {
+			position = getPosition (m_queue [i]);
+			if (position >= current) {
+				if (! bestAhead || position - current < bestDistance) {
+					bestAhead = true;
+					bestDistance = position - current;
+					best = i;
+				}
+			} else if (! bestAhead && position < bestDistance) {
+				bestDistance = position;
+				best = i;
+			}
+		}
+		break;
+
+	case QPT_SATF:
+		bestAccess = numeric_limits <OGSS_Real> ::max ();
+		for (OGSS_Ulong i = 0; i < window; ++i) {
+			access = m_hdd->estimateAccessTime (m_queue [i]);
+			if (access < bestAccess) {
+				bestAccess = access;
+				best = i;
+			}
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	return best;
+}
+
+void
+DeviceQueue::serve (
+	vector < OGSS_Ulong >	& released) {
+	OGSS_Ulong				pos;
+	OGSS_Ulong				idxRequest;
+	OGSS_Real				serviceTime;
+
+	pos = select ();
+	if (pos != 0) m_numReordered ++;
+
+	idxRequest = m_queue [pos];
+	m_queue.erase (m_queue.begin () + pos);
+
+	serviceTime = m_disk->compute (idxRequest);
+
+	m_busyUntil = max (m_busyUntil, m_requests->getDate (idxRequest) )
+		+ serviceTime;
+
+	if (m_hdd == NULL)
+		m_position = (m_requests->getDeviceAddress (idxRequest)
+			+ m_requests->getSize (idxRequest) )
+			/ _SSD (m_idxDevice) .m_pageSize;
+
+	released.push_back (idxRequest);
+}
+
+OGSS_Ulong
+DeviceQueue::getPosition (
+	const OGSS_Ulong		idxRequest) const {
+	if (m_hdd != NULL)
+		return m_hdd->getTrack (idxRequest);
+
+	return m_requests->getDeviceAddress (idxRequest)
+		/ _SSD (m_idxDevice) .m_pageSize;
+}
+
+OGSS_Ulong
+DeviceQueue::getCurrentPosition () const {
+	if (m_hdd != NULL)
+		return _HDD (m_idxDevice) .m_trackPosition;
+
+	return m_position;
+}
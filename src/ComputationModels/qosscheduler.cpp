@@ -0,0 +1,343 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	qosscheduler.cpp
+ * @brief	QoSScheduler is the stage in front of a device which shares it
+ * between the QoS classes, by strict priority, weighted fair queuing and
+ * token bucket rate limits.
+ */
+
+#include "ComputationModels/qosscheduler.hpp"
+#include "Utils/eventtrace.hpp"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+#define 					_DEV(i)			m_architecture->m_devices[i]
+#define 					_QOS(i)			m_architecture->m_qosClasses[i]
+
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+QoSScheduler::QoSScheduler (
+	RequestArray			* requests,
+	Architecture			* architecture,
+	ComputationModel		* disk,
+	const OGSS_Ushort		idxDevice) {
+	m_requests = requests;
+	m_architecture = architecture;
+	m_disk = disk;
+	m_idxDevice = idxDevice;
+
+	// Only the traces in format 1 carry a color
+	m_colored = (requests->getFormat () == 1);
+
+	m_classes.resize (architecture->m_qosClasses.size () );
+	for (OGSS_Ushort i = 0; i < m_classes.size (); ++i) {
+		m_classes [i] .m_head = 0;
+		m_classes [i] .m_count = 0;
+		m_classes [i] .m_lastTag = .0;
+
+		// The fair queuing is done between the classes of a priority level
+		m_classes [i] .m_level = i;
+		for (OGSS_Ushort j = 0; j < i; ++j)
+			if (_QOS (j) .m_priority == _QOS (i) .m_priority) {
+				m_classes [i] .m_level = m_classes [j] .m_level;
+				break;
+			}
+
+		m_classes [i] .m_tokens = _QOS (i) .m_burst;
+		m_classes [i] .m_refill = .0;
+		m_classes [i] .m_eligible = .0;
+		m_classes [i] .m_numRequests = 0;
+		m_classes [i] .m_numThrottled = 0;
+	}
+
+	m_ready.reserve (m_classes.size () );
+	m_throttled.reserve (m_classes.size () );
+	m_numWaiting = 0;
+
+	m_busyUntil = .0;
+	m_virtualTime.assign (m_classes.size (), .0);
+	m_throttleTime = .0;
+}
+
+QoSScheduler::~QoSScheduler () {  }
+
+void
+QoSScheduler::push (
+	const OGSS_Ulong		idxRequest,
+	vector < OGSS_Ulong >	& released) {
+	OGSS_Real				date = m_requests->getDate (idxRequest);
+	OGSS_Ushort				idxClass = 0;
+	unsigned				color;
+	unsigned				pid;
+
+	// Serve the requests the device would have started before this arrival
+	while (! isEmpty () && nextStart () <= date)
+		serve (released);
+
+	if (m_colored) {
+		m_requests->getOptions (idxRequest, color, pid);
+		idxClass = m_architecture->getIdxQoSClass (color);
+	}
+
+	Class					& cls = m_classes [idxClass];
+
+	// The ring is only reallocated when it is full
+	if (cls.m_count == cls.m_ring.size () ) {
+		vector < Entry >	ring (max ( (OGSS_Ulong) 16, 2 * cls.m_count) );
+
+		for (OGSS_Ulong i = 0; i < cls.m_count; ++i)
+			ring [i] = cls.m_ring [(cls.m_head + i) % cls.m_ring.size ()];
+
+		cls.m_ring.swap (ring);
+		cls.m_head = 0;
+	}
+
+	// Self-clocked fair queuing: a class which was idle starts from the tag
+	// of the request in service
+	cls.m_lastTag = max (m_virtualTime [cls.m_level], cls.m_lastTag)
+		+ getCost (idxRequest) / _QOS (idxClass) .m_weight;
+
+	Entry					& entry =
+		cls.m_ring [(cls.m_head + cls.m_count) % cls.m_ring.size ()];
+
+	entry.m_idxRequest = idxRequest;
+	entry.m_tag = cls.m_lastTag;
+
+	cls.m_count ++;
+	cls.m_numRequests ++;
+	m_numWaiting ++;
+
+	if (cls.m_count == 1)
+		schedule (idxClass);
+
+	// Idle device and tokens available: nothing to choose
+	if (nextStart () <= date)
+		serve (released);
+}
+
+void
+QoSScheduler::flush (
+	vector < OGSS_Ulong >	& released) {
+	while (! isEmpty () )
+		serve (released);
+}
+
+/**************************************/
+/* PRIVATE FUNCTIONS ******************/
+/**************************************/
+OGSS_Real
+QoSScheduler::nextStart () {
+	if (isEmpty () )
+		return numeric_limits <OGSS_Real> ::max ();
+
+	promote (m_busyUntil);
+
+	if (! m_ready.empty () )
+		return m_busyUntil;
+
+	return max (m_busyUntil, m_classes [m_throttled [0] ] .m_eligible);
+}
+
+void
+QoSScheduler::serve (
+	vector < OGSS_Ulong >	& released) {
+	OGSS_Ushort				idxClass;
+	OGSS_Ulong				idxRequest;
+	OGSS_Real				start = m_busyUntil;
+	OGSS_Real				date;
+	OGSS_Real				serviceTime;
+
+	promote (start);
+
+	// Every class waits for tokens: the device stays idle
+	if (m_ready.empty () ) {
+		start = max (start, m_classes [m_throttled [0] ] .m_eligible);
+		promote (start);
+	}
+
+	idxClass = popClass (false);
+
+	Class					& cls = m_classes [idxClass];
+
+	idxRequest = cls.m_ring [cls.m_head] .m_idxRequest;
+	m_virtualTime [cls.m_level] = cls.m_ring [cls.m_head] .m_tag;
+
+	cls.m_head = (cls.m_head + 1) % cls.m_ring.size ();
+	cls.m_count --;
+	m_numWaiting --;
+
+	date = m_requests->getDate (idxRequest);
+
+	if (cls.m_eligible > max (m_busyUntil, date) )
+		cls.m_numThrottled ++;
+
+	// The device model does not know the request waited for tokens, its clock
+	// is moved to the start
+	if (start > max (m_busyUntil, date) ) {
+		m_throttleTime += start - max (m_busyUntil, date);
+		_DEV (m_idxDevice) .m_clock = max (_DEV (m_idxDevice) .m_clock, start);
+	}
+
+	start = max (start, date);
+
+	if (_QOS (idxClass) .m_rate > .0) {
+		cls.m_tokens = min ( (OGSS_Real) _QOS (idxClass) .m_burst,
+			cls.m_tokens + (start - cls.m_refill)
+			* _QOS (idxClass) .m_rate * MEGABYTE * MILLISEC);
+		cls.m_refill = start;
+		cls.m_tokens -= getCost (idxRequest);
+	}
+
+	serviceTime = m_disk->compute (idxRequest);
+	m_busyUntil = start + serviceTime;
+
+	if (EventTrace::isEnabled (TRC_QOS) )
+		EventTrace::record (TRC_QOS, idxClass, cls.m_level, true, idxRequest,
+			start, m_busyUntil, m_numWaiting);
+
+	if (cls.m_count != 0)
+		schedule (idxClass);
+
+	released.push_back (idxRequest);
+}
+
+void
+QoSScheduler::promote (
+	const OGSS_Real			date) {
+	while (! m_throttled.empty ()
+		&& m_classes [m_throttled [0] ] .m_eligible <= date)
+		pushClass (false, popClass (true) );
+}
+
+void
+QoSScheduler::schedule (
+	const OGSS_Ushort		idxClass) {
+	Class					& cls = m_classes [idxClass];
+	OGSS_Real				needed;
+
+	if (_QOS (idxClass) .m_rate <= .0) {
+		cls.m_eligible = .0;
+		pushClass (false, idxClass);
+		return;
+	}
+
+	// A request larger than the bucket only waits for a full bucket
+	needed = min ( (OGSS_Real) _QOS (idxClass) .m_burst,
+		(OGSS_Real) getCost (cls.m_ring [cls.m_head] .m_idxRequest) );
+
+	cls.m_eligible = cls.m_refill + max (.0, needed - cls.m_tokens)
+		/ (_QOS (idxClass) .m_rate * MEGABYTE * MILLISEC);
+
+	pushClass (true, idxClass);
+}
+
+OGSS_Ulong
+QoSScheduler::getCost (
+	const OGSS_Ulong		idxRequest) const {
+	return max ( (OGSS_Ulong) 1, m_requests->getSize (idxRequest) );
+}
+
+OGSS_Bool
+QoSScheduler::before (
+	const OGSS_Bool			throttled,
+	const OGSS_Ushort		lhs,
+	const OGSS_Ushort		rhs) const {
+	const Class				& l = m_classes [lhs];
+	const Class				& r = m_classes [rhs];
+	OGSS_Real				lhsTag;
+	OGSS_Real				rhsTag;
+
+	if (throttled)
+		return l.m_eligible < r.m_eligible
+			|| (l.m_eligible == r.m_eligible && lhs < rhs);
+
+	if (_QOS (lhs) .m_priority != _QOS (rhs) .m_priority)
+		return _QOS (lhs) .m_priority > _QOS (rhs) .m_priority;
+
+	lhsTag = l.m_ring [l.m_head] .m_tag;
+	rhsTag = r.m_ring [r.m_head] .m_tag;
+
+	return lhsTag < rhsTag || (lhsTag == rhsTag && lhs < rhs);
+}
+
+void
+QoSScheduler::pushClass (
+	const OGSS_Bool			throttled,
+	const OGSS_Ushort		idxClass) {
+	vector < OGSS_Ushort >	& heap = throttled ? m_throttled : m_ready;
+
+	heap.push_back (idxClass);
+
+	siftClass (throttled, heap.size () - 1);
+}
+
+OGSS_Ushort
+QoSScheduler::popClass (
+	const OGSS_Bool			throttled) {
+	vector < OGSS_Ushort >	& heap = throttled ? m_throttled : m_ready;
+	OGSS_Ushort				idxClass = heap [0];
+
+	heap [0] = heap.back ();
+	heap.pop_back ();
+
+	if (! heap.empty () )
+		siftClass (throttled, 0);
+
+	return idxClass;
+}
+
+void
+QoSScheduler::siftClass (
+	const OGSS_Bool			throttled,
+	OGSS_Ushort				pos) {
+	vector < OGSS_Ushort >	& heap = throttled ? m_throttled : m_ready;
+	OGSS_Ushort				idxClass = heap [pos];
+	OGSS_Ushort				child;
+
+	while (pos > 0 && before (throttled, idxClass, heap [(pos - 1) / 2]) ) {
+		heap [pos] = heap [(pos - 1) / 2];
+		pos = (pos - 1) / 2;
+	}
+
+	while ( (child = 2 * pos + 1) < heap.size () ) {
+		if (child + 1u < heap.size ()
+			&& before (throttled, heap [child + 1], heap [child]) )
+			++child;
+
+		if (! before (throttled, heap [child], idxClass) ) break;
+
+		heap [pos] = heap [child];
+		pos = child;
+	}
+
+	heap [pos] = idxClass;
+}
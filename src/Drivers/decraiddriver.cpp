@@ -80,7 +80,7 @@ DecRaidDriver::updateVolume ()
 	iDevice = m_architecture->m_volumes [m_idxVolume] .m_idxDevices;
 	devCounter = iDevice + m_numSpareDevices;
 	
-	if (m_architecture->m_devices [iDevice] .m_type == DVT_HDD)
+	if (! m_architecture->m_devices [iDevice] .isFlash () )
 		deviceSize = m_architecture->m_devices [iDevice]
 			.m_hardware.m_hdd.m_numSectors
 			* m_architecture->m_devices [iDevice]
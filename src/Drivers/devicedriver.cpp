@@ -142,6 +142,12 @@ DeviceDriver::receiveRequest () {
 	if (idxRequest == OGSS_ULONG_MAX)
 		return false;
 
+	// Horizons are forwarded as is, to keep their place in the volume stream
+	if (idxRequest == OGSS_HORIZON) {
+		m_zmqExecution->send (msgRequest);
+		return true;
+	}
+
 	if (m_requests->getType (idxRequest) == RQT_FAULT) {
 		m_isFaulty = true;
 		m_failureDate = m_requests->getDate (idxRequest);
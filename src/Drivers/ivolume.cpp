@@ -28,11 +28,14 @@
 
 #include <glog/logging.h>				/* For log */
 #include <iostream>
+#include <limits>
 
 #include "Drivers/devicedriver.hpp"
 #include "Drivers/ivolume.hpp"
 
+#include "Utils/chrono.hpp"
 #include "Utils/simexception.hpp"
+#include "Utils/stagetimer.hpp"
 
 #include "XMLParsers/xmlparser.hpp"
 
@@ -85,10 +88,14 @@ IVolume::IVolume (
 	m_requests = NULL;
 	m_architecture = NULL;
 
+	m_sequence = 0;
+	m_horizonDate = .0;
+
 	if (parent == NULL)
 	{
 		OGSS_String			zmqLink;
 		OGSS_String			zmqLinkReply;
+		OGSS_Real			quantum;
 
 		m_zmqContext = new zmq::context_t (1);
 
@@ -116,6 +123,9 @@ IVolume::IVolume (
 		m_zmqExecutionReply = new zmq::socket_t (*m_zmqContext, ZMQ_PULL);
 		m_zmqExecutionReply->bind (zmqLinkReply.c_str () );
 		m_zmqExecutionReply->setsockopt (ZMQ_RCVHWM, &zero, sizeof (int) );
+
+		XMLParser::getOrderingInformation (m_configurationFile,
+			m_deterministic, quantum);
 	}
 	else
 	{
@@ -163,15 +173,20 @@ IVolume::executeSimulation () {
 #ifndef __NOSIM__
 	OGSS_Bool 				unfinished = true;
 	OGSS_Ulong				idxRequest;
+	OGSS_Real				date;
 	std::vector < OGSS_Ulong > 	subrequests = std::vector < OGSS_Ulong > ();
 	map <OGSS_Real, OGSS_Ulong> ::iterator	eventIterator;
+	Chrono					chrono;
+	int64_t					decompositionTime = 0;
+	OGSS_Bool				timed = StageTimer::isEnabled ();
 
 	try
 	{
 		// First retrieve events
 		unfinished = receiveRequest (idxRequest);
 
-		while (unfinished && m_requests->getType (idxRequest) == RQT_FAULT) {
+		while (unfinished && idxRequest != OGSS_HORIZON
+			&& m_requests->getType (idxRequest) == RQT_FAULT) {
 			handleEvent (idxRequest);
 			sendRequest (idxRequest);
 			unfinished = receiveRequest (idxRequest);
@@ -181,28 +196,45 @@ IVolume::executeSimulation () {
 
 		while (unfinished)
 		{
+			if (idxRequest == OGSS_HORIZON)
+				date = m_horizonDate;
+			else
+				date = m_requests->getDate (idxRequest);
+
 			// Then user requests
 			while (eventIterator != m_failedDevices.end ()
-				&& eventIterator->first
-				< m_requests->getDate (idxRequest) ) {
+				&& eventIterator->first < date) {
 				DLOG(INFO) << "Need to launch event management: "
-					<< eventIterator->first << " < "
-					<< m_requests->getDate (idxRequest);
+					<< eventIterator->first << " < " << date;
 				manageFailureEvent (eventIterator->first,
 					eventIterator->second);
 				++ eventIterator;
 			}
 
-			decomposeRequest (idxRequest, subrequests);
+			// An horizon is only forwarded once the events before it are
+			// treated, since they generate requests dated before it
+			if (idxRequest == OGSS_HORIZON)
+				sendHorizon (date);
+			else
+			{
+				if (timed) { chrono.restart (); chrono.tick (); }
+
+				decomposeRequest (idxRequest, subrequests);
 
-			for (auto elt: subrequests)
-				sendRequest (elt);
+				if (timed) { chrono.tick (); decompositionTime += chrono.get (); }
 
-			subrequests.clear ();
+				for (auto elt: subrequests)
+					sendRequest (elt);
+
+				subrequests.clear ();
+			}
 
 			unfinished = receiveRequest (idxRequest);
 		}
+		sendHorizon (numeric_limits <OGSS_Real> ::infinity () );
 		terminateTreatment ();
+
+		StageTimer::add (STG_DECOMPOSITION, decompositionTime);
 	}
 	catch (SimulatorException & e)
 	{ DLOG(ERROR) << "VD#" << m_idxVolume << ": " << e.getMessage (); }
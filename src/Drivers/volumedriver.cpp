@@ -64,6 +64,8 @@ VolumeDriver::VolumeDriver (
 		zmqInfos,
 		configurationFile,
 		parent) {
+	m_trimWarning = false;
+	m_cache = NULL;
 
 	if (parent != NULL)
 		instanciateLayout ();
@@ -74,6 +76,21 @@ VolumeDriver::~VolumeDriver () {
 							pid;
 							
 	delete m_layout;
+
+	if (m_cache != NULL) {
+		if (m_cache->getNumReads () + m_cache->getNumWrites () != 0)
+			LOG(INFO) << "Volume #" << m_idxVolume << " cache: "
+				<< m_cache->getNumReadHits () << "/"
+				<< m_cache->getNumReads () << " read hits, "
+				<< m_cache->getNumAbsorbedWrites () << "/"
+				<< m_cache->getNumWrites () << " writes absorbed ("
+				<< m_cache->getNumThrottledWrites () << " throttled), "
+				<< "block hit ratio " << m_cache->getBlockHitRatio ()
+				<< ", " << m_cache->getNumEvictions () << " evictions, "
+				<< m_cache->getNumGhostHits () << " ghost hits";
+
+		delete m_cache;
+	}
 }
 
 void
@@ -90,6 +107,23 @@ void
 VolumeDriver::decomposeRequest (
 	const OGSS_Ulong		idxRequest,
 	vector < OGSS_Ulong >	& subrequests) {
+	if (m_cache != NULL && lookupCache (idxRequest) ) {
+		subrequests.push_back (idxRequest);
+		return;
+	}
+
+	// The RAID layouts do not decompose a TRIM, it is a no-op at the volume
+	if (m_requests->getType (idxRequest) == RQT_ERASE
+		&& _VOL(m_idxVolume).m_hardware.m_volume.m_type != VST_JBOD) {
+		if (! m_trimWarning)
+			LOG(WARNING) << "Volume #" << m_idxVolume << " does not forward "
+				<< "TRIM requests, they are completed by the volume";
+		m_trimWarning = true;
+		completeAtVolume (idxRequest, .0);
+		subrequests.push_back (idxRequest);
+		return;
+	}
+
 	return m_layout->prepareRequest (idxRequest, subrequests);
 }
 
@@ -110,6 +144,9 @@ VolumeDriver::instanciateLayout () {
 		m_layout = new LayoutRAIDNP (m_architecture->m_volumes + m_idxVolume,
 			m_requests, m_idxVolume);
 
+	if (_VOL(m_idxVolume).m_cacheSize != 0 && m_cache == NULL)
+		m_cache = new VolumeCache (_VOL(m_idxVolume) );
+
 	if (m_parent == NULL)
 	{
 		m_layout->updateExecutionQueue (m_idxVolume,
@@ -130,6 +167,48 @@ VolumeDriver::manageFailureEvent (
 	m_layout->addFaultyDevice (idxDevice);
 }
 
+OGSS_Bool
+VolumeDriver::lookupCache (
+	const OGSS_Ulong		idxRequest) {
+	OGSS_Bool				hit = false;
+
+	switch (m_requests->getType (idxRequest) ) {
+		case RQT_READ:
+			hit = m_cache->read (m_requests->getVolumeAddress (idxRequest),
+				m_requests->getSize (idxRequest) );
+			break;
+		case RQT_WRITE:
+			hit = m_cache->write (m_requests->getVolumeAddress (idxRequest),
+				m_requests->getSize (idxRequest),
+				m_requests->getDate (idxRequest) );
+			break;
+		case RQT_ERASE:
+			m_cache->trim (m_requests->getVolumeAddress (idxRequest),
+				m_requests->getSize (idxRequest) );
+			break;
+		default:
+			break;
+	}
+
+	if (! hit)
+		return false;
+
+	completeAtVolume (idxRequest, _VOL(m_idxVolume).m_cacheLatency);
+
+	return true;
+}
+
+void
+VolumeDriver::completeAtVolume (
+	const OGSS_Ulong		idxRequest,
+	const OGSS_Real			serviceTime) {
+	m_requests->isCacheHit (idxRequest);
+	m_requests->setServiceTime (idxRequest, serviceTime);
+	m_requests->setIdxDevice (idxRequest, _VOL(m_idxVolume).m_idxDevices);
+	m_requests->setNumEffBusChild (idxRequest, 0);
+	m_requests->setNumBusChild (idxRequest, 1);
+}
+
 void
 VolumeDriver::generateRebuildRequests (
 	const OGSS_Real			date,
@@ -56,7 +56,7 @@ void GraphGenFullReqPercentile::makeGraph () {
 	mglGraph				graph;
 	mglData					valuesDT;
 
-	OGSS_Real				values [4 * m_numPercentiles];
+	OGSS_Real				values [5 * m_numPercentiles];
 	OGSS_Real				maxValue = .0;
 	OGSS_Ulong				counters [m_numPercentiles];
 	OGSS_Ulong				numRequests;
@@ -76,6 +76,8 @@ void GraphGenFullReqPercentile::makeGraph () {
 			+= m_requests->getDeviceWaitingTime (i);
 		values [3 * m_numPercentiles + j]
 			+= m_requests->getServiceTime (i);
+		values [4 * m_numPercentiles + j]
+			+= m_requests->getBufferWaitingTime (i);
 
 		maxValue = max (maxValue, m_requests->getResponseTime (i) );
 
@@ -87,11 +89,12 @@ void GraphGenFullReqPercentile::makeGraph () {
 		values [m_numPercentiles + i] /= counters [i];
 		values [2 * m_numPercentiles + i] /= counters [i];
 		values [3 * m_numPercentiles + i] /= counters [i];
+		values [4 * m_numPercentiles + i] /= counters [i];
 	}
 
 	cout << m_numPercentiles << endl;
 
-	valuesDT.Link (values, m_numPercentiles, 4);
+	valuesDT.Link (values, m_numPercentiles, 5);
 	maxValue *= 1.25;
 
 	// Set the graph parameters
@@ -103,9 +106,10 @@ void GraphGenFullReqPercentile::makeGraph () {
 	graph.AddLegend ("transfer", "n");
 	graph.AddLegend ("dev wait", "R");
 	graph.AddLegend ("dev serv", "r");
+	graph.AddLegend ("buf wait", "G");
 
 	graph.Box ();
-	graph.Bars (valuesDT, "aNnRr");
+	graph.Bars (valuesDT, "aNnRrG");
 	graph.Axis ();
 	graph.Grid ("y", "k;");
 	graph.Legend ();
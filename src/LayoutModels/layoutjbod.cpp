@@ -46,7 +46,7 @@ LayoutJBOD::LayoutJBOD (
 	OGSS_Ushort				idxVolume) {
 	m_numDevices = volume->m_numDevices;
 
-	if (devices->m_type == DVT_HDD)
+	if (! devices->isFlash () )
 		m_numBytesByDevice = devices->m_hardware.m_hdd.m_numSectors
 			* devices->m_hardware.m_hdd.m_sectorSize;
 	else
@@ -56,7 +56,7 @@ LayoutRAID1::LayoutRAID1 (
 	m_numBytesBySU = volume->m_hardware.m_volume.m_stripeUnitSize;
 
 	if (m_numBytesBySU == 0) {
-		if (devices->m_type == DVT_HDD)
+		if (! devices->isFlash () )
 			m_numBytesBySU = devices->m_hardware.m_hdd.m_numSectors
 				* devices->m_hardware.m_hdd.m_sectorSize;
 		else
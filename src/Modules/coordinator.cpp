@@ -0,0 +1,457 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+
+/**
+ * @file	coordinator.cpp
+ * @brief	Coordinator is the class which drives a distributed simulation,
+ * where groups of tiers are simulated by separate OGSSim worker processes.
+ *
+ * The coordinator reads the whole trace and the whole architecture, does the
+ * redirection the PreProcessing would do and sends to each worker the request
+ * descriptors targeting its tiers. Once the workers are done, it gathers
+ * their results and writes the global result file.
+ */
+
+#include <cstring>
+#include <fstream>
+#include <glog/logging.h>
+
+#include "Modules/coordinator.hpp"
+
+#include "Utils/simexception.hpp"
+
+#include "XMLParsers/xmlparser.hpp"
+
+#define _VOL(vol) m_architecture->m_volumes [vol]
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+static const OGSS_Ulong		DESCRIPTOR_BATCH	= 1024;
+static const OGSS_Ulong		RESULT_WINDOW		= 65536;
+
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+Coordinator::Coordinator (
+	const OGSS_String		& configurationFile) :
+	m_context (1) {
+	int						zero = 0;
+
+	m_configurationFile = configurationFile;
+	m_numRequests = 0;
+	m_numResults = 0;
+	m_numFaulty = 0;
+	m_sumResponseTime = .0;
+	m_totalExecutionTime = .0;
+
+	XMLParser::getDistributedInformation (configurationFile, m_workers);
+
+	if (m_workers.empty () )
+		throw SimulatorException (ERR_XMLPARSER,
+			"A distributed simulation needs at least one worker");
+
+	m_architecture = new Architecture ();
+	XMLParser::getHardwareConfiguration (
+		XMLParser::getFilePath (configurationFile, FTP_HARDWARE),
+		* m_architecture);
+
+	m_workload = new Workload (configurationFile);
+
+	// The coordinator binds every endpoint, workers can be launched before or
+	// after it
+	for (auto & worker: m_workers)
+	{
+		m_requestSockets.push_back (new zmq::socket_t (m_context, ZMQ_PUSH) );
+		m_requestSockets.back () ->setsockopt (ZMQ_SNDHWM, &zero, sizeof (int) );
+		m_requestSockets.back () ->bind (worker.m_requests.c_str () );
+
+		m_resultSockets.push_back (new zmq::socket_t (m_context, ZMQ_PULL) );
+		m_resultSockets.back () ->bind (worker.m_results.c_str () );
+	}
+
+	m_bases.assign (m_workers.size (), 0);
+	m_firstVolumes.assign (m_workers.size (), OGSS_USHORT_MAX);
+	m_globalIds.resize (m_workers.size () );
+}
+
+Coordinator::~Coordinator () {
+	for (auto socket: m_requestSockets)
+	{
+		socket->close ();
+		delete socket;
+	}
+
+	for (auto socket: m_resultSockets)
+	{
+		socket->close ();
+		delete socket;
+	}
+
+	delete m_workload;
+	delete m_architecture;
+}
+
+void
+Coordinator::updateWorkerMapping () {
+	OGSS_Ulong				numBytes = 0;
+	OGSS_Ushort				numActive = 0;
+	OGSS_Ushort				owner;
+	OGSS_Ushort				tier;
+
+	for (OGSS_Ushort i = 0; i < m_architecture->m_geometry->m_numVolumes; ++i)
+	{
+		tier = _VOL(i) .m_idxTier;
+		owner = OGSS_USHORT_MAX;
+
+		for (OGSS_Ushort w = 0; w < m_workers.size (); ++w)
+		{
+			if (tier >= m_workers [w] .m_firstTier
+				&& tier <= m_workers [w] .m_lastTier)
+			{ owner = w; break; }
+		}
+
+		// Worker address spaces start at their first volume
+		if (owner != OGSS_USHORT_MAX
+			&& m_firstVolumes [owner] == OGSS_USHORT_MAX)
+		{
+			m_firstVolumes [owner] = i;
+			m_bases [owner] = numBytes;
+		}
+
+		if (owner == OGSS_USHORT_MAX)
+			DLOG(WARNING) << "Volume #" << i << " (tier #" << tier
+				<< ") is not simulated by any worker";
+
+		numBytes += m_architecture->getVolumeCapacity (i);
+		m_redirectionTable [numBytes] = owner;
+
+		if (_VOL(i) .m_type == VHT_DECRAID)
+			i += _VOL(i) .m_hardware.m_draid.m_numVolumes;
+	}
+
+	for (OGSS_Ushort w = 0; w < m_workers.size (); ++w)
+	{
+		if (m_firstVolumes [w] == OGSS_USHORT_MAX)
+			DLOG(WARNING) << "Worker #" << w << " does not own any volume";
+		else
+			++numActive;
+	}
+
+	// Every worker simulates its own copy of the host bus
+	if (numActive > 1)
+		LOG(WARNING) << numActive << " workers share the host bus #"
+			<< m_architecture->m_geometry->m_idxBus << ": the contention "
+			<< "between their tiers is not simulated, the bus waiting times "
+			<< "are optimistic";
+}
+
+void
+Coordinator::dispatchRequests () {
+	RequestArray			* requests = m_workload->getRequests ();
+	OGSS_Ulong				numRequests = requests->getNumRequests ();
+	OGSS_Ulong				numDropped = 0;
+
+	std::vector <OGSS_Ushort>	owners (numRequests);
+	std::vector < std::vector <RequestDescriptor> >	batches (m_workers.size () );
+	RequestDescriptor		descriptor;
+	DistributedHeader		header;
+
+	for (OGSS_Ulong i = 0; i < numRequests; ++i)
+	{
+		owners [i] = searchWorker (requests->getAddress (i) );
+
+		if (owners [i] == OGSS_USHORT_MAX)
+			++numDropped;
+		else
+			m_globalIds [owners [i] ] .push_back (i);
+	}
+
+	if (numDropped != 0)
+		LOG(WARNING) << numDropped << " requests target no worker and are "
+			<< "not simulated";
+
+	header.m_requestFormat = requests->getFormat ();
+
+	for (OGSS_Ushort w = 0; w < m_workers.size (); ++w)
+	{
+		header.m_numRequests = m_globalIds [w] .size ();
+		sendToWorker (w, &header, sizeof (DistributedHeader) );
+		batches [w] .reserve (DESCRIPTOR_BATCH);
+
+		DLOG(INFO) << "Worker #" << w << " gets " << header.m_numRequests
+			<< " requests";
+	}
+
+	// Trace order is kept, so each worker gets its requests by date
+	for (OGSS_Ulong i = 0; i < numRequests; ++i)
+	{
+		if (owners [i] == OGSS_USHORT_MAX)
+			continue;
+
+		descriptor.m_idxRequest = i;
+		descriptor.m_date = requests->getDate (i);
+		descriptor.m_address = requests->getAddress (i) - m_bases [owners [i] ];
+		descriptor.m_size = requests->getSize (i);
+		descriptor.m_type = requests->getType (i);
+		requests->getOptions (i, descriptor.m_option1, descriptor.m_option2);
+
+		batches [owners [i] ] .push_back (descriptor);
+
+		if (batches [owners [i] ] .size () == DESCRIPTOR_BATCH)
+		{
+			sendToWorker (owners [i], batches [owners [i] ] .data (),
+				DESCRIPTOR_BATCH * sizeof (RequestDescriptor) );
+			batches [owners [i] ] .clear ();
+		}
+	}
+
+	for (OGSS_Ushort w = 0; w < m_workers.size (); ++w)
+	{
+		if (! batches [w] .empty () )
+			sendToWorker (w, batches [w] .data (),
+				batches [w] .size () * sizeof (RequestDescriptor) );
+	}
+
+	// The results only need the global index of the requests of each worker
+	m_numRequests = numRequests;
+	delete m_workload;
+	m_workload = NULL;
+}
+
+void
+Coordinator::collectResults () {
+	OGSS_Ushort				numWorkers = m_workers.size ();
+	OGSS_Ulong				numLate = 0;
+	OGSS_Ulong				numDescriptors;
+	OGSS_Ulong				next, global, local;
+	OGSS_Ushort				owner = 0;
+	OGSS_Bool				isReceived;
+	OGSS_Bool				isEnded;
+
+	std::vector <ResultDescriptor>	window (RESULT_WINDOW);
+	std::vector <OGSS_Bool>	present (RESULT_WINDOW, false);
+	std::vector <zmq::message_t>	messages (numWorkers);
+	std::vector <OGSS_Ulong>	positions (numWorkers, 0);
+	std::vector <OGSS_Ulong>	counts (numWorkers, 0);
+	std::vector <OGSS_Ulong>	cursors (numWorkers, 0);
+	std::vector <OGSS_Bool>	ended (numWorkers, false);
+	ResultDescriptor		* descriptors;
+	ResultDescriptor		result;
+
+	std::ofstream			resultFile (XMLParser::getFilePath (
+		m_configurationFile, FTP_RESULT) .c_str () );
+
+	// The results are written by request index: the next one is the first
+	// request of the workers not written yet, the following ones wait in the
+	// window
+	next = searchNextResult (cursors, owner);
+
+	for (;;)
+	{
+		// Take the received descriptors while they fit in the window
+		for (OGSS_Ushort w = 0; w < numWorkers; ++w)
+		{
+			descriptors = (ResultDescriptor *) messages [w] .data ();
+			numDescriptors = messages [w] .size () / sizeof (ResultDescriptor);
+
+			for (; positions [w] < numDescriptors; ++positions [w])
+			{
+				local = descriptors [positions [w] ] .m_idxRequest;
+
+				if (local >= m_globalIds [w] .size () )
+				{
+					DLOG(ERROR) << "Worker #" << w << " sent an unknown request #"
+						<< local;
+					continue;
+				}
+
+				global = m_globalIds [w] [local];
+
+				if (next != OGSS_ULONG_MAX && global >= next + RESULT_WINDOW)
+					break;
+
+				result = descriptors [positions [w] ];
+				result.m_idxRequest = global;
+				result.m_idxVolume += m_firstVolumes [w];
+				++counts [w];
+
+				if (global < next)
+				{
+					++numLate;
+					writeResult (resultFile, result);
+					continue;
+				}
+
+				window [global % RESULT_WINDOW] = result;
+				present [global % RESULT_WINDOW] = true;
+			}
+		}
+
+		// Write the results in order, the missing results of a worker which
+		// ended its stream are skipped
+		while (next != OGSS_ULONG_MAX
+			&& (present [next % RESULT_WINDOW] || ended [owner]) )
+		{
+			if (present [next % RESULT_WINDOW])
+			{
+				writeResult (resultFile, window [next % RESULT_WINDOW]);
+				present [next % RESULT_WINDOW] = false;
+			}
+
+			++cursors [owner];
+			next = searchNextResult (cursors, owner);
+		}
+
+		// Receive a new message from the workers whose descriptors are taken
+		isReceived = false;
+		isEnded = true;
+
+		for (OGSS_Ushort w = 0; w < numWorkers; ++w)
+		{
+			if (ended [w])
+				continue;
+
+			isEnded = false;
+
+			if (positions [w] < messages [w] .size () / sizeof (ResultDescriptor) )
+				continue;
+
+			m_resultSockets [w] ->recv (&messages [w]);
+			positions [w] = 0;
+			isReceived = true;
+
+			// An empty message ends the result stream
+			if (messages [w] .size () == 0)
+				ended [w] = true;
+		}
+
+		if (isEnded)
+			break;
+
+		// All the workers wait for the window while the next result did not
+		// come: it is written out of order once it comes
+		if (! isReceived)
+		{
+			++cursors [owner];
+			next = searchNextResult (cursors, owner);
+		}
+	}
+
+	resultFile.close ();
+
+	for (OGSS_Ushort w = 0; w < numWorkers; ++w)
+		LOG(INFO) << "Worker #" << w << " returned " << counts [w] << "/"
+			<< m_globalIds [w] .size () << " results";
+
+	if (numLate != 0)
+		LOG(WARNING) << numLate << " results came after the reorder window of "
+			<< RESULT_WINDOW << " requests and are out of order in the result "
+			<< "file";
+
+	LOG(INFO) << "Distributed simulation: " << m_numResults << "/"
+		<< m_numRequests << " requests simulated, " << m_numFaulty << " faulty";
+
+	if (m_numResults != m_numFaulty)
+		LOG(INFO) << "Mean response time: "
+			<< m_sumResponseTime / (m_numResults - m_numFaulty) << " ms";
+
+	LOG(INFO) << "Total execution time: " << m_totalExecutionTime << " ms";
+}
+
+/**************************************/
+/* PRIVATE FUNCTIONS ******************/
+/**************************************/
+OGSS_Ulong
+Coordinator::searchNextResult (
+	const std::vector <OGSS_Ulong>	& cursors,
+	OGSS_Ushort				& owner) {
+	OGSS_Ulong				next = OGSS_ULONG_MAX;
+
+	for (OGSS_Ushort w = 0; w < m_workers.size (); ++w)
+	{
+		if (cursors [w] < m_globalIds [w] .size ()
+			&& m_globalIds [w] [cursors [w] ] < next)
+		{
+			next = m_globalIds [w] [cursors [w] ];
+			owner = w;
+		}
+	}
+
+	return next;
+}
+
+void
+Coordinator::writeResult (
+	std::ofstream			& resultFile,
+	const ResultDescriptor	& result) {
+	++m_numResults;
+
+	if (result.m_isFaulty)
+	{
+		++m_numFaulty;
+		resultFile << result.m_idxRequest << " "
+			<< result.m_date << " "
+			<< result.m_type << " "
+			<< result.m_idxVolume << " -1 -1 -1 -1 -1 1 -1" << std::endl;
+		return;
+	}
+
+	resultFile << result.m_idxRequest << " "
+		<< result.m_date << " "
+		<< result.m_type << " "
+		<< result.m_idxVolume << " "
+		<< result.m_busWaitingTime << " "
+		<< result.m_transferTime << " "
+		<< result.m_deviceWaitingTime << " "
+		<< result.m_serviceTime << " "
+		<< result.m_responseTime << " 0 "
+		<< result.m_bufferWaitingTime << std::endl;
+
+	m_sumResponseTime += result.m_responseTime;
+	m_totalExecutionTime = std::max (m_totalExecutionTime,
+		result.m_date + result.m_responseTime);
+}
+
+OGSS_Ushort
+Coordinator::searchWorker (
+	const OGSS_Ulong		address) {
+	auto					it = m_redirectionTable.upper_bound (address);
+
+	if (it == m_redirectionTable.end () )
+		return OGSS_USHORT_MAX;
+
+	return it->second;
+}
+
+void
+Coordinator::sendToWorker (
+	const OGSS_Ushort		idxWorker,
+	const void				* data,
+	const size_t			size) {
+	zmq::message_t			msg (size);
+
+	memcpy (msg.data (), data, size);
+	m_requestSockets [idxWorker] ->send (msg);
+}
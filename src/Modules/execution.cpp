@@ -35,9 +35,16 @@
 
 #include "ComputationModels/cmbusadvanced.hpp"
 #include "ComputationModels/cmbusdefault.hpp"
+#include "ComputationModels/cmbusfluid.hpp"
 #include "ComputationModels/cmdiskhdd.hpp"
+#include "ComputationModels/cmdisknvme.hpp"
+#include "ComputationModels/cmdisksmr.hpp"
 #include "ComputationModels/cmdiskssd.hpp"
+#include "ComputationModels/devicecache.hpp"
 #include "Modules/execution.hpp"
+#include "Structures/ftl.hpp"
+#include "Structures/nvmecontroller.hpp"
+#include "Structures/shingledzones.hpp"
 #include "XMLParsers/xmlparser.hpp"
 
 #include <cerrno>
@@ -48,8 +55,6 @@ using namespace std;
 /**************************************/
 /* CONSTANTS **************************/
 /**************************************/
-static const OGSS_Real		PCTG_BUFFER = .1;
-
 #define 					_DEV(i)			m_architecture->m_devices[i]
 #define 					_PVL(i)			_DEV(i).m_idxVolume
 #define 					_VOL(i)			m_architecture->m_volumes[i]
@@ -60,6 +65,7 @@ static const OGSS_Real		PCTG_BUFFER = .1;
 Execution::Execution (
 	const OGSS_String		& configurationFile) {
 	OGSS_String 			xmlResult;
+	OGSS_Real				quantum;
 
 	m_configurationFile = configurationFile;
 	m_resultFile = new std::ofstream (
@@ -70,6 +76,24 @@ Execution::Execution (
 	int val = 25;
 	int zero = 0;
 
+	m_numBlockedVD = 0;
+	m_sharedCredits = 0;
+	m_unorderedReleases = 0;
+	m_liveStats = NULL;
+
+	XMLParser::getStreamInformation (configurationFile, m_streamInterval,
+		m_streamOutput);
+
+	m_busProfileCapacity = 0;
+	XMLParser::getBusProfileInformation (configurationFile,
+		m_busProfileCapacity, m_busProfileOutput);
+
+	XMLParser::getTraceInformation (configurationFile, m_traceOutput,
+		m_traceComponents);
+
+	XMLParser::getOrderingInformation (configurationFile,
+		m_deterministic, quantum);
+
 	m_zmqContext = new zmq::context_t (1);
 
 	xmlResult = XMLParser::getZeroMQInformation (configurationFile,
@@ -97,9 +121,21 @@ Execution::Execution (
 Execution::~Execution () {
 	std::map < OGSS_Ushort, zmq::socket_t * > ::iterator iter;
 
+	for (unsigned i = 0; i < m_deviceQueues.size (); ++i)
+		delete m_deviceQueues [i];
+
+	for (unsigned i = 0; i < m_qosSchedulers.size (); ++i)
+		delete m_qosSchedulers [i];
+
+	for (unsigned i = 0; i < m_deviceCaches.size (); ++i)
+		delete m_deviceCaches [i];
+
 	delete m_cmDisks [DVT_HDD];
 	delete m_cmDisks [DVT_SSD];
+	delete m_cmDisks [DVT_SMR];
+	delete m_cmDisks [DVT_NVME];
 	delete m_cmBus;
+	delete m_liveStats;
 
 	m_resultFile->close ();
 	m_subresultFile->close ();
@@ -133,50 +169,65 @@ Execution::executeSimulation () {
 	OGSS_Ulong				idxRequest;
 	OGSS_Ulong				numVol;
 	OGSS_Ulong				maxArray;
-
-	std::map < OGSS_Ushort, OGSS_Ulong > ::iterator
-							iter;
+	zmq::message_t			msg;
+	Horizon					* horizon;
+	Delivery				delivery;
 
 	maxArray = m_requests->getNumRequests () + m_requests->getNumSubrequests ();
 
+	if (m_liveStats != NULL)
+		m_liveStats->start ();
+
+	if (! m_traceOutput.empty () )
+		EventTrace::start (m_traceOutput,
+			EventTrace::parseComponents (m_traceComponents) );
+
 	while (numDrivers != 0) {
-		idxRequest = receiveRequest ();
+		if (! receiveRequest (msg) ) {
+			// Nothing arrives while volumes are blocked: the merge waits for
+			// them, they wait for the merge
+			if (m_deterministic && m_numBlockedVD != 0)
+				releaseDeliveries (true);
+			// Same for the requests held by the command queues
+			if (m_numBlockedVD != 0)
+				flushDeviceQueues ();
+			continue;
+		}
+
+		idxRequest = * (OGSS_Ulong *) msg.data ();
+
+		if (idxRequest == OGSS_HORIZON) {
+			horizon = (Horizon *) msg.data ();
+			delivery.m_date = horizon->m_date;
+			delivery.m_idxRequest = OGSS_HORIZON;
+
+			deliverRequest (horizon->m_idxVolume, horizon->m_sequence,
+				delivery);
+			releaseDeliveries (false);
+			continue;
+		}
+
 		if (idxRequest == OGSS_ULONG_MAX)
 			DLOG(INFO) << "[EX] Receive termination request";
 		numVol = idxRequest % maxArray;
 
 		if (idxRequest == numVol) {
-			if (m_requests->getType (idxRequest) == RQT_FAKER) continue;
-			
-			DLOG(INFO) << "Receives #" << idxRequest << " from dev #"
-				<< m_requests->getIdxDevice (idxRequest) << " of type "
-				<< m_requests->getType (idxRequest);
-
-			treatRequest (idxRequest);
-					
-			if (m_wakeupVD.size () != 0)
-			{
-				iter = m_wakeupVD.begin ();
-
-				while (iter != m_wakeupVD.end () )
-				{
-					iter->second --;
-
-					if (iter->second == 0)
-					{
-						DLOG(INFO) << "Wakeup " << iter->first << "!";
-						wakeupVolumeDriver (iter->first);
-						m_wakeupVD.erase (iter++);
-					}
-					else
-						++iter;
-				}
+			if (m_deterministic) {
+				delivery.m_date = m_requests->getDate (idxRequest);
+				delivery.m_idxRequest = idxRequest;
+
+				deliverRequest (
+					_PVL (m_requests->getIdxDevice (idxRequest) ),
+					m_requests->getSequence (idxRequest), delivery);
+				releaseDeliveries (false);
 			}
+			else
+				dispatchRequest (idxRequest);
 		}
 		else if (idxRequest != OGSS_ULONG_MAX)
 		{
 			DLOG(INFO) << "Stores id of Vol#" << numVol << " to wake it up later";
-			m_wakeupVD [numVol] = m_requests->getNumSubrequests () * PCTG_BUFFER;
+			blockVolumeDriver (numVol);
 		}
 		else
 		{
@@ -184,6 +235,121 @@ Execution::executeSimulation () {
 		}
 	}
 
+	if (m_deterministic) {
+		releaseDeliveries (false);
+
+		if (! m_heads.empty () )
+			LOG(WARNING) << "Some deliveries were not released by the merge "
+				<< "stage";
+		if (m_unorderedReleases != 0)
+			LOG(WARNING) << m_unorderedReleases << " deliveries were released "
+				<< "out of order because the subrequest array was full: the "
+				<< "run is not reproducible, increase the subrequest buffer size";
+	}
+
+	flushDeviceQueues ();
+
+	for (unsigned i = 0; i < m_deviceQueues.size (); ++i)
+		if (m_deviceQueues [i] != NULL
+			&& m_deviceQueues [i] ->getNumRequests () != 0)
+			LOG(INFO) << "Device #" << i << " command queue: mean depth "
+				<< m_deviceQueues [i] ->getMeanDepth () << ", max depth "
+				<< m_deviceQueues [i] ->getMaxDepth () << ", "
+				<< m_deviceQueues [i] ->getNumReordered () << "/"
+				<< m_deviceQueues [i] ->getNumRequests () << " reordered";
+
+	logQoSStatistics ();
+
+	for (unsigned i = 0; i < m_deviceCaches.size (); ++i)
+		if (m_deviceCaches [i] != NULL
+			&& m_deviceCaches [i] ->getNumReads ()
+			+ m_deviceCaches [i] ->getNumWrites () != 0)
+			LOG(INFO) << "Device #" << i << " cache: "
+				<< m_deviceCaches [i] ->getNumReadHits () << "/"
+				<< m_deviceCaches [i] ->getNumReads () << " read hits, "
+				<< m_deviceCaches [i] ->getNumAbsorbedWrites () << "/"
+				<< m_deviceCaches [i] ->getNumWrites () << " writes absorbed, "
+				<< "destage backlog max " << m_deviceCaches [i] ->getMaxBacklog ()
+				<< "B, " << m_deviceCaches [i] ->getBacklog (
+					m_architecture->m_totalExecutionTime)
+				<< "B left at the end, write stall "
+				<< m_deviceCaches [i] ->getStallTime () << "ms";
+
+	for (OGSS_Ushort i = 0; i < m_architecture->m_geometry->m_numDevices; ++i) {
+		if (! m_architecture->m_devices [i] .isFlash ()
+			|| m_architecture->m_devices [i] .m_hardware.m_ssd.m_ftl == NULL)
+			continue;
+
+		FlashTranslationLayer * ftl =
+			m_architecture->m_devices [i] .m_hardware.m_ssd.m_ftl;
+
+		if (ftl->getHostWrites () == 0 && ftl->getTrimmedPages () == 0)
+			continue;
+
+		LOG(INFO) << "Device #" << i << " FTL: write amplification "
+			<< ftl->getWriteAmplification () << ", "
+			<< ftl->getNumErases () << " erasures (max "
+			<< ftl->getMaxEraseCount () << "/"
+			<< m_architecture->m_devices [i] .m_hardware.m_ssd.m_numErase
+			<< " by block), GC stall " << ftl->getGCTime () << "ms, "
+			<< ftl->getTrimmedPages () << " pages trimmed";
+	}
+
+	for (OGSS_Ushort i = 0; i < m_architecture->m_geometry->m_numDevices; ++i) {
+		if (m_architecture->m_devices [i] .m_type != DVT_SMR)
+			continue;
+
+		ShingledZones * zones =
+			m_architecture->m_devices [i] .m_hardware.m_hdd.m_smrZones;
+
+		if (zones->getHostWrites () == 0 && zones->getNumResets () == 0
+			&& zones->getRejectedWrites () == 0)
+			continue;
+
+		LOG(INFO) << "Device #" << i << " SMR: write amplification "
+			<< zones->getWriteAmplification () << ", "
+			<< zones->getCacheWrites () << "/" << zones->getHostWrites ()
+			<< " sectors in the media cache, "
+			<< zones->getCleanedBands () << " bands cleaned (stall "
+			<< zones->getCleaningTime () << "ms), "
+			<< zones->getRelocatedWrites () << " writes appended, "
+			<< zones->getRejectedWrites () << " writes failed, "
+			<< zones->getNumResets () << " zone resets";
+	}
+
+	for (OGSS_Ushort i = 0; i < m_architecture->m_geometry->m_numDevices; ++i) {
+		if (m_architecture->m_devices [i] .m_type != DVT_NVME)
+			continue;
+
+		NVMeController * nvme =
+			m_architecture->m_devices [i] .m_hardware.m_ssd.m_nvme;
+
+		if (nvme->getNumCommands () == 0
+			|| m_architecture->m_totalExecutionTime <= .0)
+			continue;
+
+		LOG(INFO) << "Device #" << i << " NVMe: " << nvme->getNumCommands ()
+			<< " commands, " << nvme->getNumQueueFull ()
+			<< " waited for a queue slot (max " << nvme->getMaxQueueWait ()
+			<< "ms), link utilization " << 100
+			* nvme->getLinkBusyTime (false)
+			/ m_architecture->m_totalExecutionTime << "% to the device, "
+			<< 100 * nvme->getLinkBusyTime (true)
+			/ m_architecture->m_totalExecutionTime << "% to the host";
+	}
+
+	for (OGSS_Ushort i = 0; i < m_stallTime.size (); ++i)
+		if (m_stallTime [i] != 0)
+			LOG(INFO) << "Volume #" << i << " stalled during "
+				<< m_stallTime [i] << "us waiting for subrequest credits";
+
+	exportBusProfiles ();
+
+	if (m_liveStats != NULL)
+		m_liveStats->stop ();
+
+	EventTrace::stop ();
+
 	wakeupPerformanceModule ();
 }
 
@@ -209,26 +375,187 @@ Execution::initReplyZMQ () {
 	}
 }
 
-OGSS_Ulong
-Execution::receiveRequest () {
+void
+Execution::blockVolumeDriver (
+	const OGSS_Ushort		idxVolume) {
+	if (m_blockedVD [idxVolume]) return;
+
+	m_blockedVD [idxVolume] = true;
+	m_numBlockedVD ++;
+
+	// Only the credits returned after the array was found full count
+	m_credits [idxVolume] = 0;
+
+	if (m_inFlight [idxVolume] == 0) {
+		if (m_starvedVD.empty () )
+			m_sharedCredits = 0;
+		m_starvedVD.push_back (idxVolume);
+	}
+
+	m_stallChrono [idxVolume] .restart ();
+	m_stallChrono [idxVolume] .tick ();
+}
+
+void
+Execution::unblockVolumeDriver (
+	const OGSS_Ushort		idxVolume) {
+	m_blockedVD [idxVolume] = false;
+	m_numBlockedVD --;
+
+	m_stallChrono [idxVolume] .tick ();
+	m_stallTime [idxVolume] += m_stallChrono [idxVolume] .get ();
+
+	DLOG(INFO) << "Wakeup " << idxVolume << "!";
+	wakeupVolumeDriver (idxVolume);
+}
+
+void
+Execution::returnCredits () {
+	for (unsigned i = 0; i < m_releasedSlots.size (); ++i)
+		returnCredit (m_releasedSlots [i]);
+
+	m_releasedSlots.clear ();
+}
+
+void
+Execution::returnCredit (
+	const OGSS_Ulong		idxRequest) {
+	OGSS_Ulong				slot = idxRequest - m_requests->getNumRequests ();
+	OGSS_Ushort				idxVolume = m_slotVolume [slot];
+
+	if (idxVolume != OGSS_USHORT_MAX) {
+		m_slotVolume [slot] = OGSS_USHORT_MAX;
+		m_inFlight [idxVolume] --;
+
+		// Wake up the volume when its grant is covered, or when it has
+		// nothing left to get back
+		if (m_blockedVD [idxVolume]
+			&& (++ m_credits [idxVolume] >= getCreditGrant (idxVolume)
+			|| m_inFlight [idxVolume] == 0) )
+			unblockVolumeDriver (idxVolume);
+	}
+
+	if (m_starvedVD.empty () ) return;
+
+	m_sharedCredits ++;
+
+	while (! m_starvedVD.empty () ) {
+		idxVolume = m_starvedVD.front ();
+
+		// The volume was woken up by its own credits
+		if (! m_blockedVD [idxVolume]) {
+			m_starvedVD.pop_front ();
+			continue;
+		}
+
+		if (m_sharedCredits < getCreditGrant (idxVolume) ) break;
+
+		m_starvedVD.pop_front ();
+		m_sharedCredits -= getCreditGrant (idxVolume);
+		unblockVolumeDriver (idxVolume);
+	}
+}
+
+OGSS_Bool
+Execution::receiveRequest (
+	zmq::message_t			& msg) {
+	return m_zmqDeviceDriver->recv (& msg);
+}
+
+void
+Execution::dispatchRequest (
+	const OGSS_Ulong		idxRequest) {
+	if (m_requests->getType (idxRequest) == RQT_FAKER) return;
+
+	DLOG(INFO) << "Receives #" << idxRequest << " from dev #"
+		<< m_requests->getIdxDevice (idxRequest) << " of type "
+		<< m_requests->getType (idxRequest);
+
+	takeCredit (idxRequest);
+	treatRequest (idxRequest);
+	returnCredits ();
+}
+
+void
+Execution::initMerge () {
+	OGSS_Ushort				numVolumes = m_architecture->m_geometry->m_numVolumes;
+
+	if (! m_deterministic) return;
+
+	m_pending.resize (numVolumes);
+	m_nextSequence.assign (numVolumes, 0);
+	m_ready.resize (numVolumes);
+	m_horizon.assign (numVolumes, .0);
+
+	// Only the volume drivers send requests, not the subvolumes
+	for (OGSS_Ushort i = 0; i < numVolumes; ++i) {
+		updateMergeState (i, true);
+
+		if (_VOL (i) .m_type == VHT_DECRAID)
+			i += _VOL (i) .m_hardware.m_draid.m_numVolumes;
+	}
+}
+
+void
+Execution::deliverRequest (
+	const OGSS_Ushort		idxVolume,
+	const OGSS_Ulong		sequence,
+	const Delivery			& delivery) {
+	std::map < OGSS_Ulong, Delivery > ::iterator
+							iter;
+
+	updateMergeState (idxVolume, false);
+
+	m_pending [idxVolume] [sequence] = delivery;
+
+	// Deliveries of a volume can take different device drivers, so they are
+	// put back in sequence before the merge
+	for (iter = m_pending [idxVolume] .begin ();
+		iter != m_pending [idxVolume] .end ()
+		&& iter->first == m_nextSequence [idxVolume]; ) {
+		m_nextSequence [idxVolume] ++;
+		m_horizon [idxVolume] = max (m_horizon [idxVolume],
+			iter->second.m_date);
+
+		if (iter->second.m_idxRequest != OGSS_HORIZON)
+			m_ready [idxVolume] .push_back (iter->second);
+
+		m_pending [idxVolume] .erase (iter++);
+	}
+
+	updateMergeState (idxVolume, true);
+}
+
+void
+Execution::releaseDeliveries (
+	const OGSS_Bool			force) {
+	std::pair < OGSS_Real, OGSS_Ushort >	head;
 	OGSS_Ulong				idxRequest;
-	zmq::message_t			msg;
 
-	while (! m_zmqDeviceDriver->recv (& msg) );
+	while (! m_heads.empty () ) {
+		head = * m_heads.begin ();
+
+		if (! m_idleBounds.empty () && ! (head < * m_idleBounds.begin () ) ) {
+			if (! force || m_numBlockedVD == 0) break;
 
-	idxRequest = * (OGSS_Ulong *) msg.data ();
+			m_unorderedReleases ++;
+		}
 
-	return idxRequest;
+		updateMergeState (head.second, false);
+		idxRequest = m_ready [head.second] .front () .m_idxRequest;
+		m_ready [head.second] .pop_front ();
+		updateMergeState (head.second, true);
+
+		dispatchRequest (idxRequest);
+	}
 }
 
 void
 Execution::treatRequest (
 	const OGSS_Ulong		idxRequest) {
 	OGSS_Ulong				parent;
-	OGSS_Ushort				reqType;
 	OGSS_Ushort				idxDevice;
 
-	reqType = m_requests->getType (idxRequest);
 	idxDevice = m_requests->getIdxDevice (idxRequest);
 	parent = m_requests->getIdxParent (idxRequest);
 
@@ -236,35 +563,131 @@ Execution::treatRequest (
 		if (parent < m_requests->getNumRequests ())
 			m_requests->isFaulty (parent);
 	}
-	
-	if (reqType != RQT_ERASE) {
-		processEffectiveRequest (idxRequest, idxDevice);
-	}
+
+	processEffectiveRequest (idxRequest, idxDevice);
 }
 
 void
 Execution::processEffectiveRequest (
 	const OGSS_Ulong		idxRequest,
 	const OGSS_Ushort		idxDevice) {
-	OGSS_Real s;
+	vector < OGSS_Ulong >	released;
 
-	if (m_requests->getType (idxRequest) == RQT_GHSTW
+	if (m_requests->getIsCacheHit (idxRequest) ) {
+		// Served by the volume cache, the device is not involved
+		m_cmBus->compute (idxRequest);
+	} else if (m_requests->getType (idxRequest) == RQT_GHSTW
 		|| m_requests->getType (idxRequest) == RQT_GHSTR) {
 		m_requests->setServiceTime (idxRequest, .0);
+		m_cmBus->compute (idxRequest);
+	} else if (m_requests->getType (idxRequest) == RQT_ERASE
+		&& m_architecture->m_devices [idxDevice] .m_type == DVT_HDD) {
+		// The HDDs ignore a TRIM, the SMRs reset their zones
+		m_requests->setServiceTime (idxRequest, .0);
+		releaseEffectiveRequest (idxRequest, .0);
+	} else if (m_qosSchedulers [idxDevice] != NULL) {
+		m_qosSchedulers [idxDevice] ->push (idxRequest, released);
+
+		for (unsigned i = 0; i < released.size (); ++i)
+			releaseEffectiveRequest (released [i],
+				m_requests->getServiceTime (released [i]) );
+	} else if (m_deviceQueues [idxDevice] != NULL) {
+		m_deviceQueues [idxDevice] ->push (idxRequest, released);
+
+		for (unsigned i = 0; i < released.size (); ++i)
+			releaseEffectiveRequest (released [i],
+				m_requests->getServiceTime (released [i]) );
 	} else {
-		s = m_cmDisks [m_architecture->m_devices [idxDevice] .m_type]
-			->compute (idxRequest);
+		releaseEffectiveRequest (idxRequest,
+			getDeviceModel (idxDevice) ->compute (idxRequest) );
+	}
+}
 
-		DLOG(INFO) << "Device #" << m_requests->getIdxDevice (idxRequest)
-			<< " computation in " << s << "ms";
+void
+Execution::releaseEffectiveRequest (
+	const OGSS_Ulong		idxRequest,
+	const OGSS_Real			serviceTime) {
+	OGSS_Ushort				idxDevice;
 
-		m_architecture->m_devices [m_requests->getIdxDevice (idxRequest)]
-			.m_workingTime += s;
-	}
+	idxDevice = m_requests->getIdxDevice (idxRequest);
+
+	DLOG(INFO) << "Device #" << idxDevice
+		<< " computation in " << serviceTime << "ms";
+
+	m_architecture->m_devices [idxDevice] .m_workingTime += serviceTime;
+
+	if (m_liveStats != NULL)
+		m_liveStats->addDeviceTime (idxDevice, serviceTime);
 
 	m_cmBus->compute (idxRequest);
 }
 
+void
+Execution::flushDeviceQueues () {
+	vector < OGSS_Ulong >	released;
+
+	for (unsigned i = 0; i < m_deviceQueues.size (); ++i) {
+		if (m_deviceQueues [i] == NULL || m_deviceQueues [i] ->isEmpty () )
+			continue;
+
+		released.clear ();
+		m_deviceQueues [i] ->flush (released);
+
+		for (unsigned j = 0; j < released.size (); ++j)
+			releaseEffectiveRequest (released [j],
+				m_requests->getServiceTime (released [j]) );
+	}
+
+	for (unsigned i = 0; i < m_qosSchedulers.size (); ++i) {
+		if (m_qosSchedulers [i] == NULL || m_qosSchedulers [i] ->isEmpty () )
+			continue;
+
+		released.clear ();
+		m_qosSchedulers [i] ->flush (released);
+
+		for (unsigned j = 0; j < released.size (); ++j)
+			releaseEffectiveRequest (released [j],
+				m_requests->getServiceTime (released [j]) );
+	}
+
+	returnCredits ();
+}
+
+void
+Execution::logQoSStatistics () {
+	OGSS_Ulong				numRequests;
+	OGSS_Ulong				numThrottled;
+	OGSS_Real				throttleTime = .0;
+
+	if (m_architecture->m_qosClasses.size () < 2) return;
+
+	for (OGSS_Ushort c = 0; c < m_architecture->m_qosClasses.size (); ++c) {
+		numRequests = 0;
+		numThrottled = 0;
+
+		for (unsigned i = 0; i < m_qosSchedulers.size (); ++i) {
+			numRequests += m_qosSchedulers [i] ->getNumRequests (c);
+			numThrottled += m_qosSchedulers [i] ->getNumThrottled (c);
+		}
+
+		if (numRequests == 0) continue;
+
+		if (c == 0)
+			LOG(INFO) << "QoS default class: " << numRequests << " requests";
+		else
+			LOG(INFO) << "QoS class of color "
+				<< m_architecture->m_qosClasses [c] .m_color << ": "
+				<< numRequests << " requests, " << numThrottled
+				<< " delayed by the rate limit";
+	}
+
+	for (unsigned i = 0; i < m_qosSchedulers.size (); ++i)
+		throttleTime += m_qosSchedulers [i] ->getThrottleTime ();
+
+	LOG(INFO) << "QoS: the devices stayed idle during " << throttleTime
+		<< "ms because of the rate limits";
+}
+
 void
 Execution::initComputationModels () {
 	ComputationModelType	modelType;
@@ -273,13 +696,135 @@ Execution::initComputationModels () {
 		m_architecture, m_resultFile, m_subresultFile);
 	m_cmDisks [DVT_SSD] = new CMDiskSSD (m_requests,
 		m_architecture, m_resultFile, m_subresultFile);
+	m_cmDisks [DVT_SMR] = new CMDiskSMR (m_requests,
+		m_architecture, m_resultFile, m_subresultFile);
+	m_cmDisks [DVT_NVME] = new CMDiskNVMe (m_requests,
+		m_architecture, m_resultFile, m_subresultFile);
+
+	// The device caches wrap the device models
+	m_deviceCaches.assign (m_architecture->m_geometry->m_numDevices, NULL);
+	for (OGSS_Ushort i = 0; i < m_architecture->m_geometry->m_numDevices; ++i)
+		if (_DEV (i) .m_cacheSegmentSize != 0)
+			m_deviceCaches [i] = new DeviceCache (m_requests, m_architecture,
+				m_cmDisks [_DEV (i) .m_type], i);
+
+	// A QoS scheduler is only needed with QoS classes
+	m_qosSchedulers.assign (m_architecture->m_geometry->m_numDevices, NULL);
+	if (m_architecture->m_qosClasses.size () > 1) {
+		if (m_requests->getFormat () != 1)
+			LOG(WARNING) << "The QoS classes need a trace with colors, all "
+				<< "the requests are in the default class";
+
+		for (OGSS_Ushort i = 0; i < m_architecture->m_geometry->m_numDevices;
+			++i)
+			m_qosSchedulers [i] = new QoSScheduler (m_requests,
+				m_architecture, getDeviceModel (i), i);
+	}
+
+	// A command queue is only needed with NCQ
+	m_deviceQueues.assign (m_architecture->m_geometry->m_numDevices, NULL);
+	for (OGSS_Ushort i = 0; i < m_architecture->m_geometry->m_numDevices; ++i) {
+		OGSS_Bool			ncq;
+
+		if (! _DEV (i) .isFlash () )
+			ncq = _DEV (i) .m_hardware.m_hdd.m_ataNCQ
+				&& _DEV (i) .m_hardware.m_hdd.m_ataNCQDepth > 1;
+		else
+			ncq = _DEV (i) .m_hardware.m_ssd.m_ataNCQ
+				&& _DEV (i) .m_hardware.m_ssd.m_ataNCQDepth > 1;
+
+		if (ncq && m_qosSchedulers [i] != NULL)
+			LOG(WARNING) << "Device #" << i << ": the QoS scheduler chooses "
+				<< "the requests, the NCQ reordering is ignored";
+		else if (ncq)
+			m_deviceQueues [i] = new DeviceQueue (m_requests, m_architecture,
+				getDeviceModel (i), i);
+	}
+
+	if (m_busProfileCapacity != 0)
+		for (OGSS_Ushort i = 0; i < m_architecture->m_geometry->m_numBuses; ++i)
+			m_architecture->m_buses [i] .m_profileCapacity
+				= m_busProfileCapacity;
 
 	XMLParser::getComputationModelInformation (m_configurationFile,
 		OGSS_NAME_MBUS, modelType);
-	if (modelType == CMT_BUS_ADVANCED)
-		m_cmBus = new CMBusAdvanced (m_requests, m_architecture,
+	if (modelType == CMT_BUS_ADVANCED) {
+		CMBusAdvanced		* cmBus;
+
+		cmBus = new CMBusAdvanced (m_requests, m_architecture,
+			m_resultFile, m_subresultFile);
+		cmBus->setArrivalOrdering (m_deterministic);
+		m_cmBus = cmBus;
+	}
+	else if (modelType == CMT_BUS_FLUID)
+		m_cmBus = new CMBusFluid (m_requests, m_architecture,
 			m_resultFile, m_subresultFile);
 	else
 		m_cmBus = new CMBusDefault (m_requests, m_architecture,
 			m_resultFile, m_subresultFile);
+
+	// The bus model places the requests on the devices once they reached them
+	m_deviceModels.resize (m_architecture->m_geometry->m_numDevices);
+	for (OGSS_Ushort i = 0; i < m_architecture->m_geometry->m_numDevices; ++i)
+		m_deviceModels [i] = getDeviceModel (i);
+	m_cmBus->setDeviceModels (& m_deviceModels);
+
+	if (m_architecture->m_fabric != NULL && modelType != CMT_BUS_FLUID)
+		LOG(WARNING) << "The fabric is only modeled by the fluid bus model, "
+			<< "it is ignored";
+}
+
+void
+Execution::exportBusProfiles () {
+	std::ofstream			file;
+	OGSS_Real				time [BSS_TOTAL];
+
+	if (! m_busProfileOutput.empty () ) {
+		file.open (m_busProfileOutput.c_str () );
+
+		if (! file.is_open () )
+			LOG(WARNING) << "There is a problem opening the bus profile file "
+				<< m_busProfileOutput;
+	}
+
+	for (OGSS_Ushort i = 0; i < m_architecture->m_geometry->m_numBuses; ++i) {
+		std::vector < std::pair < OGSS_Real, int > > & profile =
+			m_architecture->m_buses [i] .m_profile;
+
+		m_architecture->m_buses [i] .closeProfile ();
+
+		if (profile.empty () )
+			continue;
+
+		for (int j = 0; j < BSS_TOTAL; ++j)
+			time [j] = .0;
+
+		for (unsigned j = 0; j < profile.size (); ++j) {
+			if (j + 1 < profile.size () )
+				time [profile [j] .second] +=
+					profile [j + 1] .first - profile [j] .first;
+
+			if (file.is_open () )
+				file << i << " " << profile [j] .first << " "
+					<< profile [j] .second << std::endl;
+		}
+
+		if (profile.back () .first > .0)
+			LOG(INFO) << "Bus #" << i << " profile: "
+				<< 100 * time [BSS_USE] / profile.back () .first << "% used, "
+				<< 100 * time [BSS_WAIT] / profile.back () .first
+				<< "% waited, " << 100 * time [BSS_CONGESTED]
+				/ profile.back () .first << "% congested";
+	}
+}
+
+void
+Execution::initLiveStats () {
+	if (m_streamInterval <= .0)
+		return;
+
+	m_liveStats = new LiveStats (m_architecture->m_geometry->m_numDevices,
+		m_streamInterval, m_streamOutput);
+
+	m_cmBus->setLiveStats (m_liveStats);
 }
@@ -30,6 +30,11 @@
 
 #include "Modules/performanceevaluation.hpp"
 
+#include <cmath>
+#include <limits>
+#include <map>
+#include <sstream>
+
 #include <glog/logging.h>
 
 #include "GraphGeneration/graphgenbusbehavior.hpp"
@@ -37,6 +42,9 @@
 #include "GraphGeneration/graphgenreqpercentile.hpp"
 #include "GraphGeneration/graphgenfullreqpercentile.hpp"
 
+#include "Utils/chrono.hpp"
+#include "Utils/stagetimer.hpp"
+
 using namespace std;
 
 /**************************************/
@@ -82,11 +90,19 @@ PerformanceEvaluation::~PerformanceEvaluation () {
 
 void
 PerformanceEvaluation::process () {
+	Chrono					chrono;
+
 	createGraphGenerationProcesses ();
 	waitForWakeUp ();
 	LOG(INFO) << "Total execution time: "
 		<< m_architecture->m_totalExecutionTime << "ms";
+	logHostStatistics ();
+	logColorStatistics ();
+
+	chrono.tick ();
 	processGeneration ();
+	chrono.tick ();
+	StageTimer::add (STG_OUTPUT, chrono.get () );
 }
 
 /**************************************/
@@ -129,3 +145,124 @@ PerformanceEvaluation::processGeneration () {
 	for (auto g = m_graphs.begin (); g != m_graphs.end (); ++g)
 		(*g)->makeGraph ();
 }
+
+void
+PerformanceEvaluation::logHostStatistics () {
+	OGSS_Ushort				numHosts = m_architecture->m_geometry->m_numHosts;
+	OGSS_Ushort				host;
+	OGSS_Real				completion;
+	unsigned				hid;
+	unsigned				pid;
+
+	if (numHosts < 2 || m_requests->getFormat () != 2) return;
+
+	vector <OGSS_Ulong>		numRequests (numHosts, 0);
+	vector <OGSS_Ulong>		volume (numHosts, 0);
+	vector <OGSS_Real>		first (numHosts, numeric_limits <OGSS_Real> ::max () );
+	vector <OGSS_Real>		last (numHosts, .0);
+	vector <OGSS_Real>		sumLatency (numHosts, .0);
+	vector <OGSS_Real>		maxLatency (numHosts, .0);
+
+	for (OGSS_Ulong i = 0; i < m_requests->getNumRequests (); ++i) {
+		if (m_requests->getIsFaulty (i) ) continue;
+
+		m_requests->getOptions (i, hid, pid);
+		host = m_architecture->getIdxHost (hid);
+		completion = m_requests->getDate (i) + m_requests->getResponseTime (i);
+
+		++numRequests [host];
+		volume [host] += m_requests->getSize (i);
+		first [host] = min (first [host], m_requests->getDate (i) );
+		last [host] = max (last [host], completion);
+		sumLatency [host] += m_requests->getResponseTime (i);
+		maxLatency [host] = max (maxLatency [host],
+			m_requests->getResponseTime (i) );
+	}
+
+	for (auto i = 0; i < numHosts; ++i) {
+		if (numRequests [i] == 0) continue;
+
+		LOG(INFO) << "Host " << m_architecture->m_hosts [i] .m_id << ": "
+			<< numRequests [i] << " requests, "
+			<< (last [i] > first [i] ? volume [i]
+				/ ( (last [i] - first [i]) * MEGABYTE * MILLISEC) : .0)
+			<< "MB/s, mean latency "
+			<< sumLatency [i] / numRequests [i] << "ms, max latency "
+			<< maxLatency [i] << "ms";
+	}
+}
+
+void
+PerformanceEvaluation::logColorStatistics () {
+	std::map < unsigned, ColorStatistics >	colors;
+	OGSS_Ulong				us;
+	OGSS_Ulong				count;
+	unsigned				bucket;
+	unsigned				color;
+	unsigned				pid;
+	OGSS_Real				p50;
+	OGSS_Real				p99;
+
+	if (m_requests->getFormat () != 1) return;
+
+	for (OGSS_Ulong i = 0; i < m_requests->getNumRequests (); ++i) {
+		if (m_requests->getIsFaulty (i) ) continue;
+
+		m_requests->getOptions (i, color, pid);
+
+		auto iter = colors.find (color);
+		if (iter == colors.end () ) {
+			ColorStatistics	stats = ColorStatistics ();
+
+			stats.m_first = numeric_limits <OGSS_Real> ::max ();
+			iter = colors.insert (make_pair (color, stats) ) .first;
+		}
+
+		ColorStatistics		& stats = iter->second;
+
+		stats.m_numRequests ++;
+		stats.m_volume += m_requests->getSize (i);
+		stats.m_first = min (stats.m_first, m_requests->getDate (i) );
+		stats.m_last = max (stats.m_last, m_requests->getDate (i)
+			+ m_requests->getResponseTime (i) );
+		stats.m_sumLatency += m_requests->getResponseTime (i);
+
+		// Same buckets as the live statistics
+		us = (OGSS_Ulong) (m_requests->getResponseTime (i) * 1000);
+		for (bucket = 0; us != 0 && bucket < LiveStats::NUM_BUCKETS - 1;
+			++bucket)
+			us >>= 1;
+		stats.m_histogram [bucket] ++;
+	}
+
+	for (auto iter = colors.begin (); iter != colors.end (); ++iter) {
+		const ColorStatistics	& stats = iter->second;
+		ostringstream		histogram ("");
+
+		count = 0;
+		p50 = p99 = .0;
+
+		for (bucket = 0; bucket < LiveStats::NUM_BUCKETS; ++bucket) {
+			if (stats.m_histogram [bucket] == 0) continue;
+
+			count += stats.m_histogram [bucket];
+			if (p50 == .0 && count >= .5 * stats.m_numRequests)
+				p50 = ldexp (1., bucket) / 1000;
+			if (p99 == .0 && count >= .99 * stats.m_numRequests)
+				p99 = ldexp (1., bucket) / 1000;
+
+			histogram << " <" << ldexp (1., bucket) << "us:"
+				<< stats.m_histogram [bucket];
+		}
+
+		LOG(INFO) << "Color " << iter->first << ": " << stats.m_numRequests
+			<< " requests, "
+			<< (stats.m_last > stats.m_first ? stats.m_volume
+				/ ( (stats.m_last - stats.m_first) * MEGABYTE * MILLISEC) : .0)
+			<< "MB/s, mean latency "
+			<< stats.m_sumLatency / stats.m_numRequests << "ms, p50 "
+			<< p50 << "ms, p99 " << p99 << "ms";
+		LOG(INFO) << "Color " << iter->first << " latency histogram:"
+			<< histogram.str ();
+	}
+}
@@ -52,6 +52,7 @@ using namespace std;
 /**************************************/
 /* CONSTANTS **************************/
 /**************************************/
+static const OGSS_Real		DEFAULT_HORIZON_QUANTUM = 1.;
 
 /**************************************/
 /* STATIC FUNCTIONS *******************/
@@ -129,6 +130,11 @@ PreProcessing::PreProcessing (
 	m_zmqEventReader = new zmq::socket_t (*m_zmqContext, ZMQ_PULL);
 	m_zmqEventReader->bind (result.c_str () );
 
+	XMLParser::getOrderingInformation (configurationFile,
+		m_deterministic, m_quantum);
+	if (m_quantum <= .0)
+		m_quantum = DEFAULT_HORIZON_QUANTUM;
+
 	m_requests = NULL;
 }
 
@@ -170,6 +176,8 @@ PreProcessing::~PreProcessing () {
 
 void
 PreProcessing::launchSimulation () {
+	OGSS_Real				lastHorizon = .0;
+
 //	First redirect the events, to prevent the devices
 	for (auto ev: *m_events) {
 		OGSS_Ulong			idxRequest;
@@ -187,9 +195,16 @@ PreProcessing::launchSimulation () {
 	DLOG(INFO) << "Launching simulation for "
 		<< m_requests->getNumRequests () << " Requests";
 
-	// Redirect each request
-	for (OGSS_Ulong i = 0; i < m_requests->getNumRequests (); ++i)
+	// Redirect each request, the trace being sorted by date
+	for (OGSS_Ulong i = 0; i < m_requests->getNumRequests (); ++i) {
+		if (m_deterministic
+			&& m_requests->getDate (i) >= lastHorizon + m_quantum) {
+			lastHorizon = m_requests->getDate (i);
+			sendHorizon (lastHorizon);
+		}
+
 		redirectRequest (i);
+	}
 
 	DLOG(INFO) << "All requests were distributed";
 
@@ -208,11 +223,9 @@ PreProcessing::launchSimulation () {
 
 void
 PreProcessing::updateVolumeMapping () {
-	OGSS_Ushort				idx;
 	OGSS_Ushort				counter = 0;
-	OGSS_Ushort				dec_idx, dec_nvl;
+	OGSS_Ushort				dec_idx;
 
-	OGSS_Ulong				base;
 	OGSS_Ulong				numBytes = 0;
 
 	// Get information about VolumeDriver ZMQ
@@ -232,50 +245,14 @@ PreProcessing::updateVolumeMapping () {
 
 	// For each volume
 	for (OGSS_Ushort i = 0; i < m_architecture->m_geometry->m_numVolumes; ++i) {
-		idx	= m_architecture->m_volumes[i].m_idxDevices;
 		++counter;
 
-		// Count the total number of pages for the volume
-		if (m_architecture->m_devices[idx].m_type == DVT_HDD)
-			base = m_architecture->m_devices[idx].m_hardware.m_hdd.m_numSectors
-				* m_architecture->m_devices[idx] .m_hardware.m_hdd.m_sectorSize;
-		else
-			base = m_architecture->m_devices[idx].m_hardware.m_ssd.m_numPages
-				* m_architecture->m_devices [idx] .m_hardware.m_ssd.m_pageSize;
+		numBytes += m_architecture->getVolumeCapacity (i);
 
 		dec_idx = i;
 
 		if (m_architecture->m_volumes[i].m_type == VHT_DECRAID)
-		{
-			dec_nvl = m_architecture->m_volumes[i].m_hardware.m_draid.m_numVolumes;
-
-			for (++i; i <= dec_idx + dec_nvl; ++i)
-			{
-				if (m_architecture->m_volumes[i].m_hardware.m_volume.m_type == VST_RAID1)
-					numBytes += base;
-				else if (m_architecture->m_volumes[i].m_hardware.m_volume.m_type == VST_RAID01)
-					numBytes += base * m_architecture->m_volumes[i].m_numDevices / 2;
-				else if (m_architecture->m_volumes[i].m_hardware.m_volume.m_type == VST_RAIDNP)
-					numBytes += base * (m_architecture->m_volumes[i].m_numDevices
-						- m_architecture->m_volumes[i].m_hardware.m_volume.m_numParityDevices);
-				else
-					numBytes += base * m_architecture->m_volumes[i].m_numDevices;
-			}
-
-			--i;
-		}
-		else if (m_architecture->m_volumes[i].m_type == VHT_DEFAULT)
-		{
-		if (m_architecture->m_volumes[i].m_hardware.m_volume.m_type == VST_RAID1)
-			numBytes += base;
-		else if (m_architecture->m_volumes[i].m_hardware.m_volume.m_type == VST_RAID01)
-			numBytes += base * m_architecture->m_volumes[i].m_numDevices / 2;
-		else if (m_architecture->m_volumes[i].m_hardware.m_volume.m_type == VST_RAIDNP)
-			numBytes += base * (m_architecture->m_volumes[i].m_numDevices
-				- m_architecture->m_volumes[i].m_hardware.m_volume.m_numParityDevices);
-		else
-			numBytes += base * m_architecture->m_volumes[i].m_numDevices;
-		}
+			i += m_architecture->m_volumes[i].m_hardware.m_draid.m_numVolumes;
 
 		// Edit ZMQ information
 		zmqInfo [zmqInfo.length () - 2]
@@ -32,12 +32,16 @@
  */
 
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <glog/logging.h>
 #include <sstream>
+#include <vector>
 
 #include "Modules/workload.hpp"
 
+#include "Structures/distributed.hpp"
+
 #include "XMLParsers/xmlparser.hpp"
 
 /**************************************/
@@ -46,12 +50,14 @@
 static const unsigned 		BUFFER_SIZE		= 128;
 static const OGSS_Ushort 	MIN_OPTIONS		= 0;
 static const OGSS_Ushort	MAX_OPTIONS		= 2;
+static const OGSS_Ulong		RESULT_BATCH	= 1024;
 
 /**************************************/
 /* PUBLIC FUNCTIONS *******************/
 /**************************************/
 Workload::Workload (
-	const OGSS_String		& configurationFile) {
+	const OGSS_String		& configurationFile,
+	const OGSS_Bool			remote) {
 	m_zmqToPreprocess = XMLParser::getZeroMQInformation (configurationFile,
 		OGSS_NAME_WORK,	OGSS_NAME_PPRC);
 
@@ -59,7 +65,11 @@ Workload::Workload (
 
 	m_configurationFile = configurationFile;
 
-	extractRequests (XMLParser::getFilePath (configurationFile, FTP_WORKLOAD) );
+	if (remote)
+		receiveRequests ();
+	else
+		extractRequests (XMLParser::getFilePath (configurationFile,
+			FTP_WORKLOAD) );
 };
 
 Workload::~Workload () {
@@ -98,9 +108,140 @@ Workload::extractRequests (
 	}
 }
 
+void
+Workload::returnResults (
+	const OGSS_String		& configurationFile) {
+	std::vector <WorkerDescription>	workers;
+	std::vector <ResultDescriptor>	batch;
+	ResultDescriptor		result;
+	std::ifstream			filestream;
+	std::istringstream		bufferstream;
+	char					buffer [BUFFER_SIZE];
+	int						zero = 0;
+
+	XMLParser::getDistributedInformation (configurationFile, workers);
+
+	if (workers.empty () )
+	{
+		DLOG(ERROR) << "No worker description in " << configurationFile;
+		return;
+	}
+
+	zmq::context_t			context (1);
+	zmq::socket_t			socket (context, ZMQ_PUSH);
+	socket.setsockopt (ZMQ_SNDHWM, &zero, sizeof (int) );
+	socket.connect (workers [0] .m_results.c_str () );
+
+	filestream.open (XMLParser::getFilePath (configurationFile, FTP_RESULT)
+		.c_str () );
+
+	if (! filestream.is_open () )
+	{ DLOG(ERROR) << "There is a problem opening the result file"; }
+
+	batch.reserve (RESULT_BATCH);
+
+	filestream.getline (buffer, BUFFER_SIZE);
+	while (filestream.good () )
+	{
+		bufferstream.clear ();
+		bufferstream.str (buffer);
+
+		bufferstream >> result.m_idxRequest >> result.m_date >> result.m_type
+			>> result.m_idxVolume >> result.m_busWaitingTime
+			>> result.m_transferTime >> result.m_deviceWaitingTime
+			>> result.m_serviceTime >> result.m_responseTime
+			>> result.m_isFaulty >> result.m_bufferWaitingTime;
+
+		if (! bufferstream.fail () )
+			batch.push_back (result);
+
+		if (batch.size () == RESULT_BATCH)
+		{
+			zmq::message_t	msg (batch.size () * sizeof (ResultDescriptor) );
+			memcpy (msg.data (), batch.data (), msg.size () );
+			socket.send (msg);
+			batch.clear ();
+		}
+
+		filestream.getline (buffer, BUFFER_SIZE);
+	}
+
+	if (! batch.empty () )
+	{
+		zmq::message_t		msg (batch.size () * sizeof (ResultDescriptor) );
+		memcpy (msg.data (), batch.data (), msg.size () );
+		socket.send (msg);
+	}
+
+	// An empty message ends the result stream
+	zmq::message_t			msgEnd (0);
+	socket.send (msgEnd);
+
+	filestream.close ();
+	socket.close ();
+}
+
 /**************************************/
 /* PRIVATE FUNCTIONS ******************/
 /**************************************/
+void
+Workload::receiveRequests () {
+	std::vector <WorkerDescription>	workers;
+	DistributedHeader		header;
+	RequestDescriptor		* descriptors;
+	OGSS_Ulong				index = 0;
+	OGSS_Ulong				numDescriptors;
+
+	XMLParser::getDistributedInformation (m_configurationFile, workers);
+
+	if (workers.empty () )
+	{
+		DLOG(ERROR) << "No worker description in " << m_configurationFile;
+		m_requests = new RequestArray_Type0 (0, m_numSubrequests, 0);
+		return;
+	}
+
+	zmq::context_t			context (1);
+	zmq::socket_t			socket (context, ZMQ_PULL);
+	socket.connect (workers [0] .m_requests.c_str () );
+
+	zmq::message_t			msgHeader;
+	socket.recv (&msgHeader);
+	memcpy ((void *) &header, msgHeader.data (), sizeof (DistributedHeader) );
+
+	DLOG(INFO) << "Get " << header.m_numRequests
+		<< " requests from the coordinator";
+
+	if (header.m_requestFormat == 1)
+		m_requests = new RequestArray_Type1 (header.m_numRequests,
+			m_numSubrequests, header.m_requestFormat);
+	else if (header.m_requestFormat == 2)
+		m_requests = new RequestArray_Type2 (header.m_numRequests,
+			m_numSubrequests, header.m_requestFormat);
+	else
+		m_requests = new RequestArray_Type0 (header.m_numRequests,
+			m_numSubrequests, header.m_requestFormat);
+
+	// Descriptors come by batches, in the coordinator order which is the
+	// arrival date order of the trace
+	while (index != header.m_numRequests)
+	{
+		zmq::message_t		msg;
+		socket.recv (&msg);
+
+		descriptors = (RequestDescriptor *) msg.data ();
+		numDescriptors = msg.size () / sizeof (RequestDescriptor);
+
+		for (OGSS_Ulong i = 0; i < numDescriptors; ++i, ++index)
+			m_requests->initRequest (index, descriptors [i] .m_date,
+				descriptors [i] .m_address, descriptors [i] .m_size,
+				descriptors [i] .m_type, descriptors [i] .m_option1,
+				descriptors [i] .m_option2);
+	}
+
+	socket.close ();
+}
+
 OGSS_Ulong
 Workload::extractNumberOfRequests (
 	const OGSS_String		& filename) {
@@ -203,6 +344,7 @@ void Workload::extractRequests_Type0 (
 		size *= dataUnit;
 
 		if (type == 0) rqType = RQT_READ;
+		else if (type == 2) rqType = RQT_ERASE;
 		else rqType = RQT_WRITE;
 
 		m_requests->initRequest (index, date, address, size, rqType);
@@ -253,6 +395,7 @@ void Workload::extractRequests_Type1 (
 		address *= dataUnit;
 
 		if (type == 0) rqType = RQT_READ;
+		else if (type == 2) rqType = RQT_ERASE;
 		else rqType = RQT_WRITE;
 
 		m_requests->initRequest (index, date, address, size, rqType, color);
@@ -304,6 +447,7 @@ void Workload::extractRequests_Type2 (
 		address *= dataUnit;
 
 		if (type == 0) rqType = RQT_READ;
+		else if (type == 2) rqType = RQT_ERASE;
 		else rqType = RQT_WRITE;
 
 		m_requests->initRequest (index, date, address, size, rqType, host, pid);
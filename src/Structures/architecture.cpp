@@ -26,15 +26,22 @@
  * @brief	Request is the structure which contains request parameters.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <glog/logging.h>		// log
 
 #include "Structures/architecture.hpp"
+#include "Structures/fabric.hpp"
+#include "Structures/ftl.hpp"
+#include "Structures/nvmecontroller.hpp"
+#include "Structures/shingledzones.hpp"
 
 using namespace std;
 
 /**************************************/
 /* CONSTANTS **************************/
 /**************************************/
+static const OGSS_Ulong		BUS_PROFILE_CAPACITY	= 4096;
 
 /**************************************/
 /* PUBLIC FUNCTIONS *******************/
@@ -51,6 +58,15 @@ Bus::Bus (
 	m_clock = .0;
 	m_lastParent = OGSS_ULONG_MAX;
 	m_lastProfileEntry = .0;
+	m_profileCapacity = BUS_PROFILE_CAPACITY;
+	m_profileResolution = .0;
+	m_profileBin = .0;
+	m_profileDate = .0;
+	m_profileState = BSS_IDLE;
+
+	for (int i = 0; i < BSS_TOTAL; ++i)
+		m_profileTime [i] = .0;
+
 	m_profile = vector < pair < OGSS_Real, int > > ();
 }
 
@@ -69,26 +85,384 @@ Bus::addDevice () {
 	m_numDevices ++;
 }
 
+void
+Bus::recordTransfer (
+	const OGSS_Real			date,
+	const OGSS_Real			transferTime) {
+	OGSS_Real				start;
+
+	if (m_profileCapacity == 0) return;
+
+	start = max (date, m_lastProfileEntry);
+
+	if (start == date)
+		addProfileEntry (start, BSS_USE);
+	else if (start - date > transferTime)
+		addProfileEntry (start, BSS_CONGESTED);
+	else
+		addProfileEntry (start, BSS_WAIT);
+
+	m_lastProfileEntry = start + transferTime;
+	addProfileEntry (m_lastProfileEntry, BSS_IDLE);
+}
+
+void
+Bus::closeProfile () {
+	if (m_profileResolution != .0)
+		closeProfileBin ();
+}
+
+void
+Bus::addProfileEntry (
+	const OGSS_Real			date,
+	const BusStateType		state) {
+	if (m_profileResolution == .0) {
+		// A zero-length entry is replaced
+		if (! m_profile.empty () && m_profile.back () .first == date) {
+			m_profile.back () .second = state;
+
+			if (m_profile.size () > 1
+				&& m_profile [m_profile.size () - 2] .second == state)
+				m_profile.pop_back ();
+		}
+		else
+			pushProfileEntry (date, state);
+	} else
+		advanceProfile (date);
+
+	m_profileState = state;
+	m_profileDate = date;
+
+	if (m_profile.size () >= m_profileCapacity)
+		downsampleProfile ();
+}
+
+void
+Bus::advanceProfile (
+	const OGSS_Real			date) {
+	OGSS_Real				nextBin;
+
+	nextBin = floor ( (m_profileBin + 1.5 * m_profileResolution)
+		/ m_profileResolution) * m_profileResolution;
+
+	if (date > nextBin) {
+		m_profileTime [m_profileState] += nextBin - m_profileDate;
+		closeProfileBin ();
+
+		// The bins before the date one only saw the current state
+		m_profileBin = floor (date / m_profileResolution) * m_profileResolution;
+
+		if (m_profileBin > nextBin)
+			pushProfileEntry (nextBin, m_profileState);
+
+		m_profileDate = m_profileBin;
+	}
+
+	m_profileTime [m_profileState] += date - m_profileDate;
+}
+
+void
+Bus::closeProfileBin () {
+	int						state = BSS_IDLE;
+
+	for (int i = 0; i < BSS_TOTAL; ++i)
+		if (m_profileTime [i] >= m_profileTime [state])
+			state = i;
+
+	for (int i = 0; i < BSS_TOTAL; ++i)
+		m_profileTime [i] = .0;
+
+	pushProfileEntry (m_profileBin, (BusStateType) state);
+}
+
+void
+Bus::pushProfileEntry (
+	const OGSS_Real			date,
+	const BusStateType		state) {
+	if (m_profile.empty () || m_profile.back () .second != state)
+		m_profile.push_back (make_pair (date, (int) state) );
+}
+
+void
+Bus::downsampleProfile () {
+	vector < pair < OGSS_Real, int > >	entries;
+	BusStateType			state = m_profileState;
+	OGSS_Real				date = m_profileDate;
+
+	closeProfile ();
+	entries.swap (m_profile);
+	m_profile.reserve (m_profileCapacity);
+
+	// There is at most one entry by bin: doubling the bin size for the same
+	// time span halves the number of entries
+	m_profileResolution = max (2 * m_profileResolution,
+		2 * (entries.back () .first - entries.front () .first)
+		/ m_profileCapacity);
+
+	m_profileBin = floor (entries.front () .first / m_profileResolution)
+		* m_profileResolution;
+	m_profileDate = entries.front () .first;
+	m_profileState = (BusStateType) entries.front () .second;
+
+	for (int i = 0; i < BSS_TOTAL; ++i)
+		m_profileTime [i] = .0;
+
+	for (auto & entry: entries) {
+		advanceProfile (entry.first);
+		m_profileState = (BusStateType) entry.second;
+		m_profileDate = entry.first;
+	}
+
+	// The state since the last entry is only known for the open bin
+	advanceProfile (date);
+	m_profileState = state;
+	m_profileDate = date;
+}
+
+/**
+ * Coefficients of the seek time model a * sqrt (d) + b * d + c, from the
+ * min/avg/max seek times.
+ *
+ * @param	numCyl				Number of cylinders.
+ * @param	minSeek				Min seek time.
+ * @param	avgSeek				Average seek time.
+ * @param	maxSeek				Max seek time.
+ * @param	a					Sqrt coefficient (output).
+ * @param	b					Linear coefficient (output).
+ * @param	c					Constant (output).
+ */
+void
+computeSeekCoefficients (
+	const unsigned			numCyl,
+	const OGSS_Real			minSeek,
+	const OGSS_Real			avgSeek,
+	const OGSS_Real			maxSeek,
+	OGSS_Real				& a,
+	OGSS_Real				& b,
+	OGSS_Real				& c) {
+	a = (-10 * minSeek + 15 * avgSeek - 5 * maxSeek) / (3 * sqrt (numCyl) );
+	b = (7 * minSeek - 15 * avgSeek + 8 * maxSeek) / (3 * numCyl);
+
+	// The formula is given as a * sqrt (d) + b * (d - 1) + min
+	c = minSeek - b;
+}
+
+SeekCurve::SeekCurve (
+	const HDDDevice			& device) {
+	m_numCylinders = device.m_numCylinders;
+	m_minRSeekTime = device.m_minRSeekTime;
+	m_avgRSeekTime = device.m_avgRSeekTime;
+	m_maxRSeekTime = device.m_maxRSeekTime;
+	m_minWSeekTime = device.m_minWSeekTime;
+	m_avgWSeekTime = device.m_avgWSeekTime;
+	m_maxWSeekTime = device.m_maxWSeekTime;
+
+	computeSeekCoefficients (m_numCylinders, m_minRSeekTime, m_avgRSeekTime,
+		m_maxRSeekTime, m_readA, m_readB, m_readC);
+	computeSeekCoefficients (m_numCylinders, m_minWSeekTime, m_avgWSeekTime,
+		m_maxWSeekTime, m_writeA, m_writeB, m_writeC);
+}
+
+OGSS_Bool
+SeekCurve::matches (
+	const HDDDevice			& device) const {
+	return m_numCylinders == device.m_numCylinders
+		&& m_minRSeekTime == device.m_minRSeekTime
+		&& m_avgRSeekTime == device.m_avgRSeekTime
+		&& m_maxRSeekTime == device.m_maxRSeekTime
+		&& m_minWSeekTime == device.m_minWSeekTime
+		&& m_avgWSeekTime == device.m_avgWSeekTime
+		&& m_maxWSeekTime == device.m_maxWSeekTime;
+}
+
+const Zone &
+ZoneTable::searchBySector (
+	const OGSS_Ulong		sector) const {
+	vector < Zone > ::const_iterator iter;
+
+	iter = upper_bound (m_zones.begin (), m_zones.end (), sector,
+		[] (const OGSS_Ulong s, const Zone & z)
+		{ return s < z.m_firstSector; });
+
+	return * (iter - 1);
+}
+
+const Zone &
+ZoneTable::searchByTrack (
+	const OGSS_Ulong		track) const {
+	vector < Zone > ::const_iterator iter;
+
+	iter = upper_bound (m_zones.begin (), m_zones.end (), track,
+		[] (const OGSS_Ulong t, const Zone & z)
+		{ return t < z.m_firstTrack; });
+
+	return * (iter - 1);
+}
+
+/**
+ * Search an index sorted by identifier.
+ *
+ * @param	index				Sorted index.
+ * @param	id					Identifier.
+ * @return						Associated value, 0 if not found.
+ */
+static OGSS_Ushort
+searchIndex (
+	const vector < pair < unsigned, OGSS_Ushort > >
+							& index,
+	const unsigned			id) {
+	vector < pair < unsigned, OGSS_Ushort > > ::const_iterator iter;
+
+	iter = lower_bound (index.begin (), index.end (), id,
+		[] (const pair < unsigned, OGSS_Ushort > & e, const unsigned i)
+		{ return e.first < i; });
+
+	return iter != index.end () && iter->first == id ? iter->second : 0;
+}
+
+/**
+ * Insert an identifier in an index sorted by identifier.
+ *
+ * @param	index				Sorted index.
+ * @param	id					Identifier.
+ * @param	value				Associated value.
+ * @return						False if the identifier is already present.
+ */
+static OGSS_Bool
+insertIndex (
+	vector < pair < unsigned, OGSS_Ushort > >
+							& index,
+	const unsigned			id,
+	const OGSS_Ushort		value) {
+	vector < pair < unsigned, OGSS_Ushort > > ::iterator iter;
+
+	iter = lower_bound (index.begin (), index.end (), id,
+		[] (const pair < unsigned, OGSS_Ushort > & e, const unsigned i)
+		{ return e.first < i; });
+
+	if (iter != index.end () && iter->first == id)
+		return false;
+
+	index.insert (iter, make_pair (id, value) );
+
+	return true;
+}
+
 Architecture::Architecture () {
 	m_geometry = NULL;
 	m_buses = NULL;
+	m_hosts = NULL;
 	m_tiers = NULL;
 	m_volumes = NULL;
 	m_devices = NULL;
+	m_fabric = NULL;
 	m_totalExecutionTime = .0;
 }
 
 Architecture::~Architecture () {
 	for (int i = 0; i < m_geometry->m_numDevices; ++i)
 	{
-		if (m_devices[i].m_type == DVT_SSD)
+		if (m_devices[i].isFlash () ) {
 			delete[] m_devices[i].m_hardware.m_ssd.m_lastPageSeen;
+			delete[] m_devices[i].m_hardware.m_ssd.m_dieClock;
+			delete[] m_devices[i].m_hardware.m_ssd.m_channelClock;
+			delete m_devices[i].m_hardware.m_ssd.m_ftl;
+			delete m_devices[i].m_hardware.m_ssd.m_nvme;
+		} else if (m_devices[i].m_type == DVT_SMR) {
+			delete m_devices[i].m_hardware.m_hdd.m_smrZones;
+		}
 	}
 
+	for (unsigned i = 0; i < m_seekCurves.size (); ++i)
+		delete m_seekCurves [i];
+
+	for (unsigned i = 0; i < m_zoneTables.size (); ++i)
+		delete m_zoneTables [i];
+
 	delete[] m_devices;
 	delete[] m_volumes;
 	delete[] m_tiers;
+	delete[] m_hosts;
 	delete[] m_buses;
+	delete m_fabric;
 	
 	delete m_geometry;
 }
+
+OGSS_Ulong
+Architecture::getVolumeCapacity (
+	const OGSS_Ushort		idxVolume) const {
+	OGSS_Ushort				idx = m_volumes [idxVolume] .m_idxDevices;
+	OGSS_Ushort				first = idxVolume;
+	OGSS_Ushort				last = idxVolume;
+
+	OGSS_Ulong				base;
+	OGSS_Ulong				numBytes = 0;
+
+	// Count the total number of pages for the volume
+	if (! m_devices [idx] .isFlash () )
+		base = m_devices [idx] .m_hardware.m_hdd.m_numSectors
+			* m_devices [idx] .m_hardware.m_hdd.m_sectorSize;
+	else
+		base = m_devices [idx] .m_hardware.m_ssd.m_numPages
+			* m_devices [idx] .m_hardware.m_ssd.m_pageSize;
+
+	if (m_volumes [idxVolume] .m_type == VHT_DECRAID)
+	{
+		first = idxVolume + 1;
+		last = idxVolume + m_volumes [idxVolume] .m_hardware.m_draid.m_numVolumes;
+	}
+
+	for (OGSS_Ushort i = first; i <= last; ++i)
+	{
+		if (m_volumes [i] .m_hardware.m_volume.m_type == VST_RAID1)
+			numBytes += base;
+		else if (m_volumes [i] .m_hardware.m_volume.m_type == VST_RAID01)
+			numBytes += base * m_volumes [i] .m_numDevices / 2;
+		else if (m_volumes [i] .m_hardware.m_volume.m_type == VST_RAIDNP)
+			numBytes += base * (m_volumes [i] .m_numDevices
+				- m_volumes [i] .m_hardware.m_volume.m_numParityDevices);
+		else
+			numBytes += base * m_volumes [i] .m_numDevices;
+	}
+
+	return numBytes;
+}
+
+const SeekCurve *
+Architecture::getSeekCurve (
+	const HDDDevice			& device) {
+	for (unsigned i = 0; i < m_seekCurves.size (); ++i)
+		if (m_seekCurves [i] ->matches (device) )
+			return m_seekCurves [i];
+
+	m_seekCurves.push_back (new SeekCurve (device) );
+
+	return m_seekCurves.back ();
+}
+
+OGSS_Ushort
+Architecture::getIdxHost (
+	const unsigned			id) const {
+	return searchIndex (m_hostIndex, id);
+}
+
+OGSS_Bool
+Architecture::addIdxHost (
+	const unsigned			id,
+	const OGSS_Ushort		idxHost) {
+	return insertIndex (m_hostIndex, id, idxHost);
+}
+
+OGSS_Ushort
+Architecture::getIdxQoSClass (
+	const unsigned			color) const {
+	return searchIndex (m_qosIndex, color);
+}
+
+OGSS_Bool
+Architecture::addIdxQoSClass (
+	const unsigned			color,
+	const OGSS_Ushort		idxClass) {
+	return insertIndex (m_qosIndex, color, idxClass);
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	fabric.cpp
+ * @brief	Fabric is a switched network (Ethernet, InfiniBand) between the
+ * host and the storage enclosures, which replaces the host and tier buses of
+ * the volumes attached to it.
+ */
+
+#include "Structures/fabric.hpp"
+
+#include <functional>
+#include <queue>
+
+using namespace std;
+
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+Fabric::Fabric () {
+	m_hostNode = OGSS_USHORT_MAX;
+}
+
+Fabric::~Fabric () {  }
+
+OGSS_Ushort
+Fabric::addNode (
+	const OGSS_String		name,
+	const FabricNodeType	type,
+	const OGSS_Real			latency) {
+	m_nodeNames.push_back (name);
+	m_nodeTypes.push_back (type);
+	m_nodeLatency.push_back (type == FNT_SWITCH ? latency : .0);
+	m_adjacency.resize (m_nodeNames.size () );
+
+	return m_nodeNames.size () - 1;
+}
+
+void
+Fabric::addLink (
+	const OGSS_Ushort		from,
+	const OGSS_Ushort		to,
+	const BusType			type,
+	const OGSS_Real			bandwidth,
+	const OGSS_Real			latency) {
+	Channel					channel;
+
+	channel.m_type = type;
+	channel.m_bandwidth = bandwidth * MILLISEC * MEGABYTE;
+	channel.m_clock = .0;
+	channel.m_busyTime = .0;
+
+	channel.m_from = from;
+	channel.m_to = to;
+	channel.m_latency = latency + m_nodeLatency [to];
+	m_adjacency [from] .push_back (m_channels.size () );
+	m_channels.push_back (channel);
+
+	channel.m_from = to;
+	channel.m_to = from;
+	channel.m_latency = latency + m_nodeLatency [from];
+	m_adjacency [to] .push_back (m_channels.size () );
+	m_channels.push_back (channel);
+}
+
+OGSS_Ushort
+Fabric::getNode (
+	const OGSS_String		name) const {
+	for (OGSS_Ushort i = 0; i < m_nodeNames.size (); ++i)
+		if (m_nodeNames [i] == name)
+			return i;
+
+	return OGSS_USHORT_MAX;
+}
+
+void
+Fabric::computeRoutes () {
+	typedef pair < pair < OGSS_Real, OGSS_Ushort >, OGSS_Ushort >	Candidate;
+
+	OGSS_Ushort				numNodes = m_nodeNames.size ();
+	vector < pair < OGSS_Real, OGSS_Ushort > >	cost;
+	vector < OGSS_Ushort >	previous;
+	vector < OGSS_Ushort >	path;
+
+	m_hops.clear ();
+	m_routes.assign (numNodes * numNodes, make_pair (0, 0) );
+
+	// A Dijkstra search from each host and target, on the latency then on the
+	// number of hops. The routes only cross switches.
+	for (OGSS_Ushort src = 0; src < numNodes; ++src) {
+		priority_queue < Candidate, vector < Candidate >,
+			greater < Candidate > >	candidates;
+
+		if (m_nodeTypes [src] == FNT_SWITCH)
+			continue;
+
+		cost.assign (numNodes, make_pair (-1., 0) );
+		previous.assign (numNodes, OGSS_USHORT_MAX);
+
+		cost [src] = make_pair (.0, 0);
+		candidates.push (make_pair (cost [src], src) );
+
+		while (! candidates.empty () ) {
+			Candidate		cur = candidates.top ();
+			OGSS_Ushort		node = cur.second;
+
+			candidates.pop ();
+
+			if (cur.first != cost [node]
+				|| (node != src && m_nodeTypes [node] != FNT_SWITCH) )
+				continue;
+
+			for (auto idx: m_adjacency [node]) {
+				const Channel	& channel = m_channels [idx];
+				pair < OGSS_Real, OGSS_Ushort >	next = make_pair (
+					cur.first.first + channel.m_latency,
+					cur.first.second + 1);
+
+				if (channel.m_to == src)
+					continue;
+
+				if (cost [channel.m_to] .first < .0
+					|| next < cost [channel.m_to]) {
+					cost [channel.m_to] = next;
+					previous [channel.m_to] = idx;
+					candidates.push (make_pair (next, channel.m_to) );
+				}
+			}
+		}
+
+		for (OGSS_Ushort dst = 0; dst < numNodes; ++dst) {
+			if (dst == src || m_nodeTypes [dst] == FNT_SWITCH
+				|| previous [dst] == OGSS_USHORT_MAX)
+				continue;
+
+			path.clear ();
+			for (OGSS_Ushort node = dst; node != src;
+				node = m_channels [previous [node] ] .m_from)
+				path.push_back (previous [node]);
+
+			m_routes [src * numNodes + dst] = make_pair (m_hops.size (),
+				path.size () );
+			m_hops.insert (m_hops.end (), path.rbegin (), path.rend () );
+		}
+	}
+}
+
+OGSS_Real
+Fabric::send (
+	const OGSS_Ushort		src,
+	const OGSS_Ushort		dst,
+	const OGSS_Ulong		size,
+	OGSS_Real				& date,
+	OGSS_Real				& transferTime) {
+	const pair < OGSS_Ulong, OGSS_Ushort >	& route =
+		m_routes [src * m_nodeNames.size () + dst];
+	OGSS_Real				waitingTime = .0;
+	OGSS_Real				time;
+
+	for (OGSS_Ushort i = 0; i < route.second; ++i) {
+		Channel				& channel = m_channels [m_hops [route.first + i] ];
+
+		time = size / channel.m_bandwidth;
+
+		if (channel.m_clock > date) {
+			waitingTime += channel.m_clock - date;
+			date = channel.m_clock;
+		}
+
+		channel.m_clock = date + time;
+		channel.m_busyTime += time;
+
+		date += time + channel.m_latency;
+		transferTime += time + channel.m_latency;
+	}
+
+	return waitingTime;
+}
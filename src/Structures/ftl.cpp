@@ -0,0 +1,392 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	ftl.cpp
+ * @brief	FlashTranslationLayer is the page-mapped FTL of a SSD. It maps the
+ * logical pages to physical pages, writes out-of-place in the active block
+ * of each die, and reclaims the blocks with a garbage collector when the
+ * free blocks of a die run low.
+ */
+
+#include "Structures/ftl.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <glog/logging.h>
+#include <limits>
+#include <sstream>
+
+#include "Utils/simexception.hpp"
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+enum BlockState {
+	BKS_FREE,
+	BKS_ACTIVE,
+	BKS_FULL
+};
+
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+FlashTranslationLayer::FlashTranslationLayer (
+	const SSDDevice			& device) {
+	ostringstream			oss ("");
+	OGSS_Ulong				numPhysicalPages;
+
+	m_pagesByBlock = device.m_pagesByBlock;
+	m_blocksByDie = device.m_blocksByDie;
+	m_numDies = device.m_numDies;
+	m_numBlocks = m_blocksByDie * m_numDies;
+
+	numPhysicalPages = (OGSS_Ulong) m_pagesByBlock * m_numBlocks;
+
+	if (numPhysicalPages >= numeric_limits < uint32_t > ::max () ) {
+		oss << "The SSD has too many pages (" << numPhysicalPages
+			<< ") for the FTL";
+		throw SimulatorException (ERR_ARCHITECTURE, oss.str () );
+	}
+
+	m_numPhysicalPages = numPhysicalPages;
+	m_numLogicalPages = min < OGSS_Ulong > (device.m_numPages,
+		numPhysicalPages);
+
+	m_gcThreshold = max < uint32_t > (2,
+		ceil (device.m_gcThreshold * m_blocksByDie) );
+	m_gcPolicy = device.m_gcPolicy;
+
+	m_randomReadTime = device.m_randomReadTime;
+	m_randomWriteTime = device.m_randomWriteTime;
+	m_sequentialReadTime = device.m_sequentialReadTime;
+	m_sequentialWriteTime = device.m_sequentialWriteTime;
+	m_eraseTime = device.m_eraseTime;
+
+	m_logicalToPhysical = (uint32_t *) calloc (m_numLogicalPages,
+		sizeof (uint32_t) );
+	m_physicalToLogical = (uint32_t *) calloc (m_numPhysicalPages,
+		sizeof (uint32_t) );
+	m_validPages = (uint32_t *) calloc (m_numBlocks, sizeof (uint32_t) );
+	m_eraseCount = (uint32_t *) calloc (m_numBlocks, sizeof (uint32_t) );
+	m_writePointer = (uint32_t *) calloc (m_numBlocks, sizeof (uint32_t) );
+	m_lastUpdate = (float *) calloc (m_numBlocks, sizeof (float) );
+	m_blockState = (uint8_t *) calloc (m_numBlocks, sizeof (uint8_t) );
+
+	if (! m_logicalToPhysical || ! m_physicalToLogical || ! m_validPages
+		|| ! m_eraseCount || ! m_writePointer || ! m_lastUpdate
+		|| ! m_blockState) {
+		oss << "Cannot allocate the FTL tables (" << numPhysicalPages
+			<< " pages)";
+		throw SimulatorException (ERR_SMALLOC, oss.str () );
+	}
+
+	// The free blocks are popped from the back, lowest first
+	m_freeBlocks.resize (m_numDies);
+	for (uint32_t i = 0; i < m_numDies; ++i) {
+		m_freeBlocks [i] .reserve (m_blocksByDie);
+		for (uint32_t j = m_blocksByDie; j > 0; --j)
+			m_freeBlocks [i] .push_back (i * m_blocksByDie + j - 1);
+	}
+
+	m_hostBlock.assign (m_numDies, m_numBlocks);
+	m_gcBlock.assign (m_numDies, m_numBlocks);
+	m_lastPage.assign (m_numDies, m_numPhysicalPages);
+	m_nextDie = 0;
+	m_dieTimes.assign (m_numDies, .0);
+	m_diePages.assign (m_numDies, 0);
+
+	m_hostWrites = 0;
+	m_flashWrites = 0;
+	m_numErases = 0;
+	m_trimmedPages = 0;
+	m_gcTime = .0;
+	m_gcStuck = false;
+}
+
+FlashTranslationLayer::~FlashTranslationLayer () {
+	free (m_logicalToPhysical);
+	free (m_physicalToLogical);
+	free (m_validPages);
+	free (m_eraseCount);
+	free (m_writePointer);
+	free (m_lastUpdate);
+	free (m_blockState);
+}
+
+OGSS_Real
+FlashTranslationLayer::read (
+	const OGSS_Ulong		firstPage,
+	const OGSS_Ulong		numPages) {
+	OGSS_Real				r = .0;
+	OGSS_Real				t;
+	OGSS_Bool				unmapped = false;
+	uint32_t				lpn;
+	uint32_t				die;
+
+	m_dieTimes.assign (m_numDies, .0);
+	m_diePages.assign (m_numDies, 0);
+
+	for (OGSS_Ulong i = 0; i < numPages; ++i) {
+		lpn = (firstPage + i) % m_numLogicalPages;
+
+		// The pages never written are read as if they were laid out in
+		// the logical order, striped on the dies like the writes
+		if (m_logicalToPhysical [lpn] == 0) {
+			t = unmapped ? m_sequentialReadTime : m_randomReadTime;
+			die = lpn % m_numDies;
+			m_dieTimes [die] += t;
+			unmapped = true;
+		}
+		else {
+			t = access (m_logicalToPhysical [lpn] - 1,
+				m_randomReadTime, m_sequentialReadTime);
+			die = (m_logicalToPhysical [lpn] - 1)
+				/ (m_pagesByBlock * m_blocksByDie);
+			unmapped = false;
+		}
+
+		m_diePages [die] ++;
+		r += t;
+	}
+
+	return r;
+}
+
+OGSS_Real
+FlashTranslationLayer::write (
+	const OGSS_Ulong		firstPage,
+	const OGSS_Ulong		numPages,
+	const OGSS_Real			date) {
+	OGSS_Real				r = .0;
+	uint32_t				die;
+
+	m_dieTimes.assign (m_numDies, .0);
+	m_diePages.assign (m_numDies, 0);
+
+	for (OGSS_Ulong i = 0; i < numPages; ++i) {
+		die = m_nextDie;
+		m_nextDie = (m_nextDie + 1) % m_numDies;
+
+		if (m_freeBlocks [die] .size () < m_gcThreshold)
+			r += collect (die, date);
+
+		// A die which can not be reclaimed any more is skipped
+		for (uint32_t j = 0; j < m_numDies
+			&& m_freeBlocks [die] .empty ()
+			&& (m_hostBlock [die] == m_numBlocks
+				|| m_writePointer [m_hostBlock [die] ] == m_pagesByBlock);
+			++j)
+			die = (die + 1) % m_numDies;
+
+		if (m_freeBlocks [die] .empty ()
+			&& (m_hostBlock [die] == m_numBlocks
+				|| m_writePointer [m_hostBlock [die] ] == m_pagesByBlock) ) {
+			if (! m_gcStuck)
+				LOG(ERROR) << "The SSD is full, the writes are not mapped "
+					<< "any more";
+			m_gcStuck = true;
+			break;
+		}
+
+		r += program ( (firstPage + i) % m_numLogicalPages, die,
+			m_hostBlock, date);
+		m_diePages [die] ++;
+		m_hostWrites++;
+	}
+
+	return r;
+}
+
+void
+FlashTranslationLayer::trim (
+	const OGSS_Ulong		firstPage,
+	const OGSS_Ulong		numPages,
+	const OGSS_Real			date) {
+	uint32_t				lpn;
+
+	m_dieTimes.assign (m_numDies, .0);
+	m_diePages.assign (m_numDies, 0);
+
+	for (OGSS_Ulong i = 0; i < numPages; ++i) {
+		lpn = (firstPage + i) % m_numLogicalPages;
+
+		if (m_logicalToPhysical [lpn] != 0) {
+			invalidate (m_logicalToPhysical [lpn] - 1, date);
+			m_logicalToPhysical [lpn] = 0;
+			m_trimmedPages++;
+		}
+	}
+}
+
+/**************************************/
+/* PRIVATE FUNCTIONS ******************/
+/**************************************/
+OGSS_Real
+FlashTranslationLayer::program (
+	const uint32_t			logicalPage,
+	const uint32_t			die,
+	vector < uint32_t >		& active,
+	const OGSS_Real			date) {
+	uint32_t				block = active [die];
+	uint32_t				ppn;
+
+	if (block == m_numBlocks || m_writePointer [block] == m_pagesByBlock) {
+		if (block != m_numBlocks)
+			m_blockState [block] = BKS_FULL;
+
+		block = m_freeBlocks [die] .back ();
+		m_freeBlocks [die] .pop_back ();
+
+		m_blockState [block] = BKS_ACTIVE;
+		m_writePointer [block] = 0;
+		active [die] = block;
+	}
+
+	ppn = block * m_pagesByBlock + m_writePointer [block] ++;
+
+	if (m_logicalToPhysical [logicalPage] != 0)
+		invalidate (m_logicalToPhysical [logicalPage] - 1, date);
+
+	m_logicalToPhysical [logicalPage] = ppn + 1;
+	m_physicalToLogical [ppn] = logicalPage + 1;
+	m_validPages [block] ++;
+	m_flashWrites++;
+
+	return access (ppn, m_randomWriteTime, m_sequentialWriteTime);
+}
+
+void
+FlashTranslationLayer::invalidate (
+	const uint32_t			physicalPage,
+	const OGSS_Real			date) {
+	uint32_t				block = physicalPage / m_pagesByBlock;
+
+	m_physicalToLogical [physicalPage] = 0;
+	m_validPages [block] --;
+	m_lastUpdate [block] = date;
+}
+
+OGSS_Real
+FlashTranslationLayer::collect (
+	const uint32_t			die,
+	const OGSS_Real			date) {
+	OGSS_Real				r = .0;
+	uint32_t				victim;
+	uint32_t				ppn;
+
+	while (m_freeBlocks [die] .size () < m_gcThreshold) {
+		victim = selectVictim (die, date);
+
+		if (victim == m_numBlocks) {
+			if (! m_gcStuck)
+				LOG(WARNING) << "The garbage collector found no block to "
+					<< "reclaim, the over-provisioning is too low";
+			m_gcStuck = true;
+			break;
+		}
+
+		// Relocate the valid pages in the GC block of the die
+		for (uint32_t i = 0; i < m_pagesByBlock
+			&& m_validPages [victim] > 0; ++i) {
+			ppn = victim * m_pagesByBlock + i;
+
+			if (m_physicalToLogical [ppn] == 0) continue;
+
+			if (m_freeBlocks [die] .empty ()
+				&& (m_gcBlock [die] == m_numBlocks
+					|| m_writePointer [m_gcBlock [die] ] == m_pagesByBlock) )
+				break;
+
+			r += access (ppn, m_randomReadTime, m_sequentialReadTime);
+			r += program (m_physicalToLogical [ppn] - 1, die, m_gcBlock,
+				date);
+		}
+
+		if (m_validPages [victim] > 0) break;
+
+		m_blockState [victim] = BKS_FREE;
+		m_writePointer [victim] = 0;
+		m_eraseCount [victim] ++;
+		m_numErases++;
+		m_freeBlocks [die] .push_back (victim);
+
+		m_dieTimes [die] += m_eraseTime;
+		r += m_eraseTime;
+	}
+
+	m_gcTime += r;
+
+	return r;
+}
+
+uint32_t
+FlashTranslationLayer::selectVictim (
+	const uint32_t			die,
+	const OGSS_Real			date) const {
+	uint32_t				victim = m_numBlocks;
+	OGSS_Real				best = -1.;
+	OGSS_Real				score;
+	OGSS_Real				u;
+
+	for (uint32_t b = die * m_blocksByDie;
+		b < (die + 1) * m_blocksByDie; ++b) {
+		if (m_blockState [b] != BKS_FULL
+			|| m_validPages [b] == m_pagesByBlock)
+			continue;
+
+		if (m_gcPolicy == GCP_COSTBENEFIT) {
+			u = (OGSS_Real) m_validPages [b] / m_pagesByBlock;
+			if (u == .0) return b;
+			score = (1 - u) * (1 + max (.0, date - m_lastUpdate [b] ) )
+				/ (2 * u);
+		}
+		else
+			score = m_pagesByBlock - m_validPages [b];
+
+		if (score > best) {
+			best = score;
+			victim = b;
+		}
+	}
+
+	return victim;
+}
+
+OGSS_Real
+FlashTranslationLayer::access (
+	const uint32_t			physicalPage,
+	const OGSS_Real			randomTime,
+	const OGSS_Real			sequentialTime) {
+	uint32_t				die = physicalPage
+								/ (m_pagesByBlock * m_blocksByDie);
+	OGSS_Real				r;
+
+	r = (m_lastPage [die] == physicalPage) ? sequentialTime : randomTime;
+	m_lastPage [die] = physicalPage + 1;
+	m_dieTimes [die] += r;
+
+	return r;
+}
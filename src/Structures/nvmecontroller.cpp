@@ -0,0 +1,135 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	nvmecontroller.cpp
+ * @brief	NVMeController is the host interface of a NVMe device: the
+ * submission queues, the arbitration of the command processor between them
+ * and the PCIe link.
+ */
+
+#include "Structures/nvmecontroller.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+NVMeController::NVMeController (
+	const SSDDevice			& device) {
+	m_numQueues = max (1u, device.m_nvmeNumQueues);
+	m_queueDepth = max (1u, device.m_nvmeQueueDepth);
+	m_commandTime = device.m_nvmeCommandTime;
+	m_linkBandwidth = device.m_nvmeLanes * device.m_nvmeLaneBandwidth
+		* MILLISEC * MEGABYTE;
+
+	// The high priority queues come first, then the medium ones
+	m_weights.assign (m_numQueues, 1);
+	if (device.m_nvmeArbitration == ABT_WRR)
+		for (unsigned i = 0; i < m_numQueues; ++i) {
+			if (i < device.m_nvmeHighQueues)
+				m_weights [i] = device.m_nvmeWeights [0];
+			else if (i < device.m_nvmeHighQueues + device.m_nvmeMediumQueues)
+				m_weights [i] = device.m_nvmeWeights [1];
+			else
+				m_weights [i] = device.m_nvmeWeights [2];
+		}
+
+	m_queueClock.assign (m_numQueues, .0);
+	m_outstanding.resize (m_numQueues);
+	m_linkClock [0] = m_linkClock [1] = .0;
+
+	m_numCommands = 0;
+	m_numQueueFull = 0;
+	m_maxQueueWait = .0;
+	m_linkBusyTime [0] = m_linkBusyTime [1] = .0;
+}
+
+NVMeController::~NVMeController () {  }
+
+OGSS_Real
+NVMeController::submit (
+	const unsigned			queue,
+	const OGSS_Real			date,
+	OGSS_Real				& start) {
+	CompletionQueue			& outstanding = m_outstanding [queue];
+	OGSS_Real				admission = date;
+	unsigned				backlog;
+
+	m_numCommands ++;
+
+	while (! outstanding.empty () && outstanding.top () <= date)
+		outstanding.pop ();
+
+	// The queue is full: wait for the first completion
+	if (outstanding.size () >= m_queueDepth) {
+		admission = outstanding.top ();
+		outstanding.pop ();
+
+		m_numQueueFull ++;
+		m_maxQueueWait = max (m_maxQueueWait, admission - date);
+	}
+
+	start = max (admission, m_queueClock [queue]);
+
+	// The processor is shared by the queues which have a backlog
+	backlog = m_weights [queue];
+	for (unsigned i = 0; i < m_numQueues; ++i)
+		if (i != queue && m_queueClock [i] > start)
+			backlog += m_weights [i];
+
+	m_queueClock [queue] = start
+		+ m_commandTime * backlog / m_weights [queue];
+
+	return m_queueClock [queue];
+}
+
+OGSS_Real
+NVMeController::transfer (
+	const OGSS_Ulong		size,
+	const OGSS_Bool			toHost,
+	const OGSS_Real			date) {
+	OGSS_Real				duration;
+	OGSS_Real				start;
+	unsigned				dir = toHost ? 1 : 0;
+
+	if (size == 0 || m_linkBandwidth <= .0)
+		return date;
+
+	duration = size / m_linkBandwidth;
+	start = max (date, m_linkClock [dir]);
+
+	m_linkClock [dir] = start + duration;
+	m_linkBusyTime [dir] += duration;
+
+	return m_linkClock [dir];
+}
+
+void
+NVMeController::complete (
+	const unsigned			queue,
+	const OGSS_Real			date) {
+	m_outstanding [queue] .push (date);
+}
@@ -75,6 +75,7 @@ RequestArray_Type0::initRequest (
 	m_array [index] .m_type = type;
 	m_array [index] .m_deviceWaitingTime = -1.0;
 	m_array [index] .m_busWaitingTime = .0;
+	m_array [index] .m_bufferWaitingTime = .0;
 	m_array [index] .m_serviceTime = .0;
 	m_array [index] .m_transferTime = .0;
 	m_array [index] .m_responseTime = .0;
@@ -82,6 +83,8 @@ RequestArray_Type0::initRequest (
 	m_array [index] .m_isFaulty = false;
 	m_array [index] .m_isDone = false;
 	m_array [index] .m_isUserRequest = true;
+	m_array [index] .m_isCacheHit = false;
+	m_array [index] .m_isDeviceCacheHit = false;
 
 	m_array [index] .m_numBusChild = OGSS_USHORT_MAX;
 	m_array [index] .m_numEffBusChild = OGSS_USHORT_MAX;
@@ -90,6 +93,18 @@ RequestArray_Type0::initRequest (
 	m_array [index] .m_ghostDate = .0;
 	m_array [index] .m_prereadDate = .0;
 	m_array [index] .m_childDate = .0;
+	m_array [index] .m_sequence = 0;
+}
+
+void
+RequestArray_Type0::getOptions (
+	const OGSS_Ulong		idxRequest,
+	unsigned				& option1,
+	unsigned				& option2) const {
+	(void) idxRequest;	// no optional parameter here
+
+	option1 = 0;
+	option2 = 0;
 }
 
 OGSS_Ulong
@@ -43,7 +43,10 @@ RequestArray_Type1::RequestArray_Type1 (
 		numRequests,
 		numSubrequests,
 		reqFormat) {
-	m_array = new Request_Type1 [m_numRequests + m_numSubrequests];
+	// The base class indexes the array as Request: the options are stored
+	// aside
+	m_array = new Request [m_numRequests + m_numSubrequests];
+	m_colors = new unsigned [m_numRequests + m_numSubrequests] ();
 
 	for (OGSS_Ulong idx = m_numRequests; idx != m_numRequests + m_numSubrequests;
 		++idx)
@@ -51,7 +54,7 @@ RequestArray_Type1::RequestArray_Type1 (
 }
 
 RequestArray_Type1::~RequestArray_Type1 ()
-{ delete[] m_array; }
+{ delete[] m_array; delete[] m_colors; }
 
 void
 RequestArray_Type1::initRequest (
@@ -74,6 +77,7 @@ RequestArray_Type1::initRequest (
 	m_array [index] .m_type = type;
 	m_array [index] .m_deviceWaitingTime = -1.0;
 	m_array [index] .m_busWaitingTime = .0;
+	m_array [index] .m_bufferWaitingTime = .0;
 	m_array [index] .m_serviceTime = .0;
 	m_array [index] .m_transferTime = .0;
 	m_array [index] .m_responseTime = .0;
@@ -81,7 +85,9 @@ RequestArray_Type1::initRequest (
 	m_array [index] .m_isFaulty = false;
 	m_array [index] .m_isDone = false;
 	m_array [index] .m_isUserRequest = true;
-	( (Request_Type1*) m_array) [index] .m_color = option1;
+	m_array [index] .m_isCacheHit = false;
+	m_array [index] .m_isDeviceCacheHit = false;
+	m_colors [index] = option1;
 
 	m_array [index] .m_numBusChild = OGSS_USHORT_MAX;
 	m_array [index] .m_numEffBusChild = OGSS_USHORT_MAX;
@@ -90,6 +96,16 @@ RequestArray_Type1::initRequest (
 	m_array [index] .m_ghostDate = .0;
 	m_array [index] .m_prereadDate = .0;
 	m_array [index] .m_childDate = .0;
+	m_array [index] .m_sequence = 0;
+}
+
+void
+RequestArray_Type1::getOptions (
+	const OGSS_Ulong		idxRequest,
+	unsigned				& option1,
+	unsigned				& option2) const {
+	option1 = m_colors [idxRequest];
+	option2 = 0;
 }
 
 OGSS_Ulong
@@ -123,6 +139,7 @@ RequestArray_Type1::searchNewSubrequest (
 	if (parentIndex < m_numRequests)
 	{
 		m_array [subReqIndex] = m_array [parentIndex];
+		m_colors [subReqIndex] = m_colors [parentIndex];
 		m_array [parentIndex] .m_numChild++;
 	}
 	else
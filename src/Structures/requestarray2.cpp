@@ -43,7 +43,11 @@ RequestArray_Type2::RequestArray_Type2 (
 		numRequests,
 		numSubrequests,
 		reqFormat) {
-	m_array = new Request_Type2 [m_numRequests + m_numSubrequests];
+	// The base class indexes the array as Request: the options are stored
+	// aside
+	m_array = new Request [m_numRequests + m_numSubrequests];
+	m_hosts = new unsigned [m_numRequests + m_numSubrequests] ();
+	m_pids = new unsigned [m_numRequests + m_numSubrequests] ();
 
 	for (OGSS_Ulong idx = m_numRequests; idx != m_numRequests + m_numSubrequests;
 		++idx)
@@ -51,7 +55,7 @@ RequestArray_Type2::RequestArray_Type2 (
 }
 
 RequestArray_Type2::~RequestArray_Type2 ()
-{ delete[] m_array; }
+{ delete[] m_array; delete[] m_hosts; delete[] m_pids; }
 
 void
 RequestArray_Type2::initRequest (
@@ -72,6 +76,7 @@ RequestArray_Type2::initRequest (
 	m_array [index] .m_type = type;
 	m_array [index] .m_deviceWaitingTime = -1.0;
 	m_array [index] .m_busWaitingTime = .0;
+	m_array [index] .m_bufferWaitingTime = .0;
 	m_array [index] .m_serviceTime = .0;
 	m_array [index] .m_transferTime = .0;
 	m_array [index] .m_responseTime = .0;
@@ -79,8 +84,10 @@ RequestArray_Type2::initRequest (
 	m_array [index] .m_isFaulty = false;
 	m_array [index] .m_isDone = false;
 	m_array [index] .m_isUserRequest = true;
-	( (Request_Type2 *) m_array) [index] .m_host = option1;
-	( (Request_Type2 *) m_array) [index] .m_pid = option2;
+	m_array [index] .m_isCacheHit = false;
+	m_array [index] .m_isDeviceCacheHit = false;
+	m_hosts [index] = option1;
+	m_pids [index] = option2;
 
 	m_array [index] .m_numBusChild = OGSS_USHORT_MAX;
 	m_array [index] .m_numEffBusChild = OGSS_USHORT_MAX;
@@ -89,6 +96,16 @@ RequestArray_Type2::initRequest (
 	m_array [index] .m_ghostDate = .0;
 	m_array [index] .m_prereadDate = .0;
 	m_array [index] .m_childDate = .0;
+	m_array [index] .m_sequence = 0;
+}
+
+void
+RequestArray_Type2::getOptions (
+	const OGSS_Ulong		idxRequest,
+	unsigned				& option1,
+	unsigned				& option2) const {
+	option1 = m_hosts [idxRequest];
+	option2 = m_pids [idxRequest];
 }
 
 OGSS_Ulong
@@ -122,6 +139,8 @@ RequestArray_Type2::searchNewSubrequest (
 	if (parentIndex < m_numRequests)
 	{
 		m_array [subReqIndex] = m_array [parentIndex];
+		m_hosts [subReqIndex] = m_hosts [parentIndex];
+		m_pids [subReqIndex] = m_pids [parentIndex];
 		m_array [parentIndex] .m_numChild++;
 	}
 	else
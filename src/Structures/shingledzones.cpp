@@ -0,0 +1,257 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	shingledzones.cpp
+ * @brief	ShingledZones is the zone state of a SMR device. Each zone has a
+ * write pointer, under which the data can only be rewritten with the whole
+ * band.
+ */
+
+#include "Structures/shingledzones.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+#include "Utils/simexception.hpp"
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+static const uint32_t		ZONE_QUEUED			= 0x80000000;
+
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+ShingledZones::ShingledZones (
+	const HDDDevice			& device) {
+	ostringstream			oss ("");
+	OGSS_Ulong				sectorsByZone;
+
+	m_management = device.m_smrManagement;
+	sectorsByZone = device.m_smrZoneSize / device.m_sectorSize;
+	m_numCacheSectors = (m_management == ZMT_DRIVE) ?
+		device.m_smrMediaCacheSize / device.m_sectorSize : 0;
+
+	if (sectorsByZone == 0 || sectorsByZone >= ZONE_QUEUED
+		|| m_numCacheSectors >= ZONE_QUEUED) {
+		oss << "The SMR zone size (" << device.m_smrZoneSize << "B) or "
+			<< "media cache size (" << device.m_smrMediaCacheSize
+			<< "B) is out of range";
+		throw SimulatorException (ERR_ARCHITECTURE, oss.str () );
+	}
+
+	if (m_management == ZMT_DRIVE && m_numCacheSectors == 0)
+		throw SimulatorException (ERR_ARCHITECTURE,
+			"A drive-managed SMR device needs a media cache");
+
+	m_sectorsByZone = sectorsByZone;
+	m_numZones = (device.m_numSectors + sectorsByZone - 1) / sectorsByZone;
+	m_cleaningLimit = device.m_smrCleaningThreshold * m_numCacheSectors;
+
+	m_writePointer = (uint32_t *) calloc (m_numZones, sizeof (uint32_t) );
+	m_cachedSectors = (uint32_t *) calloc (m_numZones, sizeof (uint32_t) );
+	m_staleSectors = (uint32_t *) calloc (m_numZones, sizeof (uint32_t) );
+	m_cleanQueue = (uint32_t *) calloc (m_numZones, sizeof (uint32_t) );
+
+	if (! m_writePointer || ! m_cachedSectors || ! m_staleSectors
+		|| ! m_cleanQueue) {
+		oss << "Cannot allocate the SMR zone tables (" << m_numZones
+			<< " zones)";
+		throw SimulatorException (ERR_SMALLOC, oss.str () );
+	}
+
+	m_queueHead = 0;
+	m_queueSize = 0;
+	m_cacheTail = 0;
+	m_cacheFill = 0;
+
+	m_hostWrites = 0;
+	m_cacheWrites = 0;
+	m_rewrittenSectors = 0;
+	m_cleanedBands = 0;
+	m_cleaningTime = .0;
+	m_relocatedWrites = 0;
+	m_numResets = 0;
+	m_rejectedWrites = 0;
+}
+
+ShingledZones::~ShingledZones () {
+	free (m_writePointer);
+	free (m_cachedSectors);
+	free (m_staleSectors);
+	free (m_cleanQueue);
+}
+
+OGSS_Ulong
+ShingledZones::write (
+	const OGSS_Ulong		firstSector,
+	const OGSS_Ulong		numSectors) {
+	uint32_t				first, last, start, end;
+	OGSS_Bool				inPlace = true;
+	OGSS_Ulong				sector;
+
+	first = min < OGSS_Ulong > (firstSector / m_sectorsByZone,
+		m_numZones - 1);
+
+	if (m_management == ZMT_HOST) {
+		// Zone append: the data goes at the write pointer, the zone must be
+		// reset by the host before it is written again
+		if (numSectors > m_sectorsByZone - m_writePointer [first]) {
+			m_rejectedWrites ++;
+			return OGSS_ULONG_MAX;
+		}
+
+		m_hostWrites += numSectors;
+
+		sector = (OGSS_Ulong) first * m_sectorsByZone
+			+ m_writePointer [first];
+		m_writePointer [first] += numSectors;
+
+		if (sector != firstSector) m_relocatedWrites ++;
+
+		return sector;
+	}
+
+	last = min < OGSS_Ulong > ( (firstSector + max < OGSS_Ulong > (
+		numSectors, 1) - 1) / m_sectorsByZone, m_numZones - 1);
+	m_hostWrites += numSectors;
+
+	// The write would overwrite the next shingled tracks of a zone
+	for (uint32_t i = first; i <= last && inPlace; ++i) {
+		start = (i == first) ?
+			firstSector - (OGSS_Ulong) first * m_sectorsByZone : 0;
+		inPlace = start >= m_writePointer [i];
+	}
+
+	sector = (m_cacheTail + m_cacheFill) % m_numCacheSectors;
+
+	for (uint32_t i = first; i <= last; ++i) {
+		start = (i == first) ?
+			firstSector - (OGSS_Ulong) first * m_sectorsByZone : 0;
+		end = min < OGSS_Ulong > (m_sectorsByZone, firstSector + numSectors
+			- (OGSS_Ulong) i * m_sectorsByZone);
+
+		// The cached data is merged in the band when it is cleaned
+		m_writePointer [i] = max (m_writePointer [i], end);
+
+		if (inPlace) continue;
+
+		if (! (m_cachedSectors [i] & ZONE_QUEUED) ) {
+			m_cleanQueue [ (m_queueHead + m_queueSize) % m_numZones] = i;
+			m_queueSize ++;
+			m_cachedSectors [i] |= ZONE_QUEUED;
+		}
+
+		m_cachedSectors [i] += end - start;
+	}
+
+	if (inPlace)
+		return getPhysicalSector (firstSector);
+
+	m_cacheFill += numSectors;
+	m_cacheWrites += numSectors;
+
+	return sector;
+}
+
+OGSS_Bool
+ShingledZones::isCached (
+	const OGSS_Ulong		firstSector,
+	const OGSS_Ulong		numSectors) const {
+	uint32_t				first, last;
+
+	if (m_management == ZMT_HOST)
+		return false;
+
+	first = min < OGSS_Ulong > (firstSector / m_sectorsByZone,
+		m_numZones - 1);
+	last = min < OGSS_Ulong > ( (firstSector + max < OGSS_Ulong > (
+		numSectors, 1) - 1) / m_sectorsByZone, m_numZones - 1);
+
+	for (uint32_t i = first; i <= last; ++i)
+		if (m_cachedSectors [i] & ~ZONE_QUEUED)
+			return true;
+
+	return false;
+}
+
+void
+ShingledZones::reset (
+	const OGSS_Ulong		firstSector,
+	const OGSS_Ulong		numSectors) {
+	OGSS_Ulong				first, last;
+
+	first = (firstSector + m_sectorsByZone - 1) / m_sectorsByZone;
+	last = min < OGSS_Ulong > ( (firstSector + numSectors) / m_sectorsByZone,
+		m_numZones);
+
+	for (OGSS_Ulong i = first; i < last; ++i) {
+		if (m_writePointer [i] != 0) m_numResets ++;
+
+		m_writePointer [i] = 0;
+
+		// The dropped data stays in the media cache log until the cleaning
+		// reaches the zone, which stays in the cleaning queue
+		m_staleSectors [i] += m_cachedSectors [i] & ~ZONE_QUEUED;
+		m_cachedSectors [i] &= ZONE_QUEUED;
+	}
+}
+
+void
+ShingledZones::clean (
+	OGSS_Ulong				& firstSector,
+	OGSS_Ulong				& numSectors,
+	OGSS_Ulong				& cacheSector,
+	OGSS_Ulong				& cachedSectors) {
+	uint32_t				zone;
+
+	zone = m_cleanQueue [m_queueHead];
+	m_queueHead = (m_queueHead + 1) % m_numZones;
+	m_queueSize --;
+
+	cachedSectors = m_cachedSectors [zone] & ~ZONE_QUEUED;
+	m_cachedSectors [zone] = 0;
+
+	firstSector = getPhysicalSector ( (OGSS_Ulong) zone * m_sectorsByZone);
+	cacheSector = m_cacheTail;
+
+	// The log room of the zone is freed, its dropped data included
+	m_cacheTail = (m_cacheTail + cachedSectors + m_staleSectors [zone])
+		% m_numCacheSectors;
+	m_cacheFill -= cachedSectors + m_staleSectors [zone];
+	m_staleSectors [zone] = 0;
+
+	if (cachedSectors == 0) {
+		numSectors = 0;
+		return;
+	}
+
+	numSectors = m_writePointer [zone];
+
+	m_rewrittenSectors += numSectors;
+	m_cleanedBands ++;
+}
@@ -0,0 +1,554 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	volumecache.cpp
+ * @brief	VolumeCache is the controller cache placed in front of a volume.
+ * It keeps the last blocks accessed by the host with a LRU, ARC, 2Q or
+ * S3-FIFO replacement policy, and tells the volume driver whether a request
+ * is served by the cache or has to go down to the devices.
+ */
+
+#include "Structures/volumecache.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+
+#include "Utils/simexception.hpp"
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+const uint32_t				NIL_ENTRY = numeric_limits < uint32_t > ::max ();
+
+/**
+ * Lists of the cache entries. The first two lists hold the cached blocks,
+ * the last two the ghost entries, which only remember the block number:
+ * - LRU: CCL_FIRST;
+ * - ARC: T1, T2, B1 and B2;
+ * - 2Q: A1in, Am and A1out;
+ * - S3-FIFO: small FIFO, main FIFO and ghost FIFO.
+ */
+enum CacheList {
+	CCL_FIRST,
+	CCL_SECOND,
+	CCL_FIRSTGHOST,
+	CCL_SECONDGHOST
+};
+
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+VolumeCache::VolumeCache (
+	const Volume			& volume) {
+	ostringstream			oss ("");
+	OGSS_Ulong				capacity;
+	uint32_t				tableSize;
+
+	m_policy = volume.m_cachePolicy;
+	m_blockSize = volume.m_cacheBlockSize;
+
+	capacity = volume.m_cacheSize / m_blockSize;
+
+	if (capacity == 0 || capacity >= numeric_limits < uint32_t > ::max () / 4) {
+		oss << "The volume cache can not hold " << capacity << " blocks";
+		throw SimulatorException (ERR_ARCHITECTURE, oss.str () );
+	}
+
+	// The ghost entries of ARC, 2Q and S3-FIFO are bounded by the capacity
+	m_capacity = capacity;
+	m_numEntries = (m_policy == CPT_LRU) ? m_capacity : 2 * m_capacity;
+
+	// The index table is kept at most half full
+	tableSize = 2;
+	m_tableShift = 63;
+	while (tableSize < 2 * m_numEntries) {
+		tableSize <<= 1;
+		-- m_tableShift;
+	}
+	m_tableMask = tableSize - 1;
+
+	m_blocks = (uint64_t *) calloc (m_numEntries, sizeof (uint64_t) );
+	m_prev = (uint32_t *) calloc (m_numEntries, sizeof (uint32_t) );
+	m_next = (uint32_t *) calloc (m_numEntries, sizeof (uint32_t) );
+	m_list = (uint8_t *) calloc (m_numEntries, sizeof (uint8_t) );
+	m_frequency = (uint8_t *) calloc (m_numEntries, sizeof (uint8_t) );
+	m_table = (uint32_t *) calloc (tableSize, sizeof (uint32_t) );
+
+	if (! m_blocks || ! m_prev || ! m_next || ! m_list || ! m_frequency
+		|| ! m_table) {
+		oss << "Cannot allocate the volume cache index (" << m_capacity
+			<< " blocks)";
+		throw SimulatorException (ERR_SMALLOC, oss.str () );
+	}
+
+	for (uint32_t i = 0; i < m_numEntries; ++i)
+		m_next [i] = i + 1;
+	m_next [m_numEntries - 1] = NIL_ENTRY;
+	m_freeEntry = 0;
+
+	for (unsigned i = 0; i < 4; ++i) {
+		m_head [i] = NIL_ENTRY;
+		m_tail [i] = NIL_ENTRY;
+		m_length [i] = 0;
+	}
+	m_arcTarget = .0;
+
+	m_writeBack = volume.m_cacheWriteBack;
+	m_dirty = .0;
+	m_dirtyLimit = volume.m_cacheDirtyRatio * volume.m_cacheSize;
+	m_flushRate = volume.m_cacheFlushRate;
+	m_lastDate = .0;
+
+	m_numReads = 0;
+	m_numReadHits = 0;
+	m_numWrites = 0;
+	m_numAbsorbedWrites = 0;
+	m_numThrottledWrites = 0;
+	m_blockAccesses = 0;
+	m_blockHits = 0;
+	m_numEvictions = 0;
+	m_numGhostHits = 0;
+}
+
+VolumeCache::~VolumeCache () {
+	free (m_blocks);
+	free (m_prev);
+	free (m_next);
+	free (m_list);
+	free (m_frequency);
+	free (m_table);
+}
+
+OGSS_Bool
+VolumeCache::read (
+	const OGSS_Ulong		address,
+	const OGSS_Ulong		size) {
+	OGSS_Bool				hit = true;
+	uint64_t				last;
+
+	last = (address + max < OGSS_Ulong > (size, 1) - 1) / m_blockSize;
+
+	// Every block is accessed, so that the missing ones are loaded
+	for (uint64_t b = address / m_blockSize; b <= last; ++b)
+		if (! access (b) )
+			hit = false;
+
+	++ m_numReads;
+	if (hit) ++ m_numReadHits;
+
+	return hit;
+}
+
+OGSS_Bool
+VolumeCache::write (
+	const OGSS_Ulong		address,
+	const OGSS_Ulong		size,
+	const OGSS_Real			date) {
+	uint64_t				last;
+
+	last = (address + max < OGSS_Ulong > (size, 1) - 1) / m_blockSize;
+
+	for (uint64_t b = address / m_blockSize; b <= last; ++b)
+		access (b);
+
+	++ m_numWrites;
+
+	if (! m_writeBack)
+		return false;
+
+	// The dirty data is destaged in the background at the flush rate
+	if (date > m_lastDate) {
+		m_dirty = max (.0, m_dirty - (date - m_lastDate) * m_flushRate);
+		m_lastDate = date;
+	}
+
+	if (m_dirty + size > m_dirtyLimit) {
+		++ m_numThrottledWrites;
+		return false;
+	}
+
+	m_dirty += size;
+	++ m_numAbsorbedWrites;
+
+	return true;
+}
+
+void
+VolumeCache::trim (
+	const OGSS_Ulong		address,
+	const OGSS_Ulong		size) {
+	uint32_t				entry;
+	uint64_t				last;
+
+	last = (address + max < OGSS_Ulong > (size, 1) - 1) / m_blockSize;
+
+	for (uint64_t b = address / m_blockSize; b <= last; ++b) {
+		entry = lookup (b);
+		if (entry != NIL_ENTRY)
+			release (entry);
+	}
+}
+
+/**************************************/
+/* PRIVATE FUNCTIONS ******************/
+/**************************************/
+OGSS_Bool
+VolumeCache::access (
+	const uint64_t			block) {
+	OGSS_Bool				hit;
+
+	switch (m_policy) {
+		case CPT_ARC: hit = accessARC (block); break;
+		case CPT_2Q: hit = access2Q (block); break;
+		case CPT_S3FIFO: hit = accessS3FIFO (block); break;
+		case CPT_LRU: default: hit = accessLRU (block); break;
+	}
+
+	++ m_blockAccesses;
+	if (hit) ++ m_blockHits;
+
+	return hit;
+}
+
+OGSS_Bool
+VolumeCache::accessLRU (
+	const uint64_t			block) {
+	uint32_t				entry = lookup (block);
+
+	if (entry != NIL_ENTRY) {
+		unlink (entry);
+		pushHead (entry, CCL_FIRST);
+		return true;
+	}
+
+	if (m_length [CCL_FIRST] == m_capacity) {
+		release (m_tail [CCL_FIRST]);
+		++ m_numEvictions;
+	}
+
+	pushHead (allocate (block), CCL_FIRST);
+
+	return false;
+}
+
+OGSS_Bool
+VolumeCache::accessARC (
+	const uint64_t			block) {
+	uint32_t				entry = lookup (block);
+	uint32_t				total;
+
+	if (entry != NIL_ENTRY) {
+		if (m_list [entry] == CCL_FIRSTGHOST) {
+			++ m_numGhostHits;
+			m_arcTarget = min < OGSS_Real > (m_capacity, m_arcTarget
+				+ max < OGSS_Real > (1., (OGSS_Real) m_length [CCL_SECONDGHOST]
+				/ m_length [CCL_FIRSTGHOST]) );
+			replaceARC (false);
+		} else if (m_list [entry] == CCL_SECONDGHOST) {
+			++ m_numGhostHits;
+			m_arcTarget = max < OGSS_Real > (.0, m_arcTarget
+				- max < OGSS_Real > (1., (OGSS_Real) m_length [CCL_FIRSTGHOST]
+				/ m_length [CCL_SECONDGHOST]) );
+			replaceARC (true);
+		}
+
+		OGSS_Bool			hit = m_list [entry] < CCL_FIRSTGHOST;
+
+		unlink (entry);
+		pushHead (entry, CCL_SECOND);
+		return hit;
+	}
+
+	if (m_length [CCL_FIRST] + m_length [CCL_FIRSTGHOST] == m_capacity) {
+		if (m_length [CCL_FIRST] < m_capacity) {
+			release (m_tail [CCL_FIRSTGHOST]);
+			replaceARC (false);
+		} else {
+			release (m_tail [CCL_FIRST]);
+			++ m_numEvictions;
+		}
+	} else {
+		total = m_length [CCL_FIRST] + m_length [CCL_SECOND]
+			+ m_length [CCL_FIRSTGHOST] + m_length [CCL_SECONDGHOST];
+		if (total >= m_capacity) {
+			if (total >= 2 * m_capacity && m_length [CCL_SECONDGHOST] != 0)
+				release (m_tail [CCL_SECONDGHOST]);
+			replaceARC (false);
+		}
+	}
+
+	pushHead (allocate (block), CCL_FIRST);
+
+	return false;
+}
+
+OGSS_Bool
+VolumeCache::access2Q (
+	const uint64_t			block) {
+	uint32_t				entry = lookup (block);
+
+	if (entry != NIL_ENTRY) {
+		// A1in is a FIFO: a second access does not move the block
+		if (m_list [entry] == CCL_FIRST)
+			return true;
+
+		if (m_list [entry] == CCL_SECOND) {
+			unlink (entry);
+			pushHead (entry, CCL_SECOND);
+			return true;
+		}
+
+		// Found in A1out: the block goes to Am
+		++ m_numGhostHits;
+		unlink (entry);
+		reclaim2Q ();
+		pushHead (entry, CCL_SECOND);
+		return false;
+	}
+
+	reclaim2Q ();
+	pushHead (allocate (block), CCL_FIRST);
+
+	return false;
+}
+
+OGSS_Bool
+VolumeCache::accessS3FIFO (
+	const uint64_t			block) {
+	uint32_t				entry = lookup (block);
+
+	if (entry != NIL_ENTRY) {
+		if (m_list [entry] < CCL_FIRSTGHOST) {
+			if (m_frequency [entry] < 3) ++ m_frequency [entry];
+			return true;
+		}
+
+		// Found in the ghost FIFO: the block goes to the main FIFO
+		++ m_numGhostHits;
+		unlink (entry);
+		evictS3FIFO ();
+		m_frequency [entry] = 0;
+		pushHead (entry, CCL_SECOND);
+		return false;
+	}
+
+	evictS3FIFO ();
+	entry = allocate (block);
+	m_frequency [entry] = 0;
+	pushHead (entry, CCL_FIRST);
+
+	return false;
+}
+
+void
+VolumeCache::replaceARC (
+	const OGSS_Bool			ghostHit) {
+	uint32_t				entry;
+
+	if (m_length [CCL_FIRST] + m_length [CCL_SECOND] < m_capacity)
+		return;
+
+	if (m_length [CCL_FIRST] != 0
+		&& (m_length [CCL_FIRST] > m_arcTarget
+		|| (ghostHit && m_length [CCL_FIRST] == (uint32_t) m_arcTarget) ) ) {
+		entry = m_tail [CCL_FIRST];
+		unlink (entry);
+		pushHead (entry, CCL_FIRSTGHOST);
+	} else {
+		entry = m_tail [CCL_SECOND];
+		unlink (entry);
+		pushHead (entry, CCL_SECONDGHOST);
+	}
+
+	++ m_numEvictions;
+}
+
+void
+VolumeCache::reclaim2Q () {
+	uint32_t				entry;
+	uint32_t				maxIn = max < uint32_t > (1, m_capacity / 4);
+	uint32_t				maxOut = max < uint32_t > (1, m_capacity / 2);
+
+	if (m_length [CCL_FIRST] + m_length [CCL_SECOND] < m_capacity)
+		return;
+
+	if (m_length [CCL_FIRST] > maxIn || m_length [CCL_SECOND] == 0) {
+		entry = m_tail [CCL_FIRST];
+		unlink (entry);
+		pushHead (entry, CCL_FIRSTGHOST);
+
+		if (m_length [CCL_FIRSTGHOST] > maxOut)
+			release (m_tail [CCL_FIRSTGHOST]);
+	} else
+		release (m_tail [CCL_SECOND]);
+
+	++ m_numEvictions;
+}
+
+void
+VolumeCache::evictS3FIFO () {
+	uint32_t				entry;
+	uint32_t				maxSmall = max < uint32_t > (1, m_capacity / 10);
+
+	while (m_length [CCL_FIRST] + m_length [CCL_SECOND] >= m_capacity) {
+		if (m_length [CCL_FIRST] > maxSmall || m_length [CCL_SECOND] == 0) {
+			// The blocks accessed again in the small FIFO are kept
+			entry = m_tail [CCL_FIRST];
+			unlink (entry);
+
+			if (m_frequency [entry] > 0) {
+				m_frequency [entry] = 0;
+				pushHead (entry, CCL_SECOND);
+			} else {
+				pushHead (entry, CCL_FIRSTGHOST);
+				++ m_numEvictions;
+
+				if (m_length [CCL_FIRSTGHOST] > m_capacity)
+					release (m_tail [CCL_FIRSTGHOST]);
+			}
+		} else {
+			// The main FIFO reinserts the blocks accessed since their
+			// last pass
+			entry = m_tail [CCL_SECOND];
+
+			if (m_frequency [entry] > 0) {
+				-- m_frequency [entry];
+				unlink (entry);
+				pushHead (entry, CCL_SECOND);
+			} else {
+				release (entry);
+				++ m_numEvictions;
+			}
+		}
+	}
+}
+
+uint32_t
+VolumeCache::lookup (
+	const uint64_t			block) const {
+	uint32_t				slot = hash (block);
+
+	while (m_table [slot] != 0) {
+		if (m_blocks [m_table [slot] - 1] == block)
+			return m_table [slot] - 1;
+		slot = (slot + 1) & m_tableMask;
+	}
+
+	return NIL_ENTRY;
+}
+
+uint32_t
+VolumeCache::allocate (
+	const uint64_t			block) {
+	uint32_t				entry;
+	uint32_t				slot;
+
+	// Only the ghosts can exhaust the entries, drop the oldest one
+	if (m_freeEntry == NIL_ENTRY)
+		release (m_length [CCL_FIRSTGHOST] != 0 ?
+			m_tail [CCL_FIRSTGHOST] : m_tail [CCL_SECONDGHOST]);
+
+	entry = m_freeEntry;
+	m_freeEntry = m_next [entry];
+	m_blocks [entry] = block;
+
+	slot = hash (block);
+	while (m_table [slot] != 0)
+		slot = (slot + 1) & m_tableMask;
+	m_table [slot] = entry + 1;
+
+	return entry;
+}
+
+void
+VolumeCache::release (
+	const uint32_t			entry) {
+	uint32_t				slot;
+	uint32_t				next;
+	uint32_t				home;
+
+	unlink (entry);
+
+	slot = hash (m_blocks [entry]);
+	while (m_table [slot] != entry + 1)
+		slot = (slot + 1) & m_tableMask;
+
+	// Backward shift deletion: the following entries of the probe sequence
+	// are moved up, so that no tombstone is needed
+	next = slot;
+	while (true) {
+		next = (next + 1) & m_tableMask;
+		if (m_table [next] == 0) break;
+
+		home = hash (m_blocks [m_table [next] - 1]);
+		if ( (next > slot && (home <= slot || home > next) )
+			|| (next < slot && home <= slot && home > next) ) {
+			m_table [slot] = m_table [next];
+			slot = next;
+		}
+	}
+	m_table [slot] = 0;
+
+	m_next [entry] = m_freeEntry;
+	m_freeEntry = entry;
+}
+
+void
+VolumeCache::unlink (
+	const uint32_t			entry) {
+	uint8_t					list = m_list [entry];
+
+	if (m_prev [entry] != NIL_ENTRY)
+		m_next [m_prev [entry] ] = m_next [entry];
+	else
+		m_head [list] = m_next [entry];
+
+	if (m_next [entry] != NIL_ENTRY)
+		m_prev [m_next [entry] ] = m_prev [entry];
+	else
+		m_tail [list] = m_prev [entry];
+
+	-- m_length [list];
+}
+
+void
+VolumeCache::pushHead (
+	const uint32_t			entry,
+	const uint8_t			list) {
+	m_list [entry] = list;
+	m_prev [entry] = NIL_ENTRY;
+	m_next [entry] = m_head [list];
+
+	if (m_head [list] != NIL_ENTRY)
+		m_prev [m_head [list] ] = entry;
+	else
+		m_tail [list] = entry;
+
+	m_head [list] = entry;
+	++ m_length [list];
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	eventtrace.cpp
+ * @brief	EventTrace records the events of the computation models in a
+ * binary file, as fixed-size records.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <glog/logging.h>
+#include <sstream>
+
+#include "Utils/eventtrace.hpp"
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+static const unsigned		POLL_PERIOD		= 1;	// ms of wall time
+
+/**************************************/
+/* ATTRIBUTES *************************/
+/**************************************/
+unsigned					EventTrace::s_components = 0;
+atomic <OGSS_Bool>			EventTrace::s_running (false);
+thread						* EventTrace::s_writer = NULL;
+ofstream					EventTrace::s_file;
+mutex						EventTrace::s_mutex;
+vector <unique_ptr <EventTrace::Ring> >	EventTrace::s_rings;
+thread_local EventTrace::Ring	* EventTrace::t_ring = NULL;
+
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+void
+EventTrace::start (
+	const OGSS_String		& output,
+	const unsigned			components) {
+	TraceHeader				header;
+
+	if (s_writer != NULL || components == 0) return;
+
+	s_file.open (output.c_str (), ios::binary | ios::trunc);
+	if (! s_file.is_open () )
+	{
+		LOG(WARNING) << "There is a problem opening the trace file " << output
+			<< ", the events are not traced";
+		return;
+	}
+
+	memcpy (header.m_magic, TRACE_MAGIC, sizeof (header.m_magic) );
+	header.m_version = TRACE_VERSION;
+	header.m_recordSize = sizeof (TraceRecord);
+	s_file.write ((const char *) &header, sizeof (TraceHeader) );
+
+	s_running = true;
+	s_writer = new thread (&EventTrace::write);
+
+	s_components = components;
+}
+
+void
+EventTrace::stop () {
+	if (s_writer == NULL) return;
+
+	s_components = 0;
+
+	s_running = false;
+	s_writer->join ();
+
+	delete s_writer;
+	s_writer = NULL;
+
+	s_file.close ();
+}
+
+unsigned
+EventTrace::parseComponents (
+	const OGSS_String		& components) {
+	istringstream			iss (components);
+	OGSS_String				name;
+	unsigned				mask = 0;
+
+	while (getline (iss, name, ',') )
+	{
+		name.erase (0, name.find_first_not_of (" \t") );
+		name.erase (name.find_last_not_of (" \t") + 1);
+
+		if (name == "bus")
+			mask |= 1u << TRC_BUS;
+		else if (name == "device")
+			mask |= 1u << TRC_DEVICE;
+		else if (name == "qos")
+			mask |= 1u << TRC_QOS;
+		else if (name == "all")
+			mask |= (1u << TRC_TOTAL) - 1;
+		else if (! name.empty () )
+			LOG(WARNING) << "The trace component '" << name
+				<< "' is not known";
+	}
+
+	return mask;
+}
+
+/**************************************/
+/* PRIVATE FUNCTIONS ******************/
+/**************************************/
+EventTrace::Ring *
+EventTrace::registerThread () {
+	lock_guard <mutex>		lock (s_mutex);
+	Ring					* ring = new Ring;
+
+	ring->m_head = 0;
+	ring->m_tail = 0;
+	ring->m_thread = s_rings.size ();
+
+	s_rings.push_back (unique_ptr <Ring> (ring) );
+	t_ring = ring;
+
+	return ring;
+}
+
+void
+EventTrace::write () {
+	while (s_running.load (memory_order_acquire) )
+	{
+		if (! drain () )
+			this_thread::sleep_for (chrono::milliseconds (POLL_PERIOD) );
+	}
+
+	// The records written before the stop are all drained
+	drain ();
+}
+
+OGSS_Bool
+EventTrace::drain () {
+	lock_guard <mutex>		lock (s_mutex);
+	OGSS_Bool				written = false;
+	OGSS_Ulong				head;
+	OGSS_Ulong				tail;
+	OGSS_Ulong				length;
+
+	for (unsigned i = 0; i < s_rings.size (); ++i)
+	{
+		Ring				* ring = s_rings [i] .get ();
+
+		tail = ring->m_tail.load (memory_order_relaxed);
+		head = ring->m_head.load (memory_order_acquire);
+
+		while (tail != head)
+		{
+			// The records are contiguous until the end of the ring
+			length = min (head - tail, RING_SIZE - tail % RING_SIZE);
+			s_file.write ((const char *) &ring->m_records [tail % RING_SIZE],
+				length * sizeof (TraceRecord) );
+			tail += length;
+		}
+
+		if (ring->m_tail.load (memory_order_relaxed) != tail)
+		{
+			ring->m_tail.store (tail, memory_order_release);
+			written = true;
+		}
+	}
+
+	return written;
+}
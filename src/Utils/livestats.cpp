@@ -0,0 +1,269 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+
+/**
+ * @file	livestats.cpp
+ * @brief	LiveStats gathers statistics while the simulation runs and
+ * publishes them periodically, in JSON lines, to a file or a ZMQ socket.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <glog/logging.h>
+#include <sstream>
+
+#include <zmq.hpp>
+
+#include "Utils/livestats.hpp"
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+static const unsigned		POLL_PERIOD		= 10;	// ms of wall time
+
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+LiveStats::LiveStats (
+	const OGSS_Ushort		numDevices,
+	const OGSS_Real			interval,
+	const OGSS_String		& output) {
+	m_numDevices = numDevices;
+	m_interval = interval;
+	m_output = output;
+
+	m_numCompleted = 0;
+	m_numFaulty = 0;
+	m_simulatedTime = .0;
+	m_nextSnapshot = m_interval;
+	m_lastCompleted = 0;
+
+	for (unsigned i = 0; i < NUM_BUCKETS; ++i)
+	{
+		m_histogram [i] = 0;
+		m_lastHistogram [i] = 0;
+	}
+
+	m_deviceTime.assign (m_numDevices, .0);
+
+	m_snapshots.resize (RING_SIZE);
+	for (unsigned i = 0; i < RING_SIZE; ++i)
+		m_snapshots [i] .m_deviceTime.resize (m_numDevices);
+
+	m_head = 0;
+	m_tail = 0;
+
+	m_running = false;
+	m_publisher = NULL;
+}
+
+LiveStats::~LiveStats () {
+	stop ();
+}
+
+void
+LiveStats::start () {
+	if (m_publisher != NULL) return;
+
+	m_running = true;
+	m_publisher = new thread (&LiveStats::publish, this);
+}
+
+void
+LiveStats::stop () {
+	if (m_publisher == NULL) return;
+
+	// A last snapshot is always written, for the whole simulation
+	pushSnapshot (m_simulatedTime);
+
+	m_running.store (false, memory_order_release);
+	m_publisher->join ();
+
+	delete m_publisher;
+	m_publisher = NULL;
+}
+
+/**************************************/
+/* PRIVATE FUNCTIONS ******************/
+/**************************************/
+void
+LiveStats::takeSnapshots (
+	const OGSS_Real			date) {
+	while (m_nextSnapshot <= date)
+	{
+		pushSnapshot (m_nextSnapshot);
+		m_nextSnapshot += m_interval;
+	}
+}
+
+void
+LiveStats::pushSnapshot (
+	const OGSS_Real			date) {
+	OGSS_Ulong				head = m_head.load (memory_order_relaxed);
+
+	// Only waits if the publisher is late by RING_SIZE intervals
+	while (head - m_tail.load (memory_order_acquire) >= RING_SIZE)
+		this_thread::yield ();
+
+	Snapshot				& snapshot = m_snapshots [head % RING_SIZE];
+
+	snapshot.m_date = date;
+	snapshot.m_numCompleted = m_numCompleted;
+	snapshot.m_numFaulty = m_numFaulty;
+
+	for (unsigned i = 0; i < NUM_BUCKETS; ++i)
+		snapshot.m_histogram [i] = m_histogram [i];
+
+	for (OGSS_Ushort i = 0; i < m_numDevices; ++i)
+		snapshot.m_deviceTime [i] = m_deviceTime [i];
+
+	m_head.store (head + 1, memory_order_release);
+}
+
+void
+LiveStats::publish () {
+	OGSS_Bool				remote;
+	OGSS_Bool				last = false;
+	OGSS_Ulong				tail;
+	ofstream				file;
+	ostringstream			oss;
+	int						zero = 0;
+
+	remote = m_output.compare (0, 6, "ipc://") == 0
+		|| m_output.compare (0, 6, "tcp://") == 0;
+
+	// The socket is created here since 0MQ sockets stay in their thread
+	zmq::context_t			context (1);
+	zmq::socket_t			socket (context, ZMQ_PUB);
+
+	if (remote)
+	{
+		socket.setsockopt (ZMQ_SNDHWM, &zero, sizeof (int) );
+		socket.bind (m_output.c_str () );
+	}
+	else
+	{
+		file.open (m_output.c_str () );
+		if (! file.is_open () )
+			DLOG(ERROR) << "There is a problem opening the file " << m_output;
+	}
+
+	while (! last)
+	{
+		// The snapshots taken before the stop are all written
+		last = ! m_running.load (memory_order_acquire);
+
+		for (tail = m_tail.load (memory_order_relaxed);
+			tail != m_head.load (memory_order_acquire); ++tail)
+		{
+			oss.str ("");
+			writeSnapshot (oss, m_snapshots [tail % RING_SIZE]);
+			m_tail.store (tail + 1, memory_order_release);
+
+			if (remote)
+			{
+				zmq::message_t	msg (oss.str () .size () );
+				memcpy (msg.data (), oss.str () .data (), oss.str () .size () );
+				socket.send (msg);
+			}
+			else
+				file << oss.str () << endl;
+		}
+
+		if (! last)
+			this_thread::sleep_for (chrono::milliseconds (POLL_PERIOD) );
+	}
+
+	if (remote)
+		socket.close ();
+	else
+		file.close ();
+}
+
+void
+LiveStats::writeSnapshot (
+	ostream					& stream,
+	const Snapshot			& snapshot) {
+	OGSS_Ulong				window [NUM_BUCKETS];
+	OGSS_Ulong				numLatencies = 0;
+	OGSS_Ulong				numWindow = 0;
+
+	for (unsigned i = 0; i < NUM_BUCKETS; ++i)
+	{
+		window [i] = snapshot.m_histogram [i] - m_lastHistogram [i];
+		m_lastHistogram [i] = snapshot.m_histogram [i];
+
+		numLatencies += snapshot.m_histogram [i];
+		numWindow += window [i];
+	}
+
+	stream << "{\"simtime\":" << snapshot.m_date
+		<< ",\"completed\":" << snapshot.m_numCompleted
+		<< ",\"faulty\":" << snapshot.m_numFaulty
+		<< ",\"latency\":{\"p50\":" << searchPercentile (snapshot.m_histogram,
+			numLatencies, .5)
+		<< ",\"p90\":" << searchPercentile (snapshot.m_histogram, numLatencies,
+			.9)
+		<< ",\"p99\":" << searchPercentile (snapshot.m_histogram, numLatencies,
+			.99)
+		<< "},\"window\":{\"completed\":"
+		<< snapshot.m_numCompleted - m_lastCompleted
+		<< ",\"p50\":" << searchPercentile (window, numWindow, .5)
+		<< ",\"p90\":" << searchPercentile (window, numWindow, .9)
+		<< ",\"p99\":" << searchPercentile (window, numWindow, .99)
+		<< "},\"utilization\":[";
+
+	for (OGSS_Ushort i = 0; i < m_numDevices; ++i)
+	{
+		if (i != 0) stream << ",";
+		stream << (snapshot.m_date > .0 ?
+			snapshot.m_deviceTime [i] / snapshot.m_date : .0);
+	}
+
+	stream << "]}";
+
+	m_lastCompleted = snapshot.m_numCompleted;
+}
+
+OGSS_Real
+LiveStats::searchPercentile (
+	const OGSS_Ulong		* histogram,
+	const OGSS_Ulong		total,
+	const OGSS_Real			percentile) {
+	OGSS_Ulong				count = 0;
+
+	if (total == 0) return .0;
+
+	for (unsigned i = 0; i < NUM_BUCKETS; ++i)
+	{
+		count += histogram [i];
+		if (count >= percentile * total)
+			return ldexp (1., i) / 1000;
+	}
+
+	return ldexp (1., NUM_BUCKETS - 1) / 1000;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+
+/**
+ * @file	stagetimer.cpp
+ * @brief	StageTimer accumulates the wall time spent in each stage of the
+ * simulation, so that benchmarks can see where the time goes.
+ */
+
+#include <fstream>
+#include <glog/logging.h>
+
+#include "Utils/stagetimer.hpp"
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+static const char			* STAGE_NAMES [STG_TOTAL] = {
+	"load", "preprocessing", "decomposition", "execution", "output" };
+
+atomic <OGSS_Bool>			StageTimer::m_enabled (false);
+atomic <int64_t>			StageTimer::m_times [STG_TOTAL];
+
+/**************************************/
+/* PUBLIC FUNCTIONS *******************/
+/**************************************/
+void
+StageTimer::enable () {
+	for (int i = 0; i < STG_TOTAL; ++i)
+		m_times [i] = 0;
+
+	m_enabled = true;
+}
+
+void
+StageTimer::add (
+	const StageType			stage,
+	const int64_t			time) {
+	if (! isEnabled () ) return;
+
+	m_times [stage] .fetch_add (time, memory_order_relaxed);
+}
+
+void
+StageTimer::write (
+	const OGSS_String		& filename) {
+	ofstream				file (filename.c_str () );
+
+	if (! file.is_open () )
+	{
+		DLOG(ERROR) << "There is a problem opening the file " << filename;
+		return;
+	}
+
+	file << "{";
+
+	for (int i = 0; i < STG_TOTAL; ++i)
+	{
+		if (i != 0) file << ",";
+		file << "\"" << STAGE_NAMES [i] << "_us\":" << m_times [i] .load ();
+	}
+
+	file << "}" << endl;
+
+	file.close ();
+}
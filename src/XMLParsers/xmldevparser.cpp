@@ -28,11 +28,30 @@
  */
 
 #include <glog/logging.h>
+#include <map>
 
 #include "Structures/architecture.hpp"
 #include "Utils/simexception.hpp"
 #include "XMLParsers/xmlparser.hpp"
 
+const std::map < OGSS_String, QueuePolicyType >	queuePolicyMap =
+	{ {"fifo", QPT_FIFO},
+	  {"sstf", QPT_SSTF},
+	  {"clook", QPT_CLOOK},
+	  {"satf", QPT_SATF} };
+
+const std::map < OGSS_String, GCPolicyType >	gcPolicyMap =
+	{ {"greedy", GCP_GREEDY},
+	  {"costbenefit", GCP_COSTBENEFIT} };
+
+const std::map < OGSS_String, ZoneManagementType >	zoneManagementMap =
+	{ {"drive", ZMT_DRIVE},
+	  {"host", ZMT_HOST} };
+
+const std::map < OGSS_String, ArbitrationType >	arbitrationMap =
+	{ {"rr", ABT_RR},
+	  {"wrr", ABT_WRR} };
+
 OGSS_Real
 convertIopsToMillisecond (
 	OGSS_Real				numOps,
@@ -51,6 +70,29 @@ convertRpmToMillisecond (
 	OGSS_Real				rpm)
 	{ return 60000 / rpm; }
 
+QueuePolicyType
+extractNCQPolicy (
+	xercesc::DOMNode		* node) {
+	OGSS_String				policyName;
+	std::map < OGSS_String, QueuePolicyType > ::const_iterator
+							map_iter;
+
+	policyName = XMLParser::get_string (node, "ncqpolicy", true, true);
+
+	if (policyName.compare ("und") == 0)
+		return QPT_FIFO;
+
+	map_iter = queuePolicyMap.find (policyName);
+
+	if (map_iter == queuePolicyMap.end () ) {
+		LOG(WARNING) << "Unknown NCQ policy '" << policyName
+			<< "', FIFO is used";
+		return QPT_FIFO;
+	}
+
+	return map_iter->second;
+}
+
 void
 extractHDDInformationParameters (
 	xercesc::DOMNode		* parent,
@@ -59,10 +101,69 @@ extractHDDInformationParameters (
 		XMLParser::get_long (parent, "capacity", false, false) * GIGABYTE;
 }
 
+void
+extractHDDZones (
+	xercesc::DOMNode		* parent,
+	HDDDevice				& device) {
+	xercesc::DOMNodeList	* list;
+	xercesc::DOMNode		* node;
+	ZoneTable				* table;
+	Zone					zone;
+	OGSS_Ulong				numTracks;
+	char					* tmp;
+
+	table = new ZoneTable ();
+	table->m_numTracks = 0;
+	table->m_numSectors = 0;
+
+	list = parent->getChildNodes ();
+
+	for (XMLSize_t idx = 0; idx < list->getLength (); ++idx)
+	{
+		node = list->item (idx);
+		tmp = xercesc::XMLString::transcode (node->getNodeName () );
+
+		if (OGSS_String ("zone") .compare (tmp) == 0)
+		{
+			numTracks = XMLParser::get_long (node, "tracks", true, false);
+
+			zone.m_firstTrack = table->m_numTracks;
+			zone.m_firstSector = table->m_numSectors;
+			zone.m_sectorsByTrack =
+				XMLParser::get_long (node, "sectorsbytrack", true, false);
+			zone.m_mediaTransferRate =
+				XMLParser::get_real (node, "transferrate", true, true);
+
+			if (numTracks != 0 && zone.m_sectorsByTrack != 0)
+			{
+				table->m_zones.push_back (zone);
+				table->m_numTracks += numTracks;
+				table->m_numSectors += numTracks * zone.m_sectorsByTrack;
+			}
+		}
+
+		xercesc::XMLString::release (&tmp);
+	}
+
+	if (table->m_zones.empty () )
+	{
+		delete table;
+		throw SimulatorException (ERR_XMLPARSER,
+			"The zone list of the device is empty");
+	}
+
+	// The zones replace the uniform geometry
+	device.m_zoneTable = table;
+	device.m_tracksByPlatter = table->m_numTracks;
+	device.m_numCylinders = table->m_numTracks;
+}
+
 void
 extractHDDGeometryParameters (
 	xercesc::DOMNode		* parent,
 	HDDDevice				& device) {
+	xercesc::DOMNode		* node;
+
 	device.m_sectorSize =
 		XMLParser::get_long (parent, "sectorsize", false, false);
 	device.m_sectorsByTrack =
@@ -76,15 +177,32 @@ extractHDDGeometryParameters (
 
 	device.m_trackPosition = 0;
 	device.m_headPosition = 0;
+	device.m_transferEnd = .0;
+	device.m_seekCurve = NULL;
 
 	device.m_numCylinders = device.m_tracksByPlatter;
+	device.m_zoneTable = NULL;
+
+	device.m_smrManagement = ZMT_DRIVE;
+	device.m_smrZoneSize = 0;
+	device.m_smrMediaCacheSize = 0;
+	device.m_smrCleaningThreshold = .0;
+	device.m_smrZones = NULL;
+
+	node = XMLParser::recursive_get_node (parent, "zones", false);
+	if (node != NULL)
+		extractHDDZones (node, device);
 
 #ifdef __UTOPICTEST__
 	device.m_numSectors =
 		XMLParser::get_long (parent, "nbsectors", false, false);
 #else
-	device.m_numSectors = device.m_sectorsByTrack * device.m_tracksByPlatter
-		* device.m_numPlatters;
+	if (device.m_zoneTable != NULL)
+		device.m_numSectors = device.m_zoneTable->m_numSectors
+			* device.m_numPlatters;
+	else
+		device.m_numSectors = (OGSS_Ulong) device.m_sectorsByTrack
+			* device.m_tracksByPlatter * device.m_numPlatters;
 #endif
 }
 
@@ -96,9 +214,11 @@ void extractHDDTechnologyParameters (
 	node = XMLParser::get_node (parent, "ata");
 	device.m_ataExtended = XMLParser::get_bool (node, "extended", true, true);
 	device.m_ataNCQ = XMLParser::get_bool (node, "ncq", true, true);
-	if (device.m_ataNCQ)
+	if (device.m_ataNCQ) {
 		device.m_ataNCQDepth =
 			XMLParser::get_long (node, "ncqdepth", true, true);
+		device.m_ataNCQPolicy = extractNCQPolicy (node);
+	}
 
 	node = XMLParser::get_node (parent, "sata");
 	device.m_sataBandwidth =
@@ -170,6 +290,55 @@ extractHDDParameters (
 	extractHDDReliabilityParameters (node, device);
 }
 
+void
+extractSMRParameters (
+	xercesc::DOMNode		* node,
+	HDDDevice				& device) {
+	OGSS_String				value;
+	std::map < OGSS_String, ZoneManagementType > ::const_iterator
+							map_iter;
+
+	device.m_smrZoneSize = 256 * MEGABYTE;
+
+	if (node != NULL) {
+		value = XMLParser::get_string (node, "management", true, true);
+
+		if (value.compare ("und") != 0) {
+			map_iter = zoneManagementMap.find (value);
+
+			if (map_iter == zoneManagementMap.end () )
+				LOG(WARNING) << "Unknown SMR management '" << value
+					<< "', drive-managed is used";
+			else
+				device.m_smrManagement = map_iter->second;
+		}
+
+		if (XMLParser::get_long (node, "zonesize", true, true) != 0)
+			device.m_smrZoneSize =
+				XMLParser::get_long (node, "zonesize", true, true) * MEGABYTE;
+		device.m_smrMediaCacheSize =
+			XMLParser::get_long (node, "mediacache", true, true) * MEGABYTE;
+		device.m_smrCleaningThreshold =
+			XMLParser::get_real (node, "cleaning", true, true);
+	}
+
+	if (device.m_smrCleaningThreshold <= 0
+		|| device.m_smrCleaningThreshold > 1)
+		device.m_smrCleaningThreshold = .9;
+
+	if (device.m_smrManagement == ZMT_HOST) {
+		device.m_smrMediaCacheSize = 0;
+		return;
+	}
+
+	// 1% of the device by default, hidden from the host
+	if (device.m_smrMediaCacheSize == 0)
+		device.m_smrMediaCacheSize = device.m_numSectors
+			* device.m_sectorSize / 100;
+
+	device.m_numSectors -= device.m_smrMediaCacheSize / device.m_sectorSize;
+}
+
 void
 extractSSDInformationParameters (
 	xercesc::DOMNode		* parent,
@@ -192,6 +361,12 @@ extractSSDGeometryParameters (
 
 	device.m_numDies =
 		XMLParser::get_long (parent, "nbdies", false, false);
+	device.m_numChannels =
+		XMLParser::get_long (parent, "nbchannels", false, true);
+
+	device.m_dieClock = NULL;
+	device.m_channelClock = NULL;
+	device.m_nvme = NULL;
 
 	// USED FOR TESTS
 #ifdef __UTOPICTEST__
@@ -206,6 +381,39 @@ extractSSDGeometryParameters (
 #endif
 }
 
+void
+extractSSDFTLParameters (
+	xercesc::DOMNode		* node,
+	SSDDevice				& device) {
+	OGSS_String				policyName;
+	std::map < OGSS_String, GCPolicyType > ::const_iterator
+							map_iter;
+
+	device.m_overprovisioning =
+		XMLParser::get_real (node, "overprovisioning", true, true);
+	if (device.m_overprovisioning <= 0 || device.m_overprovisioning >= 1)
+		device.m_overprovisioning = .07;
+
+	device.m_gcThreshold =
+		XMLParser::get_real (node, "gcthreshold", true, true);
+
+	device.m_gcPolicy = GCP_GREEDY;
+	policyName = XMLParser::get_string (node, "gcpolicy", true, true);
+
+	if (policyName.compare ("und") != 0) {
+		map_iter = gcPolicyMap.find (policyName);
+
+		if (map_iter == gcPolicyMap.end () )
+			LOG(WARNING) << "Unknown GC policy '" << policyName
+				<< "', greedy is used";
+		else
+			device.m_gcPolicy = map_iter->second;
+	}
+
+	// The spare pages are hidden from the host
+	device.m_numPages *= 1 - device.m_overprovisioning;
+}
+
 void
 extractSSDTechnologyParameters (
 	xercesc::DOMNode		* parent,
@@ -216,9 +424,11 @@ extractSSDTechnologyParameters (
 
 	device.m_ataExtended = XMLParser::get_bool (node, "extended", true, true);
 	device.m_ataNCQ = XMLParser::get_bool (node, "ncq", true, true);
-	if (device.m_ataNCQ)
+	if (device.m_ataNCQ) {
 		device.m_ataNCQDepth =
 			XMLParser::get_long (node, "ncqdepth", true, true);
+		device.m_ataNCQPolicy = extractNCQPolicy (node);
+	}
 
 	node = XMLParser::get_node (parent, "sata");
 	device.m_sataBandwidth =
@@ -229,6 +439,103 @@ extractSSDTechnologyParameters (
 		XMLParser::get_bool (node, "trim", true, true);
 	device.m_advanceMultiPlane =
 		XMLParser::get_bool (node, "multiplane", true, true);
+
+	device.m_overprovisioning = .0;
+	device.m_gcPolicy = GCP_GREEDY;
+	device.m_gcThreshold = .0;
+	device.m_ftl = NULL;
+
+	node = XMLParser::recursive_get_node (parent, "ftl", false);
+	if (node != NULL)
+		extractSSDFTLParameters (node, device);
+}
+
+void
+extractNVMeQueueParameters (
+	xercesc::DOMNode		* node,
+	SSDDevice				& device) {
+	OGSS_String				value;
+	std::map < OGSS_String, ArbitrationType > ::const_iterator
+							map_iter;
+
+	device.m_nvmeNumQueues = XMLParser::get_long (node, "queues", true, true);
+	if (device.m_nvmeNumQueues == 0)
+		device.m_nvmeNumQueues = 1;
+	device.m_nvmeQueueDepth =
+		XMLParser::get_long (node, "queuedepth", true, true);
+	if (device.m_nvmeQueueDepth == 0)
+		device.m_nvmeQueueDepth = 1024;
+
+	device.m_nvmeArbitration = ABT_RR;
+	value = XMLParser::get_string (node, "arbitration", true, true);
+
+	if (value.compare ("und") != 0) {
+		map_iter = arbitrationMap.find (value);
+
+		if (map_iter == arbitrationMap.end () )
+			LOG(WARNING) << "Unknown NVMe arbitration '" << value
+				<< "', round robin is used";
+		else
+			device.m_nvmeArbitration = map_iter->second;
+	}
+
+	device.m_nvmeHighQueues =
+		XMLParser::get_long (node, "highqueues", true, true);
+	device.m_nvmeMediumQueues =
+		XMLParser::get_long (node, "mediumqueues", true, true);
+	device.m_nvmeWeights [0] =
+		XMLParser::get_long (node, "highweight", true, true);
+	device.m_nvmeWeights [1] =
+		XMLParser::get_long (node, "mediumweight", true, true);
+	device.m_nvmeWeights [2] =
+		XMLParser::get_long (node, "lowweight", true, true);
+	if (device.m_nvmeWeights [0] == 0) device.m_nvmeWeights [0] = 4;
+	if (device.m_nvmeWeights [1] == 0) device.m_nvmeWeights [1] = 2;
+	if (device.m_nvmeWeights [2] == 0) device.m_nvmeWeights [2] = 1;
+
+	// Given in us
+	device.m_nvmeCommandTime =
+		XMLParser::get_real (node, "commandtime", true, true) * MILLISEC;
+
+	device.m_nvmeLanes = XMLParser::get_long (node, "lanes", true, true);
+	if (device.m_nvmeLanes == 0)
+		device.m_nvmeLanes = 4;
+	device.m_nvmeLaneBandwidth =
+		XMLParser::get_real (node, "lanebandwidth", true, true);
+	if (device.m_nvmeLaneBandwidth <= 0)
+		device.m_nvmeLaneBandwidth = 985;
+}
+
+void
+extractNVMeTechnologyParameters (
+	xercesc::DOMNode		* parent,
+	SSDDevice				& device) {
+	xercesc::DOMNode		* node;
+
+	// The submission queues replace the ATA command queue
+	device.m_ataExtended = false;
+	device.m_ataNCQ = false;
+	device.m_ataNCQDepth = 0;
+	device.m_ataNCQPolicy = QPT_FIFO;
+	device.m_sataBandwidth = 0;
+
+	node = XMLParser::recursive_get_node (parent, "advcommands", false);
+	device.m_advanceTRIM = (node != NULL)
+		&& XMLParser::get_bool (node, "trim", true, true);
+	device.m_advanceMultiPlane = (node != NULL)
+		&& XMLParser::get_bool (node, "multiplane", true, true);
+
+	device.m_overprovisioning = .0;
+	device.m_gcPolicy = GCP_GREEDY;
+	device.m_gcThreshold = .0;
+	device.m_ftl = NULL;
+
+	node = XMLParser::recursive_get_node (parent, "ftl", false);
+	if (node != NULL)
+		extractSSDFTLParameters (node, device);
+
+	node = XMLParser::get_node (parent, "nvme");
+	extractNVMeQueueParameters (node, device);
 }
 
 void
@@ -325,6 +632,10 @@ extractSSDPerformanceParameters (
 	}
 	
 	device.m_eraseTime = XMLParser::get_real (parent, "erase", false, true);
+
+	tmp = XMLParser::get_real (parent, "channelbandwidth", false, true);
+	device.m_channelTime = (tmp > 0) ?
+		convertMbpsToMillisecond (tmp, device.m_pageSize) : .0;
 	bufferSize = XMLParser::get_long (parent, "buffersize", false, true) * MEGABYTE;
 }
 
@@ -362,6 +673,65 @@ extractSSDParameters (
 	extractSSDReliabilityParameters (node, device);
 }
 
+void
+extractNVMeParameters (
+	xercesc::DOMNode		* parent,
+	SSDDevice				& device,
+    OGSS_Ulong              & bufferSize) {
+	xercesc::DOMNode		* node;
+
+	node = XMLParser::get_node (parent, "information");
+	extractSSDInformationParameters (node, device);
+
+	node = XMLParser::get_node (parent, "geometry");
+	extractSSDGeometryParameters (node, device);
+
+	// The dies always work concurrently
+	if (device.m_numChannels == 0)
+		device.m_numChannels = device.m_numDies;
+
+	node = XMLParser::get_node (parent, "technology");
+	extractNVMeTechnologyParameters (node, device);
+
+	node = XMLParser::get_node (parent, "performance");
+	extractSSDPerformanceParameters (node, device, bufferSize);
+
+	node = XMLParser::get_node (parent, "reliability");
+	extractSSDReliabilityParameters (node, device);
+}
+
+void
+extractCacheParameters (
+	xercesc::DOMNode		* node,
+	Device					& device) {
+	OGSS_String				value;
+
+	device.m_cacheSegmentSize =
+		XMLParser::get_long (node, "segmentsize", true, true) * 1024;
+	if (device.m_cacheSegmentSize == 0)
+		device.m_cacheSegmentSize = 64 * 1024;
+
+	// The HDDs read the next segment by default
+	value = XMLParser::get_string (node, "readahead", true, true);
+	if (value.compare ("und") == 0)
+		device.m_cacheReadAhead = device.isFlash () ? 0 : 1;
+	else
+		device.m_cacheReadAhead =
+			XMLParser::get_long (node, "readahead", true, true);
+
+	device.m_cacheWriteBack =
+		XMLParser::get_string (node, "writeback", true, true)
+		.compare ("off") != 0;
+
+	device.m_cacheLatency = XMLParser::get_real (node, "latency", true, true);
+
+	if (device.m_bufferSize == 0) {
+		LOG(WARNING) << "The device cache needs a buffer size, it is not "
+			<< "modeled";
+		device.m_cacheSegmentSize = 0;
+	}
+}
+
 Device
 XMLParser::getDeviceConfiguration (
 	const OGSS_String		filename) {
@@ -370,6 +740,9 @@ XMLParser::getDeviceConfiguration (
 	OGSS_String				type;
 	std::ostringstream		oss ("");
 
+	dev.m_parallel = false;
+	dev.m_cacheSegmentSize = 0;
+
 	xercesc::XercesDOMParser * parser = new xercesc::XercesDOMParser ();
 
 	try
@@ -384,10 +757,25 @@ XMLParser::getDeviceConfiguration (
 			dev.m_type = DVT_HDD;
 			extractHDDParameters (node, dev.m_hardware.m_hdd, dev.m_bufferSize);
 		}
+		else if (type.compare ("smr") == 0)
+		{
+			dev.m_type = DVT_SMR;
+			extractHDDParameters (node, dev.m_hardware.m_hdd, dev.m_bufferSize);
+			extractSMRParameters (XMLParser::recursive_get_node (
+				XMLParser::get_node (node, "technology"), "smr", false),
+				dev.m_hardware.m_hdd);
+		}
 		else if (type.compare ("ssd") == 0)
 		{
 			dev.m_type = DVT_SSD;
 			extractSSDParameters (node, dev.m_hardware.m_ssd, dev.m_bufferSize);
+			dev.m_parallel = dev.m_hardware.m_ssd.m_numChannels != 0;
+		}
+		else if (type.compare ("nvme") == 0)
+		{
+			dev.m_type = DVT_NVME;
+			extractNVMeParameters (node, dev.m_hardware.m_ssd, dev.m_bufferSize);
+			dev.m_parallel = true;
 		}
 		else
 		{
@@ -395,6 +783,11 @@ XMLParser::getDeviceConfiguration (
 
 			throw SimulatorException (ERR_XMLPARSER, oss.str () );
 		}
+
+		node = XMLParser::recursive_get_node (
+			XMLParser::get_node (node, "performance"), "cache", false);
+		if (node != NULL)
+			extractCacheParameters (node, dev);
 	}
 	catch (const SimulatorException & ex)
 	{
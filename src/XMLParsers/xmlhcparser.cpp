@@ -27,12 +27,18 @@
  * for the hardware configuration file parser.
  */
 
+#include <climits>
+#include <cstdlib>
 #include <glog/logging.h>
 #include <iostream>
 #include <map>
 #include <sstream>
 
 #include "Structures/architecture.hpp"
+#include "Structures/fabric.hpp"
+#include "Structures/ftl.hpp"
+#include "Structures/nvmecontroller.hpp"
+#include "Structures/shingledzones.hpp"
 #include "Utils/simexception.hpp"
 #include "XMLParsers/xmlparser.hpp"
 
@@ -66,6 +72,17 @@ const std::map < OGSS_String, DeclusteredRaidType >	drTypeMap =
 	{ {"sd2s", DRT_SD2S},
 	  {"crush", DRT_CRUSH} };
 
+const std::map < OGSS_String, CachePolicyType >		cachePolicyMap =
+	{ {"lru", CPT_LRU},
+	  {"arc", CPT_ARC},
+	  {"2q", CPT_2Q},
+	  {"s3fifo", CPT_S3FIFO} };
+
+const std::map < OGSS_String, FabricNodeType >	fabricNodeMap =
+	{ {"host", FNT_HOST},
+	  {"switch", FNT_SWITCH},
+	  {"target", FNT_TARGET} };
+
 void get_busesInformation (
 	xercesc::DOMNode		* root_node,
 	std::map < OGSS_String, OGSS_Ushort >	& busMap,
@@ -116,6 +133,328 @@ void get_busesInformation (
 	}
 }
 
+void get_fabricInformation (
+	xercesc::DOMNode		* root_node,
+	Architecture			& arch) {
+	OGSS_String				name;
+	OGSS_String				buffer;
+	OGSS_Ushort				from;
+	OGSS_Ushort				to;
+	char					* tmp;
+	std::ostringstream		oss ("");
+	std::map < OGSS_String, FabricNodeType > ::const_iterator
+							node_iter;
+	std::map < OGSS_String, BusType > ::const_iterator
+							bus_iter;
+
+	xercesc::DOMNode		* fabricNode;
+	xercesc::DOMNode		* node;
+	xercesc::DOMNodeList	* list;
+
+	fabricNode = XMLParser::recursive_get_node (root_node, "fabric", false);
+
+	if (fabricNode == NULL)
+		return;
+
+	arch.m_fabric = new Fabric ();
+	list = fabricNode->getChildNodes ();
+
+	for (XMLSize_t idx = 0; idx < list->getLength (); ++idx)
+	{
+		node = list->item (idx);
+
+		tmp = _DOM_GET_STRING (node->getNodeName () );
+
+		if (OGSS_String ("node") .compare (tmp) == 0)
+		{
+			name = XMLParser::get_string (node, "name", true, true);
+			buffer = XMLParser::get_string (node, "type", true, true);
+			node_iter = fabricNodeMap.find (buffer);
+
+			if (node_iter == fabricNodeMap.end () )
+			{
+				oss << "The fabric node type " << buffer << " is not "
+					<< "referenced. Please check the XML file contents.";
+				throw SimulatorException (ERR_ARCHITECTURE, oss.str () );
+			}
+
+			if (arch.m_fabric->getNode (name) != OGSS_USHORT_MAX)
+			{
+				oss << "The fabric node " << name << " is defined twice. "
+					<< "Please check the XML file contents.";
+				throw SimulatorException (ERR_ARCHITECTURE, oss.str () );
+			}
+
+			arch.m_fabric->addNode (name, node_iter->second,
+				XMLParser::get_real (node, "latency", true, true) );
+		}
+		else if (OGSS_String ("link") .compare (tmp) == 0)
+		{
+			from = arch.m_fabric->getNode (
+				XMLParser::get_string (node, "from", true, true) );
+			to = arch.m_fabric->getNode (
+				XMLParser::get_string (node, "to", true, true) );
+
+			if (from == OGSS_USHORT_MAX || to == OGSS_USHORT_MAX
+				|| from == to)
+			{
+				oss << "A fabric link does not join two defined nodes. "
+					<< "Please check the XML file contents.";
+				throw SimulatorException (ERR_ARCHITECTURE, oss.str () );
+			}
+
+			buffer = XMLParser::get_string (node, "type", true, true);
+			bus_iter = busTypeMap.find (buffer == "und" ? "ETH" : buffer);
+
+			if (bus_iter == busTypeMap.end () )
+			{
+				oss << "The link type " << buffer << " is not "
+					<< "referenced. Please check the XML file contents.";
+				throw SimulatorException (ERR_ARCHITECTURE, oss.str () );
+			}
+
+			arch.m_fabric->addLink (from, to, bus_iter->second,
+				XMLParser::get_real (node, "bandwidth", true, true),
+				XMLParser::get_real (node, "latency", true, true) );
+		}
+
+		_DOM_FREE_STRING (tmp);
+	}
+
+	name = XMLParser::get_string (fabricNode, "host", true, true);
+	arch.m_fabric->setHostNode (arch.m_fabric->getNode (name) );
+
+	if (arch.m_fabric->getHostNode () == OGSS_USHORT_MAX)
+	{
+		oss << "The fabric host " << name << " is not a defined node. "
+			<< "Please check the XML file contents.";
+		throw SimulatorException (ERR_ARCHITECTURE, oss.str () );
+	}
+}
+
+OGSS_Ushort get_fabricTarget (
+	xercesc::DOMNode		* root_node,
+	Architecture			& arch) {
+	OGSS_String				name;
+	std::ostringstream		oss ("");
+
+	name = XMLParser::get_string (root_node, "fabric", true, true);
+
+	if (name == "und")
+		return OGSS_USHORT_MAX;
+
+	if (arch.m_fabric == NULL
+		|| arch.m_fabric->getNode (name) == OGSS_USHORT_MAX)
+	{
+		oss << "The fabric target " << name << " is not a defined node. "
+			<< "Please check the XML file contents.";
+		throw SimulatorException (ERR_ARCHITECTURE, oss.str () );
+	}
+
+	return arch.m_fabric->getNode (name);
+}
+
+void check_fabricRoutes (
+	Architecture			& arch) {
+	OGSS_Ushort				host;
+	OGSS_Ushort				target;
+	std::ostringstream		oss ("");
+
+	if (arch.m_fabric == NULL)
+		return;
+
+	arch.m_fabric->computeRoutes ();
+	for (OGSS_Ushort h = 0; h < arch.m_geometry->m_numHosts; ++h)
+	{
+		host = arch.m_hosts [h] .m_idxFabricNode;
+		if (host == OGSS_USHORT_MAX)
+			host = arch.m_fabric->getHostNode ();
+
+		for (OGSS_Ushort i = 0; i < arch.m_geometry->m_numVolumes; ++i)
+		{
+			target = arch.m_volumes [i] .m_idxFabricNode;
+
+			if (target != OGSS_USHORT_MAX
+				&& (! arch.m_fabric->hasRoute (host, target)
+					|| ! arch.m_fabric->hasRoute (target, host) ) )
+			{
+				oss << "The fabric target of volume #" << i << " cannot be "
+					<< "reached from host #" << h << ". Please check the XML "
+					<< "file contents.";
+				throw SimulatorException (ERR_ARCHITECTURE, oss.str () );
+			}
+		}
+	}
+
+	LOG(INFO) << "Fabric: " << arch.m_fabric->getNumNodes () << " nodes, "
+		<< arch.m_fabric->getNumLinks () << " links";
+}
+
+void get_hostsInformation (
+	xercesc::DOMNode		* root_node,
+	std::map < OGSS_String, OGSS_Ushort >	& busMap,
+	Architecture			& arch) {
+	OGSS_Ushort				index = 1;
+	OGSS_String				buffer;
+	char					* tmp;
+	std::ostringstream		oss ("");
+
+	xercesc::DOMNode		* node;
+	xercesc::DOMNodeList	* list;
+
+	// The default host sends the requests of the undeclared identifiers
+	arch.m_hosts [0] .m_id = 0;
+	arch.m_hosts [0] .m_idxBus = OGSS_USHORT_MAX;
+	arch.m_hosts [0] .m_bufferSize = 0;
+	arch.m_hosts [0] .m_maxOutstanding = 0;
+	arch.m_hosts [0] .m_idxFabricNode = OGSS_USHORT_MAX;
+
+	node = XMLParser::recursive_get_node (root_node, "hosts", false);
+
+	if (node == NULL)
+		return;
+
+	list = node->getChildNodes ();
+
+	for (XMLSize_t idx = 0; idx < list->getLength (); ++idx)
+	{
+		node = list->item (idx);
+
+		tmp = _DOM_GET_STRING (node->getNodeName () );
+
+		if (OGSS_String ("host") .compare (tmp) == 0)
+		{
+			Host			& host = arch.m_hosts [index];
+			OGSS_Ulong		id = XMLParser::get_long (node, "id", true, false);
+
+			if (id > UINT_MAX)
+			{
+				oss << "The host identifier " << id << " is out of range. "
+					<< "Please check the XML file contents.";
+				throw SimulatorException (ERR_ARCHITECTURE, oss.str () );
+			}
+
+			host.m_id = id;
+
+			if (! arch.addIdxHost (host.m_id, index) )
+			{
+				oss << "The host " << host.m_id << " is defined twice. "
+					<< "Please check the XML file contents.";
+				throw SimulatorException (ERR_ARCHITECTURE, oss.str () );
+			}
+
+			buffer = XMLParser::get_string (node, "bus", true, true);
+			if (buffer == "und")
+				host.m_idxBus = OGSS_USHORT_MAX;
+			else
+			{
+				host.m_idxBus = busMap [buffer];
+				arch.m_buses [host.m_idxBus] .addDevice ();
+			}
+
+			host.m_bufferSize = XMLParser::get_long (node, "buffersize",
+				true, true) * MEGABYTE;
+			host.m_maxOutstanding = XMLParser::get_long (node, "maxio",
+				true, true);
+			host.m_idxFabricNode = get_fabricTarget (node, arch);
+
+			index++;
+		}
+
+		_DOM_FREE_STRING (tmp);
+	}
+}
+
+void get_qosInformation (
+	xercesc::DOMNode		* root_node,
+	Architecture			& arch) {
+	char					* tmp;
+	std::ostringstream		oss ("");
+	OGSS_String				buffer;
+
+	xercesc::DOMNode		* node;
+	xercesc::DOMNodeList	* list;
+
+	// The default class gets the requests of the undeclared colors
+	arch.m_qosClasses.resize (1);
+	arch.m_qosClasses [0] .m_color = 0;
+	arch.m_qosClasses [0] .m_priority = 0;
+	arch.m_qosClasses [0] .m_weight = 1.;
+	arch.m_qosClasses [0] .m_rate = .0;
+	arch.m_qosClasses [0] .m_burst = 0;
+
+	node = XMLParser::recursive_get_node (root_node, "qos", false);
+
+	if (node == NULL)
+		return;
+
+	list = node->getChildNodes ();
+
+	for (XMLSize_t idx = 0; idx < list->getLength (); ++idx)
+	{
+		node = list->item (idx);
+
+		tmp = _DOM_GET_STRING (node->getNodeName () );
+
+		if (OGSS_String ("class") .compare (tmp) == 0)
+		{
+			QoSClass		qos;
+			OGSS_Ulong		color = XMLParser::get_long (node, "color",
+								true, false);
+
+			if (color > UINT_MAX)
+			{
+				oss << "The QoS color " << color << " is out of range. "
+					<< "Please check the XML file contents.";
+				throw SimulatorException (ERR_ARCHITECTURE, oss.str () );
+			}
+
+			qos.m_color = color;
+
+			if (! arch.addIdxQoSClass (qos.m_color,
+				arch.m_qosClasses.size () ) )
+			{
+				oss << "The QoS class of color " << qos.m_color << " is "
+					<< "defined twice. Please check the XML file contents.";
+				throw SimulatorException (ERR_ARCHITECTURE, oss.str () );
+			}
+
+			qos.m_priority = XMLParser::get_long (node, "priority",
+				true, true);
+
+			buffer = XMLParser::get_string (node, "weight", true, true);
+			if (buffer == "und")
+				qos.m_weight = 1.;
+			else
+			{
+				qos.m_weight = atof (buffer.c_str () );
+
+				if (qos.m_weight <= .0)
+				{
+					oss << "The QoS class of color " << qos.m_color
+						<< " has a weight of " << buffer << ", which should "
+						<< "be positive. Please check the XML file contents.";
+					throw SimulatorException (ERR_ARCHITECTURE, oss.str () );
+				}
+			}
+
+			qos.m_rate = XMLParser::get_real (node, "rate", true, true);
+			qos.m_burst = XMLParser::get_real (node, "burst", true, true)
+				* MEGABYTE;
+
+			// Without a given size, the bucket holds one MB
+			if (qos.m_rate > .0 && qos.m_burst == 0)
+				qos.m_burst = MEGABYTE;
+
+			arch.m_qosClasses.push_back (qos);
+		}
+
+		_DOM_FREE_STRING (tmp);
+	}
+
+	LOG(INFO) << "QoS: " << arch.m_qosClasses.size () - 1 << " classes";
+}
+
 void get_deviceInformation (
 	xercesc::DOMNode		* root_node,
 	Architecture 			& arch,
@@ -124,6 +463,7 @@ void get_deviceInformation (
 	OGSS_String				filename;
 	Device					dev;
 	OGSS_Ushort				maxDevices;
+	OGSS_Real				linkBandwidth;
 
 	maxDevices = arch.m_volumes [index_vol] .m_numDevices
 		+ arch.m_volumes [index_vol] .m_idxDevices;
@@ -132,6 +472,15 @@ void get_deviceInformation (
 
 	dev = XMLParser::getDeviceConfiguration (filename);
 
+	if (! dev.isFlash () ) {
+		dev.m_hardware.m_hdd.m_seekCurve =
+			arch.getSeekCurve (dev.m_hardware.m_hdd);
+
+		// The zone table is shared by the devices of the volume
+		if (dev.m_hardware.m_hdd.m_zoneTable != NULL)
+			arch.m_zoneTables.push_back (dev.m_hardware.m_hdd.m_zoneTable);
+	}
+
 	while (index_dev != maxDevices)
 	{
 		arch.m_devices [index_dev] = dev;
@@ -139,15 +488,105 @@ void get_deviceInformation (
 		arch.m_devices [index_dev] .m_clock = .0;
 		arch.m_devices [index_dev] .m_workingTime = .0;
 		arch.m_devices [index_dev] .m_idxLastRequest = OGSS_ULONG_MAX;
-		if (arch.m_devices [index_dev] .m_type == DVT_SSD) {
+		if (arch.m_devices [index_dev] .isFlash () ) {
 			arch.m_devices [index_dev] .m_hardware.m_ssd.m_lastPageSeen
 				= new OGSS_Ulong [dev.m_hardware.m_ssd.m_numDies];
 			for (unsigned i = 0; i < dev.m_hardware.m_ssd.m_numDies; ++i)
 				arch.m_devices [index_dev] .m_hardware.m_ssd.m_lastPageSeen [i] = 0;
+
+			if (dev.m_hardware.m_ssd.m_numChannels != 0) {
+				arch.m_devices [index_dev] .m_hardware.m_ssd.m_dieClock
+					= new OGSS_Real [dev.m_hardware.m_ssd.m_numDies] ();
+				arch.m_devices [index_dev] .m_hardware.m_ssd.m_channelClock
+					= new OGSS_Real [dev.m_hardware.m_ssd.m_numChannels] ();
+			}
+
+			// Each device gets its own mapping
+			if (dev.m_hardware.m_ssd.m_overprovisioning > 0)
+				arch.m_devices [index_dev] .m_hardware.m_ssd.m_ftl
+					= new FlashTranslationLayer (dev.m_hardware.m_ssd);
+
+			if (dev.m_type == DVT_NVME)
+				arch.m_devices [index_dev] .m_hardware.m_ssd.m_nvme
+					= new NVMeController (dev.m_hardware.m_ssd);
+		} else if (arch.m_devices [index_dev] .m_type == DVT_SMR) {
+			// Each device gets its own write pointers
+			arch.m_devices [index_dev] .m_hardware.m_hdd.m_smrZones
+				= new ShingledZones (dev.m_hardware.m_hdd);
 		}
 
 		index_dev++;
 	}
+
+	if (dev.m_type != DVT_NVME)
+		return;
+
+	// The PCIe links of the devices end on the volume bus
+	Bus & bus = arch.m_buses [arch.m_volumes [index_vol] .m_idxBus];
+	linkBandwidth = arch.m_volumes [index_vol] .m_numDevices
+		* dev.m_hardware.m_ssd.m_nvmeLanes
+		* dev.m_hardware.m_ssd.m_nvmeLaneBandwidth;
+
+	if (bus.m_type != BST_PCIE)
+		LOG(WARNING) << "The NVMe devices of volume #" << index_vol
+			<< " are not on a PCIe bus";
+	if (bus.m_bandwidth < linkBandwidth)
+		LOG(INFO) << "The bus of volume #" << index_vol << " is "
+			<< "oversubscribed by its NVMe devices ("
+			<< linkBandwidth / bus.m_bandwidth << ":1, "
+			<< arch.m_volumes [index_vol] .m_numDevices
+			* dev.m_hardware.m_ssd.m_nvmeLanes << " lanes)";
+}
+
+void get_volumeCacheInformation (
+	xercesc::DOMNode		* root_node,
+	Volume					& volume) {
+	OGSS_String				value;
+	std::map < OGSS_String, CachePolicyType > ::const_iterator
+							map_iter;
+
+	volume.m_cacheSize =
+		XMLParser::get_long (root_node, "size", true, true) * MEGABYTE;
+	volume.m_cacheBlockSize =
+		XMLParser::get_long (root_node, "blocksize", true, true) * 1024;
+	if (volume.m_cacheBlockSize == 0)
+		volume.m_cacheBlockSize = 4 * 1024;
+
+	value = XMLParser::get_string (root_node, "policy", true, true);
+	map_iter = cachePolicyMap.find (value);
+	if (map_iter != cachePolicyMap.end () )
+		volume.m_cachePolicy = map_iter->second;
+	else {
+		if (value.compare ("und") != 0)
+			LOG(WARNING) << "The cache policy " << value << " is not "
+				<< "referenced, LRU will be used";
+		volume.m_cachePolicy = CPT_LRU;
+	}
+
+	volume.m_cacheWriteBack =
+		XMLParser::get_string (root_node, "writepolicy", true, true)
+		.compare ("writeback") == 0;
+
+	volume.m_cacheLatency =
+		XMLParser::get_real (root_node, "latency", true, true);
+
+	volume.m_cacheDirtyRatio =
+		XMLParser::get_real (root_node, "dirtyratio", true, true);
+	if (volume.m_cacheDirtyRatio <= 0 || volume.m_cacheDirtyRatio > 1)
+		volume.m_cacheDirtyRatio = .2;
+
+	// By default, each device of the volume destages at 100MB/s
+	volume.m_cacheFlushRate =
+		XMLParser::get_real (root_node, "flushrate", true, true);
+	if (volume.m_cacheFlushRate <= 0)
+		volume.m_cacheFlushRate = 100. * volume.m_numDevices;
+	volume.m_cacheFlushRate *= MILLISEC * MEGABYTE;
+
+	if (volume.m_cacheSize < volume.m_cacheBlockSize) {
+		LOG(WARNING) << "The volume cache is smaller than a cache block, it "
+			<< "is not modeled";
+		volume.m_cacheSize = 0;
+	}
 }
 
 void get_volumeInformation (
@@ -173,6 +612,7 @@ void get_volumeInformation (
 	VolumeSchemeType		volType;
 
 	xercesc::DOMNode		* node;
+	xercesc::DOMNode		* cacheNode;
 
 	std::map < OGSS_String, VolumeSchemeType > ::const_iterator
 												map_iter;
@@ -207,6 +647,13 @@ void get_volumeInformation (
 	arch.m_volumes [index_vol] .m_idxDevices = index_dev;
 
 	arch.m_volumes [index_vol] .m_bufferSize = bufferSize;
+	arch.m_volumes [index_vol] .m_idxFabricNode =
+		get_fabricTarget (root_node, arch);
+
+	arch.m_volumes [index_vol] .m_cacheSize = 0;
+	cacheNode = XMLParser::recursive_get_node (root_node, "cache", false);
+	if (cacheNode != NULL)
+		get_volumeCacheInformation (cacheNode, arch.m_volumes [index_vol]);
 
 	if (volType ==VST_RAID01)
 	{
@@ -277,6 +724,7 @@ void get_decraidInformation (
 {
 	OGSS_String				busName;
 	OGSS_Ushort				idx_device = 0;
+	OGSS_Ushort				idx_root;
 	OGSS_Ulong				decSize = 0;
 
 	OGSS_Ushort				num_volumes = 0;
@@ -323,6 +771,9 @@ void get_decraidInformation (
 	arch.m_volumes [index_vol] .m_numDevices = num_devices;
 	arch.m_volumes [index_vol] .m_idxDevices = index_dev;
 	arch.m_volumes [index_vol] .m_bufferSize = bufferSize;
+	arch.m_volumes [index_vol] .m_idxFabricNode =
+		get_fabricTarget (root_node, arch);
+	idx_root = index_vol;
 
 	arch.m_volumes [index_vol] .m_hardware.m_draid.m_type = decraidType;
 	arch.m_volumes [index_vol] .m_hardware.m_draid.m_numVolumes = num_volumes;
@@ -355,6 +806,11 @@ void get_decraidInformation (
 
 			get_volumeInformation (node, busMap, arch,
 				index_tier, index_vol, index_dev, true);
+
+			// The subvolumes are in the enclosure of the declustered RAID
+			if (arch.m_volumes [index_vol] .m_idxFabricNode == OGSS_USHORT_MAX)
+				arch.m_volumes [index_vol] .m_idxFabricNode =
+					arch.m_volumes [idx_root] .m_idxFabricNode;
 		}
 		_DOM_FREE_STRING (tmp);
 	}
@@ -462,12 +918,14 @@ void get_systemInformation (
 void count_hardware (
 	xercesc::DOMNode		* node,
 	OGSS_Ushort 			& numBuses,
+	OGSS_Ushort				& numHosts,
 	OGSS_Ushort				& numTiers,
 	OGSS_Ushort				& numVolumes,
 	OGSS_Ushort				& numDevices) {
 	xercesc::DOMNodeList	* list;
 
 	numBuses += XMLParser::get_long (node, "nbbuses", true, true);
+	numHosts += XMLParser::get_long (node, "nbhosts", true, true);
 	numTiers += XMLParser::get_long (node, "nbtiers", true, true);
 	numVolumes += XMLParser::get_long (node, "nbvolumes", true, true);
 	numVolumes += XMLParser::get_long (node, "nbsubvol", true, true);
@@ -476,12 +934,14 @@ void count_hardware (
 	list = node->getChildNodes ();
 
 	for (XMLSize_t idx = 0; idx < list->getLength (); ++idx)
-		count_hardware (list->item (idx), numBuses, numTiers, numVolumes, numDevices);
+		count_hardware (list->item (idx), numBuses, numHosts, numTiers,
+			numVolumes, numDevices);
 }
 
 void
 prepareArchitecture (
 	const OGSS_Ushort		num_buses,
+	const OGSS_Ushort		num_hosts,
 	const OGSS_Ushort		num_tiers,
 	const OGSS_Ushort		num_volumes,
 	const OGSS_Ushort		num_devices,
@@ -490,6 +950,7 @@ prepareArchitecture (
 	arch.m_geometry = new Geometry;
 
 	arch.m_geometry->m_numBuses = num_buses;
+	arch.m_geometry->m_numHosts = num_hosts;
 	arch.m_geometry->m_numTiers = num_tiers;
 	arch.m_geometry->m_numVolumes = num_volumes;
 	arch.m_geometry->m_numDevices = num_devices;
@@ -497,11 +958,14 @@ prepareArchitecture (
 	// Bus allocation
 	arch.m_buses = new Bus [num_buses];
 
+	// Host allocation
+	arch.m_hosts = new Host [num_hosts];
+
 	// Tier allocation
 	arch.m_tiers = new Tier [num_tiers];
 
 	// Volume allocation
-	arch.m_volumes = new Volume [num_volumes];
+	arch.m_volumes = new Volume [num_volumes] ();
 
 	// Device allocation
 	arch.m_devices = new Device [num_devices];
@@ -512,6 +976,7 @@ XMLParser::getHardwareConfiguration (
 	const OGSS_String		filename,
 	Architecture			& arch) {
 	OGSS_Ushort				numBuses = 0;
+	OGSS_Ushort				numHosts = 1;
 	OGSS_Ushort				numTiers = 0;
 	OGSS_Ushort				numVolumes = 0;
 	OGSS_Ushort				numDevices = 0;
@@ -528,10 +993,16 @@ XMLParser::getHardwareConfiguration (
 		{
 			xercesc::DOMNode * pNode = parser->getDocument () ->getDocumentElement ();
 
-			count_hardware (pNode, numBuses, numTiers, numVolumes, numDevices);
-			prepareArchitecture (numBuses, numTiers, numVolumes, numDevices, arch);
+			count_hardware (pNode, numBuses, numHosts, numTiers, numVolumes,
+				numDevices);
+			prepareArchitecture (numBuses, numHosts, numTiers, numVolumes,
+				numDevices, arch);
 			get_busesInformation (pNode, busMap, arch);
+			get_fabricInformation (pNode, arch);
+			get_hostsInformation (pNode, busMap, arch);
+			get_qosInformation (pNode, arch);
 			get_systemInformation (pNode, busMap, arch);
+			check_fabricRoutes (arch);
 		}
 	}
 	catch (const std::exception & ex)
@@ -27,6 +27,8 @@
  * for the configuration file parser.
  */
 
+#include <algorithm>
+#include <cstdio>
 #include <glog/logging.h>
 #include <map>
 #include <sstream>
@@ -45,7 +47,8 @@ const std::map < OGSS_String, EventType >	eventTypeMap =
 
 const std::map < OGSS_String, ComputationModelType > cmTypeMap = {
 	{"default", CMT_BUS_DEFAULT},
-	{"advanced", CMT_BUS_ADVANCED}
+	{"advanced", CMT_BUS_ADVANCED},
+	{"fluid", CMT_BUS_FLUID}
 };
 
 const map <OGSS_FileType, OGSS_String> FTPMap = {
@@ -368,3 +371,269 @@ XMLParser::getComputationModelInformation (
 
 	delete parser;
 }
+
+void
+XMLParser::getOrderingInformation (
+	const OGSS_String		filename,
+	OGSS_Bool				& deterministic,
+	OGSS_Real				& quantum) {
+	xercesc::XercesDOMParser * parser = new xercesc::XercesDOMParser ();
+	xercesc::DOMNode		* node;
+
+	deterministic = false;
+	quantum = .0;
+
+	try
+	{
+		parser->parse (filename.c_str () );
+
+		node = parser->getDocument () -> getDocumentElement ();
+		node = get_node (node, OGSS_NAME_EXEC, true);
+		node = recursive_get_node (node, OGSS_NAME_ORDR, false);
+
+		if (node != NULL)
+		{
+			deterministic = (get_string (node, "type", true, false)
+				.compare ("deterministic") == 0);
+			quantum = get_real (node, "quantum", true, true);
+		}
+	}
+	catch (const SimulatorException & ex)
+	{
+		DLOG(ERROR) << "[" << ex.getCode () << "] " << filename << ": "
+			<< ex.getMessage ();
+	}
+	catch (const std::exception & ex)
+	{
+		DLOG(ERROR) << "Exception caught: " << ex.what ();
+	}
+
+	delete parser;
+}
+
+OGSS_String
+XMLParser::getTimingInformation (
+	const OGSS_String		filename) {
+	xercesc::XercesDOMParser * parser = new xercesc::XercesDOMParser ();
+	xercesc::DOMNode		* node;
+	OGSS_String				timingFile ("");
+
+	try
+	{
+		parser->parse (filename.c_str () );
+
+		node = parser->getDocument () -> getDocumentElement ();
+		node = get_node (node, OGSS_NAME_GNRL, true);
+		node = recursive_get_node (node, "timing", false);
+
+		if (node != NULL)
+			timingFile = get_string (node, "file", true, false);
+	}
+	catch (const SimulatorException & ex)
+	{
+		DLOG(ERROR) << "[" << ex.getCode () << "] " << filename << ": "
+			<< ex.getMessage ();
+	}
+	catch (const std::exception & ex)
+	{
+		DLOG(ERROR) << "Exception caught: " << ex.what ();
+	}
+
+	delete parser;
+
+	return timingFile;
+}
+
+void
+XMLParser::getStreamInformation (
+	const OGSS_String		filename,
+	OGSS_Real				& interval,
+	OGSS_String				& output) {
+	xercesc::XercesDOMParser * parser = new xercesc::XercesDOMParser ();
+	xercesc::DOMNode		* node;
+
+	interval = .0;
+	output = "";
+
+	try
+	{
+		parser->parse (filename.c_str () );
+
+		node = parser->getDocument () -> getDocumentElement ();
+		node = get_node (node, OGSS_NAME_PERF, true);
+		node = recursive_get_node (node, OGSS_NAME_STRM, false);
+
+		if (node != NULL)
+		{
+			interval = get_real (node, "interval", true, false);
+			output = get_string (node, "output", true, false);
+		}
+	}
+	catch (const SimulatorException & ex)
+	{
+		DLOG(ERROR) << "[" << ex.getCode () << "] " << filename << ": "
+			<< ex.getMessage ();
+	}
+	catch (const std::exception & ex)
+	{
+		DLOG(ERROR) << "Exception caught: " << ex.what ();
+	}
+
+	delete parser;
+}
+
+void
+XMLParser::getBusProfileInformation (
+	const OGSS_String		filename,
+	OGSS_Ulong				& capacity,
+	OGSS_String				& output) {
+	xercesc::XercesDOMParser * parser = new xercesc::XercesDOMParser ();
+	xercesc::DOMNode		* node;
+	OGSS_Ulong				value;
+
+	capacity = 0;
+	output = "";
+
+	try
+	{
+		parser->parse (filename.c_str () );
+
+		node = parser->getDocument () -> getDocumentElement ();
+		node = get_node (node, OGSS_NAME_PERF, true);
+		node = recursive_get_node (node, OGSS_NAME_BPRF, false);
+
+		if (node != NULL)
+		{
+			value = get_long (node, "capacity", true, true);
+			output = get_string (node, "output", true, false);
+
+			if (value != 0)
+				capacity = max (value, (OGSS_Ulong) 16);
+		}
+	}
+	catch (const SimulatorException & ex)
+	{
+		DLOG(ERROR) << "[" << ex.getCode () << "] " << filename << ": "
+			<< ex.getMessage ();
+	}
+	catch (const std::exception & ex)
+	{
+		DLOG(ERROR) << "Exception caught: " << ex.what ();
+	}
+
+	delete parser;
+}
+
+void
+XMLParser::getTraceInformation (
+	const OGSS_String		filename,
+	OGSS_String				& output,
+	OGSS_String				& components) {
+	xercesc::XercesDOMParser * parser = new xercesc::XercesDOMParser ();
+	xercesc::DOMNode		* node;
+
+	output = "";
+	components = "";
+
+	try
+	{
+		parser->parse (filename.c_str () );
+
+		node = parser->getDocument () -> getDocumentElement ();
+		node = get_node (node, OGSS_NAME_PERF, true);
+		node = recursive_get_node (node, OGSS_NAME_TRCE, false);
+
+		if (node != NULL)
+		{
+			output = get_string (node, "output", true, false);
+			components = get_string (node, "components", true, true);
+
+			if (components.empty () )
+				components = "all";
+		}
+	}
+	catch (const SimulatorException & ex)
+	{
+		DLOG(ERROR) << "[" << ex.getCode () << "] " << filename << ": "
+			<< ex.getMessage ();
+	}
+	catch (const std::exception & ex)
+	{
+		DLOG(ERROR) << "Exception caught: " << ex.what ();
+	}
+
+	delete parser;
+}
+
+void
+XMLParser::getDistributedInformation (
+	const OGSS_String		filename,
+	std::vector <WorkerDescription>	& workers) {
+	xercesc::XercesDOMParser * parser = new xercesc::XercesDOMParser ();
+	xercesc::DOMNode		* node;
+	xercesc::DOMNodeList	* list;
+
+	std::ostringstream		oss ("");
+
+	WorkerDescription		worker;
+	OGSS_String				tiers;
+	char					* tmp;
+	unsigned				first, last;
+
+	workers.clear ();
+
+	try
+	{
+		parser->parse (filename.c_str () );
+
+		node = parser->getDocument () -> getDocumentElement ();
+		node = get_node (node, OGSS_NAME_DIST, true);
+
+		list = node->getChildNodes ();
+
+		for (XMLSize_t idx = 0; idx < list->getLength (); ++idx)
+		{
+			node = list->item (idx);
+			tmp = _DOM_GET_STRING (node->getNodeName () );
+
+			if (OGSS_NAME_WRKR.compare (tmp) == 0)
+			{
+				tiers = get_string (node, "tiers", true, true);
+				first = last = 0;
+
+				if (tiers.compare ("und") != 0
+					&& sscanf (tiers.c_str (), "%u-%u", &first, &last) == 1)
+					last = first;
+
+				if (last < first)
+				{
+					oss << "Worker #" << workers.size ()
+						<< " gets an empty tier range";
+					_DOM_FREE_STRING (tmp);
+					throw SimulatorException (ERR_XMLPARSER,
+						oss.str () .c_str () );
+				}
+
+				worker.m_firstTier = first;
+				worker.m_lastTier = last;
+				worker.m_requests = get_string (node, "requests", true, false);
+				worker.m_results = get_string (node, "results", true, false);
+
+				workers.push_back (worker);
+			}
+
+			_DOM_FREE_STRING (tmp);
+		}
+	}
+	catch (const SimulatorException & ex)
+	{
+		DLOG(ERROR) << "[" << ex.getCode () << "] " << filename << ": "
+			<< ex.getMessage ();
+	}
+	catch (const std::exception & ex)
+	{
+		DLOG(ERROR) << "Exception caught: " << ex.what ();
+	}
+
+	delete parser;
+}
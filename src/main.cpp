@@ -39,6 +39,7 @@
 #include "Drivers/devicedriver.hpp"
 #include "Drivers/volumedriver.hpp"
 
+#include "Modules/coordinator.hpp"
 #include "Modules/eventreader.hpp"
 #include "Modules/execution.hpp"
 #include "Modules/hardwareconfiguration.hpp"
@@ -48,7 +49,9 @@
 
 #include "Structures/types.hpp"
 
+#include "Utils/chrono.hpp"
 #include "Utils/simexception.hpp"
+#include "Utils/stagetimer.hpp"
 #include "Utils/synchro.hpp"
 #include "Utils/unitarytest.hpp"
 
@@ -64,15 +67,26 @@ launchPreprocessing (
     Barrier                 * sendingBarrier)
 {
 	PreProcessing 			* pp;
+	Chrono					chrono;
+
+	chrono.tick ();
 
 	pp = new PreProcessing (configuration);
 
 	extractionBarrier->wait ();
 
 	pp->receiveData ();
+	chrono.tick ();
+	StageTimer::add (STG_LOAD, chrono.get () );
+
 	executionBarrier->wait ();
 
+	chrono.restart ();
+	chrono.tick ();
 	pp->updateVolumeMapping ();
+	chrono.tick ();
+	StageTimer::add (STG_PREPROCESSING, chrono.get () );
+
 	sendingBarrier->wait ();
 
 #ifndef __NOSIM__
@@ -93,11 +107,12 @@ void
 launchWorkload (
 	const OGSS_String		& configuration,
 	Barrier					* extractionBarrier,
-	Barrier					* finalizeBarrier)
+	Barrier					* finalizeBarrier,
+	const OGSS_Bool			remote)
 {
 	Workload 				* wl;
 
-	wl = new Workload (configuration);
+	wl = new Workload (configuration, remote);
 
 	extractionBarrier->wait ();
 
@@ -167,8 +182,13 @@ launchExecution (
 	sendingBarrier->wait ();
 
 #ifndef __NOSIM__
+	Chrono					chrono;
+
 	DLOG(INFO) << "Launching simulation";
+	chrono.tick ();
 	ex->executeSimulation ();
+	chrono.tick ();
+	StageTimer::add (STG_EXECUTION, chrono.get () );
 #endif
 
 	delete ex;
@@ -197,6 +217,21 @@ launchPerformanceEvaluation (
 	delete module;
 }
 
+void
+launchCoordinator (
+	const OGSS_String		& configuration)
+{
+	Coordinator				* co;
+
+	co = new Coordinator (configuration);
+
+	co->updateWorkerMapping ();
+	co->dispatchRequests ();
+	co->collectResults ();
+
+	delete co;
+}
+
 int
 main (
 	int						argc,
@@ -211,6 +246,8 @@ main (
 
 	OGSS_String				configurationFile;
 	OGSS_String				logFile;
+	OGSS_String				mode;
+	OGSS_String				timingFile;
 	int						logLevel;
 
 	Barrier					extractionBarrier (4);
@@ -228,16 +265,38 @@ main (
 	}
 
 	configurationFile = argv [1];
+	mode = argc > 2 ? argv [2] : "";
 	XMLParser::getGlogInformation (configurationFile, logFile, logLevel);
 
 	FLAGS_minloglevel = logLevel;
 	FLAGS_logbuflevel = -1;
 	google::SetLogDestination (google::INFO, logFile.c_str () );
 
+	timingFile = XMLParser::getTimingInformation (configurationFile);
+	if (! timingFile.empty () )
+		StageTimer::enable ();
+
+	if (mode.compare (OGSS_NAME_CORD) == 0)
+	{
+		try
+		{ launchCoordinator (configurationFile); }
+		catch (SimulatorException & e)
+		{ DLOG(ERROR) << e.getMessage (); }
+		catch (std::exception & e)
+		{ DLOG(ERROR) << e.what (); }
+
+		xercesc::XMLPlatformUtils::Terminate ();
+		google::ShutdownGoogleLogging ();
+		google::ShutDownCommandLineFlags();
+
+		return 0;
+	}
+
 	try
 	{
 		workloadThread = new std::thread (launchWorkload,
-			configurationFile, &extractionBarrier, &finalizeBarrier);
+			configurationFile, &extractionBarrier, &finalizeBarrier,
+			mode.compare (OGSS_NAME_WRKR) == 0);
 		hardwareThread = new std::thread (launchHardwareConfiguration,
 			configurationFile, &extractionBarrier, &finalizeBarrier);
 		eventThread = new std::thread (launchEventReader,
@@ -265,12 +324,18 @@ main (
 		delete eventThread;
 		delete hardwareThread;
 		delete workloadThread;
+
+		if (mode.compare (OGSS_NAME_WRKR) == 0)
+			Workload::returnResults (configurationFile);
 	}
 	catch (SimulatorException e)
 	{ DLOG(ERROR) << e.getMessage (); }
 	catch (std::exception & e)
 	{ DLOG(ERROR) << e.what (); }
 
+	if (! timingFile.empty () )
+		StageTimer::write (timingFile);
+
 	xercesc::XMLPlatformUtils::Terminate ();
 	
 	DLOG(INFO) << "Simulation Done!";
@@ -0,0 +1,187 @@
+/*
+ * Copyright UVSQ - CEA/DAM/DIF (2016)
+ * contributeur : Sebastien GOUGEAUD	sebastien.gougeaud@uvsq.fr
+ *                Soraya ZERTAL			soraya.zertal@uvsq.fr
+ *
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ *
+ * ---------------------------------------
+ */
+
+/**
+ * @file	ogssim-tracedecode.cpp
+ * @brief	Event trace decoder. It reads a binary trace written by OGSSim and
+ * converts it to CSV, or to the Chrome trace JSON format which can be opened
+ * in chrome://tracing or Perfetto.
+ *
+ * Usage: ogssim-tracedecode [-f csv|chrome] [-o output] trace
+ */
+
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "Utils/eventtrace.hpp"
+
+using namespace std;
+
+/**************************************/
+/* CONSTANTS **************************/
+/**************************************/
+static const char			* COMPONENTS [TRC_TOTAL] = {
+	"bus", "device", "qos" };
+
+static const char			* IDENTIFIERS [TRC_TOTAL] = {
+	"Bus", "Device", "Class" };
+
+/**************************************/
+/* FUNCTIONS **************************/
+/**************************************/
+/**
+ * Write a record as a CSV line.
+ * @param	stream				Output stream.
+ * @param	r					Record.
+ */
+static void
+writeCSV (
+	ostream					& stream,
+	const TraceRecord		& r) {
+	stream << COMPONENTS [r.m_component] << "," << r.m_id << ","
+		<< r.m_idxRequest << "," << (unsigned) r.m_step << ","
+		<< (unsigned) r.m_toDevice << "," << r.m_start << "," << r.m_end
+		<< "," << r.m_occupancy << "," << r.m_thread << "\n";
+}
+
+/**
+ * Write a record as a Chrome trace complete event. The dates are converted to
+ * microseconds.
+ * @param	stream				Output stream.
+ * @param	r					Record.
+ */
+static void
+writeChrome (
+	ostream					& stream,
+	const TraceRecord		& r) {
+	stream << ",\n{\"name\":\"" << r.m_idxRequest << "\",\"cat\":\""
+		<< COMPONENTS [r.m_component] << "\",\"ph\":\"X\",\"ts\":"
+		<< r.m_start * 1000 << ",\"dur\":" << (r.m_end - r.m_start) * 1000
+		<< ",\"pid\":" << r.m_component << ",\"tid\":" << r.m_id
+		<< ",\"args\":{\"request\":" << r.m_idxRequest << ",\"step\":"
+		<< (unsigned) r.m_step << ",\"toDevice\":" << (unsigned) r.m_toDevice
+		<< ",\"occupancy\":" << r.m_occupancy << "}}";
+}
+
+int
+main (
+	int						argc,
+	char					** argv) {
+	string					format = "csv";
+	string					output;
+	ifstream				input;
+	ofstream				file;
+	ostream					* stream = &cout;
+	TraceHeader				header;
+	TraceRecord				record;
+	OGSS_Ulong				numRecords = 0;
+	int						opt;
+
+	while ( (opt = getopt (argc, argv, "f:o:") ) != -1)
+	{
+		switch (opt)
+		{
+		case 'f': format = optarg; break;
+		case 'o': output = optarg; break;
+		default: optind = argc + 1; break;
+		}
+	}
+
+	if (optind != argc - 1 || (format != "csv" && format != "chrome") )
+	{
+		cerr << "Usage: " << argv [0] << " [-f csv|chrome] [-o output] trace"
+			<< endl;
+		return 1;
+	}
+
+	input.open (argv [optind], ios::binary);
+	if (! input.read ((char *) &header, sizeof (TraceHeader) )
+		|| memcmp (header.m_magic, TRACE_MAGIC, sizeof (header.m_magic) ) )
+	{
+		cerr << argv [optind] << " is not an OGSSim trace" << endl;
+		return 1;
+	}
+
+	if (header.m_version != TRACE_VERSION
+		|| header.m_recordSize != sizeof (TraceRecord) )
+	{
+		cerr << argv [optind] << " has the trace format " << header.m_version
+			<< ", expected " << TRACE_VERSION << endl;
+		return 1;
+	}
+
+	if (! output.empty () )
+	{
+		file.open (output.c_str () );
+		if (! file.is_open () )
+		{
+			cerr << "There is a problem opening the file " << output << endl;
+			return 1;
+		}
+		stream = &file;
+	}
+
+	*stream << setprecision (15);
+
+	if (format == "csv")
+		*stream << "component,id,request,step,todevice,start,end,occupancy,"
+			<< "thread\n";
+	else
+	{
+		// The components are the processes of the trace viewer
+		*stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		for (unsigned i = 0; i < TRC_TOTAL; ++i)
+			*stream << (i ? ",\n" : "\n") << "{\"name\":\"process_name\","
+				<< "\"ph\":\"M\",\"pid\":" << i << ",\"args\":{\"name\":\""
+				<< IDENTIFIERS [i] << "s\"}}";
+	}
+
+	while (input.read ((char *) &record, sizeof (TraceRecord) ) )
+	{
+		if (record.m_component >= TRC_TOTAL)
+		{
+			cerr << "Record #" << numRecords << " has an unknown component"
+				<< endl;
+			return 1;
+		}
+
+		if (format == "csv")
+			writeCSV (*stream, record);
+		else
+			writeChrome (*stream, record);
+
+		++numRecords;
+	}
+
+	if (format == "chrome")
+		*stream << "\n]}\n";
+
+	cerr << numRecords << " records decoded" << endl;
+
+	return 0;
+}